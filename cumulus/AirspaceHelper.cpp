@@ -23,6 +23,7 @@
 #include "mapcontents.h"
 #include "mapmatrix.h"
 #include "OpenAip.h"
+#include "OpenAipCompiler.h"
 #include "openairparser.h"
 #include "projectionbase.h"
 #include "resource.h"
@@ -35,12 +36,117 @@ QSet<int> AirspaceHelper::m_airspaceDictionary;
 
 QMutex AirspaceHelper::m_mutex;
 
-int AirspaceHelper::loadAirspaces( QList<Airspace*>& list, bool readSource )
+/**
+ * Loads one airspace file into its own list. The jobs of all files are
+ * executed in parallel by a thread pool.
+ */
+class AirspaceLoadJob : public QRunnable
+{
+ public:
+
+  AirspaceLoadJob( const QString& fileName, const bool compiled ) :
+    m_fileName(fileName),
+    m_key(AirspaceHelper::setKey(fileName)),
+    m_compiled(compiled),
+    m_ok(false),
+    m_msecs(0)
+  {
+    // The results are fetched after the execution.
+    setAutoDelete( false );
+  };
+
+  virtual ~AirspaceLoadJob() {};
+
+  void run()
+  {
+    QTime t; t.start();
+
+    // The stamp is taken before reading, a later change causes a new load.
+    m_stamp = AirspaceHelper::fileStamp( m_key );
+
+    if( m_compiled )
+      {
+        m_ok = AirspaceHelper::readCompiledFile( m_fileName, m_list );
+      }
+    else if( m_fileName.endsWith( ".txt" ) )
+      {
+        OpenAirParser oap;
+        m_ok = oap.parse( m_fileName, m_list, true );
+      }
+    else
+      {
+        OpenAip oaip;
+        QString errorInfo;
+        m_ok = oaip.readAirspaces( m_fileName, m_list, errorInfo, true );
+      }
+
+    m_msecs = t.elapsed();
+  };
+
+  QString m_fileName;
+  QString m_key;
+  QDateTime m_stamp;
+  bool m_compiled;
+  bool m_ok;
+  int m_msecs;
+  QList<Airspace*> m_list;
+};
+
+QString AirspaceHelper::setKey( const QString& fileName )
+{
+  // A compiled file belongs to the set of its source file.
+  if( fileName.endsWith( ".txc" ) )
+    {
+      return fileName.left( fileName.size() - 3 ) + "txt";
+    }
+
+  if( fileName.endsWith( ".aic" ) )
+    {
+      return fileName.left( fileName.size() - 3 ) + "aip";
+    }
+
+  return fileName;
+}
+
+QDateTime AirspaceHelper::fileStamp( const QString& key )
+{
+  QFileInfo fi( key );
+
+  if( fi.exists() == false )
+    {
+      // Only the compiled file is available.
+      fi.setFile( key.left( key.size() - 1 ) + "c" );
+    }
+
+  QDateTime stamp = fi.lastModified();
+
+  // The mapping files are applied during parsing.
+  QFileInfo fiConf1( fi.path() + "/airspace_mappings.conf" );
+  QFileInfo fiConf2( fi.path() + "/" + fi.baseName() + "_mappings.conf" );
+
+  if( fiConf1.exists() && stamp < fiConf1.lastModified() )
+    {
+      stamp = fiConf1.lastModified();
+    }
+
+  if( fiConf2.exists() && stamp < fiConf2.lastModified() )
+    {
+      stamp = fiConf2.lastModified();
+    }
+
+  return stamp;
+}
+
+int AirspaceHelper::loadAirspaceSets( LoadResult& result,
+                                      const QMap<QString, QDateTime>& keep,
+                                      bool readSource,
+                                      QList<FileStatistic>* statistics )
 {
   // Set a global lock during execution to avoid calls in parallel.
   QMutexLocker locker( &m_mutex );
   QTime t; t.start();
   uint loadCounter = 0; // number of successfully loaded files
+  uint keptCounter = 0; // number of unchanged and not loaded files
 
   m_airspaceDictionary.clear();
 
@@ -116,25 +222,55 @@ int AirspaceHelper::loadAirspaces( QList<Airspace*>& list, bool readSource )
         }
     }
 
-  OpenAirParser oap;
-  OpenAip oaip;
-  QString errorInfo;
+  // The type mapping is loaded and the locale is set before the parsers
+  // are started in parallel. Changing the default locale is not thread
+  // safe.
+  if( m_airspaceTypeMap.isEmpty() )
+    {
+      loadAirspaceTypeMapping();
+    }
+
+  QLocale::setDefault(QLocale::C);
+
+  // The files are examined one after another, the reading is done later by
+  // the load jobs in parallel.
+  QList<AirspaceLoadJob*> jobs;
 
   while( ! preselect.isEmpty() )
     {
       QString srcName;
       QString binName;
 
+      const QString key = setKey( preselect.first() );
+
+      if( result.keys.contains( key ) == false )
+        {
+          result.keys.append( key );
+        }
+
+      if( keep.contains( key ) && keep.value( key ) == fileStamp( key ) )
+        {
+          // The set is already loaded and its files are unchanged. The
+          // compiled file is followed by its source file.
+          preselect.removeAt(0);
+
+          if( ! preselect.isEmpty() && preselect.first() == key )
+            {
+              preselect.removeAt(0);
+            }
+
+          loadCounter++;
+          keptCounter++;
+          continue;
+        }
+
       if( preselect.first().endsWith(QString(".txt")) )
         {
           // there can't be the same name txc after this txt
           // parse found txt file
           srcName = preselect.first();
 
-          if( oap.parse(srcName, list, true) )
-            {
-              loadCounter++;
-            }
+          jobs.append( new AirspaceLoadJob( srcName, false ) );
 
           preselect.removeAt(0);
           continue;
@@ -146,10 +282,7 @@ int AirspaceHelper::loadAirspaces( QList<Airspace*>& list, bool readSource )
           // parse found aip file
           srcName = preselect.first();
 
-          if( oaip.readAirspaces(srcName, list, errorInfo, true) )
-            {
-              loadCounter++;
-            }
+          jobs.append( new AirspaceLoadJob( srcName, false ) );
 
           preselect.removeAt(0);
           continue;
@@ -189,7 +322,7 @@ int AirspaceHelper::loadAirspaces( QList<Airspace*>& list, bool readSource )
       preselect.removeAt(0);
       QFileInfo binFi(binName);
 
-      if( srcName == preselect.first() )
+      if( ! preselect.isEmpty() && srcName == preselect.first() )
         {
           preselect.removeAt(0);
           // We found the related source file and will do some checks to
@@ -204,20 +337,7 @@ int AirspaceHelper::loadAirspaces( QList<Airspace*>& list, bool readSource )
               // wrong file and start a reparsing of source file.
               QFile::remove(binName);
 
-              if (srcSuffix == "txt")
-                {
-                  if (oap.parse(srcName, list, true))
-                    {
-                      loadCounter++;
-                    }
-                }
-              else if (srcSuffix == "aip")
-                {
-                  if (oaip.readAirspaces(srcName, list, errorInfo, true))
-                    {
-                      loadCounter++;
-                    }
-                }
+              jobs.append( new AirspaceLoadJob( srcName, false ) );
 
               continue;
             }
@@ -236,20 +356,7 @@ int AirspaceHelper::loadAirspaces( QList<Airspace*>& list, bool readSource )
           // source file.
           QFile::remove(binName);
 
-          if (srcSuffix == "txt")
-            {
-              if (oap.parse(srcName, list, true))
-                {
-                  loadCounter++;
-                }
-            }
-          else if (srcSuffix == "aip")
-            {
-              if (oaip.readAirspaces(srcName, list, errorInfo, true))
-                {
-                  loadCounter++;
-                }
-            }
+          jobs.append( new AirspaceLoadJob( srcName, false ) );
 
           continue;
         }
@@ -271,20 +378,7 @@ int AirspaceHelper::loadAirspaces( QList<Airspace*>& list, bool readSource )
           // every minute.
           QFile::remove(binName);
 
-          if (srcSuffix == "txt")
-            {
-              if (oap.parse(srcName, list, true))
-                {
-                  loadCounter++;
-                }
-            }
-          else if (srcSuffix == "aip")
-            {
-              if (oaip.readAirspaces(srcName, list, errorInfo, true))
-                {
-                  loadCounter++;
-                }
-            }
+          jobs.append( new AirspaceLoadJob( srcName, false ) );
 
           continue;
         }
@@ -303,39 +397,86 @@ int AirspaceHelper::loadAirspaces( QList<Airspace*>& list, bool readSource )
 
           QFile::remove(binName);
 
-          if (srcSuffix == "txt")
-            {
-              if (oap.parse(srcName, list, true))
-                {
-                  loadCounter++;
-                }
-            }
-          else if (srcSuffix == "aip")
-            {
-              if (oaip.readAirspaces(srcName, list, errorInfo, true))
-                {
-                  loadCounter++;
-                }
-            }
+          jobs.append( new AirspaceLoadJob( srcName, false ) );
 
           continue;
         }
 
       // We will read the compiled file, because a source file is not to
       // find after it or all checks were successfully passed
-      if (AirspaceHelper::readCompiledFile( binName, list ) )
+      jobs.append( new AirspaceLoadJob( binName, true ) );
+    } // End of While
+
+  // Every file is parsed or read in its own thread. A private pool is used,
+  // so that the waiting is not delayed by other jobs.
+  QThreadPool pool;
+  pool.setMaxThreadCount( qMax( 1, QThread::idealThreadCount() ) );
+
+  for( int i = 0; i < jobs.size(); i++ )
+    {
+      pool.start( jobs.at(i) );
+    }
+
+  pool.waitForDone();
+
+  // Every file gives its own set, in the order of the files. Airspaces
+  // with an already known identifier are skipped.
+  for( int i = 0; i < jobs.size(); i++ )
+    {
+      AirspaceLoadJob* job = jobs.at(i);
+      int added = 0;
+
+      AirspaceSet set;
+      set.key   = job->m_key;
+      set.stamp = job->m_stamp;
+
+      for( int j = 0; j < job->m_list.size(); j++ )
+        {
+          Airspace* as = job->m_list.at(j);
+
+          if( as->getId() >= 0 && addAirspaceIdentifier( as->getId() ) == false )
+            {
+              // Airspace is already known. Ignore object.
+              qDebug() << "ASH: Known Airspace" << as->getName() << "ignored!";
+              delete as;
+              set.skipped++;
+              continue;
+            }
+
+          set.airspaces.append( as );
+          added++;
+        }
+
+      result.sets.append( set );
+
+      if( job->m_ok )
         {
           loadCounter++;
         }
-    } // End of While
 
-  qDebug("ASH: %d Airspace file(s) loaded in %dms", loadCounter, t.elapsed());
+      qDebug( "ASH: %s: %d airspaces %s in %dms",
+              QFileInfo( job->m_fileName ).fileName().toLatin1().data(),
+              added,
+              job->m_compiled ? "read" : "parsed",
+              job->m_msecs );
 
-//    for(int i=0; i < list.size(); i++ )
-//      {
-//        list.at(i)->debug();
-//      }
+      if( statistics )
+        {
+          FileStatistic fs;
+          fs.fileName = job->m_fileName;
+          fs.airspaces = added;
+          fs.msecs = job->m_msecs;
+          fs.ok = job->m_ok;
+          statistics->append( fs );
+        }
+
+      delete job;
+    }
 
+  qDebug("ASH: %d Airspace file(s) loaded in %dms, %d file(s) kept",
+         loadCounter, t.elapsed(), keptCounter );
+
+  result.loadedFiles = loadCounter;
   return loadCounter;
 }
 
@@ -348,69 +489,67 @@ bool AirspaceHelper::createCompiledFile( QString& fileName,
       return false;
     }
 
-  QFile file( fileName );
-  QDataStream out( &file );
-
-  out.setVersion( QDataStream::Qt_4_7 );
+  OpenAipCompiler compiler;
 
-  if( file.open(QIODevice::WriteOnly) == false )
+  if( compiler.open( fileName, OpenAipCompiler::Airspaces ) == false )
     {
-      qWarning( "ASH: Can't open airspace file %s for writing!"
-                " Aborting ...",
-                fileName.toLatin1().data() );
-
       return false;
     }
 
+  // Storing starts at the given index.
+  for( int i = airspaceListStart; i < airspaceList.size(); i++ )
+    {
+      compiler.write( *airspaceList[i] );
+    }
+
+  return compiler.close();
+}
+
+void AirspaceHelper::writeCompiledHeader( QDataStream& out )
+{
+  out.setVersion( QDataStream::Qt_4_7 );
+
   // create compiled binary version
   out << quint32( KFLOG_FILE_MAGIC );
   out << qint8( FILE_TYPE_AIRSPACE_C );
   out << quint16( FILE_VERSION_AIRSPACE_C );
   out << QDateTime::currentDateTime();
   SaveProjection( out, _globalMapMatrix->getProjection() );
+}
 
-  // write number of airspace records to be stored
-  out << quint32( airspaceList.size() - airspaceListStart );
+void AirspaceHelper::writeCompiledRecord( QDataStream& out, Airspace& as )
+{
+  QByteArray country( 2, '\0' );
 
-  // Storing starts at the given index.
-  for( int i = airspaceListStart; i < airspaceList.size(); i++ )
+  if( as.getCountry().left(2).size() == 2 )
     {
-      Airspace* as = airspaceList[i];
-
-      const char* country = "\0\0";
-
-      if( as->getCountry().left(2).size() == 2 )
-        {
-          country = as->getCountry().left(2).toLatin1().data();
-        }
+      country = as.getCountry().left(2).toLatin1();
+    }
 
-      // Normalize Flight Level altitudes to its original value before storing.
-      float uAlt = as->getUpperAltitude().getFeet();
-      float lAlt = as->getLowerAltitude().getFeet();
+  // Normalize Flight Level altitudes to its original value before storing.
+  float uAlt = as.getUpperAltitude().getFeet();
+  float lAlt = as.getLowerAltitude().getFeet();
 
-      if( as->getUpperT() == Airspace::FL )
-        {
-          uAlt /= 100;
-        }
-
-      if( as->getLowerT() == Airspace::FL )
-        {
-          lAlt /= 100;
-        }
+  if( as.getUpperT() == Airspace::FL )
+    {
+      uAlt /= 100;
+    }
 
-      ShortSave( out, as->getName().toUtf8() );
-      out.writeRawData( country, 2 );
-      out << qint32( as->getId() );
-      out << quint8( as->getTypeID() );
-      out << quint8( as->getLowerT() );
-      out << float( lAlt );
-      out << quint8( as->getUpperT() );
-      out << float( uAlt );
-      ShortSave( out, as->getProjectedPolygon() );
+  if( as.getLowerT() == Airspace::FL )
+    {
+      lAlt /= 100;
     }
 
-  file.close();
-  return true;
+  ShortSave( out, as.getName().toUtf8() );
+  out.writeRawData( country.constData(), 2 );
+  out << qint32( as.getId() );
+  out << quint8( as.getTypeID() );
+  out << quint8( as.getLowerT() );
+  out << float( lAlt );
+  out << quint8( as.getUpperT() );
+  out << float( uAlt );
+  ShortSave( out, as.getProjectedPolygon() );
+  ShortSave( out, as.getWgsPolygon() );
 }
 
 /**
@@ -508,12 +647,14 @@ bool AirspaceHelper::readCompiledFile( QString &path, QList<Airspace*>& list )
   quint8 upperType;
   float upper;
   QPolygon pa;
+  QPolygon wgsPa;
   QByteArray utf8_temp;
   char country[3] = { 0, 0, 0 };
 
   while ( ! in.atEnd() )
     {
       pa.resize(0);
+      wgsPa.resize(0);
 
       ShortLoad(in, utf8_temp);
       name = QString::fromUtf8(utf8_temp);
@@ -525,13 +666,7 @@ bool AirspaceHelper::readCompiledFile( QString &path, QList<Airspace*>& list )
       in >> upperType;
       in >> upper;
       ShortLoad( in, pa );
-
-      if( id >= 0 && addAirspaceIdentifier(id) == false )
-        {
-          // Airspace is already known. Ignore object.
-          qDebug() << "ASH::readCompiledFile: Known Airspace" << name << "ignored!";
-          continue;
-        }
+      ShortLoad( in, wgsPa );
 
       Airspace *a = new Airspace( name,
                                   (BaseMapElement::objectType) type,
@@ -540,6 +675,7 @@ bool AirspaceHelper::readCompiledFile( QString &path, QList<Airspace*>& list )
                                   lower, (BaseMapElement::elevationType) lowerType,
                                   id,
                                   QString(country) );
+      a->setWgsPolygon( wgsPa );
       list.append(a);
       counter++;
     }
@@ -780,8 +916,11 @@ AirspaceHelper::initializeAirspaceTypeMapping(const QString& mapFilePath)
 
 #include <csignal>
 
-AirspaceHelperThread::AirspaceHelperThread( QObject *parent, bool readSource ) :
+AirspaceHelperThread::AirspaceHelperThread( QObject *parent,
+                                            const QMap<QString, QDateTime>& keep,
+                                            bool readSource ) :
   QThread( parent ),
+  m_keep(keep),
   m_readSource(readSource)
 {
   setObjectName( "AirspaceHelperThread" );
@@ -804,19 +943,28 @@ void AirspaceHelperThread::run()
   pthread_sigmask( SIG_SETMASK, &sigset, 0 );
 
   // Check is signal is connected to a slot.
-  if( receivers( SIGNAL( loadedList( int, SortableAirspaceList* )) ) == 0 )
+  if( receivers( SIGNAL( loadedSets( AirspaceHelper::LoadResult* )) ) == 0 )
     {
-      qWarning() << "AirspaceHelperThread: No Slot connection to Signal loadedList!";
+      qWarning() << "AirspaceHelperThread: No Slot connection to Signal loadedSets!";
       return;
     }
 
-  SortableAirspaceList* airspaceList = new SortableAirspaceList;
+  AirspaceHelper::LoadResult* result = new AirspaceHelper::LoadResult;
 
-  int ok = AirspaceHelper::loadAirspaces( *airspaceList, m_readSource );
+  QList<AirspaceHelper::FileStatistic> statistics;
+
+  AirspaceHelper::loadAirspaceSets( *result, m_keep, m_readSource, &statistics );
+
+  for( int i = 0; i < statistics.size(); i++ )
+    {
+      emit loadedFile( statistics.at(i).fileName,
+                       statistics.at(i).airspaces,
+                       statistics.at(i).msecs );
+    }
 
   /* It is expected that a receiver slot is connected to this signal. The
-   * receiver is responsible to delete the passed lists. Otherwise a big
+   * receiver is responsible to delete the passed result. Otherwise a big
    * memory leak will occur.
    */
-  emit loadedList( ok, airspaceList );
+  emit loadedSets( result );
 }
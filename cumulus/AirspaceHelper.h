@@ -40,12 +40,14 @@
 #ifndef AIRSPACE_HELPER_H
 #define AIRSPACE_HELPER_H
 
+#include <QDataStream>
 #include <QDateTime>
 #include <QList>
 #include <QMap>
 #include <QMutex>
 #include <QSet>
 #include <QString>
+#include <QStringList>
 
 #include "airspace.h"
 #include "basemapelement.h"
@@ -70,19 +72,116 @@ class AirspaceHelper
   {
   };
 
+  /**
+   * Load result of one airspace file.
+   */
+  class FileStatistic
+  {
+   public:
+
+    FileStatistic() : airspaces(0), msecs(0), ok(false) {};
+
+    /** Full name with path of the read file */
+    QString fileName;
+
+    /** Number of airspaces taken over from the file */
+    int airspaces;
+
+    /** Time in milli seconds used for parsing or reading the file */
+    int msecs;
+
+    /** True, if the file was read successfully */
+    bool ok;
+  };
+
+  /**
+   * Airspaces of one airspace file.
+   */
+  class AirspaceSet
+  {
+   public:
+
+    AirspaceSet() : generation(0), skipped(0) {};
+
+    /**
+     * Full name with path of the source file, also if only the compiled
+     * version of it exists. It identifies the set.
+     */
+    QString key;
+
+    /** Modification time of the file content, see \ref fileStamp. */
+    QDateTime stamp;
+
+    /** Load generation, in which the set was taken over. */
+    uint generation;
+
+    /** Number of airspaces, which are skipped as duplicates. */
+    int skipped;
+
+    QList<Airspace*> airspaces;
+  };
+
+  /**
+   * Result of an airspace load.
+   */
+  class LoadResult
+  {
+   public:
+
+    LoadResult() : loadedFiles(0) {};
+
+    /** Keys of all airspace sets, which shall be used, in file order. */
+    QStringList keys;
+
+    /** The new loaded airspace sets. */
+    QList<AirspaceSet> sets;
+
+    /** Number of successfully loaded and of kept files. */
+    int loadedFiles;
+  };
+
   /**
    * Searches on default places for OpenAir and OpenAip airspace files.
-   * That can be source files or compiled versions of them.
+   * That can be source files or compiled versions of them. The files are
+   * parsed or read in parallel by a thread pool, every file into its own
+   * airspace set.
+   *
+   * Files, whose sets are passed in keep with an unchanged stamp, are not
+   * loaded again. Their keys are reported in the result only. Duplicates
+   * of airspaces in the kept sets are removed from the new sets later by
+   * MapContents::takeOverAirspaceSets and counted as skipped there.
+   *
+   * @returns The number of successfully loaded and kept files
+   *
+   * @param result The keys of the wanted sets and the new loaded sets.
    *
-   * @returns The number of successfully loaded files
+   * @param keep Keys and stamps of the already loaded airspace sets.
    *
-   * @param list The list where the Airspace objects should be added from the
-   *        read files.
    * @param readSource If true the source files have to be read instead of
    *         compiled sources.
    *
+   * @param statistics If set, the load result of every loaded file is
+   *        appended.
+   */
+  static int loadAirspaceSets( LoadResult& result,
+                               const QMap<QString, QDateTime>& keep,
+                               bool readSource=false,
+                               QList<FileStatistic>* statistics=0 );
+
+  /**
+   * Returns the key of the airspace set, to which the passed source or
+   * compiled airspace file belongs.
+   */
+  static QString setKey( const QString& fileName );
+
+  /**
+   * Returns the modification time of the content of an airspace set. That
+   * is the newest time of the source file, or of the compiled file if no
+   * source exists, and of its mapping configuration files.
+   *
+   * \param key Key of the airspace set
    */
-  static int loadAirspaces( QList<Airspace*>& list, bool readSource=false );
+  static QDateTime fileStamp( const QString& key );
 
   /**
    * Read the content of a compiled file and put it into the passed
@@ -110,6 +209,23 @@ class AirspaceHelper
                                   QList<Airspace*>& airspaceList,
                                   int airspaceListStart );
 
+  /**
+   * Writes the header of a compiled airspace file. The number of records
+   * must follow it.
+   *
+   * \param out Data stream to the compiled file
+   */
+  static void writeCompiledHeader( QDataStream& out );
+
+  /**
+   * Writes one airspace record of a compiled airspace file.
+   *
+   * \param out Data stream to the compiled file
+   *
+   * \param as Airspace to be written
+   */
+  static void writeCompiledRecord( QDataStream& out, Airspace& as );
+
   /**
    * Get the header data of a compiled file and put it in the class
    * variables.
@@ -232,7 +348,7 @@ class AirspaceHelper
 *
 * This class can read and parse openAIP airspace data files and store
 * their content in a binary format. All work is done in an extra thread.
-* The results are returned via the signal \ref loadedList.
+* The results are returned via the signal \ref loadedSets.
 *
 * \date 2014
 *
@@ -245,7 +361,13 @@ class AirspaceHelperThread : public QThread
 
  public:
 
-  AirspaceHelperThread( QObject *parent=0, bool readSource=false );
+  /**
+   * \param keep Keys and stamps of the already loaded airspace sets, see
+   *             \ref AirspaceHelper::loadAirspaceSets.
+   */
+  AirspaceHelperThread( QObject *parent=0,
+                        const QMap<QString, QDateTime>& keep=QMap<QString, QDateTime>(),
+                        bool readSource=false );
 
   virtual ~AirspaceHelperThread();
 
@@ -259,17 +381,28 @@ class AirspaceHelperThread : public QThread
  signals:
 
   /**
-  * This signal emits the results of the OpenAIP load. The receiver slot is
-  * responsible to delete the dynamic allocated list in every case.
+  * This signal emits the results of the airspace load. The receiver slot is
+  * responsible to delete the dynamic allocated result in every case.
   *
-  * \param loadedLists     The number of loaded lists
-  * \param airspaceList    The list with the airspace data
+  * \param result The wanted and the new loaded airspace sets
   *
   */
-  void loadedList( int loadedLists, SortableAirspaceList* airspaceList );
+  void loadedSets( AirspaceHelper::LoadResult* result );
+
+  /**
+  * This signal is emitted for every loaded file before \ref loadedSets.
+  *
+  * \param fileName  Full name with path of the file
+  * \param airspaces Number of airspaces taken over from the file
+  * \param msecs     Time in milli seconds used for the file
+  *
+  */
+  void loadedFile( const QString& fileName, int airspaces, int msecs );
 
  private:
 
+  QMap<QString, QDateTime> m_keep;
+
   bool m_readSource;
 };
 
@@ -21,6 +21,7 @@
 #include "mapcalc.h"
 #include "mapmatrix.h"
 #include "OpenAip.h"
+#include "OpenAipCompiler.h"
 
 extern MapMatrix* _globalMapMatrix;
 
@@ -48,6 +49,18 @@ void OpenAip::loadUserFilterValues()
   m_filterRunwayLength = GeneralConfig::instance()->getAirfieldRunwayLengthFilter();
 }
 
+const QString& OpenAip::intern( const QString& value )
+{
+  QHash<QString, QString>::iterator it = m_stringPool.find( value );
+
+  if( it == m_stringPool.end() )
+    {
+      it = m_stringPool.insert( value, value );
+    }
+
+  return it.value();
+}
+
 void OpenAip::fillRunwaySurfaceMapper()
 {
   m_runwaySurfaceMapper.insert( "UNKN", Runway::Unknown );
@@ -191,7 +204,8 @@ bool OpenAip::readVersionAndFormat( QXmlStreamReader& xml,
 bool OpenAip::readNavAids( QString fileName,
                            QList<RadioPoint>& navAidList,
                            QString& errorInfo,
-                           bool useFiltering )
+                           bool useFiltering,
+                           OpenAipCompiler* compiler )
 {
   if( useFiltering )
     {
@@ -291,7 +305,15 @@ bool OpenAip::readNavAids( QString fileName,
                     }
                 }
 
-              navAidList.append( rp );
+              if( compiler )
+                {
+                  compiler->write( rp );
+                }
+
+              if( compiler == 0 || compiler->keepRecords() )
+                {
+                  navAidList.append( rp );
+                }
             }
 
           continue;
@@ -379,7 +401,7 @@ bool OpenAip::readNavAidRecord( QXmlStreamReader& xml, RadioPoint& rp )
 
           if( elementName == "COUNTRY" )
             {
-              rp.setCountry( xml.readElementText().left(2).toUpper() );
+              rp.setCountry( intern( xml.readElementText().left(2).toUpper() ) );
             }
           else if ( elementName == "NAME" )
             {
@@ -633,7 +655,8 @@ bool OpenAip::readParams( QXmlStreamReader& xml, RadioPoint& rp )
 bool OpenAip::readHotspots( QString fileName,
                             QList<SinglePoint>& hotspotList,
                             QString& errorInfo,
-                            bool useFiltering )
+                            bool useFiltering,
+                            OpenAipCompiler* compiler )
 {
   QFile file( fileName );
 
@@ -780,6 +803,21 @@ bool OpenAip::readHotspots( QString fileName,
           int idx = sp.getWPName().toInt();
           sp.setWPName( "H" + sp.getCountry() + QString("%1").arg(idx, fill, 10, QChar('0')));
         }
+
+      // The short names depend on the number of hotspots. Therefore the
+      // hotspots can be compiled only at the end.
+      if( compiler )
+        {
+          for( int i = startIdx; i < hotspotList.size(); i++ )
+            {
+              compiler->write( hotspotList[i] );
+            }
+
+          if( compiler->keepRecords() == false )
+            {
+              hotspotList.erase( hotspotList.begin() + startIdx, hotspotList.end() );
+            }
+        }
     }
 
   file.close();
@@ -809,7 +847,7 @@ bool OpenAip::readHotspotRecord( QXmlStreamReader& xml, SinglePoint& sp )
 
           if( elementName == "COUNTRY" )
             {
-              sp.setCountry( xml.readElementText().left(2).toUpper() );
+              sp.setCountry( intern( xml.readElementText().left(2).toUpper() ) );
             }
           else if ( elementName == "NAME" )
             {
@@ -840,7 +878,8 @@ bool OpenAip::readHotspotRecord( QXmlStreamReader& xml, SinglePoint& sp )
 bool OpenAip::readAirfields( QString fileName,
                              QList<Airfield>& airfieldList,
                              QString& errorInfo,
-                             bool useFiltering )
+                             bool useFiltering,
+                             OpenAipCompiler* compiler )
 {
   if( useFiltering )
     {
@@ -990,7 +1029,15 @@ bool OpenAip::readAirfields( QString fileName,
               // Short name is only 8 characters long and must be unique
               af.setWPName( shortName(af.getName()) );
 
-              airfieldList.append( af );
+              if( compiler )
+                {
+                  compiler->write( af );
+                }
+
+              if( compiler == 0 || compiler->keepRecords() )
+                {
+                  airfieldList.append( af );
+                }
             }
 
           continue;
@@ -1116,7 +1163,7 @@ bool OpenAip::readAirfieldRecord( QXmlStreamReader& xml, Airfield& af )
 
           if( elementName == "COUNTRY" )
             {
-              af.setCountry( xml.readElementText().left(2).toUpper() );
+              af.setCountry( intern( xml.readElementText().left(2).toUpper() ) );
             }
           else if ( elementName == "NAME" )
             {
@@ -1226,7 +1273,7 @@ bool OpenAip::readAirfieldRadio( QXmlStreamReader& xml, Airfield& af )
             }
           else if ( elementName == "TYPE" )
             {
-              type = xml.readElementText();
+              type = intern( xml.readElementText() );
             }
           else if ( elementName == "DESCRIPTION" )
             {
@@ -1519,12 +1566,12 @@ QString OpenAip::shortName( const QString& name )
 bool OpenAip::readAirspaces( QString fileName,
                              QList<Airspace*>& airspaceList,
                              QString& errorInfo,
-                             bool doCompile )
+                             bool doCompile,
+                             OpenAipCompiler* compiler )
 {
   const char* method = "OpenAip::readAirspaces:";
 
   QFileInfo fi(fileName);
-  int listStartIdx = airspaceList.size();
 
   if( fi.suffix().toLower() != "aip" )
     {
@@ -1559,6 +1606,22 @@ bool OpenAip::readAirspaces( QString fileName,
       return false;
     }
 
+  // The compiled file is written during parsing. It is only taken over, if
+  // the whole file could be read.
+  OpenAipCompiler ownCompiler;
+
+  if( compiler == 0 && doCompile )
+    {
+      // Build the compiled file name with the extension .aic from
+      // the source file name
+      QString cfn = fi.path() + "/" + fi.completeBaseName() + ".aic";
+
+      if( ownCompiler.open( cfn, OpenAipCompiler::Airspaces ) )
+        {
+          compiler = &ownCompiler;
+        }
+    }
+
   QXmlStreamReader xml( &file );
 
   int elementCounter   = 0;
@@ -1631,17 +1694,21 @@ bool OpenAip::readAirspaces( QString fileName,
                       continue;
                     }
 
-                  if( AirspaceHelper::addAirspaceIdentifier(as.getId()) )
+                  // Duplicates of other files are removed by the caller.
+                  Airspace* elem = as.createAirspaceObject();
+
+                  if( compiler )
+                    {
+                      compiler->write( *elem );
+                    }
+
+                  if( compiler == 0 || compiler->keepRecords() )
                     {
-                      Airspace* elem = as.createAirspaceObject();
                       airspaceList.append( elem );
                     }
                   else
                     {
-                      // Airspace is already known. Ignore object.
-                      qDebug() << "QIAP:: Known Airspace"
-                               << as.getName()
-                               << "ignored!";
+                      delete elem;
                     }
                 }
             }
@@ -1670,13 +1737,9 @@ bool OpenAip::readAirspaces( QString fileName,
 
   file.close();
 
-  if( doCompile )
+  if( compiler == &ownCompiler )
     {
-      // Build the compiled file name with the extension .aic from
-      // the source file name
-       QString cfn = fi.path() + "/" + fi.completeBaseName() + ".aic";
-
-       AirspaceHelper::createCompiledFile( cfn, airspaceList, listStartIdx );
+      ownCompiler.close();
     }
 
   return true;
@@ -1769,7 +1832,7 @@ bool OpenAip::readAirspaceRecord( QXmlStreamReader& xml, Airspace& as )
             }
           else if( elementName == "COUNTRY" )
             {
-              as.setCountry( xml.readElementText().left(2).toUpper() );
+              as.setCountry( intern( xml.readElementText().left(2).toUpper() ) );
             }
           else if ( elementName == "NAME" )
             {
@@ -1968,6 +2031,7 @@ bool OpenAip::readAirspaceGeometrie( QXmlStreamReader& xml, Airspace& as )
     }
 
   QPolygon asPolygon( polygonList.size() / 2 );
+  QPolygon wgsPolygon( polygonList.size() / 2 );
   extern MapMatrix* _globalMapMatrix;
 
   for( int i = 0; i < polygonList.size(); i += 2 )
@@ -2008,6 +2072,7 @@ bool OpenAip::readAirspaceGeometrie( QXmlStreamReader& xml, Airspace& as )
 
       // Project coordinates to map datum and store them in a polygon
       asPolygon.setPoint( i/2, _globalMapMatrix->wgsToMap( latInt, lonInt ) );
+      wgsPolygon.setPoint( i/2, latInt, lonInt );
     }
 
   if( asPolygon.count() < 2 )
@@ -2024,8 +2089,10 @@ bool OpenAip::readAirspaceGeometrie( QXmlStreamReader& xml, Airspace& as )
     {
       // remove the last point because it is identical to the first point
       asPolygon.remove(asPolygon.count()-1);
+      wgsPolygon.remove(wgsPolygon.count()-1);
     }
 
   as.setProjectedPolygon( asPolygon );
+  as.setWgsPolygon( wgsPolygon );
   return true;
 }
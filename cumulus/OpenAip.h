@@ -45,6 +45,8 @@
 #include "altitude.h"
 #include "radiopoint.h"
 
+class OpenAipCompiler;
+
 class OpenAip
 {
  public:
@@ -77,12 +79,16 @@ class OpenAip
    *
    * \param useFiltering If enabled, different filter rules will apply
    *
+   * \param compiler If passed, the read data are written into its compiled
+   *                 file during parsing
+   *
    * \return true as success otherwise false
    */
   bool readNavAids( QString fileName,
                     QList<RadioPoint>& navAidList,
                     QString& errorInfo,
-                    bool useFiltering=false );
+                    bool useFiltering=false,
+                    OpenAipCompiler* compiler=0 );
 
   /**
    * Reads in a hotspot file provided as openAIP xml format.
@@ -95,12 +101,16 @@ class OpenAip
    *
    * \param useFiltering If enabled, different filter rules will apply
    *
+   * \param compiler If passed, the read data are written into its compiled
+   *                 file during parsing
+   *
    * \return true as success otherwise false
    */
   bool readHotspots( QString fileName,
                      QList<SinglePoint>& hotspotList,
                      QString& errorInfo,
-	             bool useFiltering=false );
+	             bool useFiltering=false,
+	             OpenAipCompiler* compiler=0 );
 
   /**
    * Reads in an airfield file provided as openAIP xml format.
@@ -113,11 +123,15 @@ class OpenAip
    *
    * \param useFiltering If enabled, different filter rules will apply
    *
+   * \param compiler If passed, the read data are written into its compiled
+   *                 file during parsing
+   *
    * \return true as success otherwise false
    */
   bool readAirfields( QString fileName, QList<Airfield>& airfieldList,
                       QString& errorInfo,
-                      bool useFiltering=false );
+                      bool useFiltering=false,
+                      OpenAipCompiler* compiler=0 );
 
   /**
    * Reads in an airspace file provided as openAIP xml format.
@@ -130,11 +144,15 @@ class OpenAip
    *
    * \param doCompile If enabled, create a compiled file version
    *
+   * \param compiler If passed, the read data are written into its compiled
+   *                 file instead of a compiled file of its own
+   *
    * \return true on success otherwise false
    */
   bool readAirspaces( QString fileName, QList<Airspace*>& airspaceList,
                       QString& errorInfo,
-                      bool doCompile=true );
+                      bool doCompile=true,
+                      OpenAipCompiler* compiler=0 );
 
   /**
    * Upper and lower the words in the passed string.
@@ -229,6 +247,12 @@ class OpenAip
    */
   bool getUnitValueAsFloat( const QString number, const QString unit, float& result );
 
+  /**
+   * Returns a shared instance of the passed string. Repeated values like
+   * country codes and frequency types are stored only once in memory.
+   */
+  const QString& intern( const QString& value );
+
   /**
    * Loads the user's defined filter values from the configuration data.
    */
@@ -283,6 +307,9 @@ class OpenAip
 
   /** Contains all short names of parsed file. */
   QSet<QString> m_shortNameSet;
+
+  /** Pool of the interned strings. */
+  QHash<QString, QString> m_stringPool;
 };
 
 #endif /* OpenAip_h */
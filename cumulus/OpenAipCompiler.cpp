@@ -0,0 +1,267 @@
+/***********************************************************************
+**
+**   OpenAipCompiler.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <QtCore>
+
+#include "airfield.h"
+#include "airspace.h"
+#include "AirspaceHelper.h"
+#include "OpenAip.h"
+#include "OpenAipCompiler.h"
+#include "OpenAipPoiLoader.h"
+#include "radiopoint.h"
+#include "resource.h"
+#include "singlepoint.h"
+
+OpenAipCompiler::OpenAipCompiler( const bool keepRecords ) :
+  m_kind(Airfields),
+  m_countPos(-1),
+  m_count(0),
+  m_keepRecords(keepRecords)
+{
+}
+
+OpenAipCompiler::~OpenAipCompiler()
+{
+  discard();
+}
+
+bool OpenAipCompiler::open( const QString& fileName, const FileKind kind )
+{
+  discard();
+
+  m_fileName = fileName;
+  m_kind     = kind;
+  m_count    = 0;
+
+  m_file.setFileName( fileName + ".tmp" );
+
+  if( m_file.open( QIODevice::WriteOnly ) == false )
+    {
+      qWarning( "OAIP: Can't open file %s for writing!"
+                " Aborting ...",
+                m_file.fileName().toLatin1().data() );
+
+      return false;
+    }
+
+  m_out.setDevice( &m_file );
+
+  switch( kind )
+    {
+      case Airfields:
+        OpenAipPoiLoader::writeHeaderData( m_out,
+                                           FILE_TYPE_AIRFIELD_OAIP_C,
+                                           FILE_VERSION_AIRFIELD_C );
+        break;
+      case NavAids:
+        OpenAipPoiLoader::writeHeaderData( m_out,
+                                           FILE_TYPE_NAV_AIDS_OAIP_C,
+                                           FILE_VERSION_NAV_AIDS_C );
+        break;
+      case Hotspots:
+        OpenAipPoiLoader::writeHeaderData( m_out,
+                                           FILE_TYPE_HOTSPOTS_OAIP_C,
+                                           FILE_VERSION_HOTSPOT_C );
+        break;
+      case Airspaces:
+        AirspaceHelper::writeCompiledHeader( m_out );
+        break;
+    }
+
+  // The number of records is unknown yet, it is patched in close().
+  m_countPos = m_file.pos();
+  m_out << quint32( 0 );
+
+  return true;
+}
+
+bool OpenAipCompiler::checkKind( const FileKind kind )
+{
+  if( m_file.isOpen() == false || kind != m_kind )
+    {
+      qWarning() << "OpenAipCompiler: record does not match file"
+                 << m_fileName;
+      return false;
+    }
+
+  m_count++;
+  return true;
+}
+
+void OpenAipCompiler::write( Airfield& af )
+{
+  if( checkKind( Airfields ) )
+    {
+      OpenAipPoiLoader::writeRecord( m_out, af );
+    }
+}
+
+void OpenAipCompiler::write( RadioPoint& rp )
+{
+  if( checkKind( NavAids ) )
+    {
+      OpenAipPoiLoader::writeRecord( m_out, rp );
+    }
+}
+
+void OpenAipCompiler::write( SinglePoint& sp )
+{
+  if( checkKind( Hotspots ) )
+    {
+      OpenAipPoiLoader::writeRecord( m_out, sp );
+    }
+}
+
+void OpenAipCompiler::write( Airspace& as )
+{
+  if( checkKind( Airspaces ) )
+    {
+      AirspaceHelper::writeCompiledRecord( m_out, as );
+    }
+}
+
+bool OpenAipCompiler::close()
+{
+  if( m_file.isOpen() == false )
+    {
+      return false;
+    }
+
+  if( m_count == 0 )
+    {
+      // A compiled file without records is not created.
+      discard();
+      return false;
+    }
+
+  m_file.seek( m_countPos );
+  m_out << m_count;
+  m_out.setDevice( 0 );
+  m_file.close();
+
+  if( m_file.error() != QFile::NoError )
+    {
+      qWarning() << "OAIP: Writing of" << m_file.fileName() << "failed!";
+      m_file.remove();
+      return false;
+    }
+
+  QFile::remove( m_fileName );
+
+  if( m_file.rename( m_fileName ) == false )
+    {
+      qWarning() << "OAIP: Cannot rename" << m_file.fileName()
+                 << "to" << m_fileName;
+      m_file.remove();
+      return false;
+    }
+
+  qDebug() << "OAIP: created compiled file" << QFileInfo(m_fileName).fileName()
+           << "with" << m_count << "elements";
+
+  return true;
+}
+
+void OpenAipCompiler::discard()
+{
+  if( m_file.isOpen() == false )
+    {
+      return;
+    }
+
+  m_out.setDevice( 0 );
+  m_file.close();
+  m_file.remove();
+}
+
+bool OpenAipCompiler::compileFile( const QString& aipName, QString& errorInfo )
+{
+  QTime t;
+  t.start();
+
+  QFileInfo fi( aipName );
+
+  if( fi.suffix().toLower() != "aip" )
+    {
+      errorInfo = aipName + " " + QObject::tr("has not suffix .aip!");
+      return false;
+    }
+
+  OpenAip openAip;
+  QString dataFormat;
+  QString dataItem;
+
+  if( openAip.getRootElement( aipName, dataFormat, dataItem ) == false )
+    {
+      errorInfo = QObject::tr("Wrong XML data format");
+      return false;
+    }
+
+  QString aicName = fi.path() + "/" + fi.completeBaseName() + ".aic";
+
+  // The records are written only and not kept in memory.
+  OpenAipCompiler compiler( false );
+  bool ok = false;
+
+  if( dataItem == "WAYPOINTS" )
+    {
+      QList<Airfield> airfieldList;
+
+      ok = compiler.open( aicName, Airfields ) &&
+           openAip.readAirfields( aipName, airfieldList, errorInfo, true, &compiler );
+    }
+  else if( dataItem == "NAVAIDS" )
+    {
+      QList<RadioPoint> navAidList;
+
+      ok = compiler.open( aicName, NavAids ) &&
+           openAip.readNavAids( aipName, navAidList, errorInfo, true, &compiler );
+    }
+  else if( dataItem == "HOTSPOTS" )
+    {
+      QList<SinglePoint> hotspotList;
+
+      ok = compiler.open( aicName, Hotspots ) &&
+           openAip.readHotspots( aipName, hotspotList, errorInfo, true, &compiler );
+    }
+  else if( dataItem == "AIRSPACES" )
+    {
+      QList<Airspace*> airspaceList;
+
+      ok = compiler.open( aicName, Airspaces ) &&
+           openAip.readAirspaces( aipName, airspaceList, errorInfo, true, &compiler );
+    }
+  else
+    {
+      errorInfo = QObject::tr("Unsupported openAIP data item") + " " + dataItem;
+      return false;
+    }
+
+  if( ok == false || compiler.close() == false )
+    {
+      if( errorInfo.isEmpty() )
+        {
+          errorInfo = QObject::tr("Cannot create compiled file") + " " + aicName;
+        }
+
+      return false;
+    }
+
+  qDebug( "OAIP: %s compiled with %u items in %dms",
+          fi.fileName().toLatin1().data(), compiler.count(), t.elapsed() );
+
+  return true;
+}
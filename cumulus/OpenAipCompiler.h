@@ -0,0 +1,153 @@
+/***********************************************************************
+**
+**   OpenAipCompiler.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class OpenAipCompiler
+ *
+ * \author agent
+ *
+ * \brief Single pass writer of compiled openAIP files.
+ *
+ * The readers of \ref OpenAip pass every accepted record to the compiler,
+ * which writes it at once into the compiled file. So the file is created
+ * during parsing and not in a second pass over the read list. The number
+ * of records is patched into the header, when the compiler is closed.
+ *
+ * The compiled file is written under a temporary name and renamed at the
+ * end. An existing compiled file is only replaced, if the whole source file
+ * could be parsed.
+ *
+ * If the compiler is created without keeping the records, the readers do
+ * not store them in their result lists. Then the memory usage does not
+ * depend on the size of the source file. That is used by the headless
+ * batch conversion, see \ref compileFile.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef OpenAip_Compiler_h
+#define OpenAip_Compiler_h
+
+#include <QDataStream>
+#include <QFile>
+#include <QString>
+
+class Airfield;
+class Airspace;
+class RadioPoint;
+class SinglePoint;
+
+class OpenAipCompiler
+{
+ public:
+
+  /**
+   * Kinds of compiled files.
+   */
+  enum FileKind { Airfields, NavAids, Hotspots, Airspaces };
+
+  /**
+   * \param keepRecords If false, the readers do not store the written
+   *                    records in their result lists.
+   */
+  OpenAipCompiler( const bool keepRecords=true );
+
+  /**
+   * An unfinished compiled file is removed.
+   */
+  virtual ~OpenAipCompiler();
+
+  /**
+   * Creates the compiled file and writes its header.
+   *
+   * \param fileName Name of the compiled file
+   *
+   * \param kind Kind of the compiled file
+   *
+   * \return true in case of success otherwise false
+   */
+  bool open( const QString& fileName, const FileKind kind );
+
+  /**
+   * Writes one record into the compiled file. The record type must match
+   * the kind of the opened file.
+   */
+  void write( Airfield& af );
+  void write( RadioPoint& rp );
+  void write( SinglePoint& sp );
+  void write( Airspace& as );
+
+  /**
+   * Patches the record counter into the header and replaces the compiled
+   * file with the new one. A file without records is removed.
+   *
+   * \return true in case of success otherwise false
+   */
+  bool close();
+
+  /**
+   * Removes the unfinished compiled file.
+   */
+  void discard();
+
+  /**
+   * \return True, if the readers shall store the records in their lists.
+   */
+  bool keepRecords() const
+  {
+    return m_keepRecords;
+  };
+
+  /**
+   * \return Number of written records.
+   */
+  quint32 count() const
+  {
+    return m_count;
+  };
+
+  /**
+   * Converts an openAIP source file into its compiled version without
+   * keeping the records in memory. The kind of the data is taken from the
+   * file. The user's filter settings are applied as during loading.
+   *
+   * \param aipName Name of the openAIP source file with the suffix .aip
+   *
+   * \param errorInfo Info about read errors
+   *
+   * \return true in case of success otherwise false
+   */
+  static bool compileFile( const QString& aipName, QString& errorInfo );
+
+ private:
+
+  bool checkKind( const FileKind kind );
+
+  QString     m_fileName;
+  QFile       m_file;
+  QDataStream m_out;
+  FileKind    m_kind;
+
+  /** File position of the record counter. */
+  qint64 m_countPos;
+
+  quint32 m_count;
+
+  bool m_keepRecords;
+};
+
+#endif /* OpenAip_Compiler_h */
@@ -21,6 +21,7 @@
 #include "Frequency.h"
 #include "mapcontents.h"
 #include "OpenAip.h"
+#include "OpenAipCompiler.h"
 #include "OpenAipPoiLoader.h"
 #include "resource.h"
 
@@ -105,7 +106,6 @@ int OpenAipPoiLoader::load( QList<Airfield>& airfieldList, bool readSource )
       QString aicName;
       OpenAip openAip;
       QString errorInfo;
-      int listBegin;
 
       if( preselect.first().endsWith( QString( ".aip" ) ) )
         {
@@ -115,16 +115,23 @@ int OpenAipPoiLoader::load( QList<Airfield>& airfieldList, bool readSource )
           // Remove source file to be read from the list.
           preselect.removeAt(0);
 
-          listBegin = airfieldList.size();
+          // The compiled file is written during parsing.
+          aicName = aipName;
+          aicName.replace( aicName.size() - 1, 1, QChar('c') );
+
+          OpenAipCompiler compiler;
+          OpenAipCompiler* cp = 0;
+
+          if( compiler.open( aicName, OpenAipCompiler::Airfields ) )
+            {
+              cp = &compiler;
+            }
+
+          bool ok = openAip.readAirfields( aipName, airfieldList, errorInfo, true, cp );
 
-          bool ok = openAip.readAirfields( aipName,
-                                           airfieldList,
-                                           errorInfo,
-                                           true );
           if( ok )
             {
-              QString aicName = aipName.replace( aipName.size() - 1, 1 , QChar('c') );
-              createCompiledFile( aicName, airfieldList, listBegin );
+              compiler.close();
               loadCounter++;
             }
 
@@ -290,7 +297,6 @@ int OpenAipPoiLoader::load( QList<RadioPoint>& navAidList, bool readSource )
       QString aicName;
       OpenAip openAip;
       QString errorInfo;
-      int listBegin;
 
       if( preselect.first().endsWith( QString( ".aip" ) ) )
         {
@@ -300,14 +306,23 @@ int OpenAipPoiLoader::load( QList<RadioPoint>& navAidList, bool readSource )
           // Remove source file to be read from the list.
           preselect.removeAt(0);
 
-          listBegin = navAidList.size();
+          // The compiled file is written during parsing.
+          aicName = aipName;
+          aicName.replace( aicName.size() - 1, 1, QChar('c') );
+
+          OpenAipCompiler compiler;
+          OpenAipCompiler* cp = 0;
 
-          bool ok = openAip.readNavAids( aipName, navAidList, errorInfo, true );
+          if( compiler.open( aicName, OpenAipCompiler::NavAids ) )
+            {
+              cp = &compiler;
+            }
+
+          bool ok = openAip.readNavAids( aipName, navAidList, errorInfo, true, cp );
 
           if( ok )
             {
-              QString aicName = aipName.replace( aipName.size() - 1, 1 , QChar('c') );
-              createCompiledFile( aicName, navAidList, listBegin );
+              compiler.close();
               loadCounter++;
             }
 
@@ -463,7 +478,6 @@ int OpenAipPoiLoader::load( QList<SinglePoint>& spList, bool readSource )
       QString aicName;
       OpenAip openAip;
       QString errorInfo;
-      int listBegin;
 
       if( preselect.first().endsWith( QString( ".aip" ) ) )
         {
@@ -473,14 +487,23 @@ int OpenAipPoiLoader::load( QList<SinglePoint>& spList, bool readSource )
           // Remove source file to be read from the list.
           preselect.removeAt(0);
 
-          listBegin = spList.size();
+          // The compiled file is written during parsing.
+          aicName = aipName;
+          aicName.replace( aicName.size() - 1, 1, QChar('c') );
+
+          OpenAipCompiler compiler;
+          OpenAipCompiler* cp = 0;
+
+          if( compiler.open( aicName, OpenAipCompiler::Hotspots ) )
+            {
+              cp = &compiler;
+            }
 
-          bool ok = openAip.readHotspots( aipName, spList, errorInfo, true );
+          bool ok = openAip.readHotspots( aipName, spList, errorInfo, true, cp );
 
           if( ok )
             {
-              QString aicName = aipName.replace( aipName.size() - 1, 1 , QChar('c') );
-              createCompiledFile( aicName, spList, listBegin );
+              compiler.close();
               loadCounter++;
             }
 
@@ -584,108 +607,20 @@ bool OpenAipPoiLoader::createCompiledFile( QString& fileName,
       return false;
     }
 
-  QFile file( fileName );
-  QDataStream out( &file );
-
-  out.setVersion( Q_DATA_STREAM );
+  OpenAipCompiler compiler;
 
-  if( file.open(QIODevice::WriteOnly) == false )
+  if( compiler.open( fileName, OpenAipCompiler::Airfields ) == false )
     {
-      qWarning( "OAIP: Can't open file %s for writing!"
-               " Aborting ...",
-               fileName.toLatin1().data() );
-
       return false;
     }
 
-  float filterRadius = GeneralConfig::instance()->getAirfieldHomeRadius();
-
-  float filterRunwayLength = GeneralConfig::instance()->getAirfieldRunwayLengthFilter();
-
-  qDebug() << "OAIP: creating airfield file" << QFileInfo(fileName).fileName()
-           << "with" << (airfieldList.size() - listBegin) << "elements";
-
-  out << quint32( KFLOG_FILE_MAGIC );
-  out << QByteArray( FILE_TYPE_AIRFIELD_OAIP_C );
-  out << quint8( FILE_VERSION_AIRFIELD_C );
-  out << QDateTime::currentDateTime();
-  out << filterRadius;
-  out << filterRunwayLength;
-  out << QPoint( _globalMapMatrix->getHomeCoord() );
-
-#ifdef BOUNDING_BOX
-  // boundingbox is never used during read in, we don't need to write out it
-  // qDebug("Bounding box is: (%d, %d),(%d, %d)",
-  // boundingBox.left(), boundingBox.top(), boundingBox.right(), boundingBox.bottom());
-  out << boundingBox;
-#endif
-
-  SaveProjection( out, _globalMapMatrix->getProjection() );
-
-  // write number of records to be stored
-  out << quint32( airfieldList.size() - listBegin );
-
   // Storing starts at the given index.
   for( int i = listBegin; i < airfieldList.size(); i++ )
     {
-      Airfield& af = airfieldList[i];
-
-      // element type
-      out << quint8( af.getTypeID() );
-      // element name
-      ShortSave(out, af.getName().toUtf8());
-      // short waypoint name
-      ShortSave(out, af.getWPName().toUtf8());
-      // country
-      ShortSave(out, af.getCountry().toUtf8());
-      // icao
-      ShortSave(out, af.getICAO().toUtf8());
-      // comment
-      ShortSave(out, af.getComment().toUtf8());
-      // WGS84 coordinates
-      out << af.getWGSPosition();
-      // projected WGS84 coordinates
-      out << af.getPosition();
-      // elevation in meters
-      out << af.getElevation();
-
-      // The frequency list is saved.
-      QList<Frequency>& fList = af.getFrequencyList();
-
-      // Number of Frequencies
-      out << quint8( fList.size() );
-
-      for( int i = 0; i < fList.size(); i++ )
-       {
-          Frequency freq = fList.at(i);
-
-          // frequency is written as e.g. 126.575, is reduced to 16 bits
-          out << quint16( rint((freq.getFrequency() - 100.0) * 1000.0 ));
-          // frequency type
-          ShortSave(out, freq.getType().toUtf8());
-       }
-
-      // The runway list is saved
-      QList<Runway>& rwyList = af.getRunwayList();
-
-      // Number of runways
-      out << quint8( rwyList.size() );
-
-      for( int i = 0; i < rwyList.size(); i++ )
-       {
-         Runway rwy = rwyList.at(i);
-
-         out << rwy.m_length;
-         out << rwy.m_width;
-         out << quint16( rwy.m_heading );
-         out << quint8( rwy.m_surface );
-         out << quint8( rwy.m_isOpen );
-         out << quint8( rwy.m_isBidirectional );
-       }
+      compiler.write( airfieldList[i] );
     }
 
-  file.close();
-  return true;
+  return compiler.close();
 }
 
 bool OpenAipPoiLoader::createCompiledFile( QString& fileName,
@@ -697,100 +632,20 @@ bool OpenAipPoiLoader::createCompiledFile( QString& fileName,
       return false;
     }
 
-  QFile file( fileName );
-  QDataStream out( &file );
-
-  out.setVersion( Q_DATA_STREAM );
+  OpenAipCompiler compiler;
 
-  if( file.open(QIODevice::WriteOnly) == false )
+  if( compiler.open( fileName, OpenAipCompiler::NavAids ) == false )
     {
-      qWarning( "OAIP: Can't open file %s for writing!"
-               " Aborting ...",
-               fileName.toLatin1().data() );
-
       return false;
     }
 
-  float filterRadius = GeneralConfig::instance()->getAirfieldHomeRadius();
-
-  // Navaid uses not this filter but to have a unique header, it is considered.
-  float filterRunwayLength = GeneralConfig::instance()->getAirfieldRunwayLengthFilter();
-
-  qDebug() << "OAIP: creating navAid file" << QFileInfo(fileName).fileName()
-           << "with" << (navAidList.size() - listBegin) << "elements";
-
-  out << quint32( KFLOG_FILE_MAGIC );
-  out << QByteArray( FILE_TYPE_NAV_AIDS_OAIP_C );
-  out << quint8( FILE_VERSION_NAV_AIDS_C );
-  out << QDateTime::currentDateTime();
-  out << filterRadius;
-  out << filterRunwayLength;
-  out << QPoint( _globalMapMatrix->getHomeCoord() );
-
-#ifdef BOUNDING_BOX
-  // boundingbox is never used during read in, we don't need to write out it
-  // qDebug("Bounding box is: (%d, %d),(%d, %d)",
-  // boundingBox.left(), boundingBox.top(), boundingBox.right(), boundingBox.bottom());
-  out << boundingBox;
-#endif
-
-  SaveProjection( out, _globalMapMatrix->getProjection() );
-
-  // write number of records to be stored
-  out << quint32( navAidList.size() - listBegin );
-
   // Storing starts at the given index.
   for( int i = listBegin; i < navAidList.size(); i++ )
     {
-      RadioPoint& rp = navAidList[i];
-
-      // element type
-      out << quint8( rp.getTypeID() );
-      // element name
-      ShortSave(out, rp.getName().toUtf8());
-      // short waypoint name
-      ShortSave(out, rp.getWPName().toUtf8());
-      // country
-      ShortSave(out, rp.getCountry().toUtf8());
-      // icao
-      ShortSave(out, rp.getICAO().toUtf8());
-      // comment
-      ShortSave(out, rp.getComment().toUtf8());
-      // WGS84 coordinates
-      out << rp.getWGSPosition();
-      // projected WGS84 coordinates
-      out << rp.getPosition();
-      // elevation in meters
-      out << rp.getElevation();
-
-      // The frequency list is saved.
-      QList<Frequency>& fList = rp.getFrequencyList();
-
-      // Number of Frequencies
-      out << quint8( fList.size() );
-
-      for( int i = 0; i < fList.size (); i++ )
-        {
-          Frequency freq = fList.at (i);
-
-          // frequency is saved as MHz
-          out << freq.getFrequency ();
-          // frequency type
-          ShortSave (out, freq.getType ().toUtf8 ());
-        }
-
-      // Channel info
-      ShortSave(out, rp.getChannel().toUtf8());
-      // Service range as float
-      out << rp.getRange();
-      // Declination
-      out << rp.getDeclination();
-      // Aligned2TrueNorth
-      out << quint8( rp.isAligned2TrueNorth() );
+      compiler.write( navAidList[i] );
     }
 
-  file.close();
-  return true;
+  return compiler.close();
 }
 
 bool OpenAipPoiLoader::createCompiledFile( QString& fileName,
@@ -802,31 +657,37 @@ bool OpenAipPoiLoader::createCompiledFile( QString& fileName,
       return false;
     }
 
-  QFile file( fileName );
-  QDataStream out( &file );
-
-  out.setVersion( Q_DATA_STREAM );
+  OpenAipCompiler compiler;
 
-  if( file.open(QIODevice::WriteOnly) == false )
+  if( compiler.open( fileName, OpenAipCompiler::Hotspots ) == false )
     {
-      qWarning( "OAIP: Can't open file %s for writing!"
-               " Aborting ...",
-               fileName.toLatin1().data() );
-
       return false;
     }
 
+  // Storing starts at the given index.
+  for( int i = listBegin; i < spList.size(); i++ )
+    {
+      compiler.write( spList[i] );
+    }
+
+  return compiler.close();
+}
+
+void OpenAipPoiLoader::writeHeaderData( QDataStream& out,
+                                        const char* fileType,
+                                        const quint8 fileVersion )
+{
+  out.setVersion( Q_DATA_STREAM );
+
   float filterRadius = GeneralConfig::instance()->getAirfieldHomeRadius();
 
-  // Hotspot uses not this filter but to have a unique header, it is considered.
+  // Navaids and hotspots use not this filter but to have a unique header,
+  // it is considered.
   float filterRunwayLength = GeneralConfig::instance()->getAirfieldRunwayLengthFilter();
 
-  qDebug() << "OAIP: creating single point file" << QFileInfo(fileName).fileName()
-           << "with" << (spList.size() - listBegin) << "elements";
-
   out << quint32( KFLOG_FILE_MAGIC );
-  out << QByteArray( FILE_TYPE_HOTSPOTS_OAIP_C );
-  out << quint8( FILE_VERSION_HOTSPOT_C );
+  out << QByteArray( fileType );
+  out << quint8( fileVersion );
   out << QDateTime::currentDateTime();
   out << filterRadius;
   out << filterRunwayLength;
@@ -840,35 +701,129 @@ bool OpenAipPoiLoader::createCompiledFile( QString& fileName,
 #endif
 
   SaveProjection( out, _globalMapMatrix->getProjection() );
+}
 
-  // write number of records to be stored
-  out << quint32( spList.size() - listBegin );
+void OpenAipPoiLoader::writeRecord( QDataStream& out, Airfield& af )
+{
+  // element type
+  out << quint8( af.getTypeID() );
+  // element name
+  ShortSave(out, af.getName().toUtf8());
+  // short waypoint name
+  ShortSave(out, af.getWPName().toUtf8());
+  // country
+  ShortSave(out, af.getCountry().toUtf8());
+  // icao
+  ShortSave(out, af.getICAO().toUtf8());
+  // comment
+  ShortSave(out, af.getComment().toUtf8());
+  // WGS84 coordinates
+  out << af.getWGSPosition();
+  // projected WGS84 coordinates
+  out << af.getPosition();
+  // elevation in meters
+  out << af.getElevation();
+
+  // The frequency list is saved.
+  QList<Frequency>& fList = af.getFrequencyList();
+
+  // Number of Frequencies
+  out << quint8( fList.size() );
+
+  for( int i = 0; i < fList.size(); i++ )
+   {
+      Frequency freq = fList.at(i);
+
+      // frequency is written as e.g. 126.575, is reduced to 16 bits
+      out << quint16( rint((freq.getFrequency() - 100.0) * 1000.0 ));
+      // frequency type
+      ShortSave(out, freq.getType().toUtf8());
+   }
+
+  // The runway list is saved
+  QList<Runway>& rwyList = af.getRunwayList();
+
+  // Number of runways
+  out << quint8( rwyList.size() );
+
+  for( int i = 0; i < rwyList.size(); i++ )
+   {
+     Runway rwy = rwyList.at(i);
+
+     out << rwy.m_length;
+     out << rwy.m_width;
+     out << quint16( rwy.m_heading );
+     out << quint8( rwy.m_surface );
+     out << quint8( rwy.m_isOpen );
+     out << quint8( rwy.m_isBidirectional );
+   }
+}
 
-  // Storing starts at the given index.
-  for( int i = listBegin; i < spList.size(); i++ )
+void OpenAipPoiLoader::writeRecord( QDataStream& out, RadioPoint& rp )
+{
+  // element type
+  out << quint8( rp.getTypeID() );
+  // element name
+  ShortSave(out, rp.getName().toUtf8());
+  // short waypoint name
+  ShortSave(out, rp.getWPName().toUtf8());
+  // country
+  ShortSave(out, rp.getCountry().toUtf8());
+  // icao
+  ShortSave(out, rp.getICAO().toUtf8());
+  // comment
+  ShortSave(out, rp.getComment().toUtf8());
+  // WGS84 coordinates
+  out << rp.getWGSPosition();
+  // projected WGS84 coordinates
+  out << rp.getPosition();
+  // elevation in meters
+  out << rp.getElevation();
+
+  // The frequency list is saved.
+  QList<Frequency>& fList = rp.getFrequencyList();
+
+  // Number of Frequencies
+  out << quint8( fList.size() );
+
+  for( int i = 0; i < fList.size (); i++ )
     {
-      SinglePoint& sp = spList[i];
-
-      // element type
-      out << quint8( sp.getTypeID() );
-      // element name
-      ShortSave(out, sp.getName().toUtf8());
-      // element short name
-      ShortSave(out, sp.getWPName().toUtf8());
-      // country
-      ShortSave(out, sp.getCountry().toUtf8());
-      // comment
-      ShortSave(out, sp.getComment().toUtf8());
-      // WGS84 coordinates
-      out << sp.getWGSPosition();
-      // projected WGS84 coordinates
-      out << sp.getPosition();
-      // elevation in meters
-      out << sp.getElevation();
+      Frequency freq = fList.at (i);
+
+      // frequency is saved as MHz
+      out << freq.getFrequency ();
+      // frequency type
+      ShortSave (out, freq.getType ().toUtf8 ());
     }
 
-  file.close();
-  return true;
+  // Channel info
+  ShortSave(out, rp.getChannel().toUtf8());
+  // Service range as float
+  out << rp.getRange();
+  // Declination
+  out << rp.getDeclination();
+  // Aligned2TrueNorth
+  out << quint8( rp.isAligned2TrueNorth() );
+}
+
+void OpenAipPoiLoader::writeRecord( QDataStream& out, SinglePoint& sp )
+{
+  // element type
+  out << quint8( sp.getTypeID() );
+  // element name
+  ShortSave(out, sp.getName().toUtf8());
+  // element short name
+  ShortSave(out, sp.getWPName().toUtf8());
+  // country
+  ShortSave(out, sp.getCountry().toUtf8());
+  // comment
+  ShortSave(out, sp.getComment().toUtf8());
+  // WGS84 coordinates
+  out << sp.getWGSPosition();
+  // projected WGS84 coordinates
+  out << sp.getPosition();
+  // elevation in meters
+  out << sp.getElevation();
 }
 
 bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
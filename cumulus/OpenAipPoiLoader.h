@@ -197,6 +197,31 @@ class OpenAipPoiLoader
    */
   bool getHeaderData( QString &path, QString fileType, int fileVersion );
 
+  /**
+   * Writes the header of a compiled file. The number of records must
+   * follow it.
+   *
+   * \param out Data stream to the compiled file
+   *
+   * \param fileType The file type of the compiled file
+   *
+   * \param fileVersion The file version of the compiled file
+   */
+  static void writeHeaderData( QDataStream& out,
+                               const char* fileType,
+                               const quint8 fileVersion );
+
+  /**
+   * Writes one record of a compiled file.
+   *
+   * \param out Data stream to the compiled file
+   *
+   * \param af, rp, sp Record to be written
+   */
+  static void writeRecord( QDataStream& out, Airfield& af );
+  static void writeRecord( QDataStream& out, RadioPoint& rp );
+  static void writeRecord( QDataStream& out, SinglePoint& sp );
+
  private:
 
   /**
@@ -25,8 +25,8 @@
  *
  * Contains the projected region of an \ref airspace onto the map.
  * The Map class maintains a list to find the airspace data when
- * the users selects an airspace in the map or to check the nearness
- * to an airspace during the drawing and after a position change.
+ * the users selects an airspace in the map. The nearness to an airspace
+ * is checked with the WGS84 geometry of the airspace.
  *
  * This class overtakes the ownership of the region, but not of
  * the airspace!
@@ -63,8 +63,10 @@ public:
     virtual ~AirRegion();
 
     /**
-     * Returns true if the given horizontal position conflicts with
-     * the airspace properties
+     * Returns the horizontal conflict of the given position with the
+     * airspace. The check is done with the WGS84 geometry of the airspace,
+     * see \ref Airspace::lateralConflict, and does not depend on the
+     * projected region.
      * @param pos position in WSG coordinates
      * @param awd collection of distances to use for the warnings
      * @param changed set to true if the warning is different from the
@@ -80,64 +82,15 @@ public:
      */
     Airspace::ConflictType currentConflict() const
     {
-      return m_lastResult;
+      return m_airspace ? m_airspace->lastHConflict() : Airspace::none;
     }
 
-private:
-    /**
-     * Creates new regions around the current position to check for collisions.
-     */
-    void createRegions();
-
-    /**
-     * @returns true if the position, the airspace warning distances or the
-     * scale has changed. If so, the static parameters that contain these
-     * values as well as ms_smallPostionChange are set to reflect the
-     * new situation.
-     */
-    bool parametersChanged( const QPoint& pos, const AirspaceWarningDistance& awd );
-
-    /** The result returned the last time */
-    Airspace::ConflictType m_lastResult;
-
 public:
 
     QPainterPath* m_region;
 
     /** The related airspace object to which the region object belonging. */
     Airspace* m_airspace;
-
-private:
-
-    /** true if this is the first time this region is used */
-    bool m_isNew;
-
-    /**
-     * Projected pos *this* instance has last been used with.
-     * ms_lastProjPos is the static value, used for the whole class.
-     * This value is used to check if we need to re-check for
-     * horizontal conflicts.
-     */
-    QPoint m_lastProjPos;
-
-    /** contains the last known position */
-    static QPoint ms_lastPos;
-    /** contains the last known scale */
-    static double ms_lastScale;
-    /** contains the last known set of warning distances */
-    static AirspaceWarningDistance ms_lastAwd;
-
-    // calculated values based on the values above
-    /** contains a large circular region around ms_lastProjPos */
-    static QPainterPath ms_regNear;
-    /** contains a small circular region around ms_lastProjPos */
-    static QPainterPath ms_regVeryNear;
-    /** contains the last position projected */
-    static QPoint ms_lastProjPos;
-    /** contains the last known map center point. */
-    static QPoint ms_lastMapCenter;
-    /** true if the last position change was a small change */
-    static bool ms_smallPositionChange;
 };
 
 #endif
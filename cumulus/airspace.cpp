@@ -19,6 +19,8 @@
 
 #include "airspace.h"
 #include "airregion.h"
+#include "airspaceconflict.h"
+#include "airspacelimittable.h"
 #include "calculator.h"
 #include "generalconfig.h"
 #include "mapconfig.h"
@@ -28,6 +30,8 @@ Airspace::Airspace() :
   m_lLimitType(BaseMapElement::NotSet),
   m_uLimitType(BaseMapElement::NotSet),
   m_lastVConflict(none),
+  m_lastHConflict(none),
+  m_lastLateralDistance(0.0),
   m_airRegion(0),
   m_id(-1)
 {
@@ -35,6 +39,29 @@ Airspace::Airspace() :
   closed = true;
 }
 
+/**
+ * Converts an airspace limit into meters. The same conversion is used for
+ * the lower and the upper limit.
+ */
+static double limitInMeters( const BaseMapElement::elevationType type,
+                             const float limit )
+{
+  switch( type )
+  {
+  case BaseMapElement::GND:
+  case BaseMapElement::MSL:
+  case BaseMapElement::STD:
+    return Distance::mFromFeet*limit;
+  case BaseMapElement::FL:
+    return Distance::mFromFeet*100.0*limit;
+  case BaseMapElement::UNLTD:
+    return 99999.0;
+  case BaseMapElement::NotSet:
+  default:
+    return 0.0;
+  };
+}
+
 Airspace::Airspace( QString name,
                     BaseMapElement::objectType oType,
                     QPolygon pP,
@@ -48,61 +75,18 @@ Airspace::Airspace( QString name,
   m_lLimitType(lType),
   m_uLimitType(uType),
   m_lastVConflict(none),
+  m_lastHConflict(none),
+  m_lastLateralDistance(0.0),
   m_airRegion(0),
   m_id(identifier)
 {
   // All Airspaces are closed regions ...
   closed = true;
 
-  // Normalize values
-  double lLim=0.0;
-
-  switch( m_lLimitType )
-  {
-  case GND:
-  case MSL:
-  case STD:
-    lLim = Distance::mFromFeet*lower;
-    break;
-  case FL:
-    lLim = Distance::mFromFeet*100.0*lower;
-    break;
-  case UNLTD:
-    lLim=99999.0;
-    break;
-  case NotSet:
-    lLim=0.0;
-    break;
-  default:
-    lLim=0.0;
-    break;
-  };
-
-  m_lLimit.setMeters( lLim );
-  double uLim=0.0;
-
-  switch( m_uLimitType )
-  {
-  case GND:
-  case MSL:
-  case STD:
-    uLim = Distance::mFromFeet*upper;
-    break;
-  case FL:
-    uLim = Distance::mFromFeet*100.0*upper;
-    break;
-  case UNLTD:
-    lLim=99999.0;
-    break;
-  case NotSet:
-    lLim=0.0;
-    break;
-  default:
-    uLim=0.0;
-    break;
-  };
-
-  m_uLimit.setMeters( uLim );
+  // Normalize values. The normalized limits are the base of the vertical
+  // classification, see AirspaceLimitTable.
+  m_lLimit.setMeters( limitInMeters( m_lLimitType, lower ) );
+  m_uLimit.setMeters( limitInMeters( m_uLimitType, upper ) );
   m_lastVConflict=none;
 }
 
@@ -121,6 +105,7 @@ Airspace* Airspace::createAirspaceObject()
                                m_id,
                                getCountry() );
 
+  as->setWgsPolygon( getWgsPolygon() );
   as->setFlarmAlertZone( m_flarmAlertZone );
   return as;
 }
@@ -312,6 +297,31 @@ QPainterPath* Airspace::createRegion()
   return path;
 }
 
+QRect Airspace::getDrawingRect() const
+{
+  QRect rect;
+
+  if( m_flarmAlertZone.isValid() )
+    {
+      int scaledRadius = (int) rint( double(m_flarmAlertZone.Radius) / glMapMatrix->getScale() );
+
+      QPoint mcp = glMapMatrix->map( glMapMatrix->wgsToMap( m_flarmAlertZone.Latitude,
+                                                            m_flarmAlertZone.Longitude ) );
+
+      rect = QRect( mcp.x() - scaledRadius, mcp.y() - scaledRadius,
+                    scaledRadius * 2, scaledRadius * 2 );
+    }
+  else
+    {
+      rect = glMapMatrix->map(projPolygon).boundingRect();
+    }
+
+  // The border line is drawn centered on the outline.
+  int lw = GeneralConfig::instance()->getAirspaceLineWidth() + 1;
+
+  return rect.adjusted( -lw, -lw, lw, lw );
+}
+
 /**
  * Returns a text representing the type of the airspace
  */
@@ -462,93 +472,59 @@ QString Airspace::getInfoString() const
   return text;
 }
 
+bool Airspace::isInsideVertically( const AltitudeCollection& alt ) const
+{
+  const AirspaceLimitTable::Reference ref( alt, AirspaceWarningDistance() );
+
+  return ( AirspaceLimitTable::classify( ref.lower[m_lLimitType],
+                                         ref.upper[m_uLimitType],
+                                         AirspaceLimitTable::normalizedLower( *this ),
+                                         AirspaceLimitTable::normalizedUpper( *this ),
+                                         ref ) == inside );
+}
+
 /**
  * Returns true if the given altitude conflicts with the airspace
  * properties. Only the altitude is considered not the current
- * position.
+ * position. The same classification is used by the
+ * \ref AirspaceLimitTable for all airspaces at once.
  */
 Airspace::ConflictType Airspace::conflicts( const AltitudeCollection& alt,
                                             const AirspaceWarningDistance& dist ) const
 {
-  Altitude lowerAlt(0);
-  Altitude upperAlt(0);
+  const AirspaceLimitTable::Reference ref( alt, dist );
 
-  //set which altitude to use from our range of available altitudes,
-  //and apply uncertainty margins
+  m_lastVConflict =
+      AirspaceLimitTable::classify( ref.lower[m_lLimitType],
+                                    ref.upper[m_uLimitType],
+                                    AirspaceLimitTable::normalizedLower( *this ),
+                                    AirspaceLimitTable::normalizedUpper( *this ),
+                                    ref );
 
-  switch (m_lLimitType)
-    {
-      case NotSet:
-        break;
-      case MSL:
-        lowerAlt = alt.gpsAltitude;
-        break;
-      case GND:
-        lowerAlt = alt.gndAltitude + alt.gndAltitudeError; // we need to use a conservative estimate
-        if (m_lLimit == 0)
-          lowerAlt.setMeters(1); // we're always above ground
-        break;
-      case FL:
-      case STD:
-        lowerAlt = alt.stdAltitude; // flight levels are always at pressure altitude!
-        break;
-      case UNLTD:
-        m_lastVConflict = none;
-        return none;
-    }
-
-  switch (m_uLimitType)
-    {
-      case NotSet:
-        upperAlt.setMeters(100000);
-        break;
-      case MSL:
-        upperAlt = alt.gpsAltitude;
-        break;
-      case GND:
-        upperAlt = alt.gndAltitude - alt.gndAltitudeError; //we need to use a conservative estimate
-        break;
-      case FL:
-      case STD:
-        upperAlt = alt.stdAltitude;
-        break;
-      case UNLTD:
-        upperAlt = m_uLimit - 1; //we are always below the upper border of an Unlimited airspace
-        break;
-    }
-
-  //check to see if we're inside the airspace
-  if ((lowerAlt.getMeters() >= m_lLimit.getMeters()) &&
-      (upperAlt.getMeters() <= m_uLimit.getMeters()))
-    {
-      m_lastVConflict = inside;
-      // qDebug("vertical conflict: %d, airspace: %s", _lastVConflict, getName().latin1());
-      return inside;
-    }
+  return m_lastVConflict;
+}
 
-  // @AP: very near and near will not work, if you use the defined
-  // operators. Changed it to the getMeters method, that will work
-  // fine.
+double Airspace::lateralDistance( const QPoint& wgsPos,
+                                  const double maxMeters ) const
+{
+  return AirspaceConflict::signedDistance( wgsPolygon, wgsBox,
+                                           wgsPos, maxMeters );
+}
 
-  //not inside. Check to see if we're very near to the airspace
-  if ((lowerAlt.getMeters() >= (m_lLimit.getMeters() - dist.verBelowVeryClose.getMeters())) &&
-      (upperAlt.getMeters() <= (m_uLimit.getMeters() + dist.verAboveVeryClose.getMeters())))
-    {
-      m_lastVConflict = veryNear;
-      return veryNear;
-    }
+/**
+ * Returns the horizontal conflict of the position with the airspace.
+ * The distances are real meters, independent of the map scale.
+ */
+Airspace::ConflictType Airspace::lateralConflict( const QPoint& wgsPos,
+                                                  const AirspaceWarningDistance& awd ) const
+{
+  // Beyond the near distance the exact distance is not of interest.
+  const double maxMeters = awd.horClose.getMeters() + 1.0;
 
-  //not very near. Just near then?
-  if ((lowerAlt.getMeters() >= (m_lLimit.getMeters() - dist.verBelowClose.getMeters())) &&
-      (upperAlt.getMeters() <= (m_uLimit.getMeters() + dist.verAboveClose.getMeters())))
-    {
-      m_lastVConflict = near;
-      return near;
-    }
+  m_lastLateralDistance = lateralDistance( wgsPos, maxMeters );
+  m_lastHConflict = AirspaceConflict::classify( m_lastLateralDistance, awd );
 
-  //nope, we're not even near.
-  m_lastVConflict=none;
-  return none;
+  return m_lastHConflict;
 }
 
 bool Airspace::operator < (const Airspace& other) const
@@ -133,6 +133,12 @@ public:
    */
   QPainterPath* createRegion();
 
+  /**
+   * Returns the rectangle on the map display, which is covered by the
+   * airspace drawing inclusive its border line.
+   */
+  QRect getDrawingRect() const;
+
   /**
    * Sets the upper limit of the airspace.
    */
@@ -229,6 +235,13 @@ public:
   ConflictType conflicts (const AltitudeCollection& alt,
                           const AirspaceWarningDistance& dist) const;
 
+  /**
+   * Returns true if the given altitude is inside of the vertical limits of
+   * the airspace. In contrast to \ref conflicts the last vertical conflict
+   * is not changed.
+   */
+  bool isInsideVertically( const AltitudeCollection& alt ) const;
+
   /**
    * Returns the last vertical conflict type
    */
@@ -237,6 +250,56 @@ public:
       return m_lastVConflict;
   };
 
+  /**
+   * Sets the last vertical conflict type, if it has been computed by the
+   * \ref AirspaceLimitTable.
+   */
+  void setLastVConflict( const ConflictType ct ) const
+  {
+      m_lastVConflict = ct;
+  };
+
+  /**
+   * Returns the signed lateral distance in meters from the passed position
+   * to the airspace border, computed with the WGS84 polygon of the
+   * airspace. The value is negative, if the position is inside. If the
+   * airspace is farther away than maxMeters, maxMeters is returned.
+   *
+   * \param wgsPos Position in KFLog WGS84 coordinates.
+   *
+   * \param maxMeters Limit of the computed distance.
+   */
+  double lateralDistance( const QPoint& wgsPos, const double maxMeters ) const;
+
+  /**
+   * Returns the horizontal conflict of the passed position with the
+   * airspace. The check does not depend on the map view. The result and the
+   * distance are saved as last horizontal conflict.
+   *
+   * \param wgsPos Position in KFLog WGS84 coordinates.
+   *
+   * \param awd Horizontal warning distances.
+   */
+  ConflictType lateralConflict( const QPoint& wgsPos,
+                                const AirspaceWarningDistance& awd ) const;
+
+  /**
+   * Returns the last horizontal conflict type
+   */
+  ConflictType lastHConflict() const
+  {
+      return m_lastHConflict;
+  };
+
+  /**
+   * Returns the signed lateral distance in meters of the last horizontal
+   * conflict check, see \ref lateralDistance.
+   */
+  double lastLateralDistance() const
+  {
+      return m_lastLateralDistance;
+  };
+
   /**
    * sets the touch time of air space to current time
    */
@@ -370,6 +433,8 @@ private:
   BaseMapElement::elevationType m_uLimitType;
 
   mutable ConflictType m_lastVConflict;
+  mutable ConflictType m_lastHConflict;
+  mutable double m_lastLateralDistance;
 
   /** save time of last touch of airspace */
   QTime m_lastNear;
@@ -0,0 +1,170 @@
+/***********************************************************************
+**
+**   airspaceconflict.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cmath>
+
+#include "airspaceconflict.h"
+#include "mapcalc.h"
+
+double AirspaceConflict::metersPerUnit()
+{
+  // MILE_kfl are the meters of one minute, a KFLog unit is 1/10000 minute.
+  return MILE_kfl / 10000.0;
+}
+
+/** Returns the meters of one longitude unit at the passed latitude. */
+static double lonMetersPerUnit( const int latitude )
+{
+  return AirspaceConflict::metersPerUnit() *
+         cos( latitude / 600000.0 * M_PI / 180.0 );
+}
+
+double AirspaceConflict::boxDistance( const QRect& wgsBox, const QPoint& wgsPos )
+{
+  const QRect box = wgsBox.normalized();
+
+  double dLat = 0.0;
+  double dLon = 0.0;
+
+  if( wgsPos.x() < box.left() )
+    {
+      dLat = box.left() - wgsPos.x();
+    }
+  else if( wgsPos.x() > box.right() )
+    {
+      dLat = wgsPos.x() - box.right();
+    }
+
+  if( wgsPos.y() < box.top() )
+    {
+      dLon = box.top() - wgsPos.y();
+    }
+  else if( wgsPos.y() > box.bottom() )
+    {
+      dLon = wgsPos.y() - box.bottom();
+    }
+
+  dLat *= metersPerUnit();
+  dLon *= lonMetersPerUnit( wgsPos.x() );
+
+  return sqrt( dLat * dLat + dLon * dLon );
+}
+
+double AirspaceConflict::signedDistance( const QPolygon& wgsPolygon,
+                                         const QRect& wgsBox,
+                                         const QPoint& wgsPos,
+                                         const double maxMeters )
+{
+  if( wgsPolygon.isEmpty() || boxDistance( wgsBox, wgsPos ) > maxMeters )
+    {
+      return maxMeters;
+    }
+
+  // Local metric plane with the checked position as origin, x points to
+  // the east and y to the north.
+  const double latScale = metersPerUnit();
+  const double lonScale = lonMetersPerUnit( wgsPos.x() );
+
+  const int count = wgsPolygon.size();
+
+  // With less than three points the polygon has no inside.
+  const bool closed = count > 2;
+
+  bool inside = false;
+  double minSquare = -1.0;
+
+  const QPoint& last = wgsPolygon.at( count - 1 );
+
+  double ax = (last.y() - wgsPos.y()) * lonScale;
+  double ay = (last.x() - wgsPos.x()) * latScale;
+
+  for( int i = 0; i < count; i++ )
+    {
+      const QPoint& point = wgsPolygon.at(i);
+
+      const double bx = (point.y() - wgsPos.y()) * lonScale;
+      const double by = (point.x() - wgsPos.x()) * latScale;
+
+      if( i > 0 || closed )
+        {
+          // Crossing of a ray from the origin along the positive x axis.
+          if( (ay > 0.0) != (by > 0.0) )
+            {
+              const double xCross = ax + (0.0 - ay) * (bx - ax) / (by - ay);
+
+              if( xCross > 0.0 )
+                {
+                  inside = ! inside;
+                }
+            }
+
+          // Nearest point of the edge to the origin.
+          const double dx = bx - ax;
+          const double dy = by - ay;
+          const double len = dx * dx + dy * dy;
+
+          double t = 0.0;
+
+          if( len > 0.0 )
+            {
+              t = -(ax * dx + ay * dy) / len;
+              t = qBound( 0.0, t, 1.0 );
+            }
+
+          const double px = ax + t * dx;
+          const double py = ay + t * dy;
+          const double square = px * px + py * py;
+
+          if( minSquare < 0.0 || square < minSquare )
+            {
+              minSquare = square;
+            }
+        }
+
+      ax = bx;
+      ay = by;
+    }
+
+  if( minSquare < 0.0 )
+    {
+      // A single point.
+      minSquare = ax * ax + ay * ay;
+    }
+
+  const double distance = sqrt( minSquare );
+
+  return (closed && inside) ? -distance : distance;
+}
+
+Airspace::ConflictType AirspaceConflict::classify( const double distance,
+                                                   const AirspaceWarningDistance& awd )
+{
+  if( distance <= 0.0 )
+    {
+      return Airspace::inside;
+    }
+
+  if( distance <= awd.horVeryClose.getMeters() )
+    {
+      return Airspace::veryNear;
+    }
+
+  if( distance <= awd.horClose.getMeters() )
+    {
+      return Airspace::near;
+    }
+
+  return Airspace::none;
+}
@@ -0,0 +1,93 @@
+/***********************************************************************
+**
+**   airspaceconflict.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class AirspaceConflict
+ *
+ * \author agent
+ *
+ * \brief Lateral airspace conflict computation in WGS84 coordinates.
+ *
+ * The computation works on the WGS84 polygon of an airspace and does not
+ * depend on the map projection, the map scale or the screen. The polygon is
+ * transformed into a local metric plane around the checked position, in
+ * which the point-in-polygon test and the distances to the polygon edges
+ * are computed. Inside of a few hundred kilometers around the position the
+ * error of this plane is far below the warning distances.
+ *
+ * All methods are reentrant.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef AIRSPACE_CONFLICT_H
+#define AIRSPACE_CONFLICT_H
+
+#include <QPoint>
+#include <QPolygon>
+#include <QRect>
+
+#include "airspace.h"
+#include "airspacewarningdistance.h"
+
+class AirspaceConflict
+{
+ public:
+
+  /**
+   * Computes the signed distance from a position to the border of a
+   * polygon.
+   *
+   * \param wgsPolygon Polygon in KFLog WGS84 coordinates, x is the latitude
+   *                   and y is the longitude. The polygon is closed
+   *                   implicitly.
+   *
+   * \param wgsBox Bounding box of the polygon.
+   *
+   * \param wgsPos Checked position in KFLog WGS84 coordinates.
+   *
+   * \param maxMeters If the bounding box is farther away than this distance,
+   *                  the polygon is not examined and maxMeters is returned.
+   *
+   * \return Distance in meters to the nearest polygon edge. The value is
+   *         negative, if the position is inside of the polygon.
+   */
+  static double signedDistance( const QPolygon& wgsPolygon,
+                                const QRect& wgsBox,
+                                const QPoint& wgsPos,
+                                const double maxMeters );
+
+  /**
+   * Computes the distance in meters from a position to a box. It is zero,
+   * if the position is inside of the box.
+   */
+  static double boxDistance( const QRect& wgsBox, const QPoint& wgsPos );
+
+  /**
+   * Classifies a signed distance, as returned by \ref signedDistance,
+   * with the horizontal warning distances.
+   */
+  static Airspace::ConflictType classify( const double distance,
+                                          const AirspaceWarningDistance& awd );
+
+  /**
+   * Meters of one KFLog coordinate unit along a meridian.
+   */
+  static double metersPerUnit();
+};
+
+#endif
@@ -0,0 +1,213 @@
+/***********************************************************************
+**
+**   airspacelimittable.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore>
+
+#include "airspacelimittable.h"
+
+AirspaceLimitTable::Reference::Reference() :
+  belowVeryClose(0.0),
+  aboveVeryClose(0.0),
+  belowClose(0.0),
+  aboveClose(0.0)
+{
+  for( int i = 0; i <= BaseMapElement::UNLTD; i++ )
+    {
+      lower[i] = 0.0;
+      upper[i] = 0.0;
+    }
+}
+
+AirspaceLimitTable::Reference::Reference( const AltitudeCollection& alt,
+                                          const AirspaceWarningDistance& dist )
+{
+  const double gnd   = alt.gndAltitude.getMeters();
+  const double error = alt.gndAltitudeError.getMeters();
+
+  lower[BaseMapElement::NotSet] = 0.0;
+  lower[BaseMapElement::MSL]    = alt.gpsAltitude.getMeters();
+  // We need to use a conservative estimate for the ground distance.
+  lower[BaseMapElement::GND]    = gnd + error;
+  // Flight levels are always at pressure altitude!
+  lower[BaseMapElement::FL]     = alt.stdAltitude.getMeters();
+  lower[BaseMapElement::STD]    = alt.stdAltitude.getMeters();
+  lower[BaseMapElement::UNLTD]  = 0.0;
+
+  upper[BaseMapElement::NotSet] = 100000.0;
+  upper[BaseMapElement::MSL]    = alt.gpsAltitude.getMeters();
+  upper[BaseMapElement::GND]    = gnd - error;
+  upper[BaseMapElement::FL]     = alt.stdAltitude.getMeters();
+  upper[BaseMapElement::STD]    = alt.stdAltitude.getMeters();
+  upper[BaseMapElement::UNLTD]  = 0.0;
+
+  belowVeryClose = dist.verBelowVeryClose.getMeters();
+  aboveVeryClose = dist.verAboveVeryClose.getMeters();
+  belowClose     = dist.verBelowClose.getMeters();
+  aboveClose     = dist.verAboveClose.getMeters();
+}
+
+bool AirspaceLimitTable::Reference::operator==( const Reference& other ) const
+{
+  for( int i = 0; i <= BaseMapElement::UNLTD; i++ )
+    {
+      if( lower[i] != other.lower[i] || upper[i] != other.upper[i] )
+        {
+          return false;
+        }
+    }
+
+  return ( belowVeryClose == other.belowVeryClose &&
+           aboveVeryClose == other.aboveVeryClose &&
+           belowClose == other.belowClose &&
+           aboveClose == other.aboveClose );
+}
+
+AirspaceLimitTable::AirspaceLimitTable() :
+  m_evaluated(false)
+{
+}
+
+AirspaceLimitTable::~AirspaceLimitTable()
+{
+}
+
+void AirspaceLimitTable::clear()
+{
+  m_groups.clear();
+  m_lower.clear();
+  m_upper.clear();
+  m_conflicts.clear();
+  m_slots.clear();
+  m_evaluated = false;
+}
+
+double AirspaceLimitTable::normalizedLower( const Airspace& as )
+{
+  switch( as.getLowerT() )
+    {
+      case BaseMapElement::UNLTD:
+        // An unlimited lower limit is never reached.
+        return HUGE_VAL;
+
+      case BaseMapElement::GND:
+
+        if( as.getLowerAltitude().getMeters() == 0.0 )
+          {
+            // We're always above ground.
+            return -HUGE_VAL;
+          }
+
+        return as.getLowerAltitude().getMeters();
+
+      default:
+        return as.getLowerAltitude().getMeters();
+    }
+}
+
+double AirspaceLimitTable::normalizedUpper( const Airspace& as )
+{
+  if( as.getUpperT() == BaseMapElement::UNLTD )
+    {
+      // We are always below the upper border of an unlimited airspace.
+      return HUGE_VAL;
+    }
+
+  return as.getUpperAltitude().getMeters();
+}
+
+void AirspaceLimitTable::build( const SortableAirspaceList& list )
+{
+  clear();
+
+  const int count = list.size();
+
+  // The list indexes are sorted by the group key. The list order is kept
+  // inside of a group.
+  QVector< QPair<int, int> > keys( count );
+
+  for( int i = 0; i < count; i++ )
+    {
+      const Airspace* as = list.at(i);
+
+      keys[i].first  = referenceType( as->getLowerT() ) * 8 +
+                       referenceType( as->getUpperT() );
+      keys[i].second = i;
+    }
+
+  std::sort( keys.begin(), keys.end() );
+
+  m_lower.resize( count );
+  m_upper.resize( count );
+  m_conflicts.fill( Airspace::none, count );
+  m_slots.resize( count );
+
+  for( int s = 0; s < count; s++ )
+    {
+      const int key = keys.at(s).first;
+      const int idx = keys.at(s).second;
+
+      m_slots[idx] = s;
+      m_lower[s] = normalizedLower( *list.at(idx) );
+      m_upper[s] = normalizedUpper( *list.at(idx) );
+
+      if( s == 0 || key != keys.at(s - 1).first )
+        {
+          Group group;
+          group.lowerType = key / 8;
+          group.upperType = key % 8;
+          group.begin = s;
+
+          m_groups.append( group );
+        }
+
+      m_groups.last().end = s + 1;
+    }
+}
+
+void AirspaceLimitTable::evaluate( const AltitudeCollection& alt,
+                                   const AirspaceWarningDistance& dist )
+{
+  const Reference ref( alt, dist );
+
+  if( m_evaluated && ref == m_reference )
+    {
+      // Nothing has been changed since the last evaluation.
+      return;
+    }
+
+  m_reference = ref;
+  m_evaluated = true;
+
+  const double* lower = m_lower.constData();
+  const double* upper = m_upper.constData();
+  quint8* conflicts = m_conflicts.data();
+
+  for( int g = 0; g < m_groups.size(); g++ )
+    {
+      const Group& group = m_groups.at(g);
+
+      const double lowerAlt = ref.lower[group.lowerType];
+      const double upperAlt = ref.upper[group.upperType];
+
+      for( int k = group.begin; k < group.end; k++ )
+        {
+          conflicts[k] = (quint8) classifyValue( lowerAlt, upperAlt,
+                                                 lower[k], upper[k], ref );
+        }
+    }
+}
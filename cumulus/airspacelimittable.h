@@ -0,0 +1,225 @@
+/***********************************************************************
+**
+**   airspacelimittable.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class AirspaceLimitTable
+ *
+ * \author agent
+ *
+ * \brief Vertical conflict evaluation of all airspaces in one pass.
+ *
+ * The vertical limits of the airspace list are stored in flat arrays. They
+ * are grouped by the reference types of their lower and upper limit, which
+ * are MSL, GND, STD (inclusive FL), UNLTD and not set. Inside of a group
+ * the altitudes, which are compared with the limits, are the same for all
+ * airspaces. So the vertical conflicts of a group are computed in a simple
+ * loop over the limit arrays without any branches, which the compiler can
+ * vectorize.
+ *
+ * The special cases of the limit types are folded into the stored limits.
+ * An unlimited lower limit is never reached, an unlimited upper limit and
+ * a lower limit of 0 GND are never violated.
+ *
+ * The conflicts of single airspaces, see \ref Airspace::conflicts, are
+ * computed with the same normalized limits and the same classification.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef AIRSPACE_LIMIT_TABLE_H
+#define AIRSPACE_LIMIT_TABLE_H
+
+#include <QVector>
+
+#include "airspace.h"
+#include "airspacewarningdistance.h"
+#include "altitude.h"
+
+class AirspaceLimitTable
+{
+ public:
+
+  /**
+   * Altitudes and warning distances of one vertical conflict check.
+   */
+  class Reference
+  {
+   public:
+
+    Reference();
+
+    Reference( const AltitudeCollection& alt,
+               const AirspaceWarningDistance& dist );
+
+    bool operator==( const Reference& other ) const;
+
+    /**
+     * Altitudes in meters, which are compared with the lower respectively
+     * the upper limits. The index is the limit type.
+     */
+    double lower[BaseMapElement::UNLTD + 1];
+    double upper[BaseMapElement::UNLTD + 1];
+
+    /** Vertical warning distances in meters. */
+    double belowVeryClose;
+    double aboveVeryClose;
+    double belowClose;
+    double aboveClose;
+  };
+
+  AirspaceLimitTable();
+
+  virtual ~AirspaceLimitTable();
+
+  /**
+   * Removes all limits.
+   */
+  void clear();
+
+  /**
+   * Takes over the limits of the passed airspace list. The airspaces are
+   * addressed later by their index in this list.
+   */
+  void build( const SortableAirspaceList& list );
+
+  /**
+   * \return True, if the table contains no limits.
+   */
+  bool isEmpty() const
+  {
+    return m_slots.isEmpty();
+  };
+
+  /**
+   * Computes the vertical conflicts of all airspaces. If the altitudes and
+   * the warning distances are unchanged since the last call, nothing is
+   * done.
+   */
+  void evaluate( const AltitudeCollection& alt,
+                 const AirspaceWarningDistance& dist );
+
+  /**
+   * \return The vertical conflict of the last \ref evaluate call of the
+   *         airspace with the passed list index.
+   */
+  Airspace::ConflictType conflict( const int listIndex ) const
+  {
+    if( listIndex < 0 || listIndex >= m_slots.size() || m_evaluated == false )
+      {
+        return Airspace::none;
+      }
+
+    return static_cast<Airspace::ConflictType>( m_conflicts.at( m_slots.at( listIndex ) ) );
+  };
+
+  /**
+   * Maps a limit type to its reference type. Flight levels are standard
+   * pressure altitudes.
+   */
+  static BaseMapElement::elevationType referenceType( const BaseMapElement::elevationType type )
+  {
+    return ( type == BaseMapElement::FL ) ? BaseMapElement::STD : type;
+  };
+
+  /**
+   * \return The lower limit of the airspace in meters, normalized for the
+   *         classification.
+   */
+  static double normalizedLower( const Airspace& as );
+
+  /**
+   * \return The upper limit of the airspace in meters, normalized for the
+   *         classification.
+   */
+  static double normalizedUpper( const Airspace& as );
+
+  /**
+   * Classifies the vertical position against normalized limits.
+   *
+   * \param lowerAlt Altitude compared with the lower limit.
+   *
+   * \param upperAlt Altitude compared with the upper limit.
+   */
+  static Airspace::ConflictType classify( const double lowerAlt,
+                                          const double upperAlt,
+                                          const double lower,
+                                          const double upper,
+                                          const Reference& ref )
+  {
+    return static_cast<Airspace::ConflictType>( classifyValue( lowerAlt, upperAlt,
+                                                               lower, upper, ref ) );
+  };
+
+ private:
+
+  /**
+   * Airspaces with the same reference types.
+   */
+  class Group
+  {
+   public:
+
+    Group() : lowerType(0), upperType(0), begin(0), end(0) {};
+
+    int lowerType;
+    int upperType;
+
+    /** Slot range of the group. */
+    int begin;
+    int end;
+  };
+
+  static int classifyValue( const double lowerAlt,
+                            const double upperAlt,
+                            const double lower,
+                            const double upper,
+                            const Reference& ref )
+  {
+    // The conditions are combined without branches.
+    const int isInside = (lowerAlt >= lower) &
+                         (upperAlt <= upper);
+
+    const int isVeryNear = (lowerAlt >= lower - ref.belowVeryClose) &
+                           (upperAlt <= upper + ref.aboveVeryClose);
+
+    const int isNear = (lowerAlt >= lower - ref.belowClose) &
+                       (upperAlt <= upper + ref.aboveClose);
+
+    return isInside ? Airspace::inside :
+           isVeryNear ? Airspace::veryNear :
+           isNear ? Airspace::near : Airspace::none;
+  };
+
+  QVector<Group> m_groups;
+
+  /** Normalized limits in meters, ordered by groups. */
+  QVector<double> m_lower;
+  QVector<double> m_upper;
+
+  /** Vertical conflicts of the last evaluation, ordered by groups. */
+  QVector<quint8> m_conflicts;
+
+  /** Slot of every airspace list index. */
+  QVector<int> m_slots;
+
+  /** Reference of the last evaluation. */
+  Reference m_reference;
+
+  bool m_evaluated;
+};
+
+#endif
@@ -0,0 +1,383 @@
+/***********************************************************************
+**
+**   airspacelookahead.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cmath>
+
+#include <QtCore>
+
+#include "airspaceconflict.h"
+#include "airspacelookahead.h"
+#include "mapcalc.h"
+#include "mapcontents.h"
+
+extern MapContents* _globalMapContents;
+
+// Below this ground speed in m/s no track is extrapolated.
+#define MIN_SPEED 5.0
+
+// Time span in seconds, over which turn and climb rate are averaged.
+#define MIN_MODEL_TIME 3.0
+#define MAX_MODEL_TIME 10.0
+
+// Minimum time in seconds, for which the path is computed beyond the
+// lookahead time.
+#define MIN_RESERVE_TIME 10
+
+AirspaceLookahead::AirspaceLookahead() :
+  m_modelValid(false),
+  m_horizon(0),
+  m_pathTime(0),
+  m_candidateRadius(-1.0),
+  m_generation(0)
+{
+}
+
+AirspaceLookahead::~AirspaceLookahead()
+{
+}
+
+void AirspaceLookahead::reset()
+{
+  m_modelValid = false;
+  m_candidates.clear();
+  m_candidateRadius = -1.0;
+  m_incursions.clear();
+  m_entries.clear();
+  m_entryOffsets.clear();
+}
+
+bool AirspaceLookahead::createModel( const LimitedList<FlightSample>& samples,
+                                     TrackModel& model ) const
+{
+  if( samples.count() < 2 )
+    {
+      return false;
+    }
+
+  const FlightSample& last = samples.at(0);
+
+  // Look for the sample, which is at least MIN_MODEL_TIME seconds older.
+  int ref = -1;
+  double span = 0.0;
+
+  for( int i = 1; i < samples.count(); i++ )
+    {
+      double s = samples.at(i).time.msecsTo( last.time ) / 1000.0;
+
+      if( s > MAX_MODEL_TIME )
+        {
+          break;
+        }
+
+      ref = i;
+      span = s;
+
+      if( s >= MIN_MODEL_TIME )
+        {
+          break;
+        }
+    }
+
+  if( ref < 0 || span <= 0.0 )
+    {
+      return false;
+    }
+
+  Vector lastVector = last.vector;
+  Vector refVector  = samples.at(ref).vector;
+
+  model.position = last.position;
+  model.time     = last.time;
+  model.speed    = lastVector.getSpeed().getMps();
+  model.heading  = lastVector.getAngleDeg();
+
+  model.turnRate = MapCalc::angleDiff( refVector.getAngleDeg(),
+                                       lastVector.getAngleDeg() ) / span;
+
+  model.turnRate = qBound( -30.0, model.turnRate, 30.0 );
+
+  model.climb = (last.altitude.getMeters() -
+                 samples.at(ref).altitude.getMeters()) / span;
+
+  return true;
+}
+
+void AirspaceLookahead::advance( const TrackModel& model,
+                                 const double seconds,
+                                 TrackModel& result )
+{
+  result = model;
+
+  const double h0 = model.heading * M_PI / 180.0;
+  const double omega = model.turnRate * M_PI / 180.0;
+
+  double north, east;
+
+  if( fabs( model.turnRate ) < 0.1 )
+    {
+      // Straight flight
+      north = model.speed * seconds * cos( h0 );
+      east  = model.speed * seconds * sin( h0 );
+    }
+  else
+    {
+      // Flight along an arc with constant turn rate
+      const double h1 = h0 + omega * seconds;
+
+      north = model.speed / omega * (sin( h1 ) - sin( h0 ));
+      east  = model.speed / omega * (cos( h0 ) - cos( h1 ));
+    }
+
+  const double mpu = AirspaceConflict::metersPerUnit();
+  const double cosLat = cos( model.position.x() / 600000.0 * M_PI / 180.0 );
+
+  result.position.rx() += (int) rint( north / mpu );
+
+  if( cosLat > 0.01 )
+    {
+      result.position.ry() += (int) rint( east / (mpu * cosLat) );
+    }
+
+  result.heading = fmod( model.heading + model.turnRate * seconds + 360.0, 360.0 );
+  result.time = model.time.addMSecs( qint64( seconds * 1000.0 ) );
+}
+
+bool AirspaceLookahead::followsModel( const TrackModel& model ) const
+{
+  const double elapsed = m_model.time.msecsTo( model.time ) / 1000.0;
+
+  if( elapsed <= 0.0 || elapsed + m_horizon > m_pathTime )
+    {
+      // The lookahead leaves the computed path.
+      return false;
+    }
+
+  TrackModel expected;
+  advance( m_model, elapsed, expected );
+
+  QPoint p1 = expected.position;
+  QPoint p2 = model.position;
+
+  return ( MapCalc::dist( &p1, &p2 ) < 0.15 &&
+           fabs( MapCalc::angleDiff( (int) rint( expected.heading ),
+                                     (int) rint( model.heading ) ) ) < 10 &&
+           fabs( expected.speed - model.speed ) < 3.0 &&
+           fabs( expected.turnRate - model.turnRate ) < 3.0 &&
+           fabs( expected.climb - model.climb ) < 1.0 );
+}
+
+void AirspaceLookahead::updateCandidates( const QPoint& position,
+                                          const double radiusMeters )
+{
+  if( m_candidateRadius > 0.0 )
+    {
+      QPoint center = m_candidateCenter;
+      QPoint pos = position;
+
+      if( MapCalc::dist( &center, &pos ) * 1000.0 + radiusMeters <= m_candidateRadius )
+        {
+          // The cached candidates cover the whole lookahead distance.
+          return;
+        }
+    }
+
+  // Query with a reserve, so that the next fixes can use the candidates too.
+  m_candidateCenter = position;
+  m_candidateRadius = radiusMeters * 1.5;
+
+  _globalMapContents->getSpatialIndex( MapContents::AirspaceList )
+      .queryRadius( position, m_candidateRadius / 1000.0, m_candidates );
+}
+
+void AirspaceLookahead::compute( const TrackModel& model,
+                                 const AltitudeCollection& alt,
+                                 const int horizon )
+{
+  m_entries.clear();
+  m_entryOffsets.clear();
+
+  // The path is computed with a reserve, which is used by the following
+  // fixes.
+  m_pathTime = horizon + qMax( MIN_RESERVE_TIME, horizon / 2 );
+
+  updateCandidates( model.position, model.speed * m_pathTime + 1000.0 );
+
+  // Predicted positions in steps of one second.
+  QVector<QPoint> path( m_pathTime + 1 );
+  QRect pathBox( model.position, QSize( 1, 1 ) );
+
+  path[0] = model.position;
+
+  for( int s = 1; s <= m_pathTime; s++ )
+    {
+      TrackModel state;
+      advance( model, s, state );
+      path[s] = state.position;
+      pathBox |= QRect( state.position, QSize( 1, 1 ) );
+    }
+
+  SortableAirspaceList* asList = _globalMapContents->getAirspaceList();
+
+  for( int i = 0; i < m_candidates.size(); i++ )
+    {
+      if( m_candidates.at(i) >= asList->size() )
+        {
+          continue;
+        }
+
+      Airspace* as = asList->at( m_candidates.at(i) );
+      const QRect& box = as->getWgsBoundingBox();
+
+      if( as->getTypeID() == BaseMapElement::AirFir || ! box.intersects( pathBox ) )
+        {
+          continue;
+        }
+
+      if( as->isInsideVertically( alt ) &&
+          as->lateralDistance( model.position, 1.0 ) < 0.0 )
+        {
+          // We are already inside, that is no prediction.
+          continue;
+        }
+
+      for( int s = 1; s <= m_pathTime; s++ )
+        {
+          if( ! box.contains( path.at(s) ) )
+            {
+              continue;
+            }
+
+          // Altitudes at the predicted position
+          const double dz = model.climb * s;
+
+          AltitudeCollection predicted = alt;
+          predicted.gpsAltitude.setMeters( alt.gpsAltitude.getMeters() + dz );
+          predicted.stdAltitude.setMeters( alt.stdAltitude.getMeters() + dz );
+          predicted.pressureAltitude.setMeters( alt.pressureAltitude.getMeters() + dz );
+          predicted.gndAltitude.setMeters( alt.gndAltitude.getMeters() + dz );
+
+          if( ! as->isInsideVertically( predicted ) ||
+              as->lateralDistance( path.at(s), 1.0 ) >= 0.0 )
+            {
+              continue;
+            }
+
+          Incursion incursion;
+          incursion.airspace = as;
+          incursion.timeToEntry = s;
+          incursion.position = path.at(s);
+
+          // Keep the list sorted by the entry time.
+          int pos = 0;
+
+          while( pos < m_entries.size() &&
+                 m_entries.at(pos).timeToEntry <= s )
+            {
+              pos++;
+            }
+
+          m_entries.insert( pos, incursion );
+          m_entryOffsets.insert( pos, double( s ) );
+          break;
+        }
+    }
+}
+
+bool AirspaceLookahead::update( const LimitedList<FlightSample>& samples,
+                                const AltitudeCollection& alt,
+                                const int horizon )
+{
+  if( m_generation != _globalMapContents->getAirspaceGeneration() )
+    {
+      // The airspace list has been changed, the candidates and the
+      // predictions refer to the old one.
+      reset();
+      m_generation = _globalMapContents->getAirspaceGeneration();
+    }
+
+  QList<Airspace*> before;
+
+  for( int i = 0; i < m_incursions.size(); i++ )
+    {
+      before.append( m_incursions.at(i).airspace );
+    }
+
+  TrackModel model;
+
+  if( horizon <= 0 ||
+      createModel( samples, model ) == false || model.speed < MIN_SPEED )
+    {
+      // No usable track, nothing can be predicted.
+      m_modelValid = false;
+      m_incursions.clear();
+      m_entries.clear();
+      m_entryOffsets.clear();
+      return ! before.isEmpty();
+    }
+
+  if( m_modelValid && horizon == m_horizon && followsModel( model ) )
+    {
+      // The flight follows the last prediction. The entry times are only
+      // reduced by the elapsed time.
+      const double elapsed = m_model.time.msecsTo( model.time ) / 1000.0;
+
+      for( int i = m_entries.size() - 1; i >= 0; i-- )
+        {
+          const double left = m_entryOffsets.at(i) - elapsed;
+
+          if( left <= 0.0 )
+            {
+              // The entry time is reached, the current conflict check
+              // takes over.
+              m_entries.removeAt(i);
+              m_entryOffsets.removeAt(i);
+              continue;
+            }
+
+          m_entries[i].timeToEntry = (int) ceil( left );
+        }
+    }
+  else
+    {
+      compute( model, alt, horizon );
+
+      m_model = model;
+      m_modelValid = true;
+      m_horizon = horizon;
+    }
+
+  // Only the entries inside of the lookahead time are reported.
+  m_incursions.clear();
+
+  for( int i = 0; i < m_entries.size() && m_entries.at(i).timeToEntry <= horizon; i++ )
+    {
+      m_incursions.append( m_entries.at(i) );
+    }
+
+  if( before.size() != m_incursions.size() )
+    {
+      return true;
+    }
+
+  for( int i = 0; i < m_incursions.size(); i++ )
+    {
+      if( ! before.contains( m_incursions.at(i).airspace ) )
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
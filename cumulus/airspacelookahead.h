@@ -0,0 +1,208 @@
+/***********************************************************************
+**
+**   airspacelookahead.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class AirspaceLookahead
+ *
+ * \author agent
+ *
+ * \brief Prediction of airspace entries along the extrapolated track.
+ *
+ * The track is extrapolated from the flight samples of the \ref Calculator
+ * with the current ground speed, turn rate and climb rate. The predicted
+ * path is checked in steps of one second against the airspaces of the
+ * spatial airspace index, laterally with the WGS84 polygons and vertically
+ * with the predicted altitude. For every airspace, which is entered during
+ * the lookahead time, the time to the entry is reported.
+ *
+ * The prediction is updated incrementally. The path is computed with a
+ * reserve beyond the lookahead time. As long as the new fix matches the
+ * path of the last computation and the lookahead time ends inside of the
+ * computed path, the known entry times are only reduced by the elapsed time.
+ * Entries of the reserve move into the lookahead time in this way. When the
+ * lookahead leaves the computed path, the path and the candidates are
+ * computed again. The airspace candidates are taken from the index with a
+ * reserve, so that they must not be queried on every fix.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef AIRSPACE_LOOKAHEAD_H
+#define AIRSPACE_LOOKAHEAD_H
+
+#include <QDateTime>
+#include <QList>
+#include <QPoint>
+#include <QVector>
+
+#include "airspace.h"
+#include "altitude.h"
+#include "calculator.h"
+#include "limitedlist.h"
+
+class AirspaceLookahead
+{
+ public:
+
+  /**
+   * A predicted entry into an airspace.
+   */
+  class Incursion
+  {
+   public:
+
+    Incursion() : airspace(0), timeToEntry(0) {};
+
+    /** The entered airspace. */
+    Airspace* airspace;
+
+    /** Seconds until the entry. */
+    int timeToEntry;
+
+    /** Predicted entry position in KFLog WGS84 coordinates. */
+    QPoint position;
+  };
+
+  AirspaceLookahead();
+
+  virtual ~AirspaceLookahead();
+
+  /**
+   * Forgets all predictions and candidates. Must be called, if the airspace
+   * list has been changed.
+   */
+  void reset();
+
+  /**
+   * Updates the prediction with the newest flight sample.
+   *
+   * \param samples The flight samples of the calculator, the newest first.
+   *
+   * \param alt The current altitudes.
+   *
+   * \param horizon Lookahead time in seconds.
+   *
+   * \return True, if the list of entered airspaces has been changed.
+   */
+  bool update( const LimitedList<FlightSample>& samples,
+               const AltitudeCollection& alt,
+               const int horizon );
+
+  /**
+   * \return The predicted entries, sorted by the time to the entry.
+   */
+  const QList<Incursion>& getIncursions() const
+  {
+    return m_incursions;
+  };
+
+ private:
+
+  /**
+   * Movement derived from the flight samples.
+   */
+  class TrackModel
+  {
+   public:
+
+    TrackModel() : speed(0.0), heading(0.0), turnRate(0.0), climb(0.0) {};
+
+    QPoint    position;
+    QDateTime time;
+
+    /** Ground speed in m/s. */
+    double speed;
+
+    /** True track in degrees. */
+    double heading;
+
+    /** Turn rate in degrees per second, positive is clockwise. */
+    double turnRate;
+
+    /** Climb rate in m/s. */
+    double climb;
+  };
+
+  /**
+   * Derives the track model from the flight samples.
+   *
+   * \return False, if the samples are not sufficient.
+   */
+  bool createModel( const LimitedList<FlightSample>& samples,
+                    TrackModel& model ) const;
+
+  /**
+   * Moves the model along its track for the passed seconds.
+   */
+  static void advance( const TrackModel& model,
+                       const double seconds,
+                       TrackModel& result );
+
+  /**
+   * Checks, if the new model follows the path of the model, which was
+   * used for the last full computation, and if its lookahead ends inside
+   * of the computed path.
+   */
+  bool followsModel( const TrackModel& model ) const;
+
+  /**
+   * Fetches the airspace candidates from the spatial index, if the
+   * cached ones do not cover the lookahead distance.
+   */
+  void updateCandidates( const QPoint& position, const double radiusMeters );
+
+  /**
+   * Computes the entries along the whole path of the model inclusive of
+   * the reserve.
+   */
+  void compute( const TrackModel& model,
+                const AltitudeCollection& alt,
+                const int horizon );
+
+  /** Model of the last full computation. */
+  TrackModel m_model;
+
+  /** True, if m_model is valid. */
+  bool m_modelValid;
+
+  /** Lookahead time of the last full computation. */
+  int m_horizon;
+
+  /** Length in seconds of the path of the last full computation. */
+  int m_pathTime;
+
+  /** Indexes of the candidates in the airspace list. */
+  QVector<int> m_candidates;
+
+  /** Center and radius in meters of the candidate query. */
+  QPoint m_candidateCenter;
+  double m_candidateRadius;
+
+  /** Entries inside of the lookahead time. */
+  QList<Incursion> m_incursions;
+
+  /** All entries along the computed path inclusive of the reserve. */
+  QList<Incursion> m_entries;
+
+  /** Entry times of m_entries in seconds after the time of m_model. */
+  QList<double> m_entryOffsets;
+
+  /** Generation of the airspace list, to which the candidates refer. */
+  uint m_generation;
+};
+
+#endif
@@ -0,0 +1,320 @@
+/***********************************************************************
+**
+**   airspaceprofile.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore>
+
+#include "airspaceconflict.h"
+#include "airspaceprofile.h"
+#include "generalconfig.h"
+#include "mapcontents.h"
+
+extern MapContents* _globalMapContents;
+
+const float AirspaceProfile::Ceiling = static_cast<float> (HUGE_VAL);
+
+AirspaceProfile::AirspaceProfile() :
+  m_sinTrack(0.0),
+  m_cosTrack(1.0),
+  m_range(0.0),
+  m_step(0.0),
+  m_stdOffset(0.0)
+{
+}
+
+AirspaceProfile::~AirspaceProfile()
+{
+}
+
+void AirspaceProfile::clear()
+{
+  m_range = 0.0;
+  m_step = 0.0;
+  m_terrain.clear();
+  m_slices.clear();
+  m_distances.clear();
+  m_lowerLimits.clear();
+  m_upperLimits.clear();
+}
+
+void AirspaceProfile::compute( const QPoint& position,
+                               const double track,
+                               const double range,
+                               const AltitudeCollection& alt,
+                               const int samples )
+{
+  clear();
+
+  if( range <= 0.0 || samples < 1 )
+    {
+      return;
+    }
+
+  m_position  = position;
+  m_sinTrack  = sin( track * M_PI / 180.0 );
+  m_cosTrack  = cos( track * M_PI / 180.0 );
+  m_range     = range;
+  m_step      = range / samples;
+  m_stdOffset = alt.gpsAltitude.getMeters() - alt.stdAltitude.getMeters();
+
+  const double mpu = AirspaceConflict::metersPerUnit();
+  const double cosLat = qMax( 0.01, cos( position.x() / 600000.0 * M_PI / 180.0 ) );
+
+  // Terrain samples along the track line
+  m_terrain.resize( samples + 1 );
+
+  QPoint end;
+
+  for( int i = 0; i <= samples; i++ )
+    {
+      const double d = i * m_step;
+
+      end = QPoint( position.x() + (int) rint( d * m_cosTrack / mpu ),
+                    position.y() + (int) rint( d * m_sinTrack / (mpu * cosLat) ) );
+
+      m_terrain[i] = (short) _globalMapContents->findElevation( end );
+    }
+
+  // Airspaces, whose boxes touch the box of the track line
+  QRect lineBox = QRect( position, end ).normalized().adjusted( -1, -1, 1, 1 );
+
+  _globalMapContents->getSpatialIndex( MapContents::AirspaceList )
+      .queryViewport( lineBox, m_candidates );
+
+  SortableAirspaceList* asList = _globalMapContents->getAirspaceList();
+  GeneralConfig* conf = GeneralConfig::instance();
+
+  for( int i = 0; i < m_candidates.size(); i++ )
+    {
+      if( m_candidates.at(i) >= asList->size() )
+        {
+          continue;
+        }
+
+      Airspace* as = asList->at( m_candidates.at(i) );
+
+      if( as->getTypeID() == BaseMapElement::AirFir ||
+          conf->getItemDrawingEnabled( as->getTypeID() ) == false ||
+          as->getWgsBoundingBox().intersects( lineBox ) == false )
+        {
+          continue;
+        }
+
+      intersect( as );
+    }
+}
+
+void AirspaceProfile::intersect( Airspace* as )
+{
+  const QPolygon& polygon = as->getWgsPolygon();
+  const int count = polygon.size();
+
+  if( count < 3 )
+    {
+      return;
+    }
+
+  // Local metric plane with the current position as origin. The u axis
+  // points along the track, the v axis to the right of it.
+  const double latScale = AirspaceConflict::metersPerUnit();
+  const double lonScale = latScale * cos( m_position.x() / 600000.0 * M_PI / 180.0 );
+
+  m_crossings.clear();
+
+  const QPoint& last = polygon.at( count - 1 );
+
+  double x = (last.y() - m_position.y()) * lonScale;
+  double y = (last.x() - m_position.x()) * latScale;
+
+  double au = x * m_sinTrack + y * m_cosTrack;
+  double av = x * m_cosTrack - y * m_sinTrack;
+
+  for( int i = 0; i < count; i++ )
+    {
+      const QPoint& point = polygon.at(i);
+
+      x = (point.y() - m_position.y()) * lonScale;
+      y = (point.x() - m_position.x()) * latScale;
+
+      const double bu = x * m_sinTrack + y * m_cosTrack;
+      const double bv = x * m_cosTrack - y * m_sinTrack;
+
+      if( (av > 0.0) != (bv > 0.0) )
+        {
+          // The edge crosses the line of the track.
+          m_crossings.append( au + (0.0 - av) * (bu - au) / (bv - av) );
+        }
+
+      au = bu;
+      av = bv;
+    }
+
+  if( m_crossings.isEmpty() )
+    {
+      return;
+    }
+
+  std::sort( m_crossings.begin(), m_crossings.end() );
+
+  // The current position is inside, if an odd number of crossings lies
+  // ahead of it.
+  int ahead = 0;
+
+  for( int i = 0; i < m_crossings.size(); i++ )
+    {
+      if( m_crossings.at(i) > 0.0 )
+        {
+          ahead++;
+        }
+    }
+
+  bool inside = (ahead % 2) == 1;
+  double begin = 0.0;
+
+  for( int i = 0; i < m_crossings.size(); i++ )
+    {
+      const double u = m_crossings.at(i);
+
+      if( u <= 0.0 )
+        {
+          continue;
+        }
+
+      if( u >= m_range )
+        {
+          break;
+        }
+
+      if( inside )
+        {
+          addSlice( as, begin, u );
+        }
+      else
+        {
+          begin = u;
+        }
+
+      inside = ! inside;
+    }
+
+  if( inside )
+    {
+      addSlice( as, begin, m_range );
+    }
+}
+
+void AirspaceProfile::addSlice( Airspace* as, const double begin, const double end )
+{
+  if( end <= begin )
+    {
+      return;
+    }
+
+  const BaseMapElement::elevationType lType = as->getLowerT();
+  const BaseMapElement::elevationType uType = as->getUpperT();
+  const double lower = as->getLowerAltitude().getMeters();
+  const double upper = as->getUpperAltitude().getMeters();
+
+  Slice slice;
+  slice.airspace = as;
+  slice.begin = begin;
+  slice.end = end;
+  slice.first = m_distances.size();
+
+  // Limits above ground follow the terrain, then every covered terrain
+  // sample gets a vertex.
+  const bool followsTerrain = (lType == BaseMapElement::GND ||
+                               uType == BaseMapElement::GND);
+
+  double d = begin;
+  int sample = (int) floor( begin / m_step ) + 1;
+
+  while( true )
+    {
+      const double terrain = terrainAt( d );
+
+      m_distances.append( d );
+      m_lowerLimits.append( limitToMsl( lType, lower, terrain, false ) );
+      m_upperLimits.append( limitToMsl( uType, upper, terrain, true ) );
+
+      if( d >= end )
+        {
+          break;
+        }
+
+      if( followsTerrain && sample * m_step < end )
+        {
+          d = sample * m_step;
+          sample++;
+        }
+      else
+        {
+          d = end;
+        }
+    }
+
+  slice.count = m_distances.size() - slice.first;
+  m_slices.append( slice );
+}
+
+double AirspaceProfile::terrainAt( const double distance ) const
+{
+  if( m_terrain.isEmpty() )
+    {
+      return 0.0;
+    }
+
+  const double pos = distance / m_step;
+  const int i = qBound( 0, (int) floor( pos ), m_terrain.size() - 1 );
+
+  if( i == m_terrain.size() - 1 )
+    {
+      return m_terrain.at(i);
+    }
+
+  const double t = qBound( 0.0, pos - i, 1.0 );
+
+  return m_terrain.at(i) * (1.0 - t) + m_terrain.at(i + 1) * t;
+}
+
+double AirspaceProfile::limitToMsl( const BaseMapElement::elevationType type,
+                                    const double meters,
+                                    const double terrain,
+                                    const bool upper ) const
+{
+  switch( type )
+    {
+      case BaseMapElement::GND:
+        return meters + terrain;
+
+      case BaseMapElement::FL:
+      case BaseMapElement::STD:
+        // Flight levels are pressure altitudes.
+        return meters + m_stdOffset;
+
+      case BaseMapElement::MSL:
+        return meters;
+
+      case BaseMapElement::UNLTD:
+        return Ceiling;
+
+      default:
+        // A missing upper limit does not limit the airspace, a missing
+        // lower limit is the ground.
+        return upper ? Ceiling : terrain;
+    }
+}
@@ -0,0 +1,226 @@
+/***********************************************************************
+**
+**   airspaceprofile.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class AirspaceProfile
+ *
+ * \author agent
+ *
+ * \brief Vertical airspace profile along the current track.
+ *
+ * The profile is a side view of the airspaces and of the terrain along a
+ * straight line, which starts at the current position and follows the
+ * current track over the passed distance.
+ *
+ * The airspaces are taken from the spatial airspace index. The track line
+ * is intersected with their WGS84 polygons in a local metric plane, that
+ * gives the exact distances, where the line enters and leaves an airspace.
+ * For every part of the line inside of an airspace a \ref Slice is
+ * created. Its vertical limits are converted to meters above MSL. Flight
+ * levels are shifted by the difference between the GPS and the standard
+ * pressure altitude, GND limits are raised by the terrain elevation.
+ *
+ * The result is stored in flat arrays, so that a profile widget can draw
+ * it without further geometry work. The vertices of a slice are stored
+ * in the arrays \ref getDistances, \ref getLowerLimits and
+ * \ref getUpperLimits. A slice with MSL and FL limits has only two
+ * vertices, at its begin and at its end. A slice with a GND limit has
+ * additionally a vertex at every terrain sample, which it covers.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef AIRSPACE_PROFILE_H
+#define AIRSPACE_PROFILE_H
+
+#include <QPoint>
+#include <QVector>
+
+#include "airspace.h"
+#include "altitude.h"
+
+class AirspaceProfile
+{
+ public:
+
+  /**
+   * Part of the track line inside of an airspace.
+   */
+  class Slice
+  {
+   public:
+
+    Slice() : airspace(0), begin(0.0), end(0.0), first(0), count(0) {};
+
+    /** The crossed airspace. */
+    Airspace* airspace;
+
+    /** Distances in meters from the current position. */
+    float begin;
+    float end;
+
+    /** Index and number of the vertices of the slice. */
+    int first;
+    int count;
+  };
+
+  /**
+   * Upper limit in meters MSL of an unlimited airspace. Like
+   * AirspaceLimitTable::normalizedUpper it lies above every altitude, a
+   * profile widget has to clip it at its top.
+   */
+  static const float Ceiling;
+
+  AirspaceProfile();
+
+  virtual ~AirspaceProfile();
+
+  /**
+   * Removes the last computed profile.
+   */
+  void clear();
+
+  /**
+   * Computes the profile along the track line.
+   *
+   * \param position Current position in KFLog WGS84 coordinates.
+   *
+   * \param track True track in degrees.
+   *
+   * \param range Length of the track line in meters.
+   *
+   * \param alt The current altitudes, used for the conversion of flight
+   *            levels.
+   *
+   * \param samples Number of terrain samples along the track line.
+   */
+  void compute( const QPoint& position,
+                const double track,
+                const double range,
+                const AltitudeCollection& alt,
+                const int samples=100 );
+
+  /**
+   * \return Length of the track line in meters.
+   */
+  double getRange() const
+  {
+    return m_range;
+  };
+
+  /**
+   * \return Distance in meters between two terrain samples.
+   */
+  double getStep() const
+  {
+    return m_step;
+  };
+
+  /**
+   * \return Terrain elevations in meters, the first one is at the current
+   *         position, the following ones in steps of \ref getStep.
+   */
+  const QVector<short>& getTerrain() const
+  {
+    return m_terrain;
+  };
+
+  /**
+   * \return The airspace slices in drawing order, the lower airspaces
+   *         first.
+   */
+  const QVector<Slice>& getSlices() const
+  {
+    return m_slices;
+  };
+
+  /**
+   * \return Distances in meters of the slice vertices.
+   */
+  const QVector<float>& getDistances() const
+  {
+    return m_distances;
+  };
+
+  /**
+   * \return Lower limits in meters MSL of the slice vertices.
+   */
+  const QVector<float>& getLowerLimits() const
+  {
+    return m_lowerLimits;
+  };
+
+  /**
+   * \return Upper limits in meters MSL of the slice vertices.
+   */
+  const QVector<float>& getUpperLimits() const
+  {
+    return m_upperLimits;
+  };
+
+ private:
+
+  /**
+   * Computes the distances along the track line, where it crosses the
+   * polygon of the airspace, and appends a slice for every part inside.
+   */
+  void intersect( Airspace* as );
+
+  /**
+   * Appends a slice with its vertices.
+   */
+  void addSlice( Airspace* as, const double begin, const double end );
+
+  /**
+   * Returns the terrain elevation at the passed distance, interpolated
+   * between the terrain samples.
+   */
+  double terrainAt( const double distance ) const;
+
+  /**
+   * Converts an airspace limit to meters MSL. An unlimited respectively a
+   * missing upper limit is converted to \ref Ceiling.
+   */
+  double limitToMsl( const BaseMapElement::elevationType type,
+                     const double meters,
+                     const double terrain,
+                     const bool upper ) const;
+
+  QPoint m_position;
+
+  /** Sine and cosine of the track. */
+  double m_sinTrack;
+  double m_cosTrack;
+
+  double m_range;
+  double m_step;
+
+  /** Difference between GPS and standard pressure altitude in meters. */
+  double m_stdOffset;
+
+  QVector<short> m_terrain;
+  QVector<Slice> m_slices;
+  QVector<float> m_distances;
+  QVector<float> m_lowerLimits;
+  QVector<float> m_upperLimits;
+
+  /** Reused buffers of the computation. */
+  QVector<int>    m_candidates;
+  QVector<double> m_crossings;
+};
+
+#endif
@@ -0,0 +1,305 @@
+/***********************************************************************
+**
+**   airspaceprofiledialog.cpp
+**
+**   This file is part of Cumulus
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cmath>
+
+#ifndef QT_5
+#include <QtGui>
+#else
+#include <QtWidgets>
+#endif
+
+#include "airspaceprofiledialog.h"
+#include "calculator.h"
+#include "distance.h"
+#include "layout.h"
+#include "mainwindow.h"
+#include "mapconfig.h"
+
+extern MapConfig* _globalMapConfig;
+
+// initialize static member variable
+int AirspaceProfileDialog::noOfInstances = 0;
+
+AirspaceProfileDialog::AirspaceProfileDialog( QWidget *parent ) :
+  QWidget( parent )
+{
+  noOfInstances++;
+
+  setWindowTitle(tr("Airspace Profile"));
+  setWindowFlags( Qt::Tool );
+  setWindowModality( Qt::WindowModal );
+  setAttribute(Qt::WA_DeleteOnClose);
+
+  if( _globalMainWindow )
+    {
+      // Resize the window to the same size as the main window has. That will
+      // completely hide the parent window.
+      resize( _globalMainWindow->size() );
+    }
+
+  uTimer = new QTimer( this );
+  uTimer->setSingleShot( true );
+
+  connect( uTimer, SIGNAL(timeout()), this, SLOT(slot_updateProfile()) );
+
+  display = new AirspaceProfileDisplay( this );
+
+  rangeBox = new QComboBox;
+  rangeBox->setToolTip( tr("Profile range") );
+
+  // The ranges are stored in meters as item data.
+  const double ranges[] = { 10000.0, 25000.0, 50000.0 };
+
+  for( uint i = 0; i < sizeof(ranges) / sizeof(ranges[0]); i++ )
+    {
+      rangeBox->addItem( Distance::getText( ranges[i], true, 0 ), ranges[i] );
+    }
+
+  rangeBox->setCurrentIndex( 1 );
+
+  QPushButton* close = new QPushButton( tr("Close"), this );
+
+  QVBoxLayout* buttonBox = new QVBoxLayout;
+  buttonBox->addWidget( rangeBox );
+  buttonBox->addStretch( 5 );
+  buttonBox->addWidget( close );
+
+  QHBoxLayout* topLayout = new QHBoxLayout( this );
+  topLayout->addWidget( display, 1 );
+  topLayout->addLayout( buttonBox );
+
+  connect( rangeBox, SIGNAL(currentIndexChanged(int)),
+           SLOT(slot_RangeChanged(int)) );
+
+  connect( calculator, SIGNAL(newPosition(const QPoint&, const int)),
+           this, SLOT(slot_Position(const QPoint&, const int)) );
+
+  connect( close, SIGNAL(clicked()), this, SLOT(slot_Close()) );
+
+  slot_updateProfile();
+}
+
+AirspaceProfileDialog::~AirspaceProfileDialog()
+{
+  noOfInstances--;
+}
+
+void AirspaceProfileDialog::slot_Position( const QPoint& /* position */,
+                                           const int /* source */ )
+{
+  // To reduce the load the profile is computed only if the timer has
+  // expired.
+  if( ! uTimer->isActive() )
+    {
+      uTimer->start( 1000 );
+    }
+}
+
+void AirspaceProfileDialog::slot_RangeChanged( int /* index */ )
+{
+  uTimer->stop();
+  slot_updateProfile();
+}
+
+void AirspaceProfileDialog::slot_updateProfile()
+{
+  double range = rangeBox->itemData( rangeBox->currentIndex() ).toDouble();
+
+  display->setProfile( calculator->getlastPosition(),
+                       calculator->getlastHeading(),
+                       range,
+                       calculator->getAltitudeCollection() );
+}
+
+void AirspaceProfileDialog::slot_Close()
+{
+  emit closingWidget();
+  close();
+}
+
+void AirspaceProfileDialog::keyReleaseEvent( QKeyEvent *event )
+{
+  // close the dialog on key press
+  switch(event->key())
+    {
+      case Qt::Key_Close:
+      case Qt::Key_Escape:
+        emit closingWidget();
+        close();
+        break;
+      default:
+        QWidget::keyReleaseEvent( event );
+        break;
+    }
+}
+
+/*************************************************************************************/
+
+AirspaceProfileDisplay::AirspaceProfileDisplay( QWidget *parent ) :
+  QFrame( parent ),
+  altitude( 0.0 )
+{
+  setFrameStyle(StyledPanel | QFrame::Plain);
+  setLineWidth(2);
+  setMidLineWidth(2);
+}
+
+AirspaceProfileDisplay::~AirspaceProfileDisplay()
+{
+}
+
+void AirspaceProfileDisplay::setProfile( const QPoint& position,
+                                         const double track,
+                                         const double range,
+                                         const AltitudeCollection& alt )
+{
+  altitude = alt.gpsAltitude.getMeters();
+
+  if( track < 0.0 )
+    {
+      // No valid track available.
+      profile.clear();
+    }
+  else
+    {
+      profile.compute( position, track, range, alt );
+    }
+
+  update();
+}
+
+void AirspaceProfileDisplay::paintEvent( QPaintEvent *event )
+{
+  // Call paint method from QFrame otherwise the frame is not drawn.
+  QFrame::paintEvent( event );
+
+  const QRect cr = contentsRect();
+
+  QPainter pw(this);
+
+  pw.fillRect( cr, QColor( 210, 230, 255 ) );
+
+  const QVector<short>& terrain = profile.getTerrain();
+
+  if( terrain.isEmpty() || profile.getRange() <= 0.0 )
+    {
+      pw.drawText( cr, Qt::AlignCenter, tr("No Data") );
+      return;
+    }
+
+  // The vertical scale covers the terrain and the current altitude with
+  // a margin on top, rounded up to 500m.
+  double top = altitude;
+
+  for( int i = 0; i < terrain.size(); i++ )
+    {
+      top = qMax( top, (double) terrain.at(i) );
+    }
+
+  top = ceil( (top + 1000.0) / 500.0 ) * 500.0;
+
+  const double xScale = cr.width() / profile.getRange();
+  const double yScale = cr.height() / top;
+
+  pw.setClipRect( cr );
+  pw.translate( cr.left(), cr.bottom() );
+  pw.setRenderHint( QPainter::Antialiasing, true );
+
+  // Unlimited airspace borders lie above the drawing area and are clipped.
+  const double yMin = -top * yScale - 2.0;
+
+  // Airspaces, the lower ones first
+  const QVector<AirspaceProfile::Slice>& slices = profile.getSlices();
+  const QVector<float>& distances = profile.getDistances();
+  const QVector<float>& lower = profile.getLowerLimits();
+  const QVector<float>& upper = profile.getUpperLimits();
+
+  for( int i = 0; i < slices.size(); i++ )
+    {
+      const AirspaceProfile::Slice& slice = slices.at(i);
+
+      QPolygonF polygon;
+
+      for( int j = slice.first; j < slice.first + slice.count; j++ )
+        {
+          polygon.append( QPointF( distances.at(j) * xScale,
+                                   qMax( yMin, -upper.at(j) * yScale ) ) );
+        }
+
+      for( int j = slice.first + slice.count - 1; j >= slice.first; j-- )
+        {
+          polygon.append( QPointF( distances.at(j) * xScale,
+                                   qMax( yMin, -lower.at(j) * yScale ) ) );
+        }
+
+      const int typeID = slice.airspace->getTypeID();
+
+      QBrush brush = _globalMapConfig->getDrawBrush( typeID );
+      brush.setStyle( Qt::SolidPattern );
+
+      QColor color = brush.color();
+      color.setAlpha( 100 );
+      brush.setColor( color );
+
+      QPen pen = _globalMapConfig->getDrawPen( typeID );
+      pen.setWidth( 2 );
+
+      pw.setPen( pen );
+      pw.setBrush( brush );
+      pw.drawPolygon( polygon );
+    }
+
+  // Terrain
+  QPolygonF ground;
+  ground.append( QPointF( 0.0, 0.0 ) );
+
+  for( int i = 0; i < terrain.size(); i++ )
+    {
+      ground.append( QPointF( i * profile.getStep() * xScale,
+                              -terrain.at(i) * yScale ) );
+    }
+
+  ground.append( QPointF( cr.width(), 0.0 ) );
+
+  pw.setPen( QPen( QColor( 100, 70, 30 ), 1 ) );
+  pw.setBrush( QColor( 170, 130, 80 ) );
+  pw.drawPolygon( ground );
+
+  // Current altitude
+  const double y = -altitude * yScale;
+
+  pw.setPen( QPen( Qt::black, 1, Qt::DashLine ) );
+  pw.drawLine( QPointF( 0.0, y ), QPointF( cr.width(), y ) );
+
+  const double s = 5.0 * Layout::getIntScaledDensity();
+
+  QPolygonF glider;
+  glider.append( QPointF( 0.0, y - s ) );
+  glider.append( QPointF( 2.0 * s, y ) );
+  glider.append( QPointF( 0.0, y + s ) );
+
+  pw.setPen( QPen( Qt::black, 1 ) );
+  pw.setBrush( Qt::black );
+  pw.drawPolygon( glider );
+
+  // Scale labels
+  pw.resetTransform();
+  pw.setPen( Qt::black );
+  pw.drawText( cr.adjusted( 5, 5, -5, -5 ), Qt::AlignTop | Qt::AlignLeft,
+               Altitude::getText( top, true, 0 ) );
+  pw.drawText( cr.adjusted( 5, 5, -5, -5 ), Qt::AlignBottom | Qt::AlignRight,
+               Distance::getText( profile.getRange(), true, 0 ) );
+}
@@ -0,0 +1,163 @@
+/***********************************************************************
+**
+**   airspaceprofiledialog.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class AirspaceProfileDialog
+ *
+ * \author agent
+ *
+ * \brief Widget displaying the airspace profile along the current track.
+ *
+ * The dialog shows a side view of the terrain and of the airspaces ahead
+ * of the glider together with its current altitude. The profile is
+ * computed by \ref AirspaceProfile, when the position changes, at most
+ * once per second.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef AIRSPACE_PROFILE_DIALOG_H
+#define AIRSPACE_PROFILE_DIALOG_H
+
+#include <QWidget>
+#include <QFrame>
+#include <QKeyEvent>
+#include <QPoint>
+
+#include "airspaceprofile.h"
+
+class QComboBox;
+class QTimer;
+
+class AirspaceProfileDisplay;
+
+class AirspaceProfileDialog : public QWidget
+{
+  Q_OBJECT
+
+private:
+
+  /**
+   * That macro forbids the copy constructor and the assignment operator.
+   */
+  Q_DISABLE_COPY( AirspaceProfileDialog )
+
+public:
+
+  /**
+   * Constructor
+   * @param parent Pointer to parent widget
+   */
+  AirspaceProfileDialog( QWidget *parent );
+
+  /**
+   * Destructor
+   */
+  virtual ~AirspaceProfileDialog();
+
+  /**
+   * @return Returns the current number of instances.
+   */
+  static int getNrOfInstances()
+  {
+    return noOfInstances;
+  };
+
+  void keyReleaseEvent( QKeyEvent *event );
+
+private slots:
+
+  /**
+   * Called if a new position is available.
+   */
+  void slot_Position( const QPoint& position, const int source );
+
+  /**
+   * Called, when the range in the combobox was changed.
+   */
+  void slot_RangeChanged( int index );
+
+  /**
+   * Called to recompute the profile.
+   */
+  void slot_updateProfile();
+
+  /**
+   * Called if close button is pressed.
+   */
+  void slot_Close();
+
+signals:
+
+  /**
+   * This signal is emitted, when the dialog is closed
+   */
+  void closingWidget();
+
+private:
+
+  AirspaceProfileDisplay *display;
+  QComboBox              *rangeBox;
+
+  /** Profile update timer. */
+  QTimer *uTimer;
+
+  /** contains the current number of class instances */
+  static int noOfInstances;
+};
+
+/**
+ * Draws the computed airspace profile.
+ */
+class AirspaceProfileDisplay : public QFrame
+{
+  Q_OBJECT
+
+private:
+
+  /**
+   * That macro forbids the copy constructor and the assignment operator.
+   */
+  Q_DISABLE_COPY( AirspaceProfileDisplay )
+
+public:
+
+  AirspaceProfileDisplay( QWidget *parent );
+
+  virtual ~AirspaceProfileDisplay();
+
+  /**
+   * Computes the profile ahead of the passed position and redraws it.
+   */
+  void setProfile( const QPoint& position,
+                   const double track,
+                   const double range,
+                   const AltitudeCollection& alt );
+
+protected:
+
+  void paintEvent( QPaintEvent *event );
+
+private:
+
+  AirspaceProfile profile;
+
+  /** Current altitude in meters MSL. */
+  double altitude;
+};
+
+#endif
@@ -120,28 +120,19 @@ class GpsStatusEvent : public QEvent
     int m_status;
 };
 
-/* Posted by the native method "gpsNmeaString" which is called from Java object
- * LocationListener, method "onNmeaReceived"
+/* Posted by GpsConAndroid::forwardNmea, if new NMEA sentences are available
+ * in the ingest queue. The sentences are received from the Java object
+ * LocationListener, method "onNmeaReceived", or from the GPS port.
  */
 class GpsNmeaEvent : public QEvent
 {
   public:
 
-    GpsNmeaEvent( const QString& nmeaSentence ) :
-      QEvent( (QEvent::Type)(QEvent::User + 2) ),
-      m_nmeaSentence(nmeaSentence)
+    GpsNmeaEvent() :
+      QEvent( (QEvent::Type)(QEvent::User + 2) )
     {};
 
     virtual ~GpsNmeaEvent() {};
-
-    QString& sentence()
-      {
-         return m_nmeaSentence;
-      };
-
-  private:
-
-    QString m_nmeaSentence;
 };
 
 class FlarmFlightListEvent : public QEvent
@@ -189,21 +189,84 @@ const AltitudeCollection& Calculator::getAltitudeCollection()
   return lastAltCollection;
 }
 
-/** called on altitude change */
-void Calculator::slot_Altitude(Altitude& user, Altitude& std, Altitude& gnns)
+/** Called once per GNSS epoch. */
+void Calculator::slot_Epoch( const GnssEpoch& epoch )
 {
-  lastAltitude         = user;
-  lastSTDAltitude      = std;
-  lastGNSSAltitude     = gnns;
-  lastAGLAltitude      = lastAltitude - lastElevation;
-  lastAGLAltitudeError = lastElevationError;
-
-  lastAHLAltitude  = lastAltitude - GeneralConfig::instance()->getHomeElevation();
-  emit newAltitude( lastAltitude );
-  emit newUserAltitude( getAltimeterAltitude() );
+  const uint items = epoch.items;
 
-  calcGlidePath();
-  calcAltitudeGain();
+  // Take over all changed items of the epoch before anything is derived
+  // from them.
+  if( items & GnssEpoch::Speed )
+    {
+      lastSpeed = epoch.speed;
+      emit newSpeed( lastSpeed );
+    }
+
+  if( items & GnssEpoch::Heading )
+    {
+      // The speed of the epoch is already set.
+      slot_Heading( epoch.heading );
+    }
+
+  if( items & GnssEpoch::Position )
+    {
+      lastGPSPosition = epoch.position;
+
+      if( ! m_manualInFlight )
+        {
+          lastPosition = lastGPSPosition;
+        }
+
+      lastElevation = Altitude( _globalMapContents->findElevation(lastPosition, &lastElevationError) );
+    }
+
+  if( items & GnssEpoch::Altitude )
+    {
+      lastAltitude     = epoch.mslAltitude;
+      lastSTDAltitude  = epoch.stdAltitude;
+      lastGNSSAltitude = epoch.gnssAltitude;
+    }
+
+  if( items & (GnssEpoch::Position | GnssEpoch::Altitude) )
+    {
+      lastAGLAltitude      = lastAltitude - lastElevation;
+      lastAGLAltitudeError = lastElevationError;
+      lastAHLAltitude      = lastAltitude - GeneralConfig::instance()->getHomeElevation();
+    }
+
+  // Now the derived values are calculated once.
+  if( items & GnssEpoch::Altitude )
+    {
+      emit newAltitude( lastAltitude );
+      emit newUserAltitude( getAltimeterAltitude() );
+      calcAltitudeGain();
+    }
+
+  if( items & GnssEpoch::Position )
+    {
+      emit newPosition(lastGPSPosition, Calculator::GPS);
+      calcDistance();
+      calcBearing();
+      calcETA();
+      calcTas();
+    }
+
+  if( items & (GnssEpoch::Position | GnssEpoch::Altitude) )
+    {
+      calcGlidePath();
+    }
+
+  if( items & GnssEpoch::Position )
+    {
+      // Calculate List of reachable items
+      m_reachablelist->calculate(false);
+    }
+
+  if( items & GnssEpoch::Fix )
+    {
+      // The sample gets all values of the epoch.
+      slot_newFix( epoch.utc );
+    }
 }
 
 /** Called if a new heading has been obtained */
@@ -232,13 +295,6 @@ void Calculator::slot_Heading( const double& newHeadingValue )
   emit newRelBearing (lastBearing - lastHeading);
 }
 
-/** called if a new speed fix has been received */
-void Calculator::slot_Speed( Speed& newSpeedValue )
-{
-  lastSpeed = newSpeedValue;
-  emit newSpeed(newSpeedValue);
-}
-
 /** called if a new position-fix has been established. */
 void Calculator::slot_Position( QPoint& newPositionValue )
 {
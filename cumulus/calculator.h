@@ -30,6 +30,7 @@
 #include "flighttask.h"
 #include "generalconfig.h"
 #include "glider.h"
+#include "gnssepoch.h"
 #include "gpsnmea.h"
 #include "limitedlist.h"
 #include "polar.h"
@@ -505,13 +506,10 @@ public:
   void slot_Position( QPoint& newPosition );
 
   /**
-   * called if a new speed fix has been received
+   * Called once per GNSS epoch. All changed items of the epoch are taken
+   * over first, then the derived values are calculated.
    */
-  void slot_Speed( Speed& newSpeed );
-  /**
-   * called on altitude change
-   */
-  void slot_Altitude(Altitude& user, Altitude& std, Altitude& gnns);
+  void slot_Epoch( const GnssEpoch& epoch );
   /**
    * Called if the position is changed manually.
    */
@@ -0,0 +1,504 @@
+/***********************************************************************
+**
+**   compiledmapfile.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <QtCore>
+
+#include "compiledmapfile.h"
+#include "mapcalc.h"
+#include "mapmatrix.h"
+#include "resource.h"
+
+namespace
+{
+  void appendU16( QByteArray& data, const quint16 value )
+  {
+    uchar buffer[2];
+    qToLittleEndian( value, buffer );
+    data.append( reinterpret_cast<const char *> (buffer), 2 );
+  }
+
+  void appendU32( QByteArray& data, const quint32 value )
+  {
+    uchar buffer[4];
+    qToLittleEndian( value, buffer );
+    data.append( reinterpret_cast<const char *> (buffer), 4 );
+  }
+
+  /** Appends a signed value zigzag encoded as variable length integer. */
+  void appendVarint( QByteArray& data, const qint32 value )
+  {
+    quint32 v = ( quint32(value) << 1 ) ^ quint32( value >> 31 );
+
+    while( v >= 0x80 )
+      {
+        data.append( char( (v & 0x7f) | 0x80 ) );
+        v >>= 7;
+      }
+
+    data.append( char( v ) );
+  }
+
+  /** Reads a zigzag encoded variable length integer. */
+  bool readVarint( const uchar*& p, const uchar* end, qint32& value )
+  {
+    quint32 v = 0;
+
+    for( int shift = 0; shift < 35; shift += 7 )
+      {
+        if( p >= end )
+          {
+            return false;
+          }
+
+        const uchar byte = *p++;
+
+        v |= quint32( byte & 0x7f ) << shift;
+
+        if( (byte & 0x80) == 0 )
+          {
+            value = qint32( v >> 1 ) ^ -qint32( v & 1 );
+            return true;
+          }
+      }
+
+    return false;
+  }
+
+  void appendBox( QByteArray& data, const QRect& box )
+  {
+    appendU32( data, quint32( box.left() ) );
+    appendU32( data, quint32( box.top() ) );
+    appendU32( data, quint32( box.right() ) );
+    appendU32( data, quint32( box.bottom() ) );
+  }
+
+  /** Appends the points of a polygon as differences to their predecessor. */
+  void appendPoints( QByteArray& data, const QPolygon& polygon )
+  {
+    qint32 lastLat = 0;
+    qint32 lastLon = 0;
+
+    for( int i = 0; i < polygon.size(); i++ )
+      {
+        const QPoint& p = polygon.at(i);
+
+        appendVarint( data, p.x() - lastLat );
+        appendVarint( data, p.y() - lastLon );
+
+        lastLat = p.x();
+        lastLon = p.y();
+      }
+  }
+
+  /** Reads the points of a polygon written by appendPoints. */
+  bool readPoints( const uchar*& p, const uchar* end,
+                   const quint32 pointCount, QPolygon& polygon )
+  {
+    // Every point needs at least two bytes.
+    if( pointCount > quint32( end - p ) / 2 )
+      {
+        return false;
+      }
+
+    polygon.resize( pointCount );
+
+    QPoint* dst = polygon.data();
+    qint32 lat = 0;
+    qint32 lon = 0;
+
+    for( quint32 i = 0; i < pointCount; i++ )
+      {
+        qint32 dLat, dLon;
+
+        if( ! readVarint( p, end, dLat ) || ! readVarint( p, end, dLon ) )
+          {
+            return false;
+          }
+
+        lat += dLat;
+        lon += dLon;
+
+        dst[i].setX( lat );
+        dst[i].setY( lon );
+      }
+
+    return true;
+  }
+
+  QRect readBox( const uchar* p )
+  {
+    return QRect( QPoint( qFromLittleEndian<qint32>( p ),
+                          qFromLittleEndian<qint32>( p + 4 ) ),
+                  QPoint( qFromLittleEndian<qint32>( p + 8 ),
+                          qFromLittleEndian<qint32>( p + 12 ) ) );
+  }
+}
+
+CompiledMapFile::CompiledMapFile() :
+  m_data(0),
+  m_size(0),
+  m_pos(0),
+  m_end(0)
+{
+  for( int i = 0; i < SectionCount; i++ )
+    {
+      m_offset[i] = 0;
+      m_length[i] = 0;
+      m_count[i]  = 0;
+    }
+}
+
+CompiledMapFile::~CompiledMapFile()
+{
+  close();
+}
+
+bool CompiledMapFile::open( const QString& fileName,
+                            const char typeID,
+                            const quint16 formatID,
+                            const int secID )
+{
+  close();
+
+  m_file.setFileName( fileName );
+
+  if( m_file.open( QIODevice::ReadOnly ) == false )
+    {
+      return false;
+    }
+
+  m_size = m_file.size();
+
+  if( m_size < HeaderSize + SectionCount * SectionEntrySize )
+    {
+      close();
+      return false;
+    }
+
+  m_data = m_file.map( 0, m_size );
+
+  if( m_data == 0 )
+    {
+      // The file system does not support mapping, read the whole file.
+      m_buffer = m_file.readAll();
+
+      if( m_buffer.size() != m_size )
+        {
+          close();
+          return false;
+        }
+
+      m_data = reinterpret_cast<const uchar *> (m_buffer.constData());
+    }
+
+  QByteArray header = QByteArray::fromRawData( reinterpret_cast<const char *> (m_data),
+                                               HeaderSize );
+  QDataStream in( header );
+  in.setVersion( QDataStream::Qt_4_7 );
+
+  quint32 magic;
+  qint8 loadTypeID;
+  quint16 loadFormatID, loadSecID;
+
+  in >> magic;
+  in >> loadTypeID;
+  in >> loadFormatID;
+  in >> loadSecID;
+  in >> m_createDateTime;
+
+  const quint32 sections = qFromLittleEndian<quint32>( m_data + HeaderSize - 8 );
+
+  if( in.status() != QDataStream::Ok ||
+      magic != KFLOG_FILE_MAGIC ||
+      loadTypeID != typeID ||
+      loadFormatID != formatID ||
+      loadSecID != secID ||
+      sections != SectionCount )
+    {
+      close();
+      return false;
+    }
+
+  const uchar* entry = m_data + HeaderSize;
+
+  for( int i = 0; i < SectionCount; i++, entry += SectionEntrySize )
+    {
+      m_offset[i] = qFromLittleEndian<quint32>( entry );
+      m_length[i] = qFromLittleEndian<quint32>( entry + 4 );
+      m_count[i]  = qFromLittleEndian<quint32>( entry + 8 );
+      m_box[i]    = readBox( entry + 16 );
+
+      if( qint64( m_offset[i] ) + m_length[i] > m_size )
+        {
+          qWarning() << "CompiledMapFile: Section" << i << "of" << fileName
+                     << "exceeds the file size!";
+          close();
+          return false;
+        }
+    }
+
+  return true;
+}
+
+void CompiledMapFile::close()
+{
+  if( m_data != 0 && m_buffer.isEmpty() )
+    {
+      m_file.unmap( const_cast<uchar *> (m_data) );
+    }
+
+  m_data = 0;
+  m_buffer.clear();
+  m_size = 0;
+  m_pos = m_end = 0;
+
+  for( int i = 0; i < SectionCount; i++ )
+    {
+      m_offset[i] = 0;
+      m_length[i] = 0;
+      m_count[i]  = 0;
+      m_box[i]    = QRect();
+    }
+
+  if( m_file.isOpen() )
+    {
+      m_file.close();
+    }
+}
+
+void CompiledMapFile::seek( const Section section )
+{
+  m_pos = m_offset[section];
+  m_end = m_offset[section] + m_length[section];
+}
+
+bool CompiledMapFile::next( Record& record )
+{
+  if( m_data == 0 || m_pos + RecordHeaderSize > m_end )
+    {
+      return false;
+    }
+
+  const uchar* p = m_data + m_pos;
+
+  const quint32 size       = qFromLittleEndian<quint32>( p );
+  const quint16 nameSize   = qFromLittleEndian<quint16>( p + 8 );
+  const quint16 levels     = qFromLittleEndian<quint16>( p + 10 );
+  const quint32 pointCount = qFromLittleEndian<quint32>( p + 12 );
+
+  if( size < quint32( RecordHeaderSize + nameSize ) || m_pos + size > m_end )
+    {
+      qWarning( "CompiledMapFile: Corrupted record at offset %u", m_pos );
+      m_pos = m_end;
+      return false;
+    }
+
+  const uchar* end = p + size;
+
+  record.type  = p[4];
+  record.sort  = qint8( p[5] );
+  record.value = qFromLittleEndian<qint16>( p + 6 );
+  record.box   = readBox( p + 16 );
+  record.name  = QString::fromUtf8( reinterpret_cast<const char *> (p + RecordHeaderSize),
+                                    nameSize );
+
+  const uchar* q = p + RecordHeaderSize + nameSize;
+
+  bool ok = readPoints( q, end, pointCount, record.wgsPolygon );
+
+  record.detailPolygons.clear();
+
+  for( int i = 0; ok && i < levels; i++ )
+    {
+      qint32 count;
+
+      ok = readVarint( q, end, count ) && count >= 0;
+
+      if( ok && count == 0 )
+        {
+          // The level is equal to the preceding one.
+          record.detailPolygons.append( i == 0 ? record.wgsPolygon
+                                               : record.detailPolygons.last() );
+          continue;
+        }
+
+      QPolygon polygon;
+
+      ok = ok && readPoints( q, end, quint32( count ), polygon );
+
+      record.detailPolygons.append( polygon );
+    }
+
+  if( ! ok )
+    {
+      qWarning( "CompiledMapFile: Corrupted record at offset %u", m_pos );
+      m_pos = m_end;
+      return false;
+    }
+
+  m_pos += size;
+  return true;
+}
+
+CompiledMapWriter::CompiledMapWriter( const char typeID,
+                                      const quint16 formatID,
+                                      const int secID,
+                                      const QDateTime& createDateTime ) :
+  m_typeID(typeID),
+  m_formatID(formatID),
+  m_secID(secID),
+  m_createDateTime(createDateTime)
+{
+  for( int i = 0; i < CompiledMapFile::SectionCount; i++ )
+    {
+      m_count[i] = 0;
+    }
+}
+
+CompiledMapWriter::~CompiledMapWriter()
+{
+}
+
+void CompiledMapWriter::addRecord( const CompiledMapFile::Section section,
+                                   const quint8 type,
+                                   const qint8 sort,
+                                   const qint16 value,
+                                   const QString& name,
+                                   const QPolygon& wgsPolygon )
+{
+  QByteArray utf8 = name.toUtf8().left( 0xffff );
+
+  // The bounding box in the same orientation as the points.
+  QRect box = wgsPolygon.boundingRect();
+
+  // Line and area elements get a simplified polygon for every coarser
+  // draw scale band.
+  QList<QPolygon> details;
+
+  if( wgsPolygon.size() > 2 )
+    {
+      for( int i = 1; i < MapMatrix::DrawScaleCount; i++ )
+        {
+          QPolygon polygon;
+
+          MapCalc::simplifyPolygon( details.isEmpty() ? wgsPolygon : details.last(),
+                                    MapMatrix::drawScaleTolerance( i ),
+                                    polygon );
+          details.append( polygon );
+        }
+    }
+
+  QByteArray& data = m_data[section];
+  const int start = data.size();
+
+  appendU32( data, 0 ); // size, set below
+  data.append( char( type ) );
+  data.append( char( sort ) );
+  appendU16( data, quint16( value ) );
+  appendU16( data, quint16( utf8.size() ) );
+  appendU16( data, quint16( details.size() ) );
+  appendU32( data, quint32( wgsPolygon.size() ) );
+  appendBox( data, box );
+  data.append( utf8 );
+
+  appendPoints( data, wgsPolygon );
+
+  for( int i = 0; i < details.size(); i++ )
+    {
+      const QPolygon& previous = (i == 0) ? wgsPolygon : details.at(i - 1);
+
+      if( details.at(i).size() == previous.size() )
+        {
+          // Nothing was removed, the level is equal to the preceding one.
+          appendVarint( data, 0 );
+          continue;
+        }
+
+      appendVarint( data, details.at(i).size() );
+      appendPoints( data, details.at(i) );
+    }
+
+  while( (data.size() - start) % 4 )
+    {
+      data.append( char(0) );
+    }
+
+  qToLittleEndian( quint32( data.size() - start ),
+                   reinterpret_cast<uchar *> (data.data() + start) );
+
+  m_count[section]++;
+  m_box[section] = m_box[section].isValid() ? m_box[section].united( box ) : box;
+}
+
+bool CompiledMapWriter::save( const QString& fileName )
+{
+  QByteArray header;
+  QDataStream out( &header, QIODevice::WriteOnly );
+  out.setVersion( QDataStream::Qt_4_7 );
+
+  out << quint32( KFLOG_FILE_MAGIC );
+  out << qint8( m_typeID );
+  out << quint16( m_formatID );
+  out << quint16( m_secID );
+  out << m_createDateTime;
+
+  // The header is padded to its fixed size, the section count stands
+  // in front of the last four bytes.
+  header = header.leftJustified( CompiledMapFile::HeaderSize - 8, '\0', true );
+  appendU32( header, CompiledMapFile::SectionCount );
+  appendU32( header, 0 );
+
+  quint32 offset = CompiledMapFile::HeaderSize +
+                   CompiledMapFile::SectionCount * CompiledMapFile::SectionEntrySize;
+
+  for( int i = 0; i < CompiledMapFile::SectionCount; i++ )
+    {
+      appendU32( header, offset );
+      appendU32( header, quint32( m_data[i].size() ) );
+      appendU32( header, quint32( m_count[i] ) );
+      appendU32( header, 0 );
+      appendBox( header, m_box[i] );
+
+      offset += m_data[i].size();
+    }
+
+  QFile file( fileName );
+
+  if( file.open( QIODevice::WriteOnly ) == false )
+    {
+      qWarning( "CompiledMapWriter: Can't open file %s for writing!",
+                fileName.toLatin1().data() );
+      return false;
+    }
+
+  bool ok = ( file.write( header ) == header.size() );
+
+  for( int i = 0; ok && i < CompiledMapFile::SectionCount; i++ )
+    {
+      ok = ( file.write( m_data[i] ) == m_data[i].size() );
+    }
+
+  file.close();
+
+  if( ! ok )
+    {
+      qWarning( "CompiledMapWriter: Error while writing file %s!",
+                fileName.toLatin1().data() );
+      file.remove();
+      return false;
+    }
+
+  return true;
+}
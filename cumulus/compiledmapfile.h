@@ -0,0 +1,293 @@
+/***********************************************************************
+**
+**   compiledmapfile.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class CompiledMapFile
+ *
+ * \author agent
+ *
+ * \brief Reader of compiled map files.
+ *
+ * A compiled map file contains the elements of one map tile with their
+ * WGS84 coordinates. Therefore it does not depend on the map projection
+ * and must not be compiled again after a projection change.
+ *
+ * The file starts with the usual KFLog header, written by a QDataStream,
+ * which is padded to \ref HeaderSize bytes. It is followed by a table with
+ * one entry for every element list, which contains the position, the
+ * number of records and the bounding box of the list. All numbers after
+ * the header are stored in little endian byte order.
+ *
+ * A record starts with a fixed part of \ref RecordHeaderSize bytes:
+ *
+ * \code
+ * quint32  size of the whole record in bytes
+ * quint8   element type
+ * qint8    sort
+ * qint16   value, elevation or landmark type
+ * quint16  length of the name in bytes
+ * quint16  number of detail levels
+ * quint32  number of points
+ * qint32   bounding box: minimum latitude, minimum longitude,
+ *                        maximum latitude, maximum longitude
+ * \endcode
+ *
+ * The UTF-8 encoded name and the points follow. The first point is stored
+ * absolute, all further ones as difference to their predecessor. Every
+ * value is stored zigzag encoded as variable length integer.
+ *
+ * Line and area elements contain after their points the simplified
+ * polygons for the coarser draw scale bands, see
+ * \ref MapMatrix::currentDrawScale. Every detail level starts with its
+ * number of points as variable length integer, followed by the points
+ * encoded as above. A point number of zero means, that the level is equal
+ * to the preceding one. A record is padded to a multiple of four bytes.
+ *
+ * The file is mapped into memory, only the pages of the requested element
+ * lists are read.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef COMPILED_MAP_FILE_H
+#define COMPILED_MAP_FILE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QList>
+#include <QPolygon>
+#include <QRect>
+#include <QString>
+
+class CompiledMapFile
+{
+ public:
+
+  /**
+   * The element lists of a compiled map file.
+   */
+  enum Section
+  {
+    Motorways = 0,
+    Roads,
+    Railways,
+    Hydro,
+    Cities,
+    Lakes,
+    Topography,
+    Villages,
+    Spots,
+    Landmarks,
+    Isohypses,
+    SectionCount
+  };
+
+  enum
+  {
+    /** Size of the file header in bytes. */
+    HeaderSize = 32,
+
+    /** Size of an entry of the section table in bytes. */
+    SectionEntrySize = 32,
+
+    /** Size of the fixed part of a record in bytes. */
+    RecordHeaderSize = 32
+  };
+
+  /**
+   * A map element read from a compiled file.
+   */
+  class Record
+  {
+   public:
+
+    Record() : type(0), sort(0), value(0) {};
+
+    quint8 type;
+    qint8 sort;
+    qint16 value;
+    QString name;
+
+    /** Bounding box, x is the latitude and y is the longitude. */
+    QRect box;
+
+    /** Points of the element, x is the latitude and y is the longitude. */
+    QPolygon wgsPolygon;
+
+    /**
+     * Simplified points of the element for the draw scale bands 1 and
+     * higher. Empty, if the element has no detail levels.
+     */
+    QList<QPolygon> detailPolygons;
+  };
+
+  CompiledMapFile();
+
+  virtual ~CompiledMapFile();
+
+  /**
+   * Maps a compiled file into memory and checks its header.
+   *
+   * \param fileName Name of the file.
+   *
+   * \param typeID Expected file type.
+   *
+   * \param formatID Expected format version.
+   *
+   * \param secID Expected map tile identifier.
+   *
+   * \return True, if the file is valid.
+   */
+  bool open( const QString& fileName,
+             const char typeID,
+             const quint16 formatID,
+             const int secID );
+
+  /**
+   * Releases the file mapping.
+   */
+  void close();
+
+  /**
+   * @return The creation date of the file.
+   */
+  const QDateTime& getCreateDateTime() const
+  {
+    return m_createDateTime;
+  };
+
+  /**
+   * @return The number of records of a section.
+   */
+  int getRecordCount( const Section section ) const
+  {
+    return m_count[section];
+  };
+
+  /**
+   * @return The bounding box of all records of a section.
+   */
+  const QRect& getSectionBox( const Section section ) const
+  {
+    return m_box[section];
+  };
+
+  /**
+   * Positions the reader at the first record of a section.
+   */
+  void seek( const Section section );
+
+  /**
+   * Reads the next record of the current section.
+   *
+   * \return False at the end of the section or if the record is corrupted.
+   */
+  bool next( Record& record );
+
+ private:
+
+  QFile m_file;
+
+  /** Mapped file content. */
+  const uchar* m_data;
+
+  /** Copy of the file content, if the file cannot be mapped. */
+  QByteArray m_buffer;
+
+  qint64 m_size;
+
+  QDateTime m_createDateTime;
+
+  quint32 m_offset[SectionCount];
+  quint32 m_length[SectionCount];
+  int     m_count[SectionCount];
+  QRect   m_box[SectionCount];
+
+  /** Reading position and end of the current section. */
+  quint32 m_pos;
+  quint32 m_end;
+};
+
+/**
+ * \class CompiledMapWriter
+ *
+ * \author agent
+ *
+ * \brief Writer of compiled map files.
+ *
+ * Collects the records of all element lists and writes them in the format
+ * described at \ref CompiledMapFile.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+class CompiledMapWriter
+{
+ public:
+
+  /**
+   * \param typeID File type.
+   *
+   * \param formatID Format version.
+   *
+   * \param secID Map tile identifier.
+   *
+   * \param createDateTime Creation date stored in the file header.
+   */
+  CompiledMapWriter( const char typeID,
+                     const quint16 formatID,
+                     const int secID,
+                     const QDateTime& createDateTime );
+
+  virtual ~CompiledMapWriter();
+
+  /**
+   * Adds a record to a section. For elements with more than two points the
+   * simplified detail levels are computed and stored too.
+   *
+   * \param wgsPolygon Points of the element, x is the latitude and y is the
+   *                   longitude.
+   */
+  void addRecord( const CompiledMapFile::Section section,
+                  const quint8 type,
+                  const qint8 sort,
+                  const qint16 value,
+                  const QString& name,
+                  const QPolygon& wgsPolygon );
+
+  /**
+   * Writes all collected records into a file.
+   *
+   * \return True in case of success.
+   */
+  bool save( const QString& fileName );
+
+ private:
+
+  char      m_typeID;
+  quint16   m_formatID;
+  int       m_secID;
+  QDateTime m_createDateTime;
+
+  QByteArray m_data[CompiledMapFile::SectionCount];
+  int        m_count[CompiledMapFile::SectionCount];
+  QRect      m_box[CompiledMapFile::SectionCount];
+};
+
+#endif
@@ -128,6 +128,11 @@ HEADERS = \
     AirfieldSelectionList.h \
     airregion.h \
     airspace.h \
+    airspaceconflict.h \
+    airspacelookahead.h \
+    airspacelimittable.h \
+    airspaceprofile.h \
+    airspaceprofiledialog.h \
     AirspaceHelper.h \
     airspacewarningdistance.h \
     altimeterdialog.h \
@@ -138,11 +143,13 @@ HEADERS = \
     basemapelement.h \
     calculator.h \
     colordialog.h \
+    compiledmapfile.h \
     configwidget.h \
     CuLabel.h \
     datatypes.h \
     distance.h \
     elevationcolorimage.h \
+    elevationraster.h \
     filetools.h \
     flighttask.h \
     Frequency.h \
@@ -154,13 +161,17 @@ HEADERS = \
     GliderSelectionList.h \
     gpsconandroid.h \
     gpsnmea.h \
+    gnssepoch.h \
+    gnssepochassembler.h \
+    gnssingestqueue.h \
+    nmeadecoder.h \
+    spscqueue.h \
     gpsstatusdialog.h \
     helpbrowser.h \
     hwinfo.h \
     igclogger.h \
     interfaceelements.h \
     isohypse.h \
-    isolist.h \
     jnisupport.h \
     layout.h \
     limitedlist.h \
@@ -177,17 +188,23 @@ HEADERS = \
     map.h \
     mapinfobox.h \
     mapmatrix.h \
+    maptilecache.h \
+    maptileloaderthread.h \
+    maptilerenderer.h \
     mapview.h \
     messagehandler.h \
     messagewidget.h \
     multilayout.h \
     OpenAip.h \
+    OpenAipCompiler.h \
     OpenAipLoaderThread.h \
     OpenAipPoiLoader.h \
     openairparser.h \
+    openairtokenizer.h \
     PointListView.h \
     polardialog.h \
     polar.h \
+    polygonrasterizer.h \
     preflightchecklistpage.h \
     preflightgliderpage.h \
     preflightlogbookspage.h \
@@ -199,6 +216,7 @@ HEADERS = \
     projectionbase.h \
     projectioncylindric.h \
     projectionlambert.h \
+    projectionsimd.h \
     protocol.h \
     radiopoint.h \
     RadioPointListWidget.h \
@@ -228,6 +246,7 @@ HEADERS = \
     singlepoint.h \
     sonne.h \
     sound.h \
+    spatialindex.h \
     speed.h \
     splash.h \
     target.h \
@@ -269,6 +288,11 @@ SOURCES = \
     AirfieldSelectionList.cpp \
     airregion.cpp \
     airspace.cpp \
+    airspaceconflict.cpp \
+    airspacelookahead.cpp \
+    airspacelimittable.cpp \
+    airspaceprofile.cpp \
+    airspaceprofiledialog.cpp \
     AirspaceHelper.cpp \
     altimeterdialog.cpp \
     altitude.cpp \
@@ -278,10 +302,12 @@ SOURCES = \
     builddate.cpp \
     calculator.cpp \
     colordialog.cpp \
+    compiledmapfile.cpp \
     configwidget.cpp \
     CuLabel.cpp \
     distance.cpp \
     elevationcolorimage.cpp \
+    elevationraster.cpp \
     filetools.cpp \
     flighttask.cpp \
     fontdialog.cpp \
@@ -292,12 +318,13 @@ SOURCES = \
     GliderSelectionList.cpp \
     gpsconandroid.cpp \
     gpsnmea.cpp \
+    nmeadecoder.cpp \
+    gnssepochassembler.cpp \
     gpsstatusdialog.cpp \
     helpbrowser.cpp \
     hwinfo.cpp \
     igclogger.cpp \
     isohypse.cpp \
-    isolist.cpp \
     jnisupport.cpp \
     layout.cpp \
     lineelement.cpp \
@@ -313,16 +340,21 @@ SOURCES = \
     map.cpp \
     mapinfobox.cpp \
     mapmatrix.cpp \
+    maptilecache.cpp \
+    maptileloaderthread.cpp \
+    maptilerenderer.cpp \
     mapview.cpp \
     messagehandler.cpp \
     messagewidget.cpp \
     OpenAip.cpp \
+    OpenAipCompiler.cpp \
     OpenAipLoaderThread.cpp \
     OpenAipPoiLoader.cpp \
     openairparser.cpp \
     PointListView.cpp \
     polar.cpp \
     polardialog.cpp \
+    polygonrasterizer.cpp \
     preflightchecklistpage.cpp \
     preflightgliderpage.cpp \
     preflightlogbookspage.cpp \
@@ -361,6 +393,7 @@ SOURCES = \
     singlepoint.cpp \
     sonne.cpp \
     sound.cpp \
+    spatialindex.cpp \
     speed.cpp \
     splash.cpp \
     taskeditor.cpp \
@@ -52,6 +52,11 @@ HEADERS = \
     AirfieldSelectionList.h \
     airregion.h \
     airspace.h \
+    airspaceconflict.h \
+    airspacelookahead.h \
+    airspacelimittable.h \
+    airspaceprofile.h \
+    airspaceprofiledialog.h \
     AirspaceHelper.h \
     airspacewarningdistance.h \
     altimeterdialog.h \
@@ -60,11 +65,13 @@ HEADERS = \
     basemapelement.h \
     calculator.h \
     colordialog.h \
+    compiledmapfile.h \
     configwidget.h \
     CuLabel.h \
     datatypes.h \
     distance.h \
     elevationcolorimage.h \
+    elevationraster.h \
     filetools.h \
     flighttask.h \
     fontdialog.h \
@@ -75,6 +82,12 @@ HEADERS = \
     GliderSelectionList.h \
     gpscon.h \
     gpsnmea.h \
+    gnssepoch.h \
+    gnssepochassembler.h \
+    gnssingestqueue.h \
+    gnssingestthread.h \
+    nmeadecoder.h \
+    spscqueue.h \
     gpsstatusdialog.h \
     helpbrowser.h \
     hwinfo.h \
@@ -82,7 +95,6 @@ HEADERS = \
     interfaceelements.h \
     ipc.h \
     isohypse.h \
-    isolist.h \
     layout.h \
     limitedlist.h \
     lineelement.h \
@@ -99,17 +111,23 @@ HEADERS = \
     map.h \
     mapinfobox.h \
     mapmatrix.h \
+    maptilecache.h \
+    maptileloaderthread.h \
+    maptilerenderer.h \
     mapview.h \
     messagehandler.h \
     messagewidget.h \
     multilayout.h \
     OpenAip.h \
+    OpenAipCompiler.h \
     OpenAipLoaderThread.h \
     OpenAipPoiLoader.h \
     openairparser.h \
+    openairtokenizer.h \
     PointListView.h \
     polardialog.h \
     polar.h \
+    polygonrasterizer.h \
     preflightchecklistpage.h \
     preflightgliderpage.h \
     preflightlogbookspage.h \
@@ -120,6 +138,7 @@ HEADERS = \
     projectionbase.h \
     projectioncylindric.h \
     projectionlambert.h \
+    projectionsimd.h \
     protocol.h \
     radiopoint.h \
     RadioPointListWidget.h \
@@ -149,6 +168,7 @@ HEADERS = \
     singlepoint.h \
     sonne.h \
     sound.h \
+    spatialindex.h \
     speed.h \
     splash.h \
     target.h \
@@ -188,6 +208,11 @@ SOURCES = \
     AirfieldSelectionList.cpp \
     airregion.cpp \
     airspace.cpp \
+    airspaceconflict.cpp \
+    airspacelookahead.cpp \
+    airspacelimittable.cpp \
+    airspaceprofile.cpp \
+    airspaceprofiledialog.cpp \
     AirspaceHelper.cpp \    
     altimeterdialog.cpp \
     altitude.cpp \
@@ -196,10 +221,12 @@ SOURCES = \
     builddate.cpp \
     calculator.cpp \
     colordialog.cpp \
+    compiledmapfile.cpp \
     configwidget.cpp \
     CuLabel.cpp \
     distance.cpp \
     elevationcolorimage.cpp \
+    elevationraster.cpp \
     filetools.cpp \
     flighttask.cpp \
     fontdialog.cpp \
@@ -209,14 +236,16 @@ SOURCES = \
     gliderlistwidget.cpp \
     GliderSelectionList.cpp \
     gpscon.cpp \
+    gnssingestthread.cpp \
     gpsnmea.cpp \
+    nmeadecoder.cpp \
+    gnssepochassembler.cpp \
     gpsstatusdialog.cpp \
     helpbrowser.cpp \
     hwinfo.cpp \
     igclogger.cpp \
     ipc.cpp \
     isohypse.cpp \
-    isolist.cpp \
     layout.cpp \
     lineelement.cpp \
     listviewfilter.cpp \
@@ -232,16 +261,21 @@ SOURCES = \
     map.cpp \
     mapinfobox.cpp \
     mapmatrix.cpp \
+    maptilecache.cpp \
+    maptileloaderthread.cpp \
+    maptilerenderer.cpp \
     mapview.cpp \
     messagehandler.cpp \
     messagewidget.cpp \
     OpenAip.cpp \
+    OpenAipCompiler.cpp \
     OpenAipLoaderThread.cpp \
     OpenAipPoiLoader.cpp \
     openairparser.cpp \
     PointListView.cpp \
     polar.cpp \
     polardialog.cpp \
+    polygonrasterizer.cpp \
     preflightchecklistpage.cpp \
     preflightgliderpage.cpp \
     preflightlogbookspage.cpp \
@@ -279,6 +313,7 @@ SOURCES = \
     singlepoint.cpp \
     sonne.cpp \
     sound.cpp \
+    spatialindex.cpp \
     speed.cpp \
     splash.cpp \
     taskeditor.cpp \
@@ -101,6 +101,11 @@ HEADERS = \
     AirfieldSelectionList.h \
     airregion.h \
     airspace.h \
+    airspaceconflict.h \
+    airspacelookahead.h \
+    airspacelimittable.h \
+    airspaceprofile.h \
+    airspaceprofiledialog.h \
     AirspaceHelper.h \
     airspacewarningdistance.h \
     altimeterdialog.h \
@@ -109,11 +114,13 @@ HEADERS = \
     basemapelement.h \
     calculator.h \
     colordialog.h \
+    compiledmapfile.h \
     configwidget.h \
     CuLabel.h \
     datatypes.h \
     distance.h \
     elevationcolorimage.h \
+    elevationraster.h \
     frequency.h \
     filetools.h \
     flighttask.h \
@@ -125,6 +132,12 @@ HEADERS = \
     GliderSelectionList.h \
     gpscon.h \
     gpsnmea.h \
+    gnssepoch.h \
+    gnssepochassembler.h \
+    gnssingestqueue.h \
+    gnssingestthread.h \
+    nmeadecoder.h \
+    spscqueue.h \
     gpsstatusdialog.h \
     helpbrowser.h \
     hwinfo.h \
@@ -132,7 +145,6 @@ HEADERS = \
     interfaceelements.h \
     ipc.h \
     isohypse.h \
-    isolist.h \
     layout.h \
     limitedlist.h \
     lineelement.h \
@@ -148,17 +160,23 @@ HEADERS = \
     map.h \
     mapinfobox.h \
     mapmatrix.h \
+    maptilecache.h \
+    maptileloaderthread.h \
+    maptilerenderer.h \
     mapview.h \
     messagehandler.h \
     messagewidget.h \
     multilayout.h \
     OpenAip.h \
+    OpenAipCompiler.h \
     OpenAipPoiLoader.h \
     OpenAipLoaderThread.h \
     openairparser.h \
+    openairtokenizer.h \
     PointListView.h \
     polardialog.h \
     polar.h \
+    polygonrasterizer.h \
     preflightchecklistpage.h \
     preflightgliderpage.h \
     preflightlogbookspage.h \
@@ -169,6 +187,7 @@ HEADERS = \
     projectionbase.h \
     projectioncylindric.h \
     projectionlambert.h \
+    projectionsimd.h \
     protocol.h \
     radiopoint.h \
     RadioPointListWidget.h \
@@ -198,6 +217,7 @@ HEADERS = \
     singlepoint.h \
     sonne.h \
     sound.h \
+    spatialindex.h \
     speed.h \
     splash.h \
     target.h \
@@ -239,6 +259,11 @@ SOURCES = \
     AirfieldSelectionList.cpp \
     airregion.cpp \
     airspace.cpp \
+    airspaceconflict.cpp \
+    airspacelookahead.cpp \
+    airspacelimittable.cpp \
+    airspaceprofile.cpp \
+    airspaceprofiledialog.cpp \
     AirspaceHelper.cpp \
     altimeterdialog.cpp \
     altitude.cpp \
@@ -247,10 +272,12 @@ SOURCES = \
     builddate.cpp \
     calculator.cpp \
     colordialog.cpp \
+    compiledmapfile.cpp \
     configwidget.cpp \
     CuLabel.cpp \
     distance.cpp \
     elevationcolorimage.cpp \
+    elevationraster.cpp \
     filetools.cpp \
     flighttask.cpp \
     fontdialog.cpp \
@@ -260,14 +287,16 @@ SOURCES = \
     gliderlistwidget.cpp \
     GliderSelectionList.cpp \
     gpscon.cpp \
+    gnssingestthread.cpp \
     gpsnmea.cpp \
+    nmeadecoder.cpp \
+    gnssepochassembler.cpp \
     gpsstatusdialog.cpp \
     helpbrowser.cpp \
     hwinfo.cpp \
     igclogger.cpp \
     ipc.cpp \
     isohypse.cpp \
-    isolist.cpp \
     layout.cpp \
     lineelement.cpp \
     listviewfilter.cpp \
@@ -282,16 +311,21 @@ SOURCES = \
     map.cpp \
     mapinfobox.cpp \
     mapmatrix.cpp \
+    maptilecache.cpp \
+    maptileloaderthread.cpp \
+    maptilerenderer.cpp \
     mapview.cpp \
     messagehandler.cpp \
     messagewidget.cpp \
     OpenAip.cpp \
+    OpenAipCompiler.cpp \
     OpenAipPoiLoader.cpp \
     OpenAipLoaderThread.cpp \
     openairparser.cpp \
     PointListView.cpp \
     polar.cpp \
     polardialog.cpp \
+    polygonrasterizer.cpp \
     preflightchecklistpage.cpp \
     preflightgliderpage.cpp \
     preflightlogbookspage.cpp \
@@ -329,6 +363,7 @@ SOURCES = \
     singlepoint.cpp \
     sonne.cpp \
     sound.cpp \
+    spatialindex.cpp \
     speed.cpp \
     splash.cpp \
     taskeditor.cpp \
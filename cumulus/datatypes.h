@@ -53,6 +53,7 @@ Q_DECLARE_METATYPE(BtDeviceMap)
 
 #include "airfield.h"
 #include "airspace.h"
+#include "AirspaceHelper.h"
 #include "radiopoint.h"
 #include "singlepoint.h"
 
@@ -82,6 +83,13 @@ typedef QList<Airspace*>* AirspaceListPtr;
 
 Q_DECLARE_METATYPE(AirspaceListPtr)
 
+/**
+ * Special data type to return the loaded airspace sets to the GUI thread.
+ */
+typedef AirspaceHelper::LoadResult* AirspaceLoadResultPtr;
+
+Q_DECLARE_METATYPE(AirspaceLoadResultPtr)
+
 //------------------------------------------------------------------------------
 
 #endif // DATA_TYPES_H
@@ -0,0 +1,231 @@
+/***********************************************************************
+**
+**   elevationraster.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <QtCore>
+
+#include "elevationraster.h"
+#include "polygonrasterizer.h"
+#include "resource.h"
+
+namespace
+{
+  /**
+   * Span functor, which raises the elevation index of the covered cells.
+   */
+  class RaiseSpan
+  {
+   public:
+
+    RaiseSpan( uchar* data, const uchar elevationIndex ) :
+      m_data(data),
+      m_index(elevationIndex)
+    {};
+
+    void operator()( int row, int firstColumn, int lastColumn )
+    {
+      uchar* cell = m_data + row * ElevationRaster::Size + firstColumn;
+
+      for( int i = firstColumn; i <= lastColumn; i++, cell++ )
+        {
+          if( *cell == ElevationRaster::NoData || *cell < m_index )
+            {
+              *cell = m_index;
+            }
+        }
+    };
+
+   private:
+
+    uchar* m_data;
+    uchar  m_index;
+  };
+}
+
+ElevationRaster::ElevationRaster() :
+  m_secID(-1),
+  m_top(0),
+  m_left(0)
+{
+}
+
+ElevationRaster::ElevationRaster( const int secID ) :
+  m_secID(secID),
+  m_top( (90 - (secID / 180) * 2) * 600000 ),
+  m_left( ((secID % 180) * 2 - 180) * 600000 ),
+  m_data( Size * Size, char(NoData) )
+{
+}
+
+ElevationRaster::~ElevationRaster()
+{
+}
+
+void ElevationRaster::fillPolygon( const QPolygon& wgsPolygon,
+                                   const uchar elevationIndex )
+{
+  if( isNull() || wgsPolygon.size() < 3 || elevationIndex == NoData )
+    {
+      return;
+    }
+
+  // Convert the WGS84 coordinates into raster coordinates.
+  QPolygonF polygon( wgsPolygon.size() );
+
+  for( int i = 0; i < wgsPolygon.size(); i++ )
+    {
+      const QPoint& p = wgsPolygon.at(i);
+
+      polygon[i] = QPointF( double(p.y() - m_left) / CellSize,
+                            double(m_top - p.x()) / CellSize );
+    }
+
+  RaiseSpan span( reinterpret_cast<uchar *> (m_data.data()), elevationIndex );
+
+  PolygonRasterizer::fill( polygon, Size, Size, span );
+}
+
+void ElevationRaster::merge( const ElevationRaster& other )
+{
+  if( other.isNull() )
+    {
+      return;
+    }
+
+  if( isNull() )
+    {
+      *this = other;
+      return;
+    }
+
+  uchar* dst = reinterpret_cast<uchar *> (m_data.data());
+  const uchar* src = reinterpret_cast<const uchar *> (other.m_data.constData());
+
+  for( int i = 0; i < Size * Size; i++ )
+    {
+      if( src[i] != NoData && ( dst[i] == NoData || dst[i] < src[i] ) )
+        {
+          dst[i] = src[i];
+        }
+    }
+}
+
+bool ElevationRaster::save( const QString& fileName,
+                            const char typeID,
+                            const QDateTime& createDateTime ) const
+{
+  QFile file( fileName );
+
+  if( file.open( QIODevice::WriteOnly ) == false )
+    {
+      qWarning( "ElevationRaster: Can't open file %s for writing!",
+                fileName.toLatin1().data() );
+      return false;
+    }
+
+  QDataStream out( &file );
+  out.setVersion( QDataStream::Qt_4_7 );
+
+  out << quint32( KFLOG_FILE_MAGIC );
+  out << qint8( typeID );
+  out << quint16( FILE_VERSION_ELEVATION_C );
+  out << quint16( m_secID );
+  out << createDateTime;
+  out << quint16( Size );
+  out << qCompress( m_data );
+
+  file.close();
+
+  if( out.status() != QDataStream::Ok )
+    {
+      qWarning( "ElevationRaster: Error while writing file %s!",
+                fileName.toLatin1().data() );
+      file.remove();
+      return false;
+    }
+
+  return true;
+}
+
+bool ElevationRaster::load( const QString& fileName,
+                            const int secID,
+                            const char typeID,
+                            const QDateTime& createDateTime )
+{
+  QFile file( fileName );
+
+  if( file.open( QIODevice::ReadOnly ) == false )
+    {
+      return false;
+    }
+
+  QDataStream in( &file );
+  in.setVersion( QDataStream::Qt_4_7 );
+
+  quint32 magic;
+  qint8 loadTypeID;
+  quint16 formatID, loadSecID, size;
+  QDateTime loadDateTime;
+  QByteArray data;
+
+  in >> magic;
+  in >> loadTypeID;
+  in >> formatID;
+  in >> loadSecID;
+  in >> loadDateTime;
+  in >> size;
+
+  if( in.status() != QDataStream::Ok ||
+      magic != KFLOG_FILE_MAGIC ||
+      loadTypeID != typeID ||
+      formatID != FILE_VERSION_ELEVATION_C ||
+      loadSecID != secID ||
+      loadDateTime != createDateTime ||
+      size != Size )
+    {
+      // The raster does not belong to the compiled map file.
+      return false;
+    }
+
+  in >> data;
+
+  if( in.status() != QDataStream::Ok )
+    {
+      return false;
+    }
+
+  data = qUncompress( data );
+
+  if( data.size() != Size * Size )
+    {
+      qWarning( "ElevationRaster: File %s is corrupted!",
+                fileName.toLatin1().data() );
+      return false;
+    }
+
+  *this = ElevationRaster( secID );
+  m_data = data;
+
+  return true;
+}
+
+QString ElevationRaster::rasterFileName( const QString& kfcFileName )
+{
+  QString name = kfcFileName;
+
+  // Replace the extension kfc by kfr.
+  name.replace( name.length() - 1, 1, QString("r") );
+
+  return name;
+}
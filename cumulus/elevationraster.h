@@ -0,0 +1,170 @@
+/***********************************************************************
+**
+**   elevationraster.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class ElevationRaster
+ *
+ * \author agent
+ *
+ * \brief Elevation raster of a 2x2 degree map tile.
+ *
+ * The raster contains for every cell the elevation index of the highest
+ * isohypse, which covers the cell center. It is computed from the WGS84
+ * coordinates of the isohypses, when a terrain map file is compiled, and
+ * is stored beside the compiled file. Because the raster does not depend
+ * on the map projection and the map scale, the elevation of every point
+ * inside of a loaded map tile can be looked up in constant time.
+ *
+ * The raster data are implicitly shared.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef ELEVATION_RASTER_H
+#define ELEVATION_RASTER_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QPolygon>
+#include <QString>
+
+class ElevationRaster
+{
+ public:
+
+  enum
+  {
+    /** Number of cells in a row and in a column. */
+    Size = 300,
+
+    /** Cell size in 1/10000 minutes, 2 degrees divided by the size. */
+    CellSize = 2 * 600000 / Size,
+
+    /** Marker of cells, which are not covered by an isohypse. */
+    NoData = 255
+  };
+
+  /**
+   * Creates a null raster.
+   */
+  ElevationRaster();
+
+  /**
+   * Creates a raster for a map tile, all cells are set to \ref NoData.
+   *
+   * \param secID Identifier of the map tile.
+   */
+  ElevationRaster( const int secID );
+
+  virtual ~ElevationRaster();
+
+  /**
+   * @return true, if the raster contains no data.
+   */
+  bool isNull() const
+  {
+    return m_data.isEmpty();
+  };
+
+  /**
+   * @return The identifier of the map tile.
+   */
+  int getSectionId() const
+  {
+    return m_secID;
+  };
+
+  /**
+   * Marks all cells, which are covered by the polygon with the passed
+   * elevation index, if their current index is lower.
+   *
+   * \param wgsPolygon Polygon in WGS84 coordinates, x is the latitude and
+   *                   y is the longitude.
+   *
+   * \param elevationIndex Elevation index of the isohypse.
+   */
+  void fillPolygon( const QPolygon& wgsPolygon, const uchar elevationIndex );
+
+  /**
+   * Takes over the higher elevation index of every cell of the other raster.
+   */
+  void merge( const ElevationRaster& other );
+
+  /**
+   * @return The elevation index of a cell or \ref NoData.
+   */
+  uchar cell( const int row, const int column ) const
+  {
+    return static_cast<uchar> ( m_data.constData()[row * Size + column] );
+  };
+
+  /**
+   * Saves the raster into a file.
+   *
+   * \param fileName Name of the file.
+   *
+   * \param typeID Type of the related map file.
+   *
+   * \param createDateTime Creation date of the related compiled map file.
+   *
+   * \return True in case of success.
+   */
+  bool save( const QString& fileName,
+             const char typeID,
+             const QDateTime& createDateTime ) const;
+
+  /**
+   * Loads the raster from a file.
+   *
+   * \param fileName Name of the file.
+   *
+   * \param secID Expected identifier of the map tile.
+   *
+   * \param typeID Expected type of the related map file.
+   *
+   * \param createDateTime Expected creation date of the related compiled
+   *                       map file.
+   *
+   * \return True in case of success.
+   */
+  bool load( const QString& fileName,
+             const int secID,
+             const char typeID,
+             const QDateTime& createDateTime );
+
+  /**
+   * Returns the name of the raster file, which belongs to a compiled map
+   * file.
+   */
+  static QString rasterFileName( const QString& kfcFileName );
+
+ private:
+
+  /** Identifier of the map tile. */
+  int m_secID;
+
+  /** Latitude of the upper border in 1/10000 minutes. */
+  int m_top;
+
+  /** Longitude of the left border in 1/10000 minutes. */
+  int m_left;
+
+  /** Elevation indices of all cells, row by row from north to south. */
+  QByteArray m_data;
+};
+
+#endif
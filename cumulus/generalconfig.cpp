@@ -366,6 +366,9 @@ void GeneralConfig::load()
   beginGroup("Map");
   _mapProjFollowsHome             = value( "ProjectionFollowsHome", true ).toBool();
   _mapUnload                      = value( "UnloadUnneededMap", true ).toBool();
+  _mapTileCacheSize               = value( "TileCacheSize", 24576 ).toInt();
+  _mapTileCacheScales             = value( "TileCacheScales", 4 ).toInt();
+  _mapTileCacheSpill              = value( "TileCacheSpill", false ).toBool();
   _downloadMissingMaps            = value( "DownloadMissingMaps", false ).toBool();
   _mapInstallRadius               = value( "MapInstallRadius", 500 ).toInt();
   _mapLoadIsoLines                = value( "LoadIsoLines", true ).toBool();
@@ -500,6 +503,8 @@ void GeneralConfig::load()
                                   WARNING_DISPLAY_TIME_DEFAULT).toInt();
   _warningSuppressTime   = value( "WarningSuppressTime",
                                   WARNING_SUPPRESS_TIME_DEFAULT).toInt();
+  _airspaceLookaheadTime = value( "AirspaceLookaheadTime",
+                                  AIRSPACE_LOOKAHEAD_TIME_DEFAULT).toInt();
   _alarmSound            = value( "AlarmSound", ALARM_SOUND_DEFAULT ).toBool();
   _popupAirspaceWarnings = value( "Popup Airspace Warnings", true ).toBool();
   _popupFlarmAlarms      = value( "PopupFlarmAlarms", true ).toBool();
@@ -822,6 +827,9 @@ void GeneralConfig::save()
   beginGroup("Map");
   setValue( "ProjectionFollowsHome", _mapProjFollowsHome );
   setValue( "UnloadUnneededMap", _mapUnload );
+  setValue( "TileCacheSize", _mapTileCacheSize );
+  setValue( "TileCacheScales", _mapTileCacheScales );
+  setValue( "TileCacheSpill", _mapTileCacheSpill );
   setValue( "DownloadMissingMaps", _downloadMissingMaps );
   setValue( "MapInstallRadius", _mapInstallRadius );
   setValue( "LoadIsoLines", _mapLoadIsoLines );
@@ -947,6 +955,7 @@ void GeneralConfig::save()
   setValue( "WaypointDisplayTime", _waypointDisplayTime );
   setValue( "WarningDisplayTime", _warningDisplayTime );
   setValue( "WarningSuppressTime", _warningSuppressTime );
+  setValue( "AirspaceLookaheadTime", _airspaceLookaheadTime );
   setValue( "AlarmSound", _alarmSound );
   setValue( "Popup Airspace Warnings", _popupAirspaceWarnings );
   setValue( "PopupFlarmAlarms", _popupFlarmAlarms );
@@ -57,6 +57,7 @@
 #define WAYPOINT_DISPLAY_TIME_DEFAULT 20
 #define WARNING_DISPLAY_TIME_DEFAULT  20
 #define WARNING_SUPPRESS_TIME_DEFAULT 0 // time in minutes
+#define AIRSPACE_LOOKAHEAD_TIME_DEFAULT 60 // time in seconds
 
 // default for audible alarm switch
 #define ALARM_SOUND_DEFAULT true
@@ -1551,6 +1552,39 @@ class GeneralConfig : protected QSettings
     _mapUnload = newValue;
   };
 
+  /** gets the memory size in KB of the map tile cache */
+  int getMapTileCacheSize() const
+  {
+    return _mapTileCacheSize;
+  };
+  /** sets the memory size in KB of the map tile cache */
+  void setMapTileCacheSize(const int newValue)
+  {
+    _mapTileCacheSize = newValue;
+  };
+
+  /** gets the number of map scales kept in the map tile cache */
+  int getMapTileCacheScales() const
+  {
+    return _mapTileCacheScales;
+  };
+  /** sets the number of map scales kept in the map tile cache */
+  void setMapTileCacheScales(const int newValue)
+  {
+    _mapTileCacheScales = newValue;
+  };
+
+  /** gets map tile cache spill to disk */
+  bool getMapTileCacheSpill() const
+  {
+    return _mapTileCacheSpill;
+  };
+  /** sets map tile cache spill to disk */
+  void setMapTileCacheSpill(const bool newValue)
+  {
+    _mapTileCacheSpill = newValue;
+  };
+
   /** gets download missing map files */
   bool getDownloadMissingMaps() const
   {
@@ -1870,6 +1904,18 @@ class GeneralConfig : protected QSettings
   /** sets WarningSuppressTime */
   void setWarningSuppressTime(const int newValue);
 
+  /** gets the airspace lookahead time in seconds, 0 switches it off */
+  int getAirspaceLookaheadTime() const
+  {
+    return _airspaceLookaheadTime;
+  };
+
+  /** sets the airspace lookahead time in seconds */
+  void setAirspaceLookaheadTime(const int newValue)
+  {
+    _airspaceLookaheadTime = newValue;
+  };
+
   /** gets AlarmSound */
   bool getAlarmSoundOn() const;
   /** sets AlarmSound */
@@ -3182,6 +3228,12 @@ class GeneralConfig : protected QSettings
   bool _mapProjFollowsHome;
   // Map unload unneeded
   bool _mapUnload;
+  // Memory size in KB of the map tile cache
+  int _mapTileCacheSize;
+  // Number of map scales kept in the map tile cache
+  int _mapTileCacheScales;
+  // Spill map tiles, removed from the memory cache, to disk
+  bool _mapTileCacheSpill;
   // Download missing map files
   bool _downloadMissingMaps;
   // Map install radius for download
@@ -3297,6 +3349,8 @@ class GeneralConfig : protected QSettings
   int _warningDisplayTime;
   // WarningSuppressTime
   int _warningSuppressTime;
+  // Airspace lookahead time in seconds
+  int _airspaceLookaheadTime;
   // AlarmSound
   bool _alarmSound;
   // Popup Airspace Warnings
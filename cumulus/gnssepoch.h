@@ -0,0 +1,111 @@
+/***********************************************************************
+**
+**   gnssepoch.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class GnssEpoch
+ *
+ * \author agent
+ *
+ * \brief Data of one GNSS epoch.
+ *
+ * A GNSS receiver sends several sentences with the same UTC time stamp,
+ * e.g. RMC, GGA and GSA. The \ref GnssEpochAssembler finds the end of an
+ * epoch already in the thread, which decodes the sentences. GpsNmea
+ * collects their data and publishes them together as one epoch at this
+ * point. The record contains the last known state of all
+ * items. The member items tells, which of them have been changed in this
+ * epoch.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef GNSS_EPOCH_H
+#define GNSS_EPOCH_H
+
+#include <QDateTime>
+#include <QPoint>
+
+#include "altitude.h"
+#include "speed.h"
+
+#ifdef FLARM
+#include "flarmbase.h"
+#endif
+
+class GnssEpoch
+{
+ public:
+
+  /** Bits of the member items */
+  enum Item
+    {
+      Position   = 1,
+      Speed      = 2,
+      Heading    = 4,
+      Altitude   = 8,
+      Fix        = 16, // a new fix time has been received
+      Satellites = 32
+    };
+
+  GnssEpoch() :
+    items(0),
+    heading(0.0),
+    satsInView(0),
+    satsInUse(0),
+    fixAccuracy(0),
+    windDirection(0)
+  {};
+
+  /** Changed items of this epoch. */
+  uint items;
+
+  /** UTC time of the last fix. */
+  QDateTime utc;
+
+  /** Position in KFLog format. */
+  QPoint position;
+
+  ::Speed speed;
+
+  /** Course over ground in degrees. */
+  double heading;
+
+  /** MSL altitude with the user's correction, STD and GNSS altitude. */
+  ::Altitude mslAltitude;
+  ::Altitude stdAltitude;
+  ::Altitude gnssAltitude;
+
+  int satsInView;
+  int satsInUse;
+
+  /** PDOP in meters */
+  int fixAccuracy;
+
+  /** Last values received from a logger device. */
+  ::Speed vario;
+  ::Speed windSpeed;
+  short windDirection;
+  ::Speed tas;
+  ::Speed mc;
+
+#ifdef FLARM
+  /** Last received Flarm status. */
+  FlarmBase::FlarmStatus flarmStatus;
+#endif
+};
+
+#endif
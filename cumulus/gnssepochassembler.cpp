@@ -0,0 +1,97 @@
+/***********************************************************************
+**
+**   gnssepochassembler.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include "gnssepochassembler.h"
+
+QAtomicInt GnssEpochAssembler::m_talker(0);
+
+GnssEpochAssembler::GnssEpochAssembler()
+{
+  reset();
+}
+
+void GnssEpochAssembler::reset()
+{
+  m_time      = -1;
+  m_sentences = 0;
+  m_pattern   = 0;
+  m_published = false;
+}
+
+void GnssEpochAssembler::setTalker( const QString& source )
+{
+  int talker = 0;
+
+  // The source is the begin of the identifier, e.g. $GP.
+  if( source.size() == 3 )
+    {
+      talker = (source.at(1).toLatin1() << 8) | source.at(2).toLatin1();
+    }
+
+  m_talker.fetchAndStoreOrdered( talker );
+}
+
+bool GnssEpochAssembler::isTalker( const NmeaFix& fix )
+{
+  const int talker = m_talker.fetchAndAddOrdered( 0 );
+
+  return talker != 0 &&
+         fix.identifier[1] == (char) (talker >> 8) &&
+         fix.identifier[2] == (char) (talker & 0xff);
+}
+
+uint GnssEpochAssembler::assign( const int type, const NmeaFix& fix )
+{
+  if( NmeaFix::isPosition( type ) == false || isTalker( fix ) == false )
+    {
+      return 0;
+    }
+
+  uint result = 0;
+
+  if( fix.valid & NmeaFix::Time )
+    {
+      const int time = fix.hour * 3600 + fix.minute * 60 + fix.second;
+
+      if( time != m_time )
+        {
+          // A new time stamp completes the former epoch. Its sentence types
+          // are expected in the next epochs too.
+          result |= EndBefore;
+
+          if( m_sentences != 0 )
+            {
+              m_pattern = m_sentences;
+            }
+
+          m_time      = time;
+          m_sentences = 0;
+          m_published = false;
+        }
+
+      m_sentences |= 1 << type;
+    }
+
+  // The epoch is complete, if all sentence types of the last complete epoch
+  // have been received with the current time stamp.
+  if( m_published == false && m_pattern != 0 &&
+      (m_sentences & m_pattern) == m_pattern )
+    {
+      result |= EndAfter;
+      m_published = true;
+    }
+
+  return result;
+}
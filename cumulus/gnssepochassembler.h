@@ -0,0 +1,102 @@
+/***********************************************************************
+**
+**   gnssepochassembler.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class GnssEpochAssembler
+ *
+ * \author agent
+ *
+ * \brief Groups the decoded position sentences to GNSS epochs.
+ *
+ * An epoch consists of the position sentences with the same UTC time
+ * stamp. A new time stamp completes the former epoch. The sentence types of
+ * a complete epoch are expected in the next epochs too, so that an epoch
+ * can be completed already with its last sentence.
+ *
+ * The assembler runs in the thread, which decodes the sentences. It only
+ * tells, where an epoch ends. The consumer publishes the epoch at these
+ * points. Only the sentences of the selected talker, see \ref setTalker,
+ * are assigned to epochs.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef GNSS_EPOCH_ASSEMBLER_H
+#define GNSS_EPOCH_ASSEMBLER_H
+
+#include <QAtomicInt>
+#include <QString>
+
+#include "nmeadecoder.h"
+
+class GnssEpochAssembler
+{
+ public:
+
+  /** Result bits of \ref assign */
+  enum Result
+    {
+      EndBefore = 1, // the former epoch is completed before the sentence
+      EndAfter  = 2  // the epoch is completed with the sentence
+    };
+
+  GnssEpochAssembler();
+
+  /**
+   * Assigns a decoded sentence to an epoch.
+   *
+   * \param type The decoded sentence type, see \ref NmeaFix::Sentence.
+   *
+   * \param fix The decoded data of the sentence.
+   *
+   * \return The ends of epochs around the sentence, see \ref Result.
+   */
+  uint assign( const int type, const NmeaFix& fix );
+
+  /**
+   * Forgets the epochs seen so far.
+   */
+  void reset();
+
+  /**
+   * Sets the talker of the position sentences, e.g. $GP, for all
+   * assemblers. It can be called by any thread.
+   */
+  static void setTalker( const QString& source );
+
+ private:
+
+  /** \return True, if the sentence is sent by the selected talker. */
+  static bool isTalker( const NmeaFix& fix );
+
+  /** Time stamp of the current epoch in seconds of the day, -1 if unset */
+  int m_time;
+
+  /** Position sentence types of the current epoch */
+  uint m_sentences;
+
+  /** Position sentence types of the last complete epoch */
+  uint m_pattern;
+
+  /** The end of the current epoch has already been reported. */
+  bool m_published;
+
+  /** The two talker characters of the selected source, 0 if unset */
+  static QAtomicInt m_talker;
+};
+
+#endif
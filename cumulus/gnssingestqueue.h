@@ -0,0 +1,147 @@
+/***********************************************************************
+**
+**   gnssingestqueue.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class GnssIngestQueue
+ *
+ * \author agent
+ *
+ * \brief Hand over of received GNSS data to the GUI thread.
+ *
+ * The GNSS data are received and decoded in an extra thread and are stored
+ * as \ref GnssRecord objects in a lock-free queue. The producer groups the
+ * position sentences to epochs and marks the end of every epoch by an
+ * extra record. It gets the request for a notification only once after
+ * every drain. The GUI thread drains the queue at once on the first
+ * notification. Further notifications within \ref CoalesceInterval are
+ * combined to one drain, so that a burst of sentences wakes it up at most
+ * once per frame.
+ *
+ * The decoded data of an epoch are processed by GpsNmea, Calculator and
+ * their consumers in the GUI thread.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef GNSS_INGEST_QUEUE_H
+#define GNSS_INGEST_QUEUE_H
+
+#include <QAtomicInt>
+#include <QString>
+
+#include "nmeadecoder.h"
+#include "spscqueue.h"
+
+/**
+ * A received GNSS sentence with its decoding result, the end of an epoch or
+ * a message of the GPS client.
+ */
+class GnssRecord
+{
+ public:
+
+  /** Record types */
+  enum Type
+    {
+      Sentence, // a NMEA sentence
+      EpochEnd, // all sentences of an epoch have been put before
+      Message   // a status message of the GPS client
+    };
+
+  GnssRecord() :
+    type(Sentence),
+    fixType(NmeaFix::None)
+  {};
+
+  int type;
+
+  /** The sentence respectively the message. */
+  QString text;
+
+  /** Decoded sentence type, see \ref NmeaFix::Sentence. */
+  int fixType;
+
+  /** The decoded data of a position sentence. */
+  NmeaFix fix;
+};
+
+class GnssIngestQueue
+{
+ public:
+
+  enum
+    {
+      /** Number of slots of the queue. */
+      Size = 512,
+      /**
+       * Interval in milli seconds after a drain, in which further
+       * notifications are combined. That are 25 frames per second.
+       */
+      CoalesceInterval = 40
+    };
+
+  GnssIngestQueue() :
+    m_idle(1)
+  {};
+
+  /**
+   * Appends a record. Must be called only by the producer.
+   *
+   * \return False, if the queue is full.
+   */
+  bool put( const GnssRecord& record )
+  {
+    return m_queue.push( record );
+  };
+
+  /**
+   * Must be called by the producer after a put.
+   *
+   * \return True, if the consumer must be notified about new records.
+   */
+  bool notifyConsumer()
+  {
+    return m_idle.testAndSetOrdered( 1, 0 );
+  };
+
+  /**
+   * Must be called by the consumer before the queue is drained.
+   */
+  void startDrain()
+  {
+    m_idle.fetchAndStoreOrdered( 1 );
+  };
+
+  /**
+   * Takes the oldest record. Must be called only by the consumer.
+   *
+   * \return False, if the queue is empty.
+   */
+  bool take( GnssRecord& record )
+  {
+    return m_queue.pop( record );
+  };
+
+ private:
+
+  SpscQueue<GnssRecord, Size> m_queue;
+
+  /** Set by the consumer, when it drains the queue. */
+  QAtomicInt m_idle;
+};
+
+#endif
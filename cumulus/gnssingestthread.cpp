@@ -0,0 +1,312 @@
+/***********************************************************************
+**
+**   gnssingestthread.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+
+#include <QtCore>
+
+#include "gnssingestthread.h"
+#include "protocol.h"
+
+// Select timeout in milli seconds. It limits the wait time of setSocket
+// and stop.
+#define SELECT_TIMEOUT 200
+
+GnssIngestThread::GnssIngestThread( QObject *parent ) :
+  QThread( parent ),
+  m_socket(-1),
+  m_current(-1),
+  m_busy(false),
+  m_stop(false),
+  m_overflows(0)
+{
+  setObjectName( "GnssIngestThread" );
+}
+
+GnssIngestThread::~GnssIngestThread()
+{
+  stop();
+}
+
+void GnssIngestThread::setSocket( const int sock )
+{
+  QMutexLocker locker( &m_mutex );
+
+  m_socket = sock;
+  m_condition.wakeAll();
+
+  // Wait, until the thread has released the previous socket.
+  while( m_busy && m_current != sock )
+    {
+      m_condition.wait( &m_mutex );
+    }
+}
+
+int GnssIngestThread::socket()
+{
+  QMutexLocker locker( &m_mutex );
+
+  return m_socket;
+}
+
+void GnssIngestThread::stop()
+{
+  m_mutex.lock();
+  m_stop = true;
+  m_condition.wakeAll();
+  m_mutex.unlock();
+
+  wait();
+}
+
+void GnssIngestThread::run()
+{
+  sigset_t sigset;
+  sigfillset( &sigset );
+
+  // deactivate all signals in this thread
+  pthread_sigmask( SIG_SETMASK, &sigset, 0 );
+
+  m_mutex.lock();
+
+  while( m_stop == false )
+    {
+      if( m_current != m_socket )
+        {
+          // Discard a message remainder and the epochs of the previous
+          // connection.
+          m_current = m_socket;
+          m_data.clear();
+          m_assembler.reset();
+        }
+
+      if( m_current == -1 )
+        {
+          m_condition.wait( &m_mutex );
+          continue;
+        }
+
+      const int sock = m_current;
+
+      m_busy = true;
+      m_mutex.unlock();
+
+      fd_set readFds;
+      FD_ZERO( &readFds );
+      FD_SET( sock, &readFds );
+
+      struct timeval timeout;
+      timeout.tv_sec  = 0;
+      timeout.tv_usec = SELECT_TIMEOUT * 1000;
+
+      bool ok = true;
+
+      int result = select( sock + 1, &readFds, 0, 0, &timeout );
+
+      if( result > 0 )
+        {
+          ok = readSocket( sock );
+        }
+      else if( result == -1 && errno != EINTR )
+        {
+          qWarning() << "GnssIngestThread: select() returns with ERROR: errno="
+                     << errno << "," << strerror(errno);
+          ok = false;
+        }
+
+      m_mutex.lock();
+
+      if( ok == false && m_socket == sock )
+        {
+          // The socket is released before the consumer is told about it,
+          // the consumer closes it.
+          m_socket = -1;
+          emit closed( sock );
+        }
+
+      m_busy = false;
+      m_condition.wakeAll();
+    }
+
+  m_mutex.unlock();
+}
+
+bool GnssIngestThread::readSocket( const int sock )
+{
+  // Number of bytes currently in the socket receiver buffer.
+  int bytes = 0;
+
+  if( ioctl( sock, FIONREAD, &bytes ) == -1 )
+    {
+      qWarning() << "GnssIngestThread: ioctl() returns with ERROR: errno="
+                 << errno << "," << strerror(errno);
+      return false;
+    }
+
+  if( bytes <= 0 )
+    {
+      // The socket is readable without data, the client has closed it.
+      return false;
+    }
+
+  int oldSize = m_data.size();
+
+  m_data.resize( oldSize + bytes );
+
+  int done;
+
+  do
+    {
+      done = read( sock, m_data.data() + oldSize, bytes );
+    }
+  while( done == -1 && errno == EINTR );
+
+  if( done <= 0 )
+    {
+      qWarning() << "GnssIngestThread: read() returns with ERROR: errno="
+                 << errno << "," << strerror(errno);
+      m_data.clear();
+      return false;
+    }
+
+  m_data.resize( oldSize + done );
+
+  // Every message starts with its length as unsigned integer.
+  int pos = 0;
+
+  while( m_data.size() - pos >= (int) sizeof(uint) )
+    {
+      uint msgLen = 0;
+
+      memcpy( &msgLen, m_data.constData() + pos, sizeof(msgLen) );
+
+      if( (uint) (m_data.size() - pos) - sizeof(msgLen) < msgLen )
+        {
+          // The message is incomplete, wait for the rest.
+          break;
+        }
+
+      handleMessage( m_data.constData() + pos + sizeof(msgLen), msgLen );
+
+      pos += sizeof(msgLen) + msgLen;
+    }
+
+  // Keep only the remainder of an incomplete message.
+  m_data.remove( 0, pos );
+
+  return true;
+}
+
+void GnssIngestThread::handleMessage( const char *data, const uint length )
+{
+  // A GPS batch contains several sentences, every one is terminated by a
+  // newline.
+  if( length >= sizeof(MSG_GPS_BATCH) &&
+      memcmp( data, MSG_GPS_BATCH " ", sizeof(MSG_GPS_BATCH) ) == 0 )
+    {
+      const char *sentence = data + sizeof(MSG_GPS_BATCH);
+      const char *end      = data + length;
+
+      while( sentence < end )
+        {
+          const char *nl = static_cast<const char *>( memchr( sentence, '\n', end - sentence ) );
+          const char *next = nl ? nl + 1 : end;
+
+          putSentence( sentence, next - sentence );
+
+          sentence = next;
+        }
+
+      return;
+    }
+
+  if( length >= sizeof(MSG_GPS_DATA) &&
+      memcmp( data, MSG_GPS_DATA " ", sizeof(MSG_GPS_DATA) ) == 0 )
+    {
+      putSentence( data + sizeof(MSG_GPS_DATA), length - sizeof(MSG_GPS_DATA) );
+      return;
+    }
+
+  // All other messages are handled by the consumer.
+  GnssRecord record;
+  record.type = GnssRecord::Message;
+  record.text = QString( QByteArray( data, length ) );
+
+  putRecord( record );
+}
+
+void GnssIngestThread::putSentence( const char *sentence, const int length )
+{
+  GnssRecord record;
+  record.type    = GnssRecord::Sentence;
+  record.text    = QString::fromLatin1( sentence, length );
+  record.fixType = m_decoder.decode( sentence, length, record.fix );
+
+  const uint epoch = m_assembler.assign( record.fixType, record.fix );
+
+  if( epoch & GnssEpochAssembler::EndBefore )
+    {
+      putEpochEnd();
+    }
+
+  putRecord( record );
+
+  if( epoch & GnssEpochAssembler::EndAfter )
+    {
+      putEpochEnd();
+    }
+}
+
+void GnssIngestThread::putEpochEnd()
+{
+  GnssRecord record;
+  record.type = GnssRecord::EpochEnd;
+
+  putRecord( record );
+}
+
+bool GnssIngestThread::putRecord( const GnssRecord& record )
+{
+  if( m_queue.put( record ) == false )
+    {
+      // The GUI thread is blocked for a longer time. The record is dropped,
+      // so that the socket is still read and the client is not blocked.
+      if( m_overflows++ == 0 )
+        {
+          qWarning() << "GnssIngestThread: Ingest queue is full, records are dropped!";
+        }
+
+      return false;
+    }
+
+  if( m_overflows > 0 )
+    {
+      qWarning() << "GnssIngestThread:" << m_overflows
+                 << "records dropped because of a full ingest queue";
+      m_overflows = 0;
+    }
+
+  if( m_queue.notifyConsumer() )
+    {
+      emit recordsAvailable();
+    }
+
+  return true;
+}
@@ -0,0 +1,183 @@
+/***********************************************************************
+**
+**   gnssingestthread.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class GnssIngestThread
+ *
+ * \author agent
+ *
+ * \brief Receives the data of the GPS client process in an extra thread.
+ *
+ * The thread reads the forward channel of the GPS client, splits the
+ * received bytes into messages and the GPS batches into sentences, decodes
+ * the position sentences and groups them to epochs by a
+ * \ref GnssEpochAssembler. The results are stored in a
+ * \ref GnssIngestQueue. The signal \ref recordsAvailable is emitted, when
+ * the GUI thread shall drain the queue.
+ *
+ * So the receiving, decoding and the epoch assembly continue, while the
+ * GUI thread is busy, e.g. during a map redraw. If the queue is full, the
+ * records are dropped and counted, so that the socket is still read and
+ * the GPS client is never blocked.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef GNSS_INGEST_THREAD_H
+#define GNSS_INGEST_THREAD_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "gnssepochassembler.h"
+#include "gnssingestqueue.h"
+#include "nmeadecoder.h"
+
+class GnssIngestThread : public QThread
+{
+  Q_OBJECT
+
+ private:
+
+  Q_DISABLE_COPY ( GnssIngestThread )
+
+ public:
+
+  GnssIngestThread( QObject *parent );
+
+  virtual ~GnssIngestThread();
+
+  /**
+   * Sets the socket of the forward channel. -1 stops the reading. The
+   * method returns, when the thread does not use the previous socket
+   * anymore, so that it can be closed by the caller.
+   */
+  void setSocket( const int sock );
+
+  /**
+   * \return The socket in use. It is -1, if the thread has released the
+   *         socket because the client has closed the connection.
+   */
+  int socket();
+
+  /**
+   * Must be called by the consumer before the queue is drained.
+   */
+  void startDrain()
+  {
+    m_queue.startDrain();
+  };
+
+  /**
+   * Takes the oldest received record. Must be called only by the consumer.
+   *
+   * \return False, if no record is available.
+   */
+  bool takeRecord( GnssRecord& record )
+  {
+    return m_queue.take( record );
+  };
+
+  /**
+   * Stops the thread and waits for its end.
+   */
+  void stop();
+
+ protected:
+
+  /**
+   * That is the main method of the thread.
+   */
+  void run();
+
+ signals:
+
+  /**
+   * Emitted, when new records are available after the last drain.
+   */
+  void recordsAvailable();
+
+  /**
+   * Emitted, when the client has closed the connection. The thread has
+   * released the socket already, the consumer must close it.
+   */
+  void closed( int sock );
+
+ private:
+
+  /**
+   * Reads all available bytes of the socket and handles the complete
+   * messages of them.
+   *
+   * \return False, if the socket is not usable anymore.
+   */
+  bool readSocket( const int sock );
+
+  /**
+   * Handles one message of the forward channel.
+   */
+  void handleMessage( const char *data, const uint length );
+
+  /**
+   * Decodes a sentence, assigns it to an epoch and stores it in the queue.
+   */
+  void putSentence( const char *sentence, const int length );
+
+  /**
+   * Stores the end of an epoch in the queue.
+   */
+  void putEpochEnd();
+
+  /**
+   * Stores a record in the queue. If the queue is full, the record is
+   * dropped and counted.
+   *
+   * \return False, if the record has been dropped.
+   */
+  bool putRecord( const GnssRecord& record );
+
+  GnssIngestQueue m_queue;
+
+  NmeaDecoder m_decoder;
+
+  GnssEpochAssembler m_assembler;
+
+  /** Received data, which do not yet form a complete message. */
+  QByteArray m_data;
+
+  /** Socket of the forward channel. Protected by m_mutex. */
+  int m_socket;
+
+  /** Socket, which is currently read by the thread. */
+  int m_current;
+
+  /** Set, while the thread uses m_current. Protected by m_mutex. */
+  bool m_busy;
+
+  /** Stop flag of the thread. Protected by m_mutex. */
+  bool m_stop;
+
+  /** Number of records dropped since the last stored one. */
+  uint m_overflows;
+
+  QMutex m_mutex;
+  QWaitCondition m_condition;
+};
+
+#endif
@@ -39,6 +39,7 @@
 #include "mapview.h"
 #include "gpsnmea.h"
 #include "gpscon.h"
+#include "gnssingestthread.h"
 #include "signalhandler.h"
 #include "protocol.h"
 #include "ipc.h"
@@ -70,7 +71,9 @@ GpsCon::GpsCon(QObject* parent, const char *pathIn) :
   startClient(false),
   pid(-1),
   listenNotifier(static_cast<QSocketNotifier *>(0)),
-  clientNotifier(static_cast<QSocketNotifier *>(0)),
+  ingest(static_cast<GnssIngestThread *>(0)),
+  drainTimer(static_cast<QTimer *>(0)),
+  receiving(true),
   timer(0),
   ioSpeed(0)
 {
@@ -100,6 +103,20 @@ GpsCon::GpsCon(QObject* parent, const char *pathIn) :
   timer = new QTimer(this);
   timer->connect( timer, SIGNAL(timeout()), this, SLOT(slot_Timeout()) );
 
+  // The forward channel of the client is read by an extra thread.
+  ingest = new GnssIngestThread(this);
+
+  connect( ingest, SIGNAL(recordsAvailable()), this, SLOT(slot_RecordsAvailable()) );
+  connect( ingest, SIGNAL(closed(int)), this, SLOT(slot_IngestClosed(int)) );
+
+  // The notifications of a burst are combined to one hand over per frame.
+  drainTimer = new QTimer(this);
+  drainTimer->setSingleShot( true );
+  drainTimer->setInterval( GnssIngestQueue::CoalesceInterval );
+  connect( drainTimer, SIGNAL(timeout()), this, SLOT(slot_IngestRecords()) );
+
+  ingest->start();
+
   initSignalHandler();
 
   // Port can be read from the configuration file for debugging purposes. If it
@@ -134,6 +151,10 @@ GpsCon::~GpsCon()
 {
   timer->stop();
 
+  // Stop the reading of the forward channel before the sockets are closed.
+  ingest->setSocket( -1 );
+  ingest->stop();
+
   if( server.getClientSock(0) != -1 )
     {
       // Sent shutdown to client
@@ -381,9 +402,7 @@ void GpsCon::triggerRetry()
   // No GPS BT devices are available or other error. We do shutdown
   // the GPS client process. That will initiate a restart
   // by the Cumulus process supervision.
-  clientNotifier->setEnabled( false );
-  delete clientNotifier;
-  clientNotifier = static_cast<QSocketNotifier *>(0);
+  ingest->setSocket( -1 );
 
   writeClientMessage( 0, MSG_SHD );
 
@@ -503,18 +522,14 @@ bool GpsCon::startClientProcess()
       server.closeClientSock(0);
     }
 
+  // The ingest thread must release the socket before it is closed.
+  ingest->setSocket( -1 );
+
   if( server.getClientSock(1) != -1 )
     {
       server.closeClientSock(1);
     }
 
-  // not more relevant after a crash, remove it
-  if( clientNotifier )
-    {
-      delete clientNotifier;
-      clientNotifier = static_cast<QSocketNotifier *>(0);
-    }
-
   QStringList pathes;
 
   char *pathVar = getenv( "PATH" );
@@ -676,7 +691,9 @@ void GpsCon::slot_Timeout()
   if( shutdownState )
     {
       // Shutdown is requested via signal and client got the signal
-      // too. Therefore we can close all sockets.
+      // too. Therefore we can close all sockets. The ingest thread must
+      // release the socket before.
+      ingest->setSocket( -1 );
       server.closeListenSock();
       server.closeClientSock(0);
       server.closeClientSock(1);
@@ -721,21 +738,9 @@ void GpsCon::slot_ListenEvent( int socket )
           return; // accept failed
         }
 
-      // activate a socket notifier for the new client. The client can be
-      // programmed to send a notification, if there are new data
-      // available. That makes polling superfluous.
-
-      // Delete an old existing notifier, it remains after a crash.
-      if( clientNotifier )
-        {
-          delete clientNotifier;
-        }
-
-      clientNotifier = new QSocketNotifier( server.getClientSock(1),
-                                            QSocketNotifier::Read, this );
-
-      clientNotifier->connect( clientNotifier, SIGNAL(activated(int)), this,
-                               SLOT(slot_NotificationEvent(int)) );
+      // The ingest thread reads the data of the new client. That makes
+      // polling superfluous.
+      ingest->setSocket( server.getClientSock(1) );
 
       // After the second client connect we send the initialization to the
       // client. That must be done at this point and not earlier, to avoid a
@@ -765,122 +770,127 @@ void GpsCon::slot_ListenEvent( int socket )
 }
 
 /**
- * This slot is triggered by the QT main loop and is used to get the
- * GPS or status data from the client.
+ * This slot is called by the ingest thread, when new records are available.
+ * The first notification is handled at once. The following ones of a burst
+ * are combined by the drain timer.
  */
-void GpsCon::slot_NotificationEvent( int socket )
+void GpsCon::slot_RecordsAvailable()
 {
-  QString method = QString("GPSCon::slot_NotificationEvent(%1):").arg(socket);
-
-  // Disable client notifier if socket shall be read. Advised by Qt.
-  clientNotifier->setEnabled( false );
-
-#ifdef DEBUG
-  qDebug("%s %s, got notification", method.toLatin1().data(), msg.toLatin1().data());
-#endif
+  if( drainTimer->isActive() )
+    {
+      // The records are taken over, when the timer expires.
+      return;
+    }
 
-  getDataFromClient();
+  slot_IngestRecords();
+  drainTimer->start();
+}
 
-  // Enable client notifier after read.
-  clientNotifier->setEnabled( true );
+/**
+ * This slot is called by the ingest thread, when the client has closed the
+ * connection.
+ */
+void GpsCon::slot_IngestClosed( int sock )
+{
+  // The socket is closed only, if it was not replaced in the meantime.
+  if( ingest->socket() == -1 && server.getClientSock(1) == sock )
+    {
+      qWarning() << "GpsCon::slot_IngestClosed(): Client has closed the connection!";
+      server.closeClientSock(1);
+    }
 }
 
 /**
- * Gets the GPS or status data from the client.
+ * This slot is called, when new records are available, and by the drain
+ * timer. All available records are handed over to the Cumulus process.
  */
-void GpsCon::getDataFromClient()
+void GpsCon::slot_IngestRecords()
 {
-  if( server.getClientSock( 1 ) == -1 )
+  if( receiving == false )
     {
-      // No connection to the client established.
+      // The records are kept in the queue until receiving is enabled again.
       return;
     }
 
-  // QTime t; t.start();
+  ingest->startDrain();
 
-  int loops = 0;
+  GnssRecord record;
 
-  while( loops++ < 250 )
+  while( receiving && ingest->takeRecord( record ) )
     {
-      // Check, if bytes are available in the receiver buffer because we
-      // use blocking IO.
-      int bytes = 0;
-
-      // Number of bytes currently in the socket receiver buffer.
-      if( ioctl( server.getClientSock( 1 ), FIONREAD, &bytes) == -1 )
+      switch( record.type )
         {
-          qWarning() << "GpsCon::getDataFromClient():"
-                     << "ioctl() returns with ERROR: errno="
-                     << errno
-                     << "," << strerror(errno);
-          break;
-        }
+          case GnssRecord::Sentence:
+          case GnssRecord::EpochEnd:
+            emit newRecord( record );
+            break;
 
-      if( bytes <= 0 )
-        {
-          break;
+          case GnssRecord::Message:
+            handleClientMessage( record.text );
+            break;
+
+          default:
+            break;
         }
+    }
 
-      QString msg;
+  // remember last start time
+  lastQuery.start();
+}
 
-      readClientMessage( 1, msg );
+/**
+ * Enables or disables the hand over of the received data.
+ */
+void GpsCon::enableReceiving( bool enable )
+{
+  receiving = enable;
 
-      if( server.getClientSock( 1 ) == -1 )
-        {
-          // socket will be closed in case of any problems, e.g. client has
-          // crashed. we check that to avoid a dead lock here.
-          return;
-        }
+  if( enable )
+    {
+      // Hand over the records, which have been received in the meantime.
+      slot_IngestRecords();
+    }
+}
 
-      if( msg.startsWith( MSG_GPS_DATA ) )
-        {
-          msg = msg.right(msg.length() - strlen(MSG_GPS_DATA) - 1);
-          emit newSentence(msg);
-        }
-      else if (msg == MSG_CON_OFF) // GPS connection has gone off
-        {
-          emit gpsConnectionOff();
-          qDebug(MSG_CON_OFF);
-        }
-      else if ( msg == MSG_CON_ON ) // GPS connection has gone on
-        {
-          emit gpsConnectionOn();
-          qDebug(MSG_CON_ON);
-        }
-      else if( msg.startsWith(MSG_FLARM_FLIGHT_LIST_RES) )
-        {
-          // A Flarm flight list was received.
-          msg = msg.right(msg.length() - strlen(MSG_FLARM_FLIGHT_LIST_RES) - 1);
-          emit newFlarmFlightList(msg);
-        }
-      else if( msg.startsWith(MSG_FLARM_FLIGHT_DOWNLOAD_INFO) )
-         {
-           // A Flarm download flight info was received.
-           msg = msg.right(msg.length() - strlen(MSG_FLARM_FLIGHT_DOWNLOAD_INFO) - 1);
-           emit newFlarmFlightDownloadInfo(msg);
-         }
-      else if( msg.startsWith(MSG_FLARM_FLIGHT_DOWNLOAD_PROGRESS) )
-         {
-           // A Flarm download progress info was received.
-           msg = msg.right(msg.length() - strlen(MSG_FLARM_FLIGHT_DOWNLOAD_PROGRESS) - 1);
-
-           QStringList args = msg.split(",");
-
-           if( args.size() == 2 )
-             {
-               emit newFlarmFlightDownloadProgress(args[0].toInt(), args[1].toInt() );
-             }
-         }
-      else
+/**
+ * Handles a status message of the forward channel.
+ */
+void GpsCon::handleClientMessage( const QString& msg )
+{
+  if (msg == MSG_CON_OFF) // GPS connection has gone off
+    {
+      emit gpsConnectionOff();
+      qDebug(MSG_CON_OFF);
+    }
+  else if ( msg == MSG_CON_ON ) // GPS connection has gone on
+    {
+      emit gpsConnectionOn();
+      qDebug(MSG_CON_ON);
+    }
+  else if( msg.startsWith(MSG_FLARM_FLIGHT_LIST_RES) )
+    {
+      // A Flarm flight list was received.
+      emit newFlarmFlightList( msg.right(msg.length() - strlen(MSG_FLARM_FLIGHT_LIST_RES) - 1) );
+    }
+  else if( msg.startsWith(MSG_FLARM_FLIGHT_DOWNLOAD_INFO) )
+    {
+      // A Flarm download flight info was received.
+      emit newFlarmFlightDownloadInfo( msg.right(msg.length() - strlen(MSG_FLARM_FLIGHT_DOWNLOAD_INFO) - 1) );
+    }
+  else if( msg.startsWith(MSG_FLARM_FLIGHT_DOWNLOAD_PROGRESS) )
+    {
+      // A Flarm download progress info was received.
+      QStringList args = msg.right(msg.length() - strlen(MSG_FLARM_FLIGHT_DOWNLOAD_PROGRESS) - 1).split(",");
+
+      if( args.size() == 2 )
         {
-          qWarning() << "GpsCon::getDataFromClient(): Protocol Error!" << msg;
+          emit newFlarmFlightDownloadProgress(args[0].toInt(), args[1].toInt() );
         }
     }
-
-  // qDebug() << "MSG_GPS_DATA Loops" << loops << t.elapsed();
-
-  // remember last start time
-  lastQuery.start();
+  else
+    {
+      qWarning() << "GpsCon::handleClientMessage(): Protocol Error!" << msg;
+    }
 }
 
 /**
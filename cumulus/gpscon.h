@@ -44,6 +44,9 @@
 
 #include "ipc.h"
 #include "datatypes.h"
+#include "gnssingestqueue.h"
+
+class GnssIngestThread;
 
 // Device name for NMEA simulator. This name is also taken for the named pipe.
 #define NMEASIM_DEVICE "/tmp/nmeasim"
@@ -123,12 +126,10 @@ class GpsCon : public QObject
     bool stopGpsReceiving();
 
     /**
-     * Returns the socket notifier of the daemon connection.
+     * Enables or disables the hand over of the received data. If disabled,
+     * the received data are kept in the ingest queue.
      */
-    QSocketNotifier* getDaemonNotifier() const
-    {
-      return clientNotifier;
-    };
+    void enableReceiving( bool enable );
 
     /**
      * Sends the well known GPS message keys to the GPS client process.
@@ -159,9 +160,11 @@ class GpsCon : public QObject
 
   signals:
     /**
-     * This signal is send every time a new sentence has arrived.
+     * This signal is send every time a new sentence has arrived and at the
+     * end of every epoch. The record contains the sentence and its decoding
+     * result respectively the end of the epoch.
      */
-    void newSentence(const QString& sentence);
+    void newRecord(const GnssRecord& record);
 
     /**
      * This signal is send, if the GPS connection has been lost.
@@ -213,10 +216,9 @@ class GpsCon : public QObject
     void writeClientMessage( uint index, const char *msg  );
 
     /**
-     * Gets the GPS or status data from the client. The retrieved data will
-     * be hand over to the Cumulus process.
+     * Handles a status message of the forward channel.
      */
-    void getDataFromClient();
+    void handleClientMessage( const QString& msg );
 
     /**
      * Triggers a connection retry in case of error.
@@ -225,10 +227,22 @@ class GpsCon : public QObject
 
   private slots:
     /**
-     * This slot is triggered by the QT main loop and is used to handle the
-     * notification events from the client.
+     * This slot is called by the ingest thread, if new records are available.
+     * The records are handed over at once, if the drain timer is not
+     * running. Otherwise they are handed over, when it expires.
+     */
+    void slot_RecordsAvailable();
+
+    /**
+     * This slot is called by the ingest thread, if the client has closed the
+     * forward channel. The socket is closed then.
      */
-    void slot_NotificationEvent(int socket);
+    void slot_IngestClosed( int sock );
+
+    /**
+     * All available records are handed over to the Cumulus process.
+     */
+    void slot_IngestRecords();
 
     /**
      * This slot is triggered by the QT main loop and is used to handle the
@@ -278,7 +292,15 @@ class GpsCon : public QObject
 
     // Notifier for QT main loop
     QSocketNotifier *listenNotifier;
-    QSocketNotifier *clientNotifier;
+
+    // Reads the forward channel of the client
+    GnssIngestThread *ingest;
+
+    // Combines the notifications of a burst to one drain per frame
+    QTimer *drainTimer;
+
+    // Flag to indicate the hand over of the received data.
+    bool receiving;
 
     // used as timeout control for connection supervision
     QTimer *timer;
@@ -289,6 +311,7 @@ class GpsCon : public QObject
     // IPC instance to client process
     Ipc::Server server;
 
+
     // RX/TX rate of serial device
     uint ioSpeed;
 
@@ -36,6 +36,11 @@ QByteArray GpsConAndroid::rcvBuffer;
 QMutex     GpsConAndroid::mutexRead;
 QMutex     GpsConAndroid::mutexWrite;
 QMutex     GpsConAndroid::mutexAction;
+QMutex     GpsConAndroid::mutexIngest;
+
+GnssIngestQueue    GpsConAndroid::ingestQueue;
+NmeaDecoder        GpsConAndroid::decoder;
+GnssEpochAssembler GpsConAndroid::assembler;
 
 GpsConAndroid::GpsConAndroid(QObject* parent) : QObject(parent)
 {
@@ -162,9 +167,47 @@ void GpsConAndroid::forwardNmea( QString& qnmea )
         }
     }
 
-  // Hand over the GPS data as event to the GUI thread.
-  GpsNmeaEvent *ne = new GpsNmeaEvent(qnmea);
-  QCoreApplication::postEvent( GpsNmea::gps, ne, Qt::HighEventPriority );
+  // The sentence is decoded in this thread. The queue allows only one
+  // producer at a time, the Java part can call from different threads.
+  QMutexLocker locker(&mutexIngest);
+
+  GnssRecord record;
+  record.text    = qnmea;
+  record.fixType = decoder.decode( qnmea, record.fix );
+
+  const uint epoch = assembler.assign( record.fixType, record.fix );
+
+  GnssRecord epochEnd;
+  epochEnd.type = GnssRecord::EpochEnd;
+
+  if( epoch & GnssEpochAssembler::EndBefore )
+    {
+      putRecord( epochEnd );
+    }
+
+  putRecord( record );
+
+  if( epoch & GnssEpochAssembler::EndAfter )
+    {
+      putRecord( epochEnd );
+    }
+}
+
+void GpsConAndroid::putRecord( const GnssRecord& record )
+{
+  if( ingestQueue.put( record ) == false )
+    {
+      // The GUI thread is blocked for a longer time, drop the record.
+      qWarning() << "GpsConAndroid::putRecord: Ingest queue is full!";
+      return;
+    }
+
+  if( ingestQueue.notifyConsumer() )
+    {
+      // Wake up the GUI thread, one event is posted per drain.
+      GpsNmeaEvent *ne = new GpsNmeaEvent();
+      QCoreApplication::postEvent( GpsNmea::gps, ne, Qt::HighEventPriority );
+    }
 }
 
 /**
@@ -36,6 +36,9 @@
 #include <QObject>
 #include <QTime>
 
+#include "gnssepochassembler.h"
+#include "gnssingestqueue.h"
+
 class QByteArray;
 class QMutex;
 class QString;
@@ -87,11 +90,36 @@ class GpsConAndroid : public QObject
   static bool verifyCheckSum( const char *sentence );
 
   /**
-   * Forwards a NMEA message as event to the related method running in the
-   * GUI thread.
+   * Decodes a NMEA message, assigns it to an epoch and forwards it via the
+   * ingest queue to the GUI thread. The GUI thread is notified by an event.
    */
   static void forwardNmea( QString& qnmea );
 
+  /**
+   * Stores a record in the ingest queue and notifies the GUI thread, if
+   * necessary. Must be called with locked mutexIngest.
+   */
+  static void putRecord( const GnssRecord& record );
+
+  /**
+   * Must be called by the GUI thread before the ingest queue is drained.
+   */
+  static void startDrain()
+  {
+    ingestQueue.startDrain();
+  };
+
+  /**
+   * Takes the oldest record of the ingest queue. Must be called only by the
+   * GUI thread.
+   *
+   * \return False, if no record is available.
+   */
+  static bool takeRecord( GnssRecord& record )
+  {
+    return ingestQueue.take( record );
+  };
+
 #ifdef FLARM
 
   /** Gets the flight list from the Flarm device. */
@@ -153,6 +181,18 @@ class GpsConAndroid : public QObject
   /** Thread synchronizer for actions. */
   static QMutex mutexAction;
 
+  /** Thread synchronizer for the producers of the ingest queue. */
+  static QMutex mutexIngest;
+
+  /** Hand over of the received sentences to the GUI thread. */
+  static GnssIngestQueue ingestQueue;
+
+  /** Decoder of the received sentences, protected by mutexIngest. */
+  static NmeaDecoder decoder;
+
+  /** Groups the received sentences to epochs, protected by mutexIngest. */
+  static GnssEpochAssembler assembler;
+
   /** Timeout control for Flarm IGC download. */
   QTime downloadTimeControl;
 };
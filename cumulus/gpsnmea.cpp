@@ -83,6 +83,10 @@ QMutex GpsNmea::mutex;
 
 GpsNmea::GpsNmea(QObject* parent) :
   QObject(parent),
+  _epochTimer(0),
+#ifdef ANDROID
+  _ingestTimer(0),
+#endif
   flarmNmeaOutInitDone(false)
 {
   if( instances > 0 )
@@ -104,6 +108,20 @@ GpsNmea::GpsNmea(QObject* parent) :
   timeOutFix = new QTimer(this);
   connect (timeOutFix, SIGNAL(timeout()), this, SLOT(_slotTimeoutFix()));
 
+  // Publishing of epochs, which are not completed in time
+  _epochTimer = new QTimer(this);
+  _epochTimer->setSingleShot( true );
+  _epochTimer->setInterval( 1000 );
+  connect (_epochTimer, SIGNAL(timeout()), this, SLOT(_slotTimeoutEpoch()));
+
+#ifdef ANDROID
+  // The notifications of a burst are combined to one drain per frame.
+  _ingestTimer = new QTimer(this);
+  _ingestTimer->setSingleShot( true );
+  _ingestTimer->setInterval( GnssIngestQueue::CoalesceInterval );
+  connect (_ingestTimer, SIGNAL(timeout()), this, SLOT(_slotIngestRecords()));
+#endif
+
   // Load last used device
   gpsDevice = GeneralConfig::instance()->getGpsDevice();
 
@@ -246,6 +264,7 @@ void GpsNmea::resetDataObjects()
 
   // GPS source to be used
   _gpsSource = GeneralConfig::instance()->getGpsSource().left(3);
+  GnssEpochAssembler::setTalker( _gpsSource );
 
   // special logger items
   _lastWindDirection = 0;
@@ -285,12 +304,9 @@ void GpsNmea::createGpsConnection()
 
   gpsObject = serial;
 
-  connect (gpsObject, SIGNAL(newSentence(const QString&)),
-           this, SLOT(slot_sentence(const QString&)) );
-
-  // Broadcasts the new NMEA sentence
-  connect (gpsObject, SIGNAL(newSentence(const QString&)),
-           this, SIGNAL(newSentence(const QString&)) );
+  // The sentences are received and decoded by the ingest thread of GpsCon
+  connect (gpsObject, SIGNAL(newRecord(const GnssRecord&)),
+           this, SLOT(slot_record(const GnssRecord&)) );
 
   // Broadcasts that a new Flarm flight list is available
   connect (gpsObject, SIGNAL(newFlarmFlightList(const QString&)),
@@ -333,14 +349,7 @@ void GpsNmea::enableReceiving( bool enable )
 
   if ( serial )
     {
-      QSocketNotifier* notifier = static_cast<QSocketNotifier *> (0);
-
-      notifier = serial->getDaemonNotifier();
-
-      if( notifier )
-        {
-          notifier->setEnabled( enable );
-        }
+      serial->enableReceiving( enable );
     }
 
 #endif
@@ -384,7 +393,47 @@ void GpsNmea::startGpsReceiver()
  */
 void GpsNmea::slot_sentence(const QString& sentenceIn)
 {
-  // qDebug("GpsNmea::slot_sentence: %s", sentenceIn.toLatin1().data());
+  // The position sentences are decoded byte-wise without any splitting.
+  const int fixType = _nmeaDecoder.decode( sentenceIn, _nmeaFix );
+  const uint epoch = _epochAssembler.assign( fixType, _nmeaFix );
+
+  if( epoch & GnssEpochAssembler::EndBefore )
+    {
+      publishEpoch();
+    }
+
+  processSentence( sentenceIn, fixType );
+
+  if( epoch & GnssEpochAssembler::EndAfter )
+    {
+      publishEpoch();
+    }
+}
+
+/**
+ * This slot is called with a sentence, which has been decoded already by the
+ * GNSS ingest thread. The sentence is analyzed and broadcasted.
+ */
+void GpsNmea::slot_record(const GnssRecord& record)
+{
+  if( record.type == GnssRecord::EpochEnd )
+    {
+      // All sentences of the epoch have been processed before.
+      publishEpoch();
+      return;
+    }
+
+  _nmeaFix = record.fix;
+
+  processSentence( record.text, record.fixType );
+
+  // Broadcasts the new NMEA sentence
+  emit newSentence( record.text );
+}
+
+void GpsNmea::processSentence( const QString& sentenceIn, const int fixType )
+{
+  // qDebug("GpsNmea::processSentence: %s", sentenceIn.toLatin1().data());
 
   if( flarmNmeaOutInitDone == false )
     {
@@ -420,26 +469,37 @@ void GpsNmea::slot_sentence(const QString& sentenceIn)
       return;
     }
 
-  // Split sentence in single parts for each comma and the checksum. The first
-  // part will contain the identifier, the rest the arguments.
-  QStringList slst = sentenceIn.split( QRegExp("[,*]"), QString::KeepEmptyParts );
+  if( fixType == NmeaFix::Corrupt )
+    {
+      qWarning() << "GpsNmea::processSentence: Corrupt sentence" << sentenceIn;
+      return;
+    }
+
+  QStringList slst;
 
-  if( ! gpsHash.contains(slst[0]) )
+  if( fixType == NmeaFix::None )
     {
-      if( ! reportedUnknownKeys.contains(slst[0]) )
+      // Split sentence in single parts for each comma and the checksum. The first
+      // part will contain the identifier, the rest the arguments.
+      slst = NmeaDecoder::split( sentenceIn );
+
+      if( ! gpsHash.contains(slst[0]) )
         {
-          qWarning() << "GpsNmea::slot_sentence: No Id found for" << slst[0];
-          reportedUnknownKeys.insert(slst[0]);
-        }
+          if( ! reportedUnknownKeys.contains(slst[0]) )
+            {
+              qWarning() << "GpsNmea::processSentence: No Id found for" << slst[0];
+              reportedUnknownKeys.insert(slst[0]);
+            }
 
-      return;
+          return;
+        }
     }
 
   dataOK();
 
 #ifdef FLARM
 
-  if( slst[0] == "$PFLAA" )
+  if( fixType == NmeaFix::PFLAA )
     {
       // PFLAA receiving starts
       pflaaIsReceiving = true;
@@ -458,7 +518,7 @@ void GpsNmea::slot_sentence(const QString& sentenceIn)
 #if 0
 //aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa
 
-  if( slst[0] == "$GPRMC" )
+  if( fixType == NmeaFix::RMC )
     {
       /**
        *   1     2    3    4      5         6            7                8
@@ -575,43 +635,88 @@ void GpsNmea::slot_sentence(const QString& sentenceIn)
 //aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa
 #endif
 
-  // Call the decode methods for the known sentences
-  switch( gpsHash.value( slst[0] ) )
-  {
-    case 0: // GPRMC
-      if( slst[0].startsWith(_gpsSource) )
-          {
-            __ExtractGprmc( slst );
-          }
-      return;
+  if( NmeaFix::isPosition( fixType ) )
+    {
+      // The GPS source is the begin of the identifier, e.g. $GP.
+      if( _gpsSource.size() != 3 ||
+          _gpsSource.at(1) != QLatin1Char( _nmeaFix.identifier[1] ) ||
+          _gpsSource.at(2) != QLatin1Char( _nmeaFix.identifier[2] ) )
+        {
+          return;
+        }
 
-    case 1: // GPGLL
-      if( slst[0].startsWith(_gpsSource) )
-          {
-            __ExtractGpgll( slst );
-          }
-      return;
+      switch( fixType )
+        {
+          case NmeaFix::RMC:
+            __ExtractGprmc( _nmeaFix );
+            break;
 
-    case 2: // GPGGA
-      if( slst[0].startsWith(_gpsSource) )
-          {
-            __ExtractGpgga( slst );
-          }
-      return;
+          case NmeaFix::GLL:
+            __ExtractGpgll( _nmeaFix );
+            break;
 
-    case 3: // GPGSA
-      if( slst[0].startsWith(_gpsSource) )
-          {
-            __ExtractConstellation( slst );
-          }
-      return;
+          case NmeaFix::GGA:
+            __ExtractGpgga( _nmeaFix );
+            break;
+
+          case NmeaFix::GNS:
+            __ExtractGngns( _nmeaFix );
+            break;
+
+          default:
+            break;
+        }
 
-    case 4: // GPGSV or GLGSV
-      // __ExtractSatsInView( slst );
-      return;
-    case 5: // PGRMZ
-      __ExtractPgrmz( slst );
       return;
+    }
+
+  if( fixType != NmeaFix::None )
+    {
+      // The type of these sentences is known by the decoder. Their fields
+      // are only split for the extract methods.
+      switch( fixType )
+        {
+          case NmeaFix::GSA:
+
+            if( sentenceIn.startsWith(_gpsSource) )
+              {
+                __ExtractConstellation( NmeaDecoder::split( sentenceIn ) );
+              }
+
+            return;
+
+          case NmeaFix::GSV:
+            // __ExtractSatsInView( slst );
+            return;
+
+          case NmeaFix::PGRMZ:
+            __ExtractPgrmz( NmeaDecoder::split( sentenceIn ) );
+            return;
+
+#ifdef FLARM
+
+          case NmeaFix::PFLAA:
+            {
+              Flarm::FlarmAcft aircraft;
+              Flarm::instance()->extractPflaa( NmeaDecoder::split( sentenceIn ), aircraft );
+              return;
+            }
+
+          case NmeaFix::PFLAU:
+            __ExtractPflau( NmeaDecoder::split( sentenceIn ) );
+            return;
+
+#endif
+
+          default:
+            // Flarm sentences are ignored without Flarm support.
+            return;
+        }
+    }
+
+  // Call the decode methods for the other known sentences
+  switch( gpsHash.value( slst[0] ) )
+  {
     case 6: // PCAID
       __ExtractPcaid( slst );
       return;
@@ -631,26 +736,8 @@ void GpsNmea::slot_sentence(const QString& sentenceIn)
       __ExtractGpdtm( slst );
       return;
 
-    case 12: // $GNGNS
-      if( slst[0].startsWith(_gpsSource) )
-          {
-            __ExtractGngns( slst );
-          }
-      return;
-
 #ifdef FLARM
 
-    case 20: // $PFLAA
-      {
-        Flarm::FlarmAcft aircraft;
-        Flarm::instance()->extractPflaa( slst, aircraft );
-        return;
-      }
-
-    case 21: // $PFLAU
-      __ExtractPflau( slst );
-      return;
-
     case 22: // $PFLAV
       Flarm::instance()->extractPflav( slst );
       return;
@@ -736,24 +823,23 @@ void GpsNmea::slot_sentence(const QString& sentenceIn)
    12) Signal integrity, A=Autonomous mode
    13) Checksum, hh
 */
-void GpsNmea::__ExtractGprmc( const QStringList& slst )
+void GpsNmea::__ExtractGprmc( const NmeaFix& fix )
 {
-  if( slst.size() < 14 )
+  if( fix.fields < 14 )
     {
-      qWarning() << slst[0] << "contains too less parameters!";
+      qWarning() << fix.identifier << "contains too less parameters!";
       return;
     }
 
   _gprmcSeen = true;
 
-  //qDebug("%s",slst[2].toLatin1().data());
-  if( slst[2] == "A" )
+  if( fix.status == NmeaFix::Valid )
     { /* Data status A=OK, V=warning */
       fixOK( "RMC" );
 
       static QTime lastUtcTime;
 
-      QTime utcTime = __ExtractTime(slst[1]);
+      QTime utcTime = __ExtractTime(fix);
 
       if( lastUtcTime == utcTime )
         {
@@ -763,10 +849,19 @@ void GpsNmea::__ExtractGprmc( const QStringList& slst )
 
       lastUtcTime = utcTime;
 
-      __ExtractDate(slst[9]);
-      __ExtractKnotSpeed(slst[7]);
-      __ExtractCoord(slst[3],slst[4],slst[5],slst[6]);
-      __ExtractHeading(slst[8]);
+      __ExtractDate(fix);
+
+      if( fix.valid & NmeaFix::Speed )
+        {
+          __ExtractKnotSpeed(fix.speed);
+        }
+
+      __ExtractCoord(fix);
+
+      if( fix.valid & NmeaFix::Heading )
+        {
+          __ExtractHeading(fix.heading);
+        }
 
       if( _lastTime.isValid() && _lastDate.isValid() )
         {
@@ -795,7 +890,7 @@ void GpsNmea::__ExtractGprmc( const QStringList& slst )
                * We do check the fix time only here in the $GPRMC sentence.
                */
               _lastRmcUtc = utc;
-              emit newFix( _lastRmcUtc );
+              updateEpoch( GnssEpoch::Fix );
             }
         }
     }
@@ -803,8 +898,8 @@ void GpsNmea::__ExtractGprmc( const QStringList& slst )
     {
       fixNOK( "RMC" );
 
-      QTime time = __ExtractTime( slst[1] );
-      QDate date = __ExtractDate( slst[9] );
+      QTime time = __ExtractTime( fix );
+      QDate date = __ExtractDate( fix );
 
       if( time.isValid() && date.isValid() )
         {
@@ -835,19 +930,19 @@ void GpsNmea::__ExtractGprmc( const QStringList& slst )
     6) Status A - Data Valid, V - Data Invalid
     7) Checksum
 */
-void GpsNmea::__ExtractGpgll( const QStringList& slst )
+void GpsNmea::__ExtractGpgll( const NmeaFix& fix )
 {
-  if( slst.size() < 8 )
+  if( fix.fields < 8 )
     {
-      qWarning() << slst[0] << "contains too less parameters!";
+      qWarning() << fix.identifier << "contains too less parameters!";
       return;
     }
 
-  if (slst[6] == "A")
+  if( fix.status == NmeaFix::Valid )
     {
       fixOK( "GGL" );
-      __ExtractTime(slst[5]);
-      __ExtractCoord(slst[1],slst[2],slst[3],slst[4]);
+      __ExtractTime(fix);
+      __ExtractCoord(fix);
     }
   else
     {
@@ -886,15 +981,15 @@ void GpsNmea::__ExtractGpgll( const QStringList& slst )
    14) Differential reference station ID, 0000-1023
    15) Checksum
 */
-void GpsNmea::__ExtractGpgga( const QStringList& slst )
+void GpsNmea::__ExtractGpgga( const NmeaFix& fix )
 {
-  if ( slst.size() < 16 )
+  if ( fix.fields < 16 )
     {
-      qWarning() << slst[0] << "contains too less parameters!";
+      qWarning() << fix.identifier << "contains too less parameters!";
       return;
     }
 
-  if ( slst[6] != "0" && ! slst[6].isEmpty() )
+  if ( fix.status == NmeaFix::Valid )
     {
       /* a value of 0 means invalid fix and we don't need that one */
       if( _gprmcSeen == false )
@@ -906,7 +1001,7 @@ void GpsNmea::__ExtractGpgga( const QStringList& slst )
 
       static QTime lastUtcTime;
 
-      QTime utcTime = __ExtractTime(slst[1]);
+      QTime utcTime = __ExtractTime(fix);
 
       if( lastUtcTime == utcTime )
         {
@@ -916,11 +1011,19 @@ void GpsNmea::__ExtractGpgga( const QStringList& slst )
 
       lastUtcTime = utcTime;
 
-      __ExtractCoord(slst[2], slst[3], slst[4], slst[5]);
-      __ExtractAltitude(slst[9], slst[10]);
-      __ExtractSatsInView(slst[7]);
+      __ExtractCoord(fix);
+
+      if( fix.valid & NmeaFix::Altitude )
+        {
+          __ExtractAltitude( fix.altitude, fix.altitudeUnit == 'f' || fix.altitudeUnit == 'F' );
+        }
+
+      if( fix.valid & NmeaFix::Satellites )
+        {
+          __ExtractSatsInView(fix.satellites);
+        }
     }
-  else if( slst[6] == "0" )
+  else if( fix.status == NmeaFix::Invalid )
     {
       if( _gprmcSeen == false )
         {
@@ -962,19 +1065,19 @@ $GNGNS,124524.0,5227.153706,N,01335.903142,E,AA,15,0.7,37.5,43.0, ,  *54<CR><LF>
    12) Differential reference station ID, 0000-1023
    13) Checksum
  */
-void GpsNmea::__ExtractGngns( const QStringList& slst )
+void GpsNmea::__ExtractGngns( const NmeaFix& fix )
 {
-  if( slst.size() < 14 )
+  if( fix.fields < 14 )
     {
-      qWarning() << slst[0] << "contains too less parameters!";
+      qWarning() << fix.identifier << "contains too less parameters!";
       return;
     }
 
-  if( slst[6].contains( "N") == false )
+  if( fix.status == NmeaFix::Valid )
     {
       static QTime lastUtcTime;
 
-      QTime utcTime = __ExtractTime(slst[1]);
+      QTime utcTime = __ExtractTime(fix);
 
       if( lastUtcTime == utcTime )
         {
@@ -984,9 +1087,17 @@ void GpsNmea::__ExtractGngns( const QStringList& slst )
 
       lastUtcTime = utcTime;
 
-      __ExtractCoord(slst[2], slst[3], slst[4], slst[5]);
-      __ExtractAltitude(slst[9], QString("M"));
-      __ExtractSatsInView(slst[7]);
+      __ExtractCoord(fix);
+
+      if( fix.valid & NmeaFix::Altitude )
+        {
+          __ExtractAltitude( fix.altitude, false );
+        }
+
+      if( fix.valid & NmeaFix::Satellites )
+        {
+          __ExtractSatsInView(fix.satellites);
+        }
     }
 }
 
@@ -1035,7 +1146,7 @@ void GpsNmea::__ExtractPgrmz( const QStringList& slst )
                   _lastMslAltitude.setMeters( altitude.getMeters() + _userAltitudeCorrection.getMeters() );
 
                   // report new pressure altitude
-                  emit newAltitude( _lastMslAltitude, _lastStdAltitude, _lastGNSSAltitude );
+                  updateEpoch( GnssEpoch::Altitude );
                 }
             }
           }
@@ -1142,7 +1253,7 @@ void GpsNmea::__ExtractPgcs( const QStringList& slst )
       // the MSL altitude using the QNH provided by the user
       calcMslAltitude( res );
 
-      emit newAltitude( _lastMslAltitude, _lastStdAltitude, _lastGNSSAltitude );
+      updateEpoch( GnssEpoch::Altitude );
     }
 }
 
@@ -1316,7 +1427,7 @@ void GpsNmea::__ExtractCambridgeW( const QStringList& stringList )
             // set these altitudes too, when pressure is selected
             _lastMslAltitude.setMeters( res.getMeters() + _userAltitudeCorrection.getMeters() );
             // STD altitude is delivered by Cambrigde via $PCAID record
-            emit newAltitude( _lastMslAltitude, _lastStdAltitude, _lastGNSSAltitude );
+            updateEpoch( GnssEpoch::Altitude );
           }
       }
     }
@@ -1447,7 +1558,7 @@ void GpsNmea::__ExtractLxwp0( const QStringList& stringList )
                   // set these altitudes too, when pressure is selected
                   _lastMslAltitude.setMeters( altitude.getMeters() + _userAltitudeCorrection.getMeters() );
 
-                  emit newAltitude( _lastMslAltitude, _lastStdAltitude, _lastGNSSAltitude );
+                  updateEpoch( GnssEpoch::Altitude );
                 }
             }
         }
@@ -1542,30 +1653,25 @@ void GpsNmea::__ExtractLxwp2( const QStringList& stringList )
 }
 
 /**
- * This function returns a QTime from the time encoded in a MNEA sentence.
+ * This function returns a QTime from the time of a decoded position sentence.
  */
-QTime GpsNmea::__ExtractTime(const QString& timeString)
+QTime GpsNmea::__ExtractTime(const NmeaFix& fix)
 {
-  if( timeString.isEmpty() && timeString.size() < 6 )
+  if( ! (fix.valid & NmeaFix::Time) )
     {
-      // qWarning("Invalid GPS time %s", timeString.toLatin1().data());
       return QTime();
     }
 
-  QString hh (timeString.left(2));
-  QString mm (timeString.mid(2,2));
-  QString ss (timeString.mid(4,2));
-
   // @AP: newer CF Cards can also provide milliseconds. In this case the time
   // format is defined as hhmmss.sss. But we will not use it to avoid problems
   // with our fixes.
-  QTime res = QTime( hh.toInt(), mm.toInt(), ss.toInt() );
+  QTime res = QTime( fix.hour, fix.minute, fix.second );
 
   // @AP: don't overtake invalid times. They will cause invalid fixes!
   if ( ! res.isValid() )
     {
-      qWarning("GpsNmea::__ExtractTime(): Invalid time %s! Ignoring it (%s, %d)",
-               timeString.toLatin1().data(), __FILE__, __LINE__ );
+      qWarning("GpsNmea::__ExtractTime(): Invalid time %02d%02d%02d! Ignoring it (%s, %d)",
+               fix.hour, fix.minute, fix.second, __FILE__, __LINE__ );
       return QTime();
     }
 
@@ -1574,134 +1680,61 @@ QTime GpsNmea::__ExtractTime(const QString& timeString)
   return res;
 }
 
-/** This function returns a QDate from the date string encoded in a
-    NWEA sentence as "ddmmyy". */
-QDate GpsNmea::__ExtractDate(const QString& dateString)
+/** This function returns a QDate from the date of a decoded position sentence. */
+QDate GpsNmea::__ExtractDate(const NmeaFix& fix)
 {
-  if( dateString.isEmpty() && dateString.size() != 6 )
+  if( ! (fix.valid & NmeaFix::Date) )
     {
-      // qWarning("Invalid GPS date %s", dateString.toLatin1().data());
       return QDate();
     }
 
-  QString dd (dateString.left(2));
-  QString mm (dateString.mid(2,2));
-  QString yy (dateString.right(2));
-
-  /*we assume that we only use this after the year 2000, which is
-    reasonable since this is made 2002 ...*/
-
-  bool ok1, ok2, ok3;
-
-  QDate res (yy.toInt(&ok1) + 2000, mm.toInt(&ok2), dd.toInt(&ok3) );
+  QDate res( fix.year, fix.month, fix.day );
 
   // @AP: don't take over invalid dates
-  if ( ok1 && ok2 && ok3 && res.isValid() )
+  if ( res.isValid() )
     {
       _lastDate = res;
     }
   else
     {
-      qWarning("GpsNmea::__ExtractDate(): Invalid date %s! Ignoring it (%s, %d)",
-               dateString.toLatin1().data(), __FILE__, __LINE__ );
+      qWarning("GpsNmea::__ExtractDate(): Invalid date %02d%02d%02d! Ignoring it (%s, %d)",
+               fix.day, fix.month, fix.year % 100, __FILE__, __LINE__ );
     }
 
   return res;
 }
 
-/** This function returns a Speed from the speed encoded in knots */
-Speed GpsNmea::__ExtractKnotSpeed(const QString& speedString)
+/** This function returns a Speed from the speed in knots */
+Speed GpsNmea::__ExtractKnotSpeed(const double knots)
 {
   Speed res;
 
-  if( speedString.isEmpty() )
-    {
-      return res;
-    }
-
-  bool ok;
-  double speed = speedString.toDouble( &ok );
-
-  if( ok == false )
-    {
-      return res;
-    }
-
-  res.setKnot( speed );
+  res.setKnot( knots );
 
   if( res != _lastSpeed )
     {
       _lastSpeed = res;
-      emit newSpeed( _lastSpeed );
+      updateEpoch( GnssEpoch::Speed );
     }
 
   return res;
 }
 
-/** This function converts the coordinate data from the NMEA sentence to the internal QPoint format. */
-QPoint GpsNmea::__ExtractCoord(const QString& slat, const QString& slatNS,
-                               const QString& slon, const QString& slonEW)
+/** This function takes over the coordinate of a decoded position sentence. */
+QPoint GpsNmea::__ExtractCoord(const NmeaFix& fix)
 {
-  /* The internal KFLog format for coordinates represents coordinates in 10.000'st of a minute.
-     So, one minute corresponds to 10.000, one degree to 600.000 and one second to 167.
-     KFLogCoord = degrees * 600000 + minutes * 10000
-  */
-
-  if( slat.isEmpty() || slatNS.isEmpty() ||
-      slon.isEmpty() || slonEW.isEmpty() )
-      {
-        return QPoint();
-      }
-
-  int lat = 0;
-  int lon = 0;
-  float fLat = 0.0;
-  float fLon = 0.0;
-
-  bool ok1, ok2, ok3, ok4;
-
-  lat  = slat.left(2).toInt(&ok1);
-  fLat = slat.mid(2).toFloat(&ok2);
-
-  // qDebug ("slat: %s", slat.toLatin1().data());
-  // qDebug ("lat/fLat: %d/%f", lat, fLat);
-
-  lon  = slon.left(3).toInt(&ok3);
-  fLon = slon.mid(3).toFloat(&ok4);
-
-  if( !ok1 || !ok2 || !ok3 || !ok4 )
+  // The decoder delivers the coordinates already in the KFLog format.
+  if( ! (fix.valid & NmeaFix::Position) )
     {
       return QPoint();
     }
 
-  // qDebug ("slon: %s", slon.toLatin1().data());
-  // qDebug ("lon/fLon: %d/%f", lon, fLon);
-
-  int latMin = (int) rint(fLat * 10000);
-  int lonMin = (int) rint(fLon * 10000);
-
-  // convert to internal KFLog format
-  int latTemp = lat * 600000 + latMin;
-  int lonTemp = lon * 600000 + lonMin;
-
-  // qDebug("latTemp=%d, lonTemp=%d", latTemp, lonTemp);
-
-  if (slatNS == "S")
-    {
-      latTemp = -latTemp;
-    }
-
-  if (slonEW == "W")
-    {
-      lonTemp = -lonTemp;
-    }
-
-  QPoint res (latTemp, lonTemp);
+  QPoint res (fix.latitude, fix.longitude);
 
   if ( _lastCoord != res )
     {
       _lastCoord=res;
-      emit newPosition( _lastCoord );
+      updateEpoch( GnssEpoch::Position );
     }
 
   return _lastCoord;
@@ -1710,8 +1743,6 @@ QPoint GpsNmea::__ExtractCoord(const QString& slat, const QString& slatNS,
 /** Extract the heading from the NMEA sentence. */
 double GpsNmea::__ExtractHeading(const QString& headingstring)
 {
-  static uint report = 0;
-
   if( headingstring.isEmpty() )
     {
       return 0.0;
@@ -1726,34 +1757,51 @@ double GpsNmea::__ExtractHeading(const QString& headingstring)
       return 0.0;
     }
 
+  return __ExtractHeading( heading );
+}
+
+/** Takes over the heading in degrees. */
+double GpsNmea::__ExtractHeading(const double heading)
+{
+  static uint report = 0;
+
   if ( heading != _lastHeading || (++report % 5) == 0 )
     {
       _lastHeading = heading;
-      emit newHeading( _lastHeading );
+      updateEpoch( GnssEpoch::Heading );
     }
 
   return heading;
 }
 
 /**
- * Extracts the altitude from a NMEA GGA sentence.
+ * Extracts the altitude from a NMEA sentence.
  */
 Altitude GpsNmea::__ExtractAltitude( const QString& altitude, const QString& unit )
 {
   // qDebug("alt=%s, unit=%s", altitude.toLatin1().data(), unitAlt.toLatin1().data() );
   bool ok;
 
-  Altitude res(0);
   double alt = altitude.toDouble(&ok);
 
   if( ok == false )
     {
-      return res;
+      return Altitude(0);
     }
 
   // Check for other unit as meters, meters is the default.
+  return __ExtractAltitude( alt, unit.toLower() == "f" );
+}
+
+/**
+ * Takes over the altitude in meters or in feet.
+ */
+Altitude GpsNmea::__ExtractAltitude( const double alt, const bool feet )
+{
+  Altitude res(0);
+
   // Consider user's altitude correction
-  if ( unit.toLower() == "f" )
+  if ( feet )
     {
       res.setFeet( alt );
     }
@@ -1777,7 +1825,7 @@ Altitude GpsNmea::__ExtractAltitude( const QString& altitude, const QString& uni
       calcStdAltitude( res );
     }
 
-  emit newAltitude( _lastMslAltitude, _lastStdAltitude, _lastGNSSAltitude );
+  updateEpoch( GnssEpoch::Altitude );
 
   return res;
 }
@@ -1854,6 +1902,7 @@ QString GpsNmea::__ExtractConstellation(const QStringList& sentence)
 
   if( lastSatsInUse != _lastSatInfo.satsInUse )
     {
+      updateEpoch( GnssEpoch::Satellites );
       emit newSatCount( _lastSatInfo );
     }
 
@@ -1893,9 +1942,16 @@ bool GpsNmea::__ExtractSatsInView(const QString& satcount)
       return false;
     }
 
-  if( ok && count != _lastSatInfo.satsInView )
+  return __ExtractSatsInView( count );
+}
+
+/** Takes over the satellite count in view. */
+bool GpsNmea::__ExtractSatsInView(const int count)
+{
+  if( count != _lastSatInfo.satsInView )
     {
       _lastSatInfo.satsInView = count;
+      updateEpoch( GnssEpoch::Satellites );
       emit newSatCount( _lastSatInfo );
     }
 
@@ -2002,7 +2058,7 @@ void GpsNmea::__ExtractMaemo0(const QStringList& slist)
           if( _lastCoord != res )
             {
               _lastCoord = res;
-              emit newPosition( _lastCoord );
+              updateEpoch( GnssEpoch::Position );
             }
         }
     }
@@ -2037,7 +2093,7 @@ void GpsNmea::__ExtractMaemo0(const QStringList& slist)
           if( speed != _lastSpeed )
             {
               _lastSpeed = speed;
-              emit newSpeed( _lastSpeed );
+              updateEpoch( GnssEpoch::Speed );
             }
         }
     }
@@ -2065,8 +2121,11 @@ void GpsNmea::__ExtractMaemo0(const QStringList& slist)
        * We do check the fix time only once in the $GPRMC sentence.
        */
       _lastRmcUtc = _lastUtc;
-      emit newFix( _lastRmcUtc );
+      updateEpoch( GnssEpoch::Fix );
     }
+
+  // Every $MAEMO0 sentence is a complete epoch.
+  publishEpoch();
 }
 
 /**
@@ -2158,6 +2217,7 @@ void GpsNmea::__ExtractMaemo1(const QStringList& slist)
     if( ok )
       {
         _lastSatInfo.satsInUse = satsInUse;
+        updateEpoch( GnssEpoch::Satellites );
         emit newSatCount( _lastSatInfo );
       }
     }
@@ -2219,6 +2279,62 @@ void GpsNmea::_slotTimeoutFix()
     }
 }
 
+/** Called, if an epoch was not completed in time. */
+void GpsNmea::_slotTimeoutEpoch()
+{
+  publishEpoch();
+}
+
+/** Marks items of the current epoch as changed. */
+void GpsNmea::updateEpoch( const uint items )
+{
+  _epoch.items |= items;
+
+  if( _epochTimer != 0 && _epochTimer->isActive() == false )
+    {
+      _epochTimer->start();
+    }
+}
+
+/** Publishes the pending epoch data by the signal newEpoch. */
+void GpsNmea::publishEpoch()
+{
+  if( _epochTimer != 0 )
+    {
+      _epochTimer->stop();
+    }
+
+  if( _epoch.items == 0 )
+    {
+      // Nothing has been changed.
+      return;
+    }
+
+  _epoch.utc           = _lastRmcUtc;
+  _epoch.position      = _lastCoord;
+  _epoch.speed         = _lastSpeed;
+  _epoch.heading       = _lastHeading;
+  _epoch.mslAltitude   = _lastMslAltitude;
+  _epoch.stdAltitude   = _lastStdAltitude;
+  _epoch.gnssAltitude  = _lastGNSSAltitude;
+  _epoch.satsInView    = _lastSatInfo.satsInView;
+  _epoch.satsInUse     = _lastSatInfo.satsInUse;
+  _epoch.fixAccuracy   = _lastSatInfo.fixAccuracy;
+  _epoch.vario         = _lastVariometer;
+  _epoch.windSpeed     = _lastWindSpeed;
+  _epoch.windDirection = _lastWindDirection;
+  _epoch.tas           = _lastTas;
+  _epoch.mc            = _lastMc;
+
+#ifdef FLARM
+  _epoch.flarmStatus   = Flarm::getFlarmStatus();
+#endif
+
+  emit newEpoch( _epoch );
+
+  _epoch.items = 0;
+}
+
 /** This function is called to indicate that valid data (checksum ok)
  *  has been received. If necessary it changes the connection status.
  */
@@ -2231,7 +2347,8 @@ void GpsNmea::dataOK()
       _lastGNSSAltitude = Altitude(0);
       calcStdAltitude( Altitude(0) );
       _lastPressureAltitude = Altitude(0);
-      emit newAltitude( _lastMslAltitude, _lastStdAltitude, _lastGNSSAltitude );
+      updateEpoch( GnssEpoch::Altitude );
+      publishEpoch();
 
       _status = noFix;
       emit statusChange(_status);
@@ -2288,6 +2405,7 @@ void GpsNmea::slot_reset()
   _reportAltitude = true;
   flarmNmeaOutInitDone = false;
   _gpsSource = conf->getGpsSource().left(3);
+  GnssEpochAssembler::setTalker( _gpsSource );
 
 #ifndef ANDROID
 
@@ -2872,23 +2990,49 @@ void GpsNmea::slot_closeNmeaLogFile()
 
 #ifdef ANDROID
 
+/**
+ * Takes over the NMEA sentences, which have been decoded already by
+ * GpsConAndroid.
+ */
+void GpsNmea::_slotIngestRecords()
+{
+  GpsConAndroid::startDrain();
+
+  GnssRecord record;
+
+  while( GpsConAndroid::takeRecord( record ) )
+    {
+      // The records are dropped, if GPS data processing is disabled.
+      if( _enableGpsDataProcessing )
+        {
+          slot_record( record );
+        }
+    }
+}
+
 /**
  * Handler for custom QEvents posted by the native JNI functions in
  * jnisupport.cpp. GPS data handling partly duplicated from other NMEA functions.
  */
 bool GpsNmea::event(QEvent *event)
 {
-  if( ! _enableGpsDataProcessing )
+  // New NMEA sentences forwarded by the Android system are available in the
+  // ingest queue.
+  if( event->type() == QEvent::User + 2 )
     {
+      if( _ingestTimer->isActive() == false )
+        {
+          // The first notification is handled at once, the following ones
+          // of a burst are combined by the timer.
+          _slotIngestRecords();
+          _ingestTimer->start();
+        }
+
       return true;
     }
 
-  // Handles NMEA sentences forwarded by the Android system
-  if( event->type() == QEvent::User + 2 )
+  if( ! _enableGpsDataProcessing )
     {
-      GpsNmeaEvent *gpsNmeaEvent = static_cast<GpsNmeaEvent *>(event);
-      slot_sentence( gpsNmeaEvent->sentence() );
-      emit newSentence( gpsNmeaEvent->sentence() );
       return true;
     }
 
@@ -2927,7 +3071,7 @@ bool GpsNmea::event(QEvent *event)
         {
           _lastMslAltitude = newAlt;
           calcStdAltitude( newAlt );
-          emit newAltitude( _lastMslAltitude, _lastStdAltitude, _lastGNSSAltitude );
+          updateEpoch( GnssEpoch::Altitude );
         }
 
       msg += newAlt.getText( true, 0 );
@@ -2941,7 +3085,7 @@ bool GpsNmea::event(QEvent *event)
       if ( _lastCoord != newPoint )
         {
           _lastCoord = newPoint;
-          emit newPosition( _lastCoord );
+          updateEpoch( GnssEpoch::Position );
         }
 
       msg += "," + QString::number( gpsFixEvent->latitude(), 'f' );
@@ -2955,7 +3099,7 @@ bool GpsNmea::event(QEvent *event)
         {
           // report speed change only if the difference is greater than 0.3m/s, 1.08Km/h
           _lastSpeed = newSpeedFix;
-          emit newSpeed( _lastSpeed );
+          updateEpoch( GnssEpoch::Speed );
         }
 
       msg += "," + newSpeedFix.getHorizontalText( true, 1 );
@@ -2966,7 +3110,7 @@ bool GpsNmea::event(QEvent *event)
       if ( newHeadingFix != _lastHeading )
         {
           _lastHeading = newHeadingFix;
-          emit newHeading( _lastHeading );
+          updateEpoch( GnssEpoch::Heading );
         }
 
       msg += "," + QString::number( (int) rint(newHeadingFix) );
@@ -2980,9 +3124,12 @@ bool GpsNmea::event(QEvent *event)
       if( fix_utc != _lastRmcUtc )
         {
           _lastRmcUtc = fix_utc;
-          emit newFix( _lastRmcUtc );
+          updateEpoch( GnssEpoch::Fix );
         }
 
+      // Every Android fix is a complete epoch.
+      publishEpoch();
+
       msg += "," + fix_utc.toString(Qt::ISODate);
 
       // emits the new message that something is to see in GPS status widget
@@ -3070,7 +3217,7 @@ bool GpsNmea::event(QEvent *event)
                   // set these altitudes too, when pressure is selected
                   _lastMslAltitude.setMeters( altitude.getMeters() + _userAltitudeCorrection.getMeters() );
                    // report new barometer altitude
-                  emit newAltitude( _lastMslAltitude, _lastStdAltitude, _lastGNSSAltitude );
+                  updateEpoch( GnssEpoch::Altitude );
                 }
            }
 
@@ -49,6 +49,10 @@
 
 #include "speed.h"
 #include "altitude.h"
+#include "gnssepoch.h"
+#include "gnssepochassembler.h"
+#include "gnssingestqueue.h"
+#include "nmeadecoder.h"
 #include "wgspoint.h"
 
 #ifndef ANDROID
@@ -423,6 +427,13 @@ class GpsNmea : public QObject
      */
     void slot_sentence(const QString& sentence);
 
+    /**
+     * This slot is called with a sentence, which has been received and
+     * decoded by the GNSS ingest thread, and with the end of an epoch,
+     * which has been found by it.
+     */
+    void slot_record(const GnssRecord& record);
+
     /**
      * This slot is called if the object needs to reset. It is
      * used to destroy the serial connection and create a new
@@ -484,31 +495,32 @@ class GpsNmea : public QObject
      */
     void _slotTimeoutFix();
 
-  signals: // Signals
     /**
-     * This signal is emitted if the position has been changed.
+     * Publishes the pending epoch data, if the epoch was not completed in
+     * time.
      */
-    void newPosition( QPoint &newPosition );
+    void _slotTimeoutEpoch();
 
+#ifdef ANDROID
     /**
-     * This signal is emitted if the altitude has been changed.
+     * Drains the ingest queue of GpsConAndroid. Called at once, if new
+     * records are available, and by the ingest timer to combine the
+     * notifications of a burst.
      */
-    void newAltitude( Altitude& user, Altitude& std, Altitude& gnns );
-
-    /**
-     * This signal is emitted if a new Android altitude is available.
-     */
-    void newAndroidAltitude(const Altitude& altitude);
+    void _slotIngestRecords();
+#endif
 
+  signals: // Signals
     /**
-     * This signal is emitted if a new speed fix has been established.
+     * This signal is emitted once per GNSS epoch. It contains position,
+     * speed, heading, altitudes and the fix time of the epoch.
      */
-    void newSpeed( Speed& newSpeed );
+    void newEpoch( const GnssEpoch& epoch );
 
     /**
-     * This signal is emitted if a new heading has been established.
+     * This signal is emitted if a new Android altitude is available.
      */
-    void newHeading( const double& newHeading );
+    void newAndroidAltitude(const Altitude& altitude);
 
     /**
      * This signal is emitted if a new wind (speed, direction)
@@ -556,12 +568,6 @@ class GpsNmea : public QObject
      */
     void statusChange(GpsNmea::GpsStatus);
 
-    /**
-     * This signal is send to indicate that there is a new fix.
-     * Data send after this fix belongs to the new fix!
-     */
-    void newFix( const QDateTime& newFixTime );
-
     /**
      * This signal is send to indicate that new satellite in view
      * info is available.
@@ -600,17 +606,25 @@ class GpsNmea : public QObject
      *  at startup, at restart and if the GPS fix has been lost. */
     void resetDataObjects();
 
+    /**
+     * Analyzes a sentence. The decoding result of a position sentence must
+     * be stored in _nmeaFix before.
+     *
+     * \param fixType The decoded sentence type, see \ref NmeaFix::Sentence.
+     */
+    void processSentence( const QString& sentence, const int fixType );
+
     /** write configuration data to allow restore of last fix */
     void writeConfig();
 
     /** Extracts GPRMC sentence. */
-    void __ExtractGprmc( const QStringList& slst );
+    void __ExtractGprmc( const NmeaFix& fix );
     /** Extracts GPGLL sentence. */
-    void __ExtractGpgll( const QStringList& slst );
+    void __ExtractGpgll( const NmeaFix& fix );
     /** Extracts GPGGA sentence. */
-    void __ExtractGpgga( const QStringList& slst );
+    void __ExtractGpgga( const NmeaFix& fix );
     /** Extracts GNGNS sentence. */
-    void __ExtractGngns( const QStringList& slst );
+    void __ExtractGngns( const NmeaFix& fix );
     /** Extracts PGRMZ sentence. */
     void __ExtractPgrmz( const QStringList& slst );
     /** Extracts PCAID sentence. */
@@ -625,22 +639,28 @@ class GpsNmea : public QObject
     void __ExtractPflau( const QStringList& slst );
 #endif
 
-    /** This function return a QTime from the time encoded in a MNEA sentence. */
-    QTime __ExtractTime(const QString& timestring);
-    /** This function return a QDate from the date encoded in a MNEA sentence. */
-    QDate __ExtractDate(const QString& datestring);
-    /** This function return a Speed from the speed encoded in knots */
-    Speed __ExtractKnotSpeed(const QString& speedstring);
-    /** This function converts the coordinate data from the NMEA sentence to the internal QPoint coordinate format. */
-    QPoint __ExtractCoord(const QString& slat, const QString& slatNS, const QString& slon, const QString& slonEW);
+    /** This function return a QTime from the time of a decoded position sentence. */
+    QTime __ExtractTime(const NmeaFix& fix);
+    /** This function return a QDate from the date of a decoded position sentence. */
+    QDate __ExtractDate(const NmeaFix& fix);
+    /** This function return a Speed from the speed in knots */
+    Speed __ExtractKnotSpeed(const double knots);
+    /** This function takes over the coordinate of a decoded position sentence. */
+    QPoint __ExtractCoord(const NmeaFix& fix);
     /** Extract the heading from the NMEA sentence. */
     double __ExtractHeading(const QString& headingstring);
+    /** Takes over the heading in degrees. */
+    double __ExtractHeading(const double heading);
     /** Extracts the altitude from a NMEA GGA or Gramin/Flarm PGRMZ sentence */
     Altitude __ExtractAltitude(const QString& altitude, const QString& unit);
+    /** Takes over the altitude in meters or in feet. */
+    Altitude __ExtractAltitude(const double altitude, const bool feet);
     /** Extracts the constellation from the NMEA sentence. */
     QString __ExtractConstellation(const QStringList& sentence);
     /** Extracts the satellites in view from the NMEA sentence. */
     bool __ExtractSatsInView(const QString& satcount);
+    /** Takes over the satellites in view. */
+    bool __ExtractSatsInView(const int satcount);
     /** Extracts satellites In View (SIV) info from a NMEA sentence. */
     void __ExtractSatsInView(const QStringList& sentence);
     /** Extracts satellites In View (SIV) info from a NMEA sentence. */
@@ -690,6 +710,12 @@ class GpsNmea : public QObject
     /** This function calculates the MSL altitude from the passed STD altitude. */
     void calcMslAltitude(const Altitude& altitude);
 
+    /** Marks items of the current epoch as changed. */
+    void updateEpoch( const uint items );
+
+    /** Publishes the pending epoch data by the signal newEpoch. */
+    void publishEpoch();
+
     /** Set system date/time. Input is UTC related. */
     void setSystemClock( const QDateTime& utcDt );
     /** create a GPS connection */
@@ -770,6 +796,25 @@ class GpsNmea : public QObject
     /** configurated GPS source to be used */
     QString _gpsSource;
 
+    /** Decoder of the position sentences and its last result. */
+    NmeaDecoder _nmeaDecoder;
+    NmeaFix _nmeaFix;
+
+    /** Epoch data, which are collected for publishing. */
+    GnssEpoch _epoch;
+    /**
+     * Groups the sentences of slot_sentence to epochs. The records of the
+     * ingest queue are grouped by their producer.
+     */
+    GnssEpochAssembler _epochAssembler;
+    /** Publishes pending epoch data, if no complete epoch follows. */
+    QTimer* _epochTimer;
+
+#ifdef ANDROID
+    /** Combines the notifications of a burst to one drain per frame. */
+    QTimer* _ingestTimer;
+#endif
+
 #ifndef ANDROID
     /** The reference to the used serial connection */
     GpsCon* serial;
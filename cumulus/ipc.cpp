@@ -700,6 +700,64 @@ int Ipc::Client::writeMsg( void *data, int length )
   return writtenBytes;
 }
 
+/**
+ * Writes the passed data parts as one message to the connected client socket.
+ * @returns -1 in error case or number of written bytes
+ */
+int Ipc::Client::writeMsg( struct iovec *parts, int count )
+{
+  static const char* method = ( "Ipc::Client::writeMsg(): " );
+
+  if ( getSock() == -1 )
+    {
+      cerr << method
+           << "No server connection is established, "
+           << "Message will be discarded!" << endl;
+
+      errno = ENOTCONN;
+      return -1;
+    }
+
+  int writtenBytes = 0;
+
+  while ( count > 0 )
+    {
+      int done = writev( sock, parts, count );
+
+      if ( done < 0 )
+        {
+          if ( errno == EINTR )
+            {
+              continue; // Ignore interrupts
+            }
+
+          cerr << method
+               << "writev() returns with ERROR: errno="
+               << errno
+               << ", " << strerror(errno) << endl;
+          return -1;
+        }
+
+      writtenBytes += done;
+
+      // Skip the written parts and write the rest again.
+      while ( count > 0 && done >= (int) parts->iov_len )
+        {
+          done -= parts->iov_len;
+          parts++;
+          count--;
+        }
+
+      if ( count > 0 )
+        {
+          parts->iov_base = (char *) parts->iov_base + done;
+          parts->iov_len -= done;
+        }
+    }
+
+  return writtenBytes;
+}
+
 
 /**
  * Closes the socket of the server connection
@@ -20,6 +20,8 @@
 #ifndef _Ipc_hh_
 #define _Ipc_hh_ 1
 
+#include <sys/uio.h>
+
 #include <QByteArray>
 
 #define IPC_IP "127.0.0.1"
@@ -223,6 +225,14 @@ public:
          */
         int writeMsg( void *data, int length );
 
+        /**
+         * Writes the passed data parts as one message to the connected
+         * client socket without copying them together. The parts are
+         * modified, if a part is written only partially.
+         * @return -1 in error case or number of written bytes
+         */
+        int writeMsg( struct iovec *parts, int count );
+
         /**
          * Closes the socket of the server connection
          * @return -1 in error case otherwise 0
@@ -20,12 +20,7 @@
 
 #include <QtCore>
 
-#include <QPainterPath>
-#include <QString>
-#include <QSize>
-
 #include "isohypse.h"
-#include "mapmatrix.h"
 
 Isohypse::Isohypse( QPolygon elevationCoordinates,
                     const short elevation,
@@ -41,49 +36,3 @@ Isohypse::Isohypse( QPolygon elevationCoordinates,
 
 Isohypse::~Isohypse()
 {}
-
-QPainterPath* Isohypse::drawRegion( QPainter* targetP,
-                                       bool isolines )
-{
-  QPainterPath *ppath = static_cast<QPainterPath *> (0);
-
-  if( !glMapMatrix->isVisible(bBox, getTypeID() ) || projPolygon.size() < 3 )
-    {
-      return ppath;
-    }
-
-  QPolygon mP = glMapMatrix->map(projPolygon);
-
-  if (mP.boundingRect().isNull())
-    {
-      // ignore null values
-      return ppath;
-    }
-
-  ppath = new QPainterPath;
-
-  ppath->moveTo( mP.at(0) );
-
-  for( int i = 1; i < mP.size(); i++ )
-    {
-      ppath->lineTo( mP.at(i) );
-    }
-
-  ppath->closeSubpath();
-
-  targetP->save();
-
-  if( isolines )
-    {
-      QPen pen = targetP->pen();
-      pen.setWidth(1);
-      pen.setColor(Qt::black);
-      pen.setStyle(Qt::DotLine);
-      targetP->setPen(pen);
-    }
-
-  targetP->drawPath( *ppath );
-  targetP->restore();
-
-  return ppath;
-}
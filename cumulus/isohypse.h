@@ -20,7 +20,6 @@
 #define ISOHYPSE_H
 
 #include <QRect>
-#include <QPainterPath>
 
 #include "lineelement.h"
 
@@ -55,18 +54,6 @@ class Isohypse : public LineElement
      */
     virtual ~Isohypse();
 
-    /**
-     * Draws the isoline region into the given painter.
-     *
-     * @param targetP The painter to draw the element into.
-     * @param isolines Switches outline drawing on/off
-     *
-     * @return The projected region polygon as QPainterPath object usable
-     *         for later elevation finding.
-     */
-    QPainterPath* drawRegion( QPainter* targetP,
-                               bool isolines = false );
-
     /**
      * @return the elevation of the line
      */
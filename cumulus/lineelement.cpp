@@ -21,6 +21,7 @@
 
 LineElement::LineElement() :
   BaseMapElement(),
+  projectionId(-1),
   valley(false),
   closed(false)
 {
@@ -34,6 +35,7 @@ LineElement::LineElement( const QString& name,
                           const QString& country )
   : BaseMapElement(name, t, secID, country),
     projPolygon(pP),
+    projectionId(-1),
     bBox(pP.boundingRect()),
     valley(isV),
     closed(false)
@@ -126,7 +128,7 @@ bool LineElement::drawMapElement(QPainter* targetP)
       break;
     }
 
-  QPolygon mP( glMapMatrix->map(projPolygon) );
+  QPolygon mP( glMapMatrix->map( getProjectedPolygon( glMapMatrix->currentDrawScale() ) ) );
 
   // Save screen bounding box
   sbBox = mP.boundingRect();
@@ -166,3 +168,40 @@ bool LineElement::drawMapElement(QPainter* targetP)
 
   return true;
 }
+
+void LineElement::updateProjection()
+{
+  const int currentId = glMapMatrix->getProjectionId();
+
+  if( projectionId == currentId || wgsPolygon.isEmpty() )
+    {
+      return;
+    }
+
+  glMapMatrix->wgsToMap( wgsPolygon, projPolygon );
+  bBox = projPolygon.boundingRect();
+  projectionId = currentId;
+
+  projDetails.clear();
+
+  for( int i = 0; i < wgsDetails.size(); i++ )
+    {
+      const QPolygon& previous = (i == 0) ? wgsPolygon : wgsDetails.at(i - 1);
+
+      if( wgsDetails.at(i).size() == previous.size() )
+        {
+          // The level is equal to the preceding one.
+          projDetails.append( i == 0 ? projPolygon : projDetails.last() );
+          continue;
+        }
+
+      QPolygon polygon;
+      glMapMatrix->wgsToMap( wgsDetails.at(i), polygon );
+      projDetails.append( polygon );
+    }
+}
+
+QRect LineElement::mapScreenBoundingBox() const
+{
+  return glMapMatrix->map(projPolygon).boundingRect();
+}
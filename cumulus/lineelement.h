@@ -19,6 +19,9 @@
 #ifndef LINE_ELEMENT_H
 #define LINE_ELEMENT_H
 
+#include <QList>
+#include <QPolygon>
+
 #include "basemapelement.h"
 
 /**
@@ -109,6 +112,21 @@ class LineElement : public BaseMapElement
       return projPolygon;
     };
 
+    /**
+      * Returns the projected positions of the line element, simplified for
+      * the passed draw scale band, see \ref MapMatrix::currentDrawScale.
+      * If the element has no detail levels, all positions are returned.
+      */
+    const QPolygon& getProjectedPolygon( const unsigned int drawScale ) const
+    {
+      if( drawScale == 0 || projDetails.isEmpty() )
+        {
+          return projPolygon;
+        }
+
+      return projDetails.at( qMin( int(drawScale), projDetails.size() ) - 1 );
+    };
+
     /**
      * Sets the polygon of the line element containing the projected positions
      * of the line element.
@@ -118,20 +136,132 @@ class LineElement : public BaseMapElement
     void setProjectedPolygon( const QPolygon& newPolygon )
     {
       projPolygon = newPolygon;
+      projDetails.clear();
       bBox = newPolygon.boundingRect();
     };
 
+    /**
+     * Returns the WGS84 positions of the line element, x is the latitude
+     * and y is the longitude. The list is empty, if the element was created
+     * with projected positions only or if the positions have been released
+     * by \ref releaseWgsPolygon.
+     */
+    const QPolygon& getWgsPolygon() const
+    {
+      return wgsPolygon;
+    };
+
+    /**
+     * Sets the WGS84 positions of the line element. The projected positions
+     * are computed by \ref updateProjection.
+     *
+     * \param newPolygon Polygon with WGS84 coordinate points.
+     *
+     * \param detailPolygons Simplified polygons for the draw scale bands 1
+     *        and higher, see \ref CompiledMapFile::Record.
+     */
+    void setWgsPolygon( const QPolygon& newPolygon,
+                        const QList<QPolygon>& detailPolygons = QList<QPolygon>() )
+    {
+      wgsPolygon = newPolygon;
+      wgsDetails = detailPolygons;
+      wgsBox = newPolygon.boundingRect();
+      projectionId = -1;
+    };
+
+    /**
+     * Releases the WGS84 positions after they have been projected, only
+     * their bounding box is kept. Afterwards the element cannot be projected
+     * again, it must be loaded again after a projection change.
+     */
+    void releaseWgsPolygon()
+    {
+      wgsPolygon = QPolygon();
+      wgsDetails = QList<QPolygon>();
+    };
+
+    /**
+     * Returns the bounding box of the WGS84 positions, x is the latitude
+     * and y is the longitude.
+     */
+    const QRect& getWgsBoundingBox() const
+    {
+      return wgsBox;
+    };
+
+    /**
+     * Returns the identifier of the projection used for the projected
+     * positions, see \ref MapMatrix::getProjectionId.
+     */
+    int getProjectionId() const
+    {
+      return projectionId;
+    };
+
+    /**
+     * Projects the WGS84 positions with the current map projection, if
+     * that was not already done.
+     */
+    void updateProjection();
+
+    /**
+     * Returns the bounding box of the projected positions.
+     */
+    const QRect& getBoundingBox() const
+    {
+      return bBox;
+    };
+
+    /**
+     * @return "true", if the element is a closed polygon.
+     */
+    bool isClosed() const
+    {
+      return closed;
+    };
+
+    /**
+     * Returns the screen bounding box of the line element using the current
+     * map matrix. Used for elements, which are not drawn by
+     * \ref drawMapElement. In contrast to \ref getScreenBoundingBox the
+     * box is not stored, so that shared elements are not modified.
+     */
+    QRect mapScreenBoundingBox() const;
+
 protected:
     /**
      * Contains the projected positions of the line element.
      */
     QPolygon projPolygon;
 
+    /**
+     * Contains the WGS84 positions of the line element.
+     */
+    QPolygon wgsPolygon;
+
+    /**
+     * Simplified WGS84 positions and their projections for the draw scale
+     * bands 1 and higher.
+     */
+    QList<QPolygon> wgsDetails;
+    QList<QPolygon> projDetails;
+
+    /**
+     * Identifier of the projection used for projPolygon, -1 if the WGS84
+     * positions are not projected yet.
+     */
+    int projectionId;
+
     /**
      * The bounding-box of the line element.
      */
     QRect bBox;
 
+    /**
+     * The bounding-box of the WGS84 positions.
+     */
+    QRect wgsBox;
+
     /**
      * The bounding box of the line element on the screen.
      */
@@ -33,6 +33,7 @@
 #include <clocale>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -46,14 +47,67 @@
 #include "generalconfig.h"
 #include "messagehandler.h"
 #include "hwinfo.h"
+#include "mapmatrix.h"
+#include "OpenAipCompiler.h"
 
 #ifdef ANDROID
 #include "jnisupport.h"
 #endif
 
+extern MapMatrix* _globalMapMatrix;
+
+/**
+ * Converts the openAIP files, passed as arguments, into their compiled
+ * versions without starting the GUI. The projection, the home position and
+ * the filter values are taken from the Cumulus configuration.
+ *
+ * Usage: cumulus --compile-openaip <file.aip> ...
+ */
+static int compileOpenAipFiles( int argc, char *argv[] )
+{
+  QCoreApplication app(argc, argv);
+
+  QCoreApplication::setApplicationName( "Cumulus" );
+  QCoreApplication::setApplicationVersion( CU_VERSION );
+  QCoreApplication::setOrganizationName( "KFLog" );
+  QCoreApplication::setOrganizationDomain( "www.kflog.org" );
+
+  GeneralConfig::instance();
+
+  _globalMapMatrix = new MapMatrix( &app );
+
+  int errors = 0;
+
+  for( int i = 2; i < argc; i++ )
+    {
+      QString errorInfo;
+      QString fileName = QString::fromLocal8Bit( argv[i] );
+
+      if( OpenAipCompiler::compileFile( fileName, errorInfo ) == false )
+        {
+          fprintf( stderr, "%s: %s\n",
+                   fileName.toLocal8Bit().data(),
+                   errorInfo.toLocal8Bit().data() );
+          errors++;
+        }
+    }
+
+  delete _globalMapMatrix;
+  _globalMapMatrix = 0;
+
+  return (errors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 /////////////////////
 int main(int argc, char *argv[])
 {
+  if( argc > 2 && strcmp( argv[1], "--compile-openaip" ) == 0 )
+    {
+      // Headless batch conversion of downloaded openAIP data.
+      setlocale(LC_NUMERIC, "C");
+      return compileOpenAipFiles( argc, argv );
+    }
+
   // Workaround to start browser from QTextView
   qputenv( "BROWSER", "browser --url" );
 
@@ -180,6 +180,7 @@ MainWindow::MainWindow( Qt::WindowFlags flags ) :
 #endif
   actionStatusGPS(0),
   actionStatusAirspace(0),
+  actionStatusAirspaceProfile(0),
   actionZoomInZ(0),
   actionZoomOutZ(0),
   actionToggleStatusbar(0),
@@ -794,20 +795,12 @@ void MainWindow::slotCreateApplicationWidgets()
            calculator->getWindAnalyser(), SLOT( slot_newConstellation(SatInfo&) ) );
   connect( GpsNmea::gps, SIGNAL( statusChange( GpsNmea::GpsStatus ) ),
            calculator->getWindAnalyser(), SLOT( slot_gpsStatusChange( GpsNmea::GpsStatus ) ) );
-  connect( GpsNmea::gps, SIGNAL( newSpeed(Speed&) ),
-           calculator, SLOT( slot_Speed(Speed&) ) );
   connect( GpsNmea::gps, SIGNAL( newTas(const Speed&) ),
            calculator, SLOT( slot_GpsTas(const Speed&) ) );
-  connect( GpsNmea::gps, SIGNAL( newPosition(QPoint&) ),
-           calculator, SLOT( slot_Position(QPoint&) ) );
-  connect( GpsNmea::gps, SIGNAL( newAltitude(Altitude&, Altitude&, Altitude&) ),
-           calculator, SLOT( slot_Altitude(Altitude&, Altitude&, Altitude&) ) );
+  connect( GpsNmea::gps, SIGNAL( newEpoch(const GnssEpoch&) ),
+           calculator, SLOT( slot_Epoch(const GnssEpoch&) ) );
   connect( GpsNmea::gps, SIGNAL( newAndroidAltitude(const Altitude&) ),
            calculator, SLOT( slot_AndroidAltitude(const Altitude&) ) );
-  connect( GpsNmea::gps, SIGNAL( newHeading(const double&) ),
-           calculator, SLOT( slot_Heading(const double&) ) );
-  connect( GpsNmea::gps, SIGNAL( newFix(const QDateTime&) ),
-           calculator, SLOT( slot_newFix(const QDateTime&) ) );
   connect( GpsNmea::gps, SIGNAL( statusChange( GpsNmea::GpsStatus ) ),
            calculator, SLOT( slot_GpsStatus( GpsNmea::GpsStatus ) ) );
 
@@ -1364,6 +1357,7 @@ void MainWindow::createContextMenu()
 
   statusMenu = contextMenu->addMenu(tr("Status") + "  ");
   statusMenu->addAction( actionStatusAirspace );
+  statusMenu->addAction( actionStatusAirspaceProfile );
   statusMenu->addAction( actionStatusGPS );
 
   setupMenu = contextMenu->addMenu(tr("Setup") + "  ");
@@ -1648,6 +1642,11 @@ void MainWindow::createActions()
   connect( actionStatusAirspace, SIGNAL( triggered() ),
             Map::instance, SLOT( slotShowAirspaceStatus() ) );
 
+  actionStatusAirspaceProfile = new QAction( tr( "Airspace Profile" ), this );
+  addAction( actionStatusAirspaceProfile );
+  connect( actionStatusAirspaceProfile, SIGNAL( triggered() ),
+            viewMap, SLOT( slot_airspaceProfileDialog() ) );
+
   actionStatusGPS = new QAction( tr( "GPS" ), this );
 #ifndef ANDROID
   actionStatusGPS->setShortcut(Qt::Key_G);
@@ -1911,6 +1910,7 @@ void  MainWindow::toggleActions( const bool toggle )
     }
 
   actionStatusAirspace->setEnabled( toggle );
+  actionStatusAirspaceProfile->setEnabled( toggle );
   actionStatusGPS->setEnabled( toggle );
   actionZoomInZ->setEnabled( toggle );
   actionZoomOutZ->setEnabled( toggle );
@@ -2794,6 +2794,8 @@ void MainWindow::slotReadconfig()
       m_outlandingListVisible = false;
     }
 
+  // The drawing configuration of the base map can be changed.
+  Map::instance->invalidateTiles();
   Map::instance->scheduleRedraw();
 }
 
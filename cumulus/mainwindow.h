@@ -487,6 +487,7 @@ private:
 
   QAction* actionStatusGPS;
   QAction* actionStatusAirspace;
+  QAction* actionStatusAirspaceProfile;
 
   QAction* actionZoomInZ;
   QAction* actionZoomOutZ;
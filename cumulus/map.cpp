@@ -36,6 +36,7 @@
 #include "mapcontents.h"
 #include "mapdefaults.h"
 #include "mapmatrix.h"
+#include "maptilerenderer.h"
 #include "mapview.h"
 #include "radiopoint.h"
 #include "reachablelist.h"
@@ -81,6 +82,11 @@ Map::Map(QWidget* parent) : QWidget(parent),
   m_isRedrawEvent = false;
   m_mouseMoveIsActive = false;
   m_ignoreMouseRelease = false;
+  m_baseLayerValid = false;
+  m_airspaceLayersValid = false;
+  m_airspaceLayerProjection = -1;
+  m_baseLayerProjection = -1;
+  m_baseLayerGeneration = -1;
   m_mapRot = 0;
   m_curMapRot = 0;
   m_heading = 0;
@@ -126,6 +132,17 @@ Map::Map(QWidget* parent) : QWidget(parent),
   connect( m_showASSTimer, SIGNAL(timeout()),
             this, SLOT(slotASSTimerExpired()));
 
+  m_tileRenderer = new MapTileRenderer(this);
+
+  connect( m_tileRenderer, SIGNAL(tilesReady()),
+            this, SLOT(slotTilesReady()));
+
+  m_tileTimer = new QTimer(this);
+  m_tileTimer->setSingleShot(true);
+
+  connect( m_tileTimer, SIGNAL(timeout()),
+            this, SLOT(slotTileTimerExpired()));
+
   m_zoomFactor = _globalMapMatrix->getScale(MapMatrix::CurrentScale);
   m_curMANPos  = _globalMapMatrix->getMapCenter();
   m_curGPSPos  = _globalMapMatrix->getMapCenter();
@@ -355,12 +372,28 @@ void Map::p_displayDetailedItemInfo(const QPoint& current)
       return;
     }
 
+  // Only the points near to the touched position are checked. The snap
+  // radius is converted to km and enlarged for the icon size.
+  QPoint touchPos = _globalMapMatrix->mapToWgs( current );
+
+  // Coordinates are toggled, see mapToWgs
+  touchPos = QPoint( touchPos.y(), touchPos.x() );
+
+  const double snapRadius = delta * cs * 1.5 / 1000.0;
+
+  QVector<int> candidates;
+
   // @AP: On map scale higher as 1024 we don't evaluate anything
   for( int l = 0; l < searchList.size() && cs < 1024.0; l++ )
     {
-      for (unsigned int loop = 0;
-          loop < _globalMapContents->getListLength (searchList.at (l)); loop++)
+      _globalMapContents->getSpatialIndex( searchList.at(l) ).queryRadius( touchPos,
+                                                                          snapRadius,
+                                                                          candidates );
+
+      for( int c = 0; c < candidates.size(); c++ )
         {
+          const unsigned int loop = candidates.at(c);
+
           // Get specific site data from current list. We have to
           // distinguish between AirfieldList, GilderfieldList, OutlandingList
           // RadioList and HotspotList.
@@ -776,10 +809,6 @@ void Map::slotNewWind( Vector& wind )
 
 void Map::p_drawAirspaces( bool reset )
 {
-  QPainter cuAeroMapP;
-
-  cuAeroMapP.begin(&m_pixAeroMap);
-
   QTime t;
   t.start();
 
@@ -814,22 +843,51 @@ void Map::p_drawAirspaces( bool reset )
       airspaceOpacity = 100.0; // no transparency
     }
 
+  // A reset means a changed view. If only the map center has been moved,
+  // the airspace layers are scrolled like the base layer. Otherwise all
+  // airspace layers must be rendered again.
+  QPoint delta;
+  bool renderAll = (m_airspaceLayersValid == false);
+
+  if( reset == true && renderAll == false )
+    {
+      renderAll = ( m_airspaceLayerProjection != _globalMapMatrix->getProjectionId() ||
+                    m_airspaceLayerSize != m_pixAeroMap.size() ||
+                    p_isLayerScrollable( m_airspaceLayerMatrix, delta ) == false );
+    }
+
   // The border is stored as FL
   uint asBorder = (uint) rint(settings->getAirspaceDrawingBorder() * 100.0 * Distance::mFromFeet );
 
+  // The airspaces to be drawn with their conflict classes.
+  QVector<AirspaceDrawItem> items;
+
   // Two airspace lists have to be processed.
   SortableAirspaceList* asl[2];
 
   asl[0] = _globalMapContents->getAirspaceList();
   asl[1] = _globalMapContents->getFlarmAlertZoneList();
 
+  // Only the airspaces of the current view are taken from the airspace list.
+  // The indexes are sorted, so the drawing order is kept.
+  QVector<int> visible;
+
+  _globalMapContents->getSpatialIndex( MapContents::AirspaceList )
+      .queryViewport( MapContents::getViewportBox(), visible );
+
+  AirspaceLimitTable& limits = _globalMapContents->getAirspaceLimitTable();
+  limits.evaluate( alt, awd );
+
   for( int i = 0; i < 2; i++ )
     {
-      for( int loop = 0; loop < asl[i]->size(); loop++ )
+      const int count = (i == 0) ? visible.size() : asl[i]->size();
+
+      for( int loop = 0; loop < count; loop++ )
         {
           AirRegion* region = 0;
           SortableAirspaceList* asList = asl[i];
-          Airspace* currentAirS = dynamic_cast<Airspace *> (asList->value(loop));
+          const int idx = (i == 0) ? visible.at(loop) : loop;
+          Airspace* currentAirS = dynamic_cast<Airspace *> (asList->value(idx));
 
           if( currentAirS == 0 || currentAirS->isDrawable() == false )
             {
@@ -875,13 +933,26 @@ void Map::p_drawAirspaces( bool reset )
               region = currentAirS->getAirRegion();
             }
 
+          // Without filling, all airspaces are drawn into the first layer.
+          int layer = 0;
+
           if( region && currentAirS->getTypeID() != BaseMapElement::AirFir )
             {
               // determine lateral conflict
               Airspace::ConflictType lConflict = region->conflicts( pos, awd );
 
               // determine vertical conflict
-              Airspace::ConflictType vConflict = currentAirS->conflicts( alt, awd );
+              Airspace::ConflictType vConflict;
+
+              if( i == 0 )
+                {
+                  vConflict = limits.conflict( idx );
+                  currentAirS->setLastVConflict( vConflict );
+                }
+              else
+                {
+                  vConflict = currentAirS->conflicts( alt, awd );
+                }
 
               if( fillAirspace == true )
                 {
@@ -891,17 +962,131 @@ void Map::p_drawAirspaces( bool reset )
                       // We are inside from the lateral position out,
                       // vertical conflict has priority.
                       airspaceOpacity = (qreal) settings->getAirspaceFillingVertical( vConflict );
+                      layer = 3 + vConflict;
                     }
                   else
                     {
                       // We are not inside from the lateral position out,
                       // lateral conflict has priority.
                       airspaceOpacity = (qreal) settings->getAirspaceFillingLateral( lConflict );
+                      layer = lConflict;
                     }
                 }
             }
 
-          currentAirS->drawRegion( &cuAeroMapP, airspaceOpacity );
+          AirspaceDrawItem item;
+          item.airspace = currentAirS;
+          item.layer    = layer;
+          item.opacity  = airspaceOpacity;
+          item.rect     = currentAirS->getDrawingRect();
+
+          items.append( item );
+        }
+    }
+
+  if( renderAll )
+    {
+      m_airspaceDrawItems = items;
+      p_renderAirspaceLayers();
+      m_airspaceLayersValid = true;
+    }
+  else
+    {
+      // Look for airspaces, which have changed their conflict class or
+      // which are added or removed. Only their rectangles in the affected
+      // layers are rendered again.
+      QRegion dirty[AIRSPACE_LAYERS];
+      bool changed = false;
+
+      if( delta.isNull() == false )
+        {
+          // Shift the old content of the layers. The exposed strips must be
+          // rendered in all layers.
+          const QRect rect = m_pixAeroMap.rect();
+          const QRegion exposed = QRegion( rect ) - QRegion( rect.translated( delta ) );
+
+          for( int l = 0; l < AIRSPACE_LAYERS; l++ )
+            {
+              if( m_pixAirspaceLayers[l].isNull() == false )
+                {
+                  m_pixAirspaceLayers[l].scroll( delta.x(), delta.y(), rect );
+                }
+
+              dirty[l] = exposed;
+            }
+
+          for( int i = 0; i < m_airspaceDrawItems.size(); i++ )
+            {
+              m_airspaceDrawItems[i].rect.translate( delta );
+            }
+
+          changed = true;
+        }
+
+      QHash<Airspace*, int> oldItems;
+
+      for( int i = 0; i < m_airspaceDrawItems.size(); i++ )
+        {
+          oldItems.insert( m_airspaceDrawItems.at(i).airspace, i );
+        }
+
+      for( int i = 0; i < items.size(); i++ )
+        {
+          const AirspaceDrawItem& item = items.at(i);
+          QHash<Airspace*, int>::iterator it = oldItems.find( item.airspace );
+
+          if( it != oldItems.end() )
+            {
+              const AirspaceDrawItem& old = m_airspaceDrawItems.at( it.value() );
+              oldItems.erase( it );
+
+              if( old.layer == item.layer && old.opacity == item.opacity &&
+                  old.rect == item.rect )
+                {
+                  continue;
+                }
+
+              dirty[old.layer] += old.rect;
+            }
+
+          dirty[item.layer] += item.rect;
+          changed = true;
+        }
+
+      // The remaining old airspaces are not drawn any more.
+      QHash<Airspace*, int>::const_iterator it;
+
+      for( it = oldItems.constBegin(); it != oldItems.constEnd(); ++it )
+        {
+          const AirspaceDrawItem& old = m_airspaceDrawItems.at( it.value() );
+          dirty[old.layer] += old.rect;
+          changed = true;
+        }
+
+      m_airspaceDrawItems = items;
+
+      if( changed )
+        {
+          p_renderAirspaceLayers( dirty );
+        }
+    }
+
+  // Save the view of the airspace layers for the next scroll check.
+  m_airspaceLayerMatrix     = _globalMapMatrix->getWorldMatrix();
+  m_airspaceLayerProjection = _globalMapMatrix->getProjectionId();
+  m_airspaceLayerSize       = m_pixAeroMap.size();
+
+  // Copy the airspace layers onto the aero map. Unused layers are released
+  // by the rendering, so only the layers with airspaces are copied.
+  QPainter cuAeroMapP;
+
+  cuAeroMapP.begin(&m_pixAeroMap);
+
+  for( int i = 0; i < AIRSPACE_LAYERS; i++ )
+    {
+      if( m_pixAirspaceLayers[i].isNull() == false )
+        {
+          cuAeroMapP.drawPixmap( 0, 0, m_pixAirspaceLayers[i] );
         }
     }
 
@@ -909,6 +1094,112 @@ void Map::p_drawAirspaces( bool reset )
   // qDebug("Airspace, drawTime=%d ms", t.elapsed());
 }
 
+void Map::removeAirspaces( const QSet<Airspace*>& airspaces )
+{
+  for( int i = m_airspaceRegionList.size() - 1; i >= 0; i-- )
+    {
+      AirRegion* region = m_airspaceRegionList.at(i);
+
+      if( region->m_airspace == 0 || airspaces.contains( region->m_airspace ) )
+        {
+          delete m_airspaceRegionList.takeAt(i);
+        }
+    }
+
+  // The areas of the removed airspaces are cleared in their layers.
+  QRegion dirty[AIRSPACE_LAYERS];
+  bool changed = false;
+
+  for( int i = m_airspaceDrawItems.size() - 1; i >= 0; i-- )
+    {
+      const AirspaceDrawItem& item = m_airspaceDrawItems.at(i);
+
+      if( airspaces.contains( item.airspace ) )
+        {
+          dirty[item.layer] += item.rect;
+          m_airspaceDrawItems.remove(i);
+          changed = true;
+        }
+    }
+
+  if( changed && m_airspaceLayersValid )
+    {
+      p_renderAirspaceLayers( dirty );
+    }
+}
+
+void Map::p_renderAirspaceLayers( const QRegion* dirty )
+{
+  bool used[AIRSPACE_LAYERS];
+
+  for( int i = 0; i < AIRSPACE_LAYERS; i++ )
+    {
+      used[i] = false;
+    }
+
+  for( int i = 0; i < m_airspaceDrawItems.size(); i++ )
+    {
+      used[m_airspaceDrawItems.at(i).layer] = true;
+    }
+
+  for( int l = 0; l < AIRSPACE_LAYERS; l++ )
+    {
+      if( used[l] == false )
+        {
+          // Release the memory of an unused layer. It is not drawn anymore.
+          m_pixAirspaceLayers[l] = QPixmap();
+          continue;
+        }
+
+      if( dirty == 0 )
+        {
+          if( m_pixAirspaceLayers[l].size() != m_pixAeroMap.size() )
+            {
+              m_pixAirspaceLayers[l] = QPixmap( m_pixAeroMap.size() );
+            }
+
+          m_pixAirspaceLayers[l].fill( Qt::transparent );
+        }
+      else
+        {
+          if( dirty[l].isEmpty() )
+            {
+              continue;
+            }
+
+          if( m_pixAirspaceLayers[l].isNull() )
+            {
+              m_pixAirspaceLayers[l] = QPixmap( m_pixAeroMap.size() );
+              m_pixAirspaceLayers[l].fill( Qt::transparent );
+            }
+        }
+
+      QPainter layerP( &m_pixAirspaceLayers[l] );
+
+      if( dirty != 0 )
+        {
+          // Clear the dirty region, only it is rendered again.
+          layerP.setClipRegion( dirty[l] );
+          layerP.setCompositionMode( QPainter::CompositionMode_Clear );
+          layerP.fillRect( dirty[l].boundingRect(), Qt::transparent );
+          layerP.setCompositionMode( QPainter::CompositionMode_SourceOver );
+        }
+
+      for( int i = 0; i < m_airspaceDrawItems.size(); i++ )
+        {
+          const AirspaceDrawItem& item = m_airspaceDrawItems.at(i);
+
+          if( item.layer != l ||
+              (dirty != 0 && dirty[l].intersects( item.rect ) == false) )
+            {
+              continue;
+            }
+
+          item.airspace->drawRegion( &layerP, item.opacity );
+        }
+    }
+}
+
 void Map::p_drawGrid()
 {
   const QRect mapBorder = _globalMapMatrix->getViewBorder();
@@ -1278,6 +1569,7 @@ void Map::p_redrawMap(mapLayer fromLayer, bool queueRequest)
           lastSize = size();
           // reinitialize the base pixmap
           m_pixBaseMap = QPixmap( size() );
+          m_baseLayerValid = false;
         }
 
       //actually start doing our drawing
@@ -1364,35 +1656,38 @@ void Map::p_drawBaseLayer()
   m_drawnCityList.clear();
   QList<BaseMapElement *> drawnElements;
 
-  // Erase the base layer and fill it with the subterrain color. If there
-  // are no terrain map data available, this is the default map ground color.
-  m_pixBaseMap.fill( GeneralConfig::instance()->getTerrainColor(0) );
-
   // make sure we have all the map files we need loaded
   _globalMapContents->proofeSection();
 
   double cs = _globalMapMatrix->getScale(MapMatrix::CurrentScale);
 
+  // The part of the base layer, which must be drawn.
+  QRegion exposed( m_pixBaseMap.rect() );
+  QPoint delta;
+
+  if( p_isBaseLayerScrollable( delta ) )
+    {
+      // Only the map center has been moved. The old content is shifted and
+      // only the exposed strips are drawn.
+      m_pixBaseMap.scroll( delta.x(), delta.y(), m_pixBaseMap.rect() );
+      exposed -= QRegion( m_pixBaseMap.rect().translated( delta ) );
+    }
+
   // create a pixmap painter
   QPainter baseMapP;
 
   baseMapP.begin(&m_pixBaseMap);
+  baseMapP.setClipRegion( exposed );
 
-  // first, draw the iso lines
-  _globalMapContents->drawIsoList(&baseMapP);
-
-  // next, draw the topographical elements and the cities
-  _globalMapContents->drawList(&baseMapP, MapContents::TopoList, drawnElements);
-  _globalMapContents->drawList(&baseMapP, MapContents::CityList, m_drawnCityList);
-  _globalMapContents->drawList(&baseMapP, MapContents::LakeList, drawnElements);
+  // Erase the base layer and fill it with the subterrain color. If there
+  // are no terrain map data available, this is the default map ground color.
+  baseMapP.fillRect( m_pixBaseMap.rect(), GeneralConfig::instance()->getTerrainColor(0) );
 
-  // draw the roads, the railroads, the hydro
-  if( cs <= 200.0 )
-    {
-      _globalMapContents->drawList(&baseMapP, MapContents::RoadList, drawnElements);
-      _globalMapContents->drawList(&baseMapP, MapContents::RailList, drawnElements);
-      _globalMapContents->drawList(&baseMapP, MapContents::HydroList, drawnElements);
-   }
+  // First, draw the landscape tiles. They contain the iso lines, the
+  // topographical elements, the cities, the lakes, the roads, the railroads,
+  // the hydro and the motorways. Missing tiles are rendered in the
+  // background and drawn later on.
+  const int outdatedTiles = m_tileRenderer->drawTiles( &baseMapP, size() );
 
   // draw the landmarks and the obstacles
   if( cs < 1024.0 )
@@ -1402,22 +1697,69 @@ void Map::p_drawBaseLayer()
       _globalMapContents->drawList(&baseMapP, MapContents::ReportList, drawnElements);
     }
 
-  // draw the motorways
-  _globalMapContents->drawList(&baseMapP, MapContents::MotorwayList, drawnElements);
-
   // end the painter
   baseMapP.end();
 
   // draw the city labels if scale is not to high
   if( cs <= 60.0 )
     {
-      p_drawCityLabels( m_pixBaseMap );
+      _globalMapContents->getVisibleCities( m_drawnCityList );
+      p_drawCityLabels( m_pixBaseMap, exposed );
     }
 
+  // Save the state of the base layer. If tiles are missing, it must be
+  // drawn completely again, when they are delivered.
+  m_baseLayerValid      = (outdatedTiles == 0);
+  m_baseLayerMatrix     = _globalMapMatrix->getWorldMatrix();
+  m_baseLayerProjection = _globalMapMatrix->getProjectionId();
+  m_baseLayerGeneration = _globalMapContents->getGeneration();
+
   // calculate the tail points because projection has been changed
   p_calculateTrailPoints();
 }
 
+bool Map::p_isBaseLayerScrollable( QPoint& delta ) const
+{
+  if( m_baseLayerValid == false ||
+      m_baseLayerProjection != _globalMapMatrix->getProjectionId() ||
+      m_baseLayerGeneration != _globalMapContents->getGeneration() )
+    {
+      return false;
+    }
+
+  return p_isLayerScrollable( m_baseLayerMatrix, delta );
+}
+
+bool Map::p_isLayerScrollable( const QTransform& matrix, QPoint& delta ) const
+{
+  const QTransform& wm = _globalMapMatrix->getWorldMatrix();
+
+  // Scale and rotation must be unchanged.
+  if( wm.m11() != matrix.m11() ||
+      wm.m12() != matrix.m12() ||
+      wm.m21() != matrix.m21() ||
+      wm.m22() != matrix.m22() )
+    {
+      return false;
+    }
+
+  const double dx = wm.dx() - matrix.dx();
+  const double dy = wm.dy() - matrix.dy();
+
+  // The translation is always a whole number of pixels. Otherwise the
+  // scrolled content would not fit to the new drawn strips.
+  if( fabs( dx - rint( dx ) ) > 0.01 || fabs( dy - rint( dy ) ) > 0.01 )
+    {
+      return false;
+    }
+
+  delta = QPoint( (int) rint( dx ), (int) rint( dy ) );
+
+  // If nothing of the old content remains visible, scrolling makes no sense.
+  return ( abs( delta.x() ) < m_pixBaseMap.width() &&
+           abs( delta.y() ) < m_pixBaseMap.height() );
+}
+
 /**
  * Draws the aero layer of the map.
  * The aero layer consists of the airspace structures and the navigation
@@ -1683,6 +2025,37 @@ void Map::slotRedrawMap()
   p_redrawMap(drawLayer);
 }
 
+void Map::slotTilesReady()
+{
+  // Several tiles are delivered in a short time. They are collected to
+  // avoid a redraw for every single tile.
+  if( ! m_tileTimer->isActive() )
+    {
+      m_tileTimer->start(100);
+    }
+}
+
+void Map::slotTileTimerExpired()
+{
+  if( mutex() )
+    {
+      // Map drawing is running, try it later again.
+      m_tileTimer->start(100);
+      return;
+    }
+
+  m_scheduledFromLayer = baseLayer;
+  slotRedrawMap();
+}
+
+void Map::invalidateTiles()
+{
+  m_tileRenderer->invalidate();
+
+  // The base layer must be drawn completely again.
+  m_baseLayerValid = false;
+}
+
 /** Draws the waypoints of the waypoint catalog on the map */
 void Map::p_drawWaypoints(QPainter* painter, QList<Waypoint*> &drawnWp)
 {
@@ -1967,7 +2340,7 @@ void Map::p_drawLabel( QPainter* painter,
   painter->restore();
 }
 
-void Map::p_drawCityLabels( QPixmap& pixmap )
+void Map::p_drawCityLabels( QPixmap& pixmap, const QRegion& clip )
 {
   if( m_drawnCityList.size() == 0 )
     {
@@ -1977,6 +2350,8 @@ void Map::p_drawCityLabels( QPixmap& pixmap )
   QString labelText;
 
   QPainter painter(&pixmap);
+  painter.setClipRegion( clip );
+
   QFont font = painter.font();
 
   // Uses on all screens the same font point size
@@ -1990,10 +2365,10 @@ void Map::p_drawCityLabels( QPixmap& pixmap )
 
   for( int i = 0; i < m_drawnCityList.size(); i++ )
     {
-      LineElement* city = static_cast<LineElement *> (m_drawnCityList.at(i));
+      const LineElement* city = m_drawnCityList.at(i);
 
       // Get the screen bounding box of the city
-      QRect sbRect = city->getScreenBoundingBox();
+      QRect sbRect = city->mapScreenBoundingBox();
 
       // A city can consist of several segments at a border edge but we want to
       // draw the name only once.
@@ -3092,11 +3467,9 @@ void Map::p_drawRelBearingInfo()
  */
 void Map::checkAirspace(const QPoint& pos)
 {
-  if ( mutex() )
-    {
-      return;
-    }
-
+  // The check works with the WGS84 geometry of the airspaces. It is done
+  // for every position, independent of the map view and of a running
+  // map redraw.
   bool warningEnabled = GeneralConfig::instance()->getAirspaceWarningEnabled();
   bool fillingEnabled = GeneralConfig::instance()->getAirspaceFillingEnabled();
   bool needAirspaceRedraw = false;
@@ -3137,10 +3510,48 @@ void Map::checkAirspace(const QPoint& pos)
 
   bool warn = false; // warning flag
 
+  // The border is stored as FL
+  bool drawingBorder = GeneralConfig::instance()->getAirspaceDrawBorderEnabled();
+  uint asBorder = (uint) rint(GeneralConfig::instance()->getAirspaceDrawingBorder() * 100.0 * Distance::mFromFeet );
+
+  // Only the airspaces inside of the near distance plus the distance flown
+  // in the next minute are candidates of a conflict. The horizon ensures,
+  // that an airspace of the last check cannot leave the candidates with an
+  // outdated conflict state between two fixes.
+  const double horizon = awd.horClose.getMeters() +
+                         calculator->getLastSpeed().getMps() * 60.0;
+
+  QVector<int> candidates;
+
+  _globalMapContents->getSpatialIndex( MapContents::AirspaceList )
+      .queryRadius( pos, horizon / 1000.0, candidates );
+
+  SortableAirspaceList* asList = _globalMapContents->getAirspaceList();
+
+  QList<Airspace*> airspaces;
+
+  for( int i = 0; i < candidates.size(); i++ )
+    {
+      airspaces.append( asList->at( candidates.at(i) ) );
+    }
+
+  // The few Flarm alert zones are checked always.
+  airspaces << *_globalMapContents->getFlarmAlertZoneList();
+
+  // The vertical conflicts of all airspaces are computed in one pass.
+  AirspaceLimitTable& limits = _globalMapContents->getAirspaceLimitTable();
+  limits.evaluate( alt, awd );
+
   // check if there are overlaps between the region around our current position and airspaces
-  for( int loop = 0; loop < m_airspaceRegionList.count(); loop++ )
+  for( int loop = 0; loop < airspaces.count(); loop++ )
     {
-      Airspace* pSpace = m_airspaceRegionList.at(loop)->m_airspace;
+      Airspace* pSpace = airspaces.at(loop);
+
+      if( drawingBorder == true && pSpace->getLowerL() > asBorder )
+        {
+          // Airspaces above the drawing border are not shown and not checked.
+          continue;
+        }
 
       if( pSpace->getTypeID() == BaseMapElement::AirFir )
         {
@@ -3159,11 +3570,20 @@ void Map::checkAirspace(const QPoint& pos)
         }
 
       lastVConflict = pSpace->lastVConflict();
-      lastHConflict = m_airspaceRegionList.at(loop)->currentConflict();
+      lastHConflict = pSpace->lastHConflict();
       lastConflict = (lastHConflict < lastVConflict ? lastHConflict : lastVConflict);
 
       // check for vertical conflicts at first
-      vConflict = pSpace->conflicts(alt, awd);
+      if( loop < candidates.size() )
+        {
+          vConflict = limits.conflict( candidates.at(loop) );
+          pSpace->setLastVConflict( vConflict );
+        }
+      else
+        {
+          // Flarm alert zones are not contained in the airspace list.
+          vConflict = pSpace->conflicts(alt, awd);
+        }
 
       needAirspaceRedraw |= (vConflict != lastVConflict);
 
@@ -3174,7 +3594,7 @@ void Map::checkAirspace(const QPoint& pos)
         }
 
       // check for horizontal conflicts
-      hConflict = m_airspaceRegionList.at(loop)->conflicts(pos, awd);
+      hConflict = pSpace->lateralConflict(pos, awd);
 
       // the resulting conflict is always the lesser of the two
       conflict = (hConflict < vConflict ? hConflict : vConflict);
@@ -3302,6 +3722,39 @@ void Map::checkAirspace(const QPoint& pos)
   m_veryNearAsMap = allVeryNearAsMap;
   m_nearAsMap     = allNearAsMap;
 
+  // Predicted entries along the extrapolated track
+  QMap<QString, int> newAheadAsMap;
+  QMap<QString, int> allAheadAsMap;
+
+  const int lookahead = GeneralConfig::instance()->getAirspaceLookaheadTime();
+
+  m_asLookahead.update( calculator->samplelist, alt, lookahead );
+
+  const QList<AirspaceLookahead::Incursion>& incursions =
+      m_asLookahead.getIncursions();
+
+  for( int i = 0; i < incursions.size(); i++ )
+    {
+      Airspace* pSpace = incursions.at(i).airspace;
+
+      if( ! GeneralConfig::instance()->getItemDrawingEnabled(pSpace->getTypeID()) ||
+          allInsideAsMap.contains( pSpace->getInfoString() ) )
+        {
+          continue;
+        }
+
+      allAheadAsMap.insert( pSpace->getInfoString(), incursions.at(i).timeToEntry );
+
+      // A prediction is announced only once per airspace.
+      if( ! m_aheadAsMap.contains( pSpace->getInfoString() ) )
+        {
+          newAheadAsMap.insert( pSpace->getInfoString(), incursions.at(i).timeToEntry );
+          warn = true;
+        }
+    }
+
+  m_aheadAsMap = allAheadAsMap;
+
   // redraw the airspaces if needed
   if (needAirspaceRedraw && fillingEnabled)
     {
@@ -3439,6 +3892,22 @@ void Map::checkAirspace(const QPoint& pos)
                 + "</td></tr>";
           }
     }
+  else if ( ! newAheadAsMap.isEmpty() )
+    {
+      // new predicted entry has been found
+      QMapIterator<QString, int> j(newAheadAsMap);
+
+      while ( j.hasNext()  )
+        {
+           j.next();
+
+           text += "<tr><td align=left>"
+                + tr("Entry in %1 s").arg( j.value() ) + " "
+                + "</td></tr><tr><td align=left>"
+                + j.key()
+                + "</td></tr>";
+          }
+    }
 
   // Pop up a warning window with all data to touched airspace
   if ( warn == true )
@@ -3498,7 +3967,8 @@ void Map::slotShowAirspaceStatus()
 
   if( m_insideAsMap.size() == 0 &&
        m_veryNearAsMap.size() == 0 &&
-       m_nearAsMap.size() == 0 )
+       m_nearAsMap.size() == 0 &&
+       m_aheadAsMap.size() == 0 )
     {
       text += "<tr><td align=center>" +
               tr("No Airspace violation") + " " +
@@ -3552,6 +4022,21 @@ void Map::slotShowAirspaceStatus()
         }
     }
 
+  if( m_aheadAsMap.size() )
+    {
+      text += "<tr><td align=center><b>" +
+              tr("Ahead") + "</b></td></tr>";
+
+      QMapIterator<QString, int> it(m_aheadAsMap);
+
+      while (it.hasNext())
+        {
+          it.next();
+          text += "<tr><td>" + tr("Entry in %1 s").arg( it.value() ) +
+                  "<br>" + it.key() + "</td></tr>";
+        }
+    }
+
   box = new WhatsThat( this, text, showTime );
   box->show();
 }
@@ -44,11 +44,16 @@
 #include <QEvent>
 #include <QResizeEvent>
 #include <QRect>
+#include <QRegion>
 #include <QTime>
+#include <QTransform>
+#include <QSet>
+#include <QVector>
 #include <QWheelEvent>
 
 #include "airspace.h"
 #include "airregion.h"
+#include "airspacelookahead.h"
 #include "flighttask.h"
 #include "speed.h"
 #include "vector.h"
@@ -58,6 +63,14 @@
 #include "flarm.h"
 #endif
 
+class LineElement;
+class MapTileRenderer;
+
+// Number of airspace layers. Lateral conflict classes none, near and very
+// near plus the vertical classes none, near, very near and inside for
+// laterally entered airspaces.
+#define AIRSPACE_LAYERS 7
+
 class Map : public QWidget
 {
   Q_OBJECT
@@ -197,14 +210,35 @@ public:
     return instance;
   };
 
+  /**
+   * Marks all rendered base map tiles as outdated. Must be called, if the
+   * drawing configuration of the base map has been changed.
+   */
+  void invalidateTiles();
+
   /** clear airspace region list */
   void clearAirspaceRegionList()
     {
       qDeleteAll(m_airspaceRegionList);
       m_airspaceRegionList.clear();
       m_airspaceRegionList = QList<AirRegion *>();
+
+      // The airspace layers refer to the airspace list.
+      m_airspaceDrawItems.clear();
+      m_airspaceLayersValid = false;
+
+      // The predictions refer to the airspace list.
+      m_asLookahead.reset();
+      m_aheadAsMap.clear();
     };
 
+  /**
+   * Removes all references to the passed airspaces, before they are
+   * deleted. Their regions are removed and their areas in the airspace
+   * layers are rendered again without them.
+   */
+  void removeAirspaces( const QSet<Airspace*>& airspaces );
+
 public slots:
 
   /** This slot is called, if a new wind value is available. */
@@ -268,6 +302,12 @@ private slots:
   /** Called by timer expiration. */
   void slotASSTimerExpired();
 
+  /** Called, if base map tiles have been rendered in the background. */
+  void slotTilesReady();
+
+  /** Called by timer expiration to draw the new rendered tiles. */
+  void slotTileTimerExpired();
+
 signals:
 
   /**
@@ -365,10 +405,36 @@ private:
    * Draws the base layer of the map.
    * The base layer consists of the basic map, containing everything up
    * to the features of the landscape.
-   * It is drawn on an empty canvas.
+   * It is drawn on an empty canvas. If only the map center has been moved
+   * since the last drawing, the old content is shifted and only the
+   * exposed strips are drawn.
    */
   void p_drawBaseLayer();
 
+  /**
+   * Checks, if the base layer pixmap can be reused by shifting it. That is
+   * the case, if it is complete and only the translation of the map matrix
+   * and nothing else has been changed since its drawing.
+   *
+   * @param delta The pixel distance, by which the content must be shifted.
+   *
+   * @return True, if the base layer can be scrolled.
+   */
+  bool p_isBaseLayerScrollable( QPoint& delta ) const;
+
+  /**
+   * Checks, if only the translation of the current map matrix differs from
+   * the passed matrix by whole pixels and the old content is still partly
+   * visible.
+   *
+   * @param matrix The map matrix, with which a layer has been drawn.
+   *
+   * @param delta The pixel distance, by which the content must be shifted.
+   *
+   * @return True, if the layer can be scrolled.
+   */
+  bool p_isLayerScrollable( const QTransform& matrix, QPoint& delta ) const;
+
   /**
    * Draws the aero layer of the map.
    * The aero layer consists of the airspace structures and the navigation
@@ -415,9 +481,23 @@ private:
    *            This only needs to be done if a change in which
    *            airspaces are drawn can be expected. Otherwise, it's
    *            better to re-use the current list.
+   *
+   * The airspaces are rendered into the airspace layers, one layer per
+   * conflict class, which are then copied onto the aero map. Only the
+   * rectangles of airspaces, which have changed their conflict class, are
+   * rendered again. If the map center has been moved, the layers are
+   * scrolled and the exposed strips are rendered in addition.
    */
   void p_drawAirspaces(bool reset);
 
+  /**
+   * Renders the airspaces of the draw item list into the airspace layers.
+   * If dirty regions are passed, only these regions of the layers are
+   * rendered again, otherwise the whole layers. Layers without airspaces
+   * are released.
+   */
+  void p_renderAirspaceLayers( const QRegion* dirty = 0 );
+
   /**
    * Draws the waypoints of the active waypoint catalog to the map.
    * @arg wpPainter Painter for the waypoints
@@ -449,8 +529,10 @@ private:
 
   /**
    * Draws the city labels at the map.
+   *
+   * @param clip Only this part of the pixmap is drawn.
    */
-  void p_drawCityLabels( QPixmap& pixmap );
+  void p_drawCityLabels( QPixmap& pixmap, const QRegion& clip );
 
   /**
    * Display Info about Airspace items
@@ -625,6 +707,41 @@ private: //members
   //contains a strip with wind arrows in different directions
   QPixmap m_windArrow;
 
+  /**
+   * An airspace, which is drawn into one of the airspace layers.
+   */
+  class AirspaceDrawItem
+  {
+   public:
+
+    AirspaceDrawItem() : airspace(0), layer(0), opacity(0.0) {};
+
+    Airspace* airspace;
+
+    /** Index of the airspace layer, that is the conflict class. */
+    int layer;
+
+    /** Opacity, with which the airspace is drawn. */
+    qreal opacity;
+
+    /** Rectangle on the map, which is covered by the airspace. */
+    QRect rect;
+  };
+
+  // the pre-rendered airspaces, one transparent layer per conflict class
+  QPixmap m_pixAirspaceLayers[AIRSPACE_LAYERS];
+
+  // the airspaces of the airspace layers in drawing order
+  QVector<AirspaceDrawItem> m_airspaceDrawItems;
+
+  // true, if the airspace layers match the current view
+  bool m_airspaceLayersValid;
+
+  // view of the airspace layers at their last rendering
+  QTransform m_airspaceLayerMatrix;
+  int        m_airspaceLayerProjection;
+  QSize      m_airspaceLayerSize;
+
   int m_mapRot;
   int m_curMapRot;
 
@@ -696,6 +813,10 @@ protected:
   QMap<QString, int> m_insideAsMap;   // AS Text and AS type
   QMap<QString, int> m_veryNearAsMap; // AS Text and AS type
   QMap<QString, int> m_nearAsMap;     // AS Text and AS type
+  QMap<QString, int> m_aheadAsMap;    // AS Text and time to entry
+
+  /** Prediction of airspace entries along the track */
+  AirspaceLookahead m_asLookahead;
 
   /* Airspace conflicts touch times */
   QMap<QString, QTime> m_insideAsMapTouchTime;   // AS Text and touch time
@@ -703,7 +824,7 @@ protected:
   QMap<QString, QTime> m_nearAsMapTouchTime;     // AS Text and touch time
 
   /** List of drawn cities. */
-  QList<BaseMapElement *> m_drawnCityList;
+  QList<const LineElement *> m_drawnCityList;
 
   /** List of mapped positions for trail drawing */
   QList<QPoint> m_trailPoints;
@@ -717,9 +838,24 @@ protected:
   /** Timer which activates the airspace status display. */
   QTimer* m_showASSTimer;
 
+  /** Renderer of the base map tiles. */
+  MapTileRenderer* m_tileRenderer;
+
+  /** Timer to combine several tile deliveries to one redraw. */
+  QTimer* m_tileTimer;
+
   /** Flag to ignore mouse release event. */
   bool m_ignoreMouseRelease;
 
+  /**
+   * State of the base layer pixmap at its last drawing. It is used to
+   * decide, if the pixmap can be scrolled instead of drawn again.
+   */
+  bool       m_baseLayerValid;
+  QTransform m_baseLayerMatrix;
+  int        m_baseLayerProjection;
+  int        m_baseLayerGeneration;
+
 public:
 
   static Map *instance;
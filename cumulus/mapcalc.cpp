@@ -554,3 +554,121 @@ bool MapCalc::calcETAS( const int tk,
 
   return true;
 }
+
+void MapCalc::simplifyPolygon( const QPolygon& wgsPolygon,
+                               const double tolerance,
+                               QPolygon& result )
+{
+  const int size = wgsPolygon.size();
+
+  if( size < 3 || tolerance <= 0.0 )
+    {
+      result = wgsPolygon;
+      return;
+    }
+
+  // The points are converted into a local plane in meters. That is
+  // accurate enough for the small extension of a map element.
+  const double latFactor = MILE_kfl / 10000.0;
+  const double lonFactor = latFactor *
+                           cos( wgsPolygon.at(0).x() * M_PI / 108000000.0 );
+
+  QVector<double> x( size );
+  QVector<double> y( size );
+
+  for( int i = 0; i < size; i++ )
+    {
+      x[i] = wgsPolygon.at(i).y() * lonFactor;
+      y[i] = wgsPolygon.at(i).x() * latFactor;
+    }
+
+  QVector<bool> keep( size, false );
+  keep[0] = keep[size - 1] = true;
+
+  const double tolerance2 = tolerance * tolerance;
+
+  // Ranges still to be checked, an explicit stack avoids deep recursions
+  // at long isolines.
+  QVector<QPair<int, int> > stack;
+  stack.append( qMakePair( 0, size - 1 ) );
+
+  while( stack.isEmpty() == false )
+    {
+      const QPair<int, int> range = stack.last();
+      stack.pop_back();
+
+      const int first = range.first;
+      const int last  = range.second;
+
+      if( last - first < 2 )
+        {
+          continue;
+        }
+
+      const double dx = x[last] - x[first];
+      const double dy = y[last] - y[first];
+      const double len2 = dx * dx + dy * dy;
+
+      double maxDist2 = -1.0;
+      int index = first;
+
+      for( int i = first + 1; i < last; i++ )
+        {
+          double px = x[i] - x[first];
+          double py = y[i] - y[first];
+          double dist2;
+
+          if( len2 == 0.0 )
+            {
+              // Closed polygon, first and last point are identical.
+              dist2 = px * px + py * py;
+            }
+          else
+            {
+              // Distance to the segment, not to the infinite line. Otherwise
+              // points of a line doubling back beyond the segment ends are
+              // dropped.
+              const double t = (px * dx + py * dy) / len2;
+
+              if( t <= 0.0 )
+                {
+                  dist2 = px * px + py * py;
+                }
+              else if( t >= 1.0 )
+                {
+                  const double qx = x[i] - x[last];
+                  const double qy = y[i] - y[last];
+                  dist2 = qx * qx + qy * qy;
+                }
+              else
+                {
+                  const double cross = px * dy - py * dx;
+                  dist2 = cross * cross / len2;
+                }
+            }
+
+          if( dist2 > maxDist2 )
+            {
+              maxDist2 = dist2;
+              index = i;
+            }
+        }
+
+      if( maxDist2 > tolerance2 )
+        {
+          keep[index] = true;
+          stack.append( qMakePair( first, index ) );
+          stack.append( qMakePair( index, last ) );
+        }
+    }
+
+  result.clear();
+
+  for( int i = 0; i < size; i++ )
+    {
+      if( keep[i] )
+        {
+          result.append( wgsPolygon.at(i) );
+        }
+    }
+}
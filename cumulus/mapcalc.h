@@ -17,6 +17,7 @@
 #ifndef MAP_CALC_H
 #define MAP_CALC_H
 
+#include <QPolygon>
 #include <QRect>
 
 #include "speed.h"
@@ -174,6 +175,19 @@ namespace MapCalc
 		 const Speed& ws,
 		 Speed& etas,
 		 int& eth );
+
+  /**
+   * Simplifies a polygon with the Douglas-Peucker algorithm. All points,
+   * which deviate less than the tolerance from the simplified line, are
+   * removed. The first and the last point are always kept.
+   *
+   * \param [in] wgsPolygon Points in KFLog coordinates, x is the latitude.
+   * \param [in] tolerance Maximum deviation in meters.
+   * \param [out] result The simplified polygon.
+   */
+  void simplifyPolygon( const QPolygon& wgsPolygon,
+                        const double tolerance,
+                        QPolygon& result );
 };
 
 #endif
@@ -27,6 +27,7 @@
 #include "basemapelement.h"
 #include "calculator.h"
 #include "datatypes.h"
+#include "elevationraster.h"
 #include "filetools.h"
 #include "flighttask.h"
 #include "generalconfig.h"
@@ -36,8 +37,10 @@
 #include "lineelement.h"
 #include "mainwindow.h"
 #include "mapcalc.h"
+#include "mapconfig.h"
 #include "mapcontents.h"
 #include "mapmatrix.h"
+#include "maptilerenderer.h"
 #include "mapview.h"
 #include "projectionbase.h"
 #include "resource.h"
@@ -49,28 +52,34 @@
 #include "OpenAipPoiLoader.h"
 #include "OpenAipLoaderThread.h"
 
+extern MapConfig* _globalMapConfig;
 extern MapMatrix* _globalMapMatrix;
 extern MapView*   _globalMapView;
 
-#define FILE_FORMAT_ID 100 // used to handle a previous version
-
-#define READ_POINT_LIST\
-  if (compiling) {\
-    in >> locLength;\
-    all.resize(locLength);\
-    for(uint i = 0; i < locLength; i++) { \
-      in >> lat_temp; \
-      in >> lon_temp; \
-      all.setPoint(i, _globalMapMatrix->wgsToMap(lat_temp, lon_temp)); \
-    }\
-    ShortSave(out, all);\
-  } else\
-    ShortLoad(in, all);\
+// Priority offset of the tiles, which are prefetched along the track.
+#define PREFETCH_PRIORITY 1000000
 
 // Minimum amount of required free memory to start loading of a map file.
 // Do not under run this limit, OS can freeze is such a case.
 #define MINIMUM_FREE_MEMORY 1024*25
 
+namespace
+{
+  /**
+   * Projects the WGS84 positions of all elements of a new tile with the
+   * current map projection. The WGS84 positions are released afterwards,
+   * so that an element holds only one copy of its positions.
+   */
+  template <class T> void projectElements( QList<T>& list )
+  {
+    for( int i = 0; i < list.size(); i++ )
+      {
+        list[i].updateProjection();
+        list[i].releaseWgsPolygon();
+      }
+  }
+}
+
 // List of used elevation levels in meters (51 in total):
 const short MapContents::isoLevels[] =
 {
@@ -86,7 +95,14 @@ MapContents::MapContents(QObject* parent, WaitScreen* waitscreen) :
     unloadDone(false),
     memoryFull(false),
     isFirst(true),
-    isReload(false)
+    isReload(false),
+    m_generation(0),
+    m_resetGeneration(0),
+    m_projectionId(-1),
+    m_tileLoader(0),
+    m_tileLoadGeneration(0),
+    m_airspaceLimitsValid(false),
+    m_airspaceGeneration(0)
 #ifdef INTERNET
 
     , m_downloadMangerMaps(0),
@@ -98,1301 +114,163 @@ MapContents::MapContents(QObject* parent, WaitScreen* waitscreen) :
 #endif
 {
   ws = waitscreen;
+  m_mapLoadSettings = getMapLoadSettings();
 
   // Setup a hash used as reverse mapping from isoLine elevation value
   // to color array index.
   for ( uchar i = 0; i < ISO_LINE_LEVELS; i++ )
-    {
-      isoHash.insert( isoLevels[i], i );
-    }
-
-  _nextIsoLevel=10000;
-  _lastIsoLevel=-1;
-  _isoLevelReset=true;
-  _lastIsoEntry=0;
-
-  // read in waypoint list from catalog
-  WaypointCatalog wpCat;
-  int ok;
-  const char* format;
-  QString error;
-
-  if( GeneralConfig::instance()->getWaypointFileFormat() == GeneralConfig::Binary )
-    {
-      ok = wpCat.readBinary( "", &wpList );
-      format = "binary";
-    }
-  else
-    {
-      ok = wpCat.readXml( "", &wpList, error );
-      format = "xml";
-    }
-
-  if( ok )
-    {
-      qDebug() << "MapContents():" << wpList.size() << "waypoints read from"
-               << format << "catalog.";
-    }
-
-  currentTask = 0;
-
-  connect( this, SIGNAL(progress(int)), ws, SLOT(slot_Progress(int)) );
-
-  connect( this, SIGNAL(loadingFile(const QString&)),
-           ws, SLOT(slot_SetText2(const QString&)) );
-
-  // qDebug("MapContents initialized");
-}
-
-MapContents::~MapContents()
-{
-  if ( currentTask )
-    {
-      delete currentTask;
-    }
-
-  qDeleteAll( airspaceList );
-  qDeleteAll( flarmAlertZoneList );
-}
-
-// save the current waypoint list
-void MapContents::saveWaypointList()
-{
-  WaypointCatalog wpCat;
-
-  if( GeneralConfig::instance()->getWaypointFileFormat() == GeneralConfig::Binary )
-    {
-      wpCat.writeBinary( "", wpList );
-    }
-  else
-    {
-      wpCat.writeXml( "", wpList );
-    }
-}
-
-/**
- * This method reads in the ground and terrain files from the original
- * kflog source or from the own compiled source. Compiled sources are
- * created from the original kflog source to have a faster access to the
- * single data items. If the map projection is changed the compiled source
- * must be renewed.
- *
- * Ground files describe the surface at level 0m. They are always read in.
- * Terrain files describe the surface above level 0m. If isoline drawing
- * is switched off, terrain files are never read in.
- *
- * Thanks to Josua Dietze for his contribution of precomputed map files.
- *
- */
-bool MapContents::readTerrainFile( const int fileSecID, const int fileTypeID )
-{
-  bool kflExists, kfcExists;
-  bool compiling = false;
-
-  if ( fileTypeID != FILE_TYPE_TERRAIN && fileTypeID != FILE_TYPE_GROUND )
-    {
-      qWarning( "Requested terrain file type 0x%X is unsupported!", fileTypeID );
-      return false;
-    }
-
-  // First check if we need to load terrain files.
-  if ( fileTypeID == FILE_TYPE_TERRAIN &&
-       ( !GeneralConfig::instance()->getMapLoadIsoLines() ))
-    {
-      // loading of terrain files is switched off by the user
-      return true;
-    }
-
-  if (memoryFull) //if we already know the memory if full and can't be emptied at this point, just return.
-    {
-      _globalMapView->message(tr("Out of memory! Map not loaded."));
-      return false;
-    }
-
-  // check free memory
-  int memFree = HwInfo::instance()->getFreeMemory();
-
-  if ( memFree < MINIMUM_FREE_MEMORY )
-    {
-      if ( !unloadDone)
-        {
-          unloadMaps();  // try freeing some memory
-          memFree = HwInfo::instance()->getFreeMemory();  //re-asses free memory
-          if ( memFree < MINIMUM_FREE_MEMORY )
-            {
-              memoryFull=true; //set flag to indicate that we need not try loading any more mapfiles now.
-              qWarning("Cumulus couldn't load file, low on memory! Memory needed: %d kB, free: %d kB", MINIMUM_FREE_MEMORY, memFree );
-              _globalMapView->message(tr("Out of memory! Map not loaded."));
-              return false;
-            }
-        }
-      else
-        {
-          memoryFull=true; //set flag to indicate that we need not try loading any more mapfiles now.
-          qWarning("Cumulus couldn't load file, low on memory! Memory needed: %d kB, free: %d kB", MINIMUM_FREE_MEMORY, memFree );
-          _globalMapView->message(tr("Out of memory! Map not loaded."));
-          return false;
-        }
-    }
-
-  QString kflPathName, kfcPathName, pathName;
-  QString kflName, kfcName;
-
-  kflName.sprintf("%c_%.5d.kfl", fileTypeID, fileSecID);
-  kflExists = locateFile("landscape/" + kflName, kflPathName);
-
-  kfcName.sprintf("landscape/%c_%.5d.kfc", fileTypeID, fileSecID);
-  kfcExists = locateFile(kfcName, kfcPathName);
-
-  if ( ! (kflExists || kfcExists) )
-    {
-      QString path = GeneralConfig::instance()->getMapRootDir() + "/landscape";
-
-      bool res = false;
-
-#ifdef INTERNET
-
-      res = askUserForDownload();
-
-      if( res == true )
-        {
-          res = downloadMapFile( kflName, path );
-        }
-
-#endif
-
-      if( res == false  )
-        {
-          qWarning( "no map files (%s or %s) found! Please install %s.",
-                    kflName.toLatin1().data(), kfcName.toLatin1().data(),
-                    kflName.toLatin1().data() );
-        }
-
-      return false; // file could not be located in any of the possible map directories.
-    }
-
-  if ( kflExists )
-    {
-      if ( kfcExists )
-        {
-          // kfl file newer than kfc ? Then compile it
-          if (getDateFromMapFile( kflPathName ) > getDateFromMapFile( kfcPathName ))
-            {
-              compiling = true;
-              qDebug("Map file %s has a newer date! Recompiling it from source.",
-                     kflPathName.toLatin1().data() );
-            }
-        }
-      else
-        {
-          // no kfc file, we compile anyway
-          compiling = true;
-        }
-    }
-
-  // what file do we read after all ?
-  if ( compiling )
-    {
-      pathName = kflPathName;
-      kfcPathName = kflPathName;
-      kfcPathName.replace( kfcPathName.length()-1, 1, QString("c") );
-    }
-  else
-    {
-      pathName = kfcPathName;
-      kflPathName = kfcPathName;
-      kflPathName.replace( kflPathName.length()-1, 1, QString("l") );
-    }
-
-  QFile mapfile(pathName);
-
-  if( mapfile.size() == 0 )
-    {
-      // qWarning() << "Map file" << pathName << "is empty!";
-
-      if( ! compiling )
-	{
-	  // Remove corrupted compiled file
-	  mapfile.remove();
-	}
-
-      return false;
-    }
-
-  if ( !mapfile.open(QIODevice::ReadOnly) )
-    {
-      qWarning("Can't open map file %s for reading", pathName.toLatin1().data() );
-
-      if ( ! compiling && kflExists )
-        {
-          qDebug("Try to use file %s", kflPathName.toLatin1().data());
-          // try to remove unopenable file, not sure if this works.
-          mapfile.remove();
-          return readTerrainFile( fileSecID, fileTypeID );
-        }
-
-      return false;
-    }
-
-  emit loadingFile(pathName);
-
-  QDataStream in(&mapfile);
-
-  if( compiling )
-    {
-      in.setVersion(QDataStream::Qt_3_3);
-    }
-  else
-    {
-      in.setVersion(QDataStream::Qt_4_7);
-    }
-
-  // qDebug("reading file %s", pathName.toLatin1().data());
-
-  qint8 loadTypeID;
-  quint16 loadSecID, formatID;
-  quint32 magic;
-  QDateTime createDateTime;
-  ProjectionBase *projectionFromFile = 0;
-
-  in >> magic;
-  in >> loadTypeID;
-  in >> formatID;
-  in >> loadSecID;
-  in >> createDateTime;
-
-  if( in.status() != QDataStream::Ok )
-    {
-      qWarning() << "Data stream status of" << pathName
-	         << "is NOK! Status=" << in.status();
-      mapfile.close();
-
-      if( ! compiling )
-	{
-	  // Remove corrupted compiled file
-	  unlink( pathName.toLatin1().data() );
-	}
-
-      return false;
-    }
-
-  if ( magic != KFLOG_FILE_MAGIC )
-    {
-      mapfile.close();
-
-      if ( ! compiling && kflExists )
-        {
-          qWarning("Wrong magic key %x read!\n Retry to compile %s.",
-                   magic, kflPathName.toLatin1().data());
-          mapfile.remove();
-          return readTerrainFile( fileSecID, fileTypeID );
-        }
-
-      qWarning( "Wrong magic key %x read from %s! Removing content.",
-                 magic, pathName.toLatin1().data() );
-      // Some map file does not exists on the server. But if they have
-      // been downloaded, the map server has sent some http page content.
-      // That content makes no sense, therefore the map file content is cleared.
-      mapfile.open( QIODevice::WriteOnly|QIODevice::Truncate );
-      mapfile.close();
-      return false;
-    }
-
-  if (loadTypeID != fileTypeID) // wrong type
-    {
-      mapfile.close();
-
-      if ( ! compiling && kflExists )
-        {
-          qWarning("Wrong load type identifier %x read! "
-                   "Retry to compile %s",
-                   loadTypeID, kflPathName.toLatin1().data() );
-          mapfile.remove();
-          return readTerrainFile( fileSecID, fileTypeID );
-        }
-
-      qWarning("%s wrong load type identifier %x read! ",
-                pathName.toLatin1().data(), loadTypeID );
-
-      return false;
-    }
-
-  // Determine, which file format id is expected
-  int expFormatID, expComFormatID;
-
-  if ( fileTypeID == FILE_TYPE_TERRAIN )
-    {
-      expFormatID = FILE_VERSION_TERRAIN;
-      expComFormatID = FILE_VERSION_TERRAIN_C;
-    }
-  else
-    {
-      expFormatID = FILE_VERSION_GROUND;
-      expComFormatID = FILE_VERSION_GROUND_C;
-    }
-
-  QFileInfo fi( pathName );
-
-  qDebug("Reading File=%s, Magic=0x%x, TypeId=%c, formatId=%d, Date=%s",
-         fi.fileName().toLatin1().data(), magic, loadTypeID, formatID,
-         createDateTime.toString(Qt::ISODate).toLatin1().data() );
-
-  if ( compiling )
-    {
-      // Check map file
-      if ( formatID < expFormatID )
-        {
-          // too old ...
-          qWarning("File format too old! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, expFormatID );
-          return false;
-        }
-      else if (formatID > expFormatID )
-        {
-          // too new ...
-          qWarning("File format too new! (version %d, expecting: %d) "
-                   "Aborting ...", formatID,expFormatID );
-          return false;
-        }
-    }
-  else
-    {
-      // Check compiled file
-      if ( formatID < expComFormatID )
-        {
-          // too old ...
-          if ( kflExists )
-            {
-              qWarning("File format too old! (version %d, expecting: %d) "
-                       "Retry to compile %s",
-                       formatID, expComFormatID, kflPathName.toLatin1().data() );
-              mapfile.close();
-              unlink( pathName.toLatin1().data() );
-              return readTerrainFile( fileSecID, fileTypeID );
-            }
-
-          qWarning("File format too old! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, expFormatID );
-          return false;
-        }
-      else if (formatID > expComFormatID )
-        {
-          // too new ...
-          if ( kflExists )
-            {
-              qWarning( "File format too new! (version %d, expecting: %d) "
-                        "Retry to compile %s",
-                        formatID, expComFormatID, kflPathName.toLatin1().data() );
-              mapfile.close();
-              unlink( pathName.toLatin1().data() );
-              return readTerrainFile( fileSecID, fileTypeID );
-            }
-
-          qWarning("File format too new! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, expFormatID );
-          return false;
-        }
-    }
-
-  if ( loadSecID != fileSecID )
-    {
-      if ( ! compiling && kflExists )
-        {
-          qWarning( "%s: wrong section, bogus file name!"
-                    "\n Retry to compile %s",
-                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
-          mapfile.close();
-          unlink( pathName.toLatin1().data() );
-          return readTerrainFile( fileSecID, fileTypeID );
-        }
-
-      qWarning("%s: wrong section, bogus file name! Arborting ...",
-               pathName.toLatin1().data() );
-      return false;
-    }
-
-  if ( ! compiling )
-    {
-      // check projection parameters from file against current used values
-      projectionFromFile = LoadProjection(in);
-      ProjectionBase *currentProjection = _globalMapMatrix->getProjection();
-
-      if ( ! compareProjections( projectionFromFile, currentProjection ) )
-        {
-          delete projectionFromFile;
-          mapfile.close();
-
-          if ( kflExists )
-            {
-              qWarning( "%s, can't use file, compiled for another projection!"
-                        "\n Retry to compile %s",
-                        pathName.toLatin1().data(), kflPathName.toLatin1().data() );
-
-              unlink( pathName.toLatin1().data() );
-              return readTerrainFile( fileSecID, fileTypeID );
-            }
-
-          qWarning( "%s, can't use file, compiled for another projection!"
-                    " Please install %s file and restart.",
-                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
-          return false;
-        }
-      else
-        {
-          // Must be deleted after use to avoid memory leak
-          delete projectionFromFile;
-        }
-    }
-
-  // Got to initialize "out" stream properly, even if write file is not needed
-  QFile ausgabe(kfcPathName);
-  QDataStream out(&ausgabe);
-
-  if( compiling )
-    {
-      out.setDevice(&ausgabe);
-      out.setVersion(QDataStream::Qt_4_7);
-
-      if (!ausgabe.open(QIODevice::WriteOnly))
-        {
-          mapfile.close();
-          qWarning("Can't open compiled map file %s for writing!"
-                   " Arborting...",
-                   kfcPathName.toLatin1().data() );
-          return false;
-        }
-
-      qDebug("Writing file %s", kfcPathName.toLatin1().data());
-
-      out << magic;
-      out << loadTypeID;
-      out << quint16(expComFormatID);
-      out << loadSecID;
-
-      //set time one second later than the time of the original file;
-      out << createDateTime.addSecs(1);
-
-      // save current projection data
-      SaveProjection(out, _globalMapMatrix->getProjection() );
-    }
-
-  int loop = 0;
-
-  while ( !in.atEnd() )
-    {
-      qint16 elevation;
-      qint32 pointNumber, lat, lon;
-      QPolygon isoline;
-
-      in >> elevation;
-
-      if ( compiling )
-        {
-          in >> pointNumber;
-          isoline.resize( pointNumber );
-
-          for (int i = 0; i < pointNumber; i++)
-            {
-              in >> lat;
-              in >> lon;
-
-              // This is what causes the long delays, lots of floating point calculations
-              isoline.setPoint( i, _globalMapMatrix->wgsToMap(lat, lon));
-            }
-
-          // Check, if first point and last point of the isoline identical. In this
-          // case we can remove the last point and repeat the check.
-          for( int i = isoline.size() - 1; i >= 0; i-- )
-            {
-              if( isoline.point(0) == isoline.point(i) )
-                 {
-                   //qWarning( "Isoline Tile=%d has same start and end point. Remove end point.",
-                   //           loadSecID );
-
-                   // remove last point and check again
-                   isoline.remove(i);
-                   continue;
-                 }
-
-              break;
-            }
-
-          if( isoline.size() < 3)
-            {
-              // ignore to small isolines
-              qWarning( "Isoline Tile=%d, elevation=%dm has to less points!",
-                         loadSecID, elevation );
-              continue;
-            }
-
-          out << elevation;
-          // And that is the whole trick: saving the computed result. Takes the same space!
-          ShortSave( out, isoline );
-        }
-      else
-        {
-          // Reading the computed result from kfc file
-          ShortLoad( in, isoline );
-        }
-
-      // determine elevation index, 0 is returned as default for not existing values
-      uchar elevationIdx = isoHash.value( elevation, 0 );
-
-      Isohypse newItem(isoline, elevation, elevationIdx, fileSecID, fileTypeID);
-
-      // Check in which map the isohypse has to be stored. We do use two
-      // different maps, one for Ground and another for Terrain. The default
-      // is set to terrain because there are a lot more.
-      QMap<int, QList<Isohypse> > *usedMap = &terrainMap;
-
-      if( fileTypeID == FILE_TYPE_GROUND )
-        {
-          usedMap = &groundMap;
-        }
-
-      // Store new isohypse in the isomap. The tile section identifier is the key.
-      if( usedMap->contains( fileSecID ))
-        {
-          // append isohypse to existing vector
-          QList<Isohypse>& isoList = (*usedMap)[fileSecID];
-          isoList.append( newItem );
-        }
-      else
-        {
-          // create a new entry in the isomap
-          QList<Isohypse> isoList;
-          isoList.append( newItem );
-          usedMap->insert( fileSecID, isoList );
-        }
-
-      // qDebug("Isohypse added: Size=%d, Elevation=%d, FileTypeID=%c",
-      //       isoline.size(), elevation, fileTypeID );
-
-      // AP: Performance brake! emit progress calls wait screen and
-      // this steps into main loop
-      if ( compiling && (++loop % 100) == 0 )
-        {
-          emit progress(2);
-        }
-    }
-
-  // qDebug("loop=%d", loop);
-  mapfile.close();
-
-  if ( compiling )
-    {
-      ausgabe.close();
-    }
-
-  return true;
-}
-
-bool MapContents::readBinaryFile(const int fileSecID, const char fileTypeID)
-{
-  bool kflExists, kfcExists;
-  bool compiling = false;
-
-  //first, check if we need to load this file at all...
-  if ( fileTypeID == FILE_TYPE_TERRAIN &&
-       ( !GeneralConfig::instance()->getMapLoadIsoLines() ))
-    {
-      return true;
-    }
-
-  if (memoryFull)   //if we already know the memory if full and can't be emptied at this point, just return.
-    {
-      _globalMapView->message(tr("Out of memory! Map not loaded."));
-      return false;
-    }
-
-  //check free memory
-  int memFree = HwInfo::instance()->getFreeMemory();
-
-  if ( memFree < MINIMUM_FREE_MEMORY )
-    {
-      if ( !unloadDone)
-        {
-          unloadMaps();  //try freeing some memory
-          memFree = HwInfo::instance()->getFreeMemory();  //re-asses free memory
-          if ( memFree < MINIMUM_FREE_MEMORY )
-            {
-              memoryFull=true; //set flag to indicate that we need not try loading any more mapfiles now.
-              qWarning("Cumulus couldn't load file, low on memory! Memory needed: %d kB, free: %d kB", MINIMUM_FREE_MEMORY, memFree );
-              _globalMapView->message(tr("Out of memory! Map not loaded."));
-              return false;
-            }
-        }
-      else
-        {
-          memoryFull=true; //set flag to indicate that we need not try loading any more mapfiles now.
-          qWarning("Cumulus couldn't load file, low on memory! Memory needed: %d kB, free: %d kB", MINIMUM_FREE_MEMORY, memFree );
-          _globalMapView->message(tr("Out of memory! Map not loaded."));
-          return false;
-        }
-    }
-
-  QString kflPathName, kfcPathName, pathName;
-  QString kflName, kfcName;
-
-  kflName.sprintf("%c_%.5d.kfl", fileTypeID, fileSecID);
-  kflExists = locateFile("landscape/" + kflName, kflPathName);
-
-  kfcName.sprintf("landscape/%c_%.5d.kfc", fileTypeID, fileSecID);
-  kfcExists = locateFile(kfcName, kfcPathName);
-
-  if ( ! (kflExists || kfcExists) )
-    {
-      QString path = GeneralConfig::instance()->getMapRootDir() + "/landscape";
-
-      bool res = false;
-
-#ifdef INTERNET
-
-      res = askUserForDownload();
-
-      if( res == true )
-        {
-          res = downloadMapFile( kflName, path );
-        }
-
-#endif
-
-      if( res == false  )
-        {
-          qWarning( "no map files (%s or %s) found! Please install %s.",
-                    kflName.toLatin1().data(), kfcName.toLatin1().data(),
-                    kflName.toLatin1().data() );
-        }
-
-      return false; // file could not be located in any of the possible map directories.
-    }
-
-  if ( kflExists )
-    {
-      if ( kfcExists )
-        // kfl file newer than kfc ? Then compile it
-        {
-          if ( getDateFromMapFile( kflPathName ) > getDateFromMapFile( kfcPathName ) )
-            {
-              compiling = true;
-              qDebug("Map file %s has a newer date! Recompiling it from source.",
-                     kflPathName.toLatin1().data() );
-            }
-        }
-      else
-        {
-          // no kfc file, we compile anyway
-          compiling = true;
-        }
-    }
-
-  // what file do we read after all ?
-  if ( compiling )
-    {
-      pathName = kflPathName;
-      kfcPathName = kflPathName;
-      kfcPathName.replace( kfcPathName.length()-1, 1, QString("c") );
-    }
-  else
-    {
-      pathName = kfcPathName;
-      kflPathName = kfcPathName;
-      kflPathName.replace( kflPathName.length()-1, 1, QString("l") );
-    }
-
-  QFile mapfile(pathName);
-
-  if( mapfile.size() == 0 )
-    {
-      // qWarning() << "Map file" << pathName << "is empty!";
-
-      if( ! compiling )
-	{
-	  // Remove corrupted compiled file
-	  mapfile.remove();
-	}
-
-      return false;
-    }
-
-  if (!mapfile.open(QIODevice::ReadOnly))
-    {
-      if ( ! compiling && kflExists )
-        {
-          qDebug("Can't open map file %s for reading!"
-                 " Try to use file %s",
-                 pathName.toLatin1().data(), kflPathName.toLatin1().data());
-          // try to remove unopenable file, not sure if this works.
-          mapfile.remove();
-          return readBinaryFile( fileSecID, fileTypeID );
-        }
-
-      qWarning("Can't open map file %s for reading! Aborting ...",
-               pathName.toLatin1().data() );
-      return false;
-    }
-
-  emit loadingFile(pathName);
-
-  QDataStream in(&mapfile);
-
-  if( compiling )
-    {
-      in.setVersion( QDataStream::Qt_2_0 );
-    }
-  else
-    {
-      in.setVersion( QDataStream::Qt_4_7 );
-    }
-
-  // qDebug("reading file %s", pathName.toLatin1().data());
-
-  qint8 loadTypeID;
-  quint16 loadSecID, formatID;
-  quint32 magic;
-  QDateTime createDateTime;
-  ProjectionBase *projectionFromFile = 0;
-
-  in >> magic;
-
-  if ( magic != KFLOG_FILE_MAGIC )
-    {
-      mapfile.close();
-
-      if ( ! compiling && kflExists )
-        {
-          qWarning("Wrong magic key %x read!\n Retry to compile %s.",
-                   magic, kflPathName.toLatin1().data());
-
-          mapfile.remove();
-          return readBinaryFile( fileSecID, fileTypeID );
-        }
-
-      qWarning( "Wrong magic key %x read from %s! Removing content.",
-                 magic, pathName.toLatin1().data() );
-      // Some map file does not exists on the server. But if they have
-      // been downloaded, the map server has sent some http page content.
-      // That content makes no sense, therefore the map file content is cleared.
-      mapfile.open( QIODevice::WriteOnly|QIODevice::Truncate );
-      mapfile.close();
-      return false;
-    }
-
-  in >> loadTypeID;
-
-  /** Originally, the binary files were mend to come in different flavors.
-   * Now, they are all of type 'm'. Use that fact to do check for the
-   * compiled or the uncompiled version. */
-  if (compiling)
-    {
-      // uncompiled maps have a different format identifier than compiled
-      // maps
-      if (loadTypeID != FILE_TYPE_MAP)
-        {
-          qWarning("Wrong load type identifier %x read! Aborting ...",
-                   loadTypeID );
-          mapfile.close();
-          return false;
-        }
-    }
-  else
-    {
-      if ( loadTypeID != FILE_TYPE_MAP_C) // wrong type
-        {
-          mapfile.close();
-
-          if ( kflExists )
-            {
-              qWarning("Wrong load type identifier %x read! "
-                       "Retry to compile %s",
-                       loadTypeID, kflPathName.toLatin1().data() );
-              mapfile.remove();
-              return readBinaryFile( fileSecID, fileTypeID );
-            }
-
-          qWarning("%s wrong load type identifier %x read!",
-                   pathName.toLatin1().data(), loadTypeID );
-          return false;
-        }
+    {
+      isoHash.insert( isoLevels[i], i );
     }
 
-  // Check the version of the subtype. This can be different for the
-  // compiled and the uncompiled version.
-  in >> formatID;
-  in >> loadSecID;
-  in >> createDateTime;
+  m_tileLoader = new MapTileLoaderThread( this, isoHash );
 
-  if( in.status() != QDataStream::Ok )
-    {
-      qWarning() << "Data stream status of" << pathName
-	         << "is NOK! Status=" << in.status();
-      mapfile.close();
+  // Register a special data type for return results. That must be
+  // done to transfer the results between different threads.
+  qRegisterMetaType<MapTile *>("MapTile*");
 
-      if( ! compiling )
-	{
-	  // Remove corrupted compiled file
-	  unlink( pathName.toLatin1().data() );
-	}
+  // Connect the receiver of the results. It is located in this
+  // thread and not in the loader thread.
+  connect( m_tileLoader, SIGNAL(tileLoaded( MapTile* )),
+           this, SLOT(slotTileLoaded( MapTile* )) );
 
-      return false;
-    }
+  connect( m_tileLoader, SIGNAL(loadingFile( const QString& )),
+           this, SIGNAL(loadingFile( const QString& )) );
 
-  QFileInfo fi( pathName );
+  m_tileLoader->start( QThread::LowPriority );
 
-  qDebug("Reading File=%s, Magic=0x%x, TypeId=%c, FormatId=%d, Date=%s",
-         fi.fileName().toLatin1().data(), magic, loadTypeID, formatID,
-         createDateTime.toString(Qt::ISODate).toLatin1().data() );
+  // read in waypoint list from catalog
+  WaypointCatalog wpCat;
+  int ok;
+  const char* format;
+  QString error;
 
-  if (compiling)
+  if( GeneralConfig::instance()->getWaypointFileFormat() == GeneralConfig::Binary )
     {
-      if ( formatID < FILE_VERSION_MAP)
-        {
-          // to old ...
-          qWarning("File format too old! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, FILE_VERSION_MAP );
-          mapfile.close();
-          return false;
-        }
-      else if (formatID > FILE_VERSION_MAP)
-        {
-          // to new ...
-          qWarning("File format too new! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, FILE_VERSION_MAP );
-          mapfile.close();
-          return false;
-        }
+      ok = wpCat.readBinary( "", &wpList );
+      format = "binary";
     }
   else
     {
-      if ( formatID < FILE_VERSION_MAP_C)
-        {
-          // to old ...
-          mapfile.close();
-
-          if ( kflExists )
-            {
-              qWarning("File format too old! (version %d, expecting: %d) "
-                       "Retry to compile %s",
-                       formatID, FILE_VERSION_MAP_C, kflPathName.toLatin1().data() );
-              unlink( pathName.toLatin1().data() );
-              return readBinaryFile( fileSecID, fileTypeID );
-            }
-
-          qWarning("File format too old! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, FILE_VERSION_MAP_C );
-          return false;
-        }
-      else if (formatID > FILE_VERSION_MAP_C)
-        {
-          // to new ...
-          mapfile.close();
-
-          if ( kflExists )
-            {
-              qWarning( "File format too new! (version %d, expecting: %d) "
-                        "Retry to compile %s",
-                        formatID, FILE_VERSION_MAP_C, kflPathName.toLatin1().data() );
-              unlink( pathName.toLatin1().data() );
-              return readBinaryFile( fileSecID, fileTypeID );
-            }
-
-          qWarning("File format too new! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, FILE_VERSION_MAP_C );
-
-          return false;
-        }
+      ok = wpCat.readXml( "", &wpList, error );
+      format = "xml";
     }
 
-  // check if this section really covers the area we want to deal with
-  if ( loadSecID != fileSecID )
+  if( ok )
     {
-      mapfile.close();
-
-      if ( ! compiling && kflExists )
-        {
-          qWarning( "%s: wrong section, bogus file name!"
-                    "\n Retry to compile %s",
-                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
-          unlink( pathName.toLatin1().data() );
-          return readBinaryFile( fileSecID, fileTypeID );
-        }
-
-      qWarning("%s: wrong section, bogus file name! Aborting ...",
-               pathName.toLatin1().data() );
-      return false;
+      qDebug() << "MapContents():" << wpList.size() << "waypoints read from"
+               << format << "catalog.";
     }
 
-  if ( ! compiling )
-    {
-      // check projection parameters from file against current used values
-      projectionFromFile = LoadProjection(in);
-      ProjectionBase *currentProjection = _globalMapMatrix->getProjection();
-
-      if ( ! compareProjections( projectionFromFile, currentProjection ) )
-        {
-          delete projectionFromFile;
-          mapfile.close();
+  currentTask = 0;
 
-          if ( kflExists )
-            {
-              qWarning( "%s, can't use file, compiled for another projection!"
-                        "\n Retry to compile %s",
-                        pathName.toLatin1().data(), kflPathName.toLatin1().data() );
+  connect( this, SIGNAL(progress(int)), ws, SLOT(slot_Progress(int)) );
 
-              unlink( pathName.toLatin1().data() );
-              return readBinaryFile( fileSecID, fileTypeID );
-            }
+  connect( this, SIGNAL(loadingFile(const QString&)),
+           ws, SLOT(slot_SetText2(const QString&)) );
 
-          qWarning( "%s, can't use file, compiled for another projection!"
-                    " Please install %s file and restart.",
-                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
-          return false;
-        }
-      else
-        {
-          // Must be deleted after use to avoid memory leak
-          delete projectionFromFile;
-        }
-    }
+  // qDebug("MapContents initialized");
+}
 
-  QFile ausgabe(kfcPathName);
-  QDataStream out(&ausgabe);
+MapContents::~MapContents()
+{
+  m_tileLoader->stop();
 
-  if ( compiling )
+  if ( currentTask )
     {
-      out.setDevice( &ausgabe );
-      out.setVersion( QDataStream::Qt_4_7 );
-
-      if (!ausgabe.open(QIODevice::WriteOnly))
-        {
-          qWarning("Can't open compiled map file %s for writing!"
-                   " Aborting ...",
-                   kfcPathName.toLatin1().data() );
-          mapfile.close();
-          return false;
-        }
-
-      qDebug("Writing file %s", kfcPathName.toLatin1().data());
-
-      out << magic;
-      loadTypeID = FILE_TYPE_MAP_C;
-      formatID   = FILE_VERSION_MAP_C;
-      out << loadTypeID;
-      out << formatID;
-      out << loadSecID;
-      out << createDateTime.addSecs(1);   //set time one second later than the time of the original file;
-      SaveProjection(out, _globalMapMatrix->getProjection());
+      delete currentTask;
     }
 
-  quint8 lm_typ;
-  qint8 sort, elev;
-  qint32 lat_temp, lon_temp;
-  quint32 locLength = 0;
-  QString name = "";
+  qDeleteAll( airspaceList );
+  qDeleteAll( flarmAlertZoneList );
+}
 
-  unsigned int gesamt_elemente = 0;
-  uint loop = 0;
+// save the current waypoint list
+void MapContents::saveWaypointList()
+{
+  WaypointCatalog wpCat;
 
-  while ( ! in.atEnd() )
+  if( GeneralConfig::instance()->getWaypointFileFormat() == GeneralConfig::Binary )
     {
-      BaseMapElement::objectType typeIn = BaseMapElement::NotSelected;
-      in >> (quint8&)typeIn;
-
-      if ( compiling )
-        out << (quint8&)typeIn;
-
-      locLength = 0;
-      name = "";
-
-      QPolygon all;
-      QPoint single;
-
-      gesamt_elemente++;
-
-      switch (typeIn)
-        {
-        case BaseMapElement::Motorway:
-          READ_POINT_LIST
-
-          if ( !GeneralConfig::instance()->getMapLoadMotorways() ) break;
-
-          motorwayList.append( LineElement("", typeIn, all, false, fileSecID) );
-          break;
-
-        case BaseMapElement::Road:
-        case BaseMapElement::Trail:
-          READ_POINT_LIST
-
-          if ( !GeneralConfig::instance()->getMapLoadRoads() ) break;
-
-          roadList.append( LineElement("", typeIn, all, false, fileSecID) );
-          break;
-
-        case BaseMapElement::Aerial_Cable:
-        case BaseMapElement::Railway:
-        case BaseMapElement::Railway_D:
-          READ_POINT_LIST
-
-          if ( !GeneralConfig::instance()->getMapLoadRailways() ) break;
-
-          railList.append( LineElement("", typeIn, all, false, fileSecID) );
-          break;
-
-        case BaseMapElement::Canal:
-        case BaseMapElement::River:
-        case BaseMapElement::River_T:
-
-          typeIn = BaseMapElement::River; //don't use different river types internally
-
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              if ( compiling )
-                {
-                  in >> name;
-                  ShortSave(out, name);
-                }
-              else
-                {
-                  ShortLoad(in, name);
-                }
-            }
-
-          READ_POINT_LIST
-
-          if ( !GeneralConfig::instance()->getMapLoadWaterways() ) break;
-
-          hydroList.append( LineElement(name, typeIn, all, false, fileSecID) );
-          break;
-
-        case BaseMapElement::City:
-          in >> sort;
-          if ( compiling )
-            out << sort;
-
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              if ( compiling )
-                {
-                  in >> name;
-                  ShortSave(out, name);
-                }
-              else
-                {
-                  ShortLoad(in, name);
-                }
-            }
-
-          READ_POINT_LIST
-
-          if ( !GeneralConfig::instance()->getMapLoadCities() ) break;
-
-          cityList.append( LineElement(name, typeIn, all, sort, fileSecID) );
-          // qDebug("added city '%s'", name.toLatin1().data());
-          break;
-
-        case BaseMapElement::Lake:
-        case BaseMapElement::Lake_T:
-
-          typeIn=BaseMapElement::Lake; // don't use different lake type internally
-          in >> sort;
-
-          if ( compiling )
-            out << sort;
-
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              if ( compiling )
-                {
-                  in >> name;
-                  ShortSave(out, name);
-                }
-              else
-                {
-                  ShortLoad(in, name);
-                }
-            }
-
-          READ_POINT_LIST
-
-          lakeList.append(LineElement(name, typeIn, all, sort, fileSecID));
-          // qDebug("appended lake, name='%s', pointCount=%d", name.toLatin1().data(), all.count());
-          break;
-
-        case BaseMapElement::Forest:
-        case BaseMapElement::Glacier:
-        case BaseMapElement::PackIce:
-          in >> sort;
-          if ( compiling )
-            out << sort;
-
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              if ( compiling )
-                {
-                  in >> name;
-                  ShortSave(out, name);
-                }
-              else
-                {
-                  ShortLoad(in, name);
-                }
-            }
-
-          READ_POINT_LIST
-
-          if ( !GeneralConfig::instance()->getMapLoadForests() ||
-               typeIn == BaseMapElement::Glacier ||
-               typeIn == BaseMapElement::PackIce )
-            {
-              // Cumulus ignores Glacier and PackIce items
-              break;
-            }
-
-          topoList.append( LineElement(name, typeIn, all, sort, fileSecID) );
-          break;
-
-        case BaseMapElement::Village:
-
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              if ( compiling )
-                {
-                  in >> name;
-                  ShortSave(out, name);
-                }
-              else
-                {
-                  ShortLoad(in, name);
-                }
-            }
-          in >> lat_temp;
-          in >> lon_temp;
-
-          if ( !GeneralConfig::instance()->getMapLoadCities() ) break;
-
-          if ( compiling )
-            {
-              single = _globalMapMatrix->wgsToMap(lat_temp, lon_temp);
-              out << single;
-            }
-          else
-            {
-              in >> single;
-            }
-
-          villageList.append( SinglePoint( name,
-                                           "",
-                                           typeIn,
-                                           WGSPoint(lat_temp, lon_temp),
-                                           single,
-                                           0,
-                                           "",
-                                           "",
-                                           fileSecID ) );
-          // qDebug("added village '%s'", name.toLatin1().data());
-          break;
-
-        case BaseMapElement::Spot:
-
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              in >> elev;
-              if ( compiling )
-                out << elev;
-            }
-
-          in >> lat_temp;
-          in >> lon_temp;
+      wpCat.writeBinary( "", wpList );
+    }
+  else
+    {
+      wpCat.writeXml( "", wpList );
+    }
+}
 
-          if ( !GeneralConfig::instance()->getMapLoadCities() ) break;
+void MapContents::updateProjection()
+{
+  const int projectionId = _globalMapMatrix->getProjectionId();
 
-          if ( compiling )
-            {
-              single = _globalMapMatrix->wgsToMap(lat_temp, lon_temp);
-              out << single;
-            }
-          else
-            {
-              in >> single;
-            }
+  if( projectionId == m_projectionId )
+    {
+      // New elements are projected, when their tile is loaded.
+      return;
+    }
 
-          obstacleList.append( SinglePoint( "Spot",
-                                            "",
-                                            typeIn,
-                                            WGSPoint(lat_temp, lon_temp),
-                                            single,
-                                            0,
-                                            "",
-                                            "",
-                                            fileSecID ) );
-          break;
+  if( m_projectionId != -1 )
+    {
+      // The loaded elements have no WGS84 positions anymore. They are
+      // loaded again from the compiled map files.
+      clearMapElements();
+      m_projectionId = projectionId;
+      requestTiles();
+      return;
+    }
 
-        case BaseMapElement::Landmark:
+  m_projectionId = projectionId;
+}
 
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              in >> lm_typ;
-              if ( compiling )
-                {
-                  in >> name;
-                  out << lm_typ;
-                  ShortSave(out, name);
-                }
-              else
-                {
-                  ShortLoad(in, name);
-                }
-            }
+void MapContents::clearMapElements()
+{
+  cityList.clear();
+  hydroList.clear();
+  lakeList.clear();
+  landmarkList.clear();
+  obstacleList.clear();
+  railList.clear();
+  reportList.clear();
+  motorwayList.clear();
+  roadList.clear();
+  topoList.clear();
+  villageList.clear();
 
-          in >> lat_temp;
-          in >> lon_temp;
+  // all isolines are cleared
+  groundMap.clear();
+  terrainMap.clear();
+  m_elevationRasters.clear();
 
-          if ( !GeneralConfig::instance()->getMapLoadCities() ) break;
+  // tile maps are cleared
+  tileSectionSet.clear();
+  tilePartMap.clear();
+  m_prefetchTiles.clear();
 
-          if ( compiling )
-            {
-              single = _globalMapMatrix->wgsToMap(lat_temp, lon_temp);
-              out << single;
-            }
-          else
-            {
-              in >> single;
-            }
+  m_spatialIndexes.remove( CityList );
+  m_spatialIndexes.remove( VillageList );
+  m_spatialIndexes.remove( ObstacleList );
+  m_spatialIndexes.remove( LandmarkList );
 
-          landmarkList.append( SinglePoint( name,
-                               "",
-                               typeIn,
-                               WGSPoint(lat_temp, lon_temp),
-                               single,
-                               0,
-                               "",
-                               "",
-                               fileSecID ) );
-
-          // qDebug("added landmark '%s'", name.toLatin1().data());
-          break;
-        default:
-          qWarning ("MapContents::__readBinaryFile; type not handled in switch: %d", typeIn);
-          break;
-        }
+  // Tiles, which are loaded with the former settings, are dropped.
+  m_tileLoadGeneration++;
+}
 
-      // @AP: Performance brake! emit progress calls waitscreen and
-      // this steps into main loop
-      if ( compiling && (++loop % 100) == 0 )
-        {
-          emit progress(2);
-        }
-    }
+QString MapContents::getMapLoadSettings() const
+{
+  GeneralConfig *conf = GeneralConfig::instance();
 
-  // qDebug("loop=%d", loop);
-  mapfile.close();
+  QString settings = conf->getMapRootDir() + ";";
 
-  if ( compiling )
-    {
-      ausgabe.close();
-    }
+  settings += conf->getMapLoadIsoLines()  ? "1" : "0";
+  settings += conf->getMapLoadRoads()     ? "1" : "0";
+  settings += conf->getMapLoadMotorways() ? "1" : "0";
+  settings += conf->getMapLoadRailways()  ? "1" : "0";
+  settings += conf->getMapLoadCities()    ? "1" : "0";
+  settings += conf->getMapLoadWaterways() ? "1" : "0";
+  settings += conf->getMapLoadForests()   ? "1" : "0";
 
-  return true;
+  return settings;
 }
 
 #ifdef INTERNET
@@ -1848,32 +726,8 @@ void MapContents::proofeSection()
 
   mutex = true;
 
-  extern MapMatrix* _globalMapMatrix;
-
-  // Get map borders in KFLog coordinates. X=Longitude, Y=Latitude.
-  QRect mapBorder = _globalMapMatrix->getViewBorder();
-
-  int westCorner = ( ( mapBorder.left() / 600000 / 2 ) * 2 + 180 ) / 2;
-  int eastCorner = ( ( mapBorder.right() / 600000 / 2 ) * 2 + 180 ) / 2;
-  int northCorner = ( ( mapBorder.top() / 600000 / 2 ) * 2 - 88 ) / -2;
-  int southCorner = ( ( mapBorder.bottom() / 600000 / 2 ) * 2 - 88 ) / -2;
-
-  if (mapBorder.left() < 0)
-    westCorner -= 1;
-  if (mapBorder.right() < 0)
-    eastCorner -= 1;
-  if (mapBorder.top() < 0)
-    northCorner += 1;
-  if (mapBorder.bottom() < 0)
-    southCorner += 1;
-
-  // qDebug( "MapBorderCorners: l=%d, r=%d, t=%d, b=%d",
-  //          westCorner, eastCorner, northCorner, southCorner );
-
   unloadDone = false;
   memoryFull = false;
-  char step, hasstep; // used as small integers
-  TilePartMap::Iterator it;
 
   if( isReload )
     {
@@ -1887,103 +741,43 @@ void MapContents::proofeSection()
     {
       ws->slot_SetText1( tr( "Loading maps..." ) );
     }
-
-  for( int row = northCorner; row <= southCorner; row++ )
+  else if( GeneralConfig::instance()->getMapUnload() )
     {
-      for( int col = westCorner; col <= eastCorner; col++ )
-        {
-          int secID = row + (col + (row * 179));
-          // qDebug( "Needed BoxSecID=%d", secID );
+      // @AP: remove of all unused maps to get place in heap.
+      unloadMaps(0);
+    }
 
-          if( isFirst )
-            {
-              // Animate a little bit during first load. Later on in flight,
-              // we need the time for GPS processing.
-              emit progress( 2 );
-            }
+  // check free memory
+  int memFree = HwInfo::instance()->getFreeMemory();
 
-          if( secID >= 0 && secID <= MAX_TILE_NUMBER )
-            {
-              // a valid tile (2x2 degree area) must be in the range 0 ... 16200
-              if( ! tileSectionSet.contains( secID ) )
-                {
-                  // qDebug(" Tile %d is missing", secID );
-                  // Tile is missing
-                  if( ! isFirst)
-                    {
-                      // @AP: remove of all unused maps to get place
-                      // in heap. That can be disabled here because
-                      // the loading routines will also check the
-                      // available memory and call the unloadMaps()
-                      // method is necessary. But the disadvantage
-                      // is in that case that the freeing needs a
-                      // lot of time (several seconds).
-                      if( GeneralConfig::instance()->getMapUnload() )
-                        {
-                          unloadMaps(0);
-                        }
-                    }
-
-                  // qDebug("Going to load sectionID %d", secID);
-
-                  step = 0;
-                  // check to see if parts of this tile has already been loaded before
-                  it = tilePartMap.find(secID);
-
-                  if (it == tilePartMap.end())
-                    {
-                      //not found
-                      hasstep = 0;
-                    }
-                  else
-                    {
-                      hasstep = it.value();
-                    }
-
-                  //try loading the currently unloaded files
-                  if (!(hasstep & 1))
-                    {
-                      if (readTerrainFile(secID, FILE_TYPE_GROUND))
-                        step |= 1;
-                    }
-
-                  if (!(hasstep & 2))
-                    {
-                      if (readTerrainFile(secID, FILE_TYPE_TERRAIN))
-                        step |= 2;
-                    }
-
-                  if (!(hasstep & 4))
-                    {
-                      if (readBinaryFile(secID, FILE_TYPE_MAP))
-                        step |= 4;
-                    }
-
-                  if (step == 7) //set the correct flags for this map tile
-                    {
-                      tileSectionSet.insert(secID);  // add section id to set
-                      tilePartMap.remove(secID); // make sure we don't leave it as partly loaded
-                    }
-                  else
-                    {
-                      if (step > 0)
-                        {
-                          tilePartMap.insert(secID, step);
-                        }
-                    }
-                }
-            }
+  if ( memFree < MINIMUM_FREE_MEMORY )
+    {
+      unloadMaps();  // try freeing some memory
+      memFree = HwInfo::instance()->getFreeMemory();  //re-asses free memory
+
+      if ( memFree < MINIMUM_FREE_MEMORY )
+        {
+          memoryFull=true; //set flag to indicate that we need not try loading any more mapfiles now.
+          qWarning("Cumulus couldn't load file, low on memory! Memory needed: %d kB, free: %d kB", MINIMUM_FREE_MEMORY, memFree );
+          _globalMapView->message(tr("Out of memory! Map not loaded."));
         }
     }
 
+  // After a projection change the loaded tiles are dropped.
+  updateProjection();
+
+  // The missing tiles are loaded in the background. The map draws the
+  // loaded tiles and is redrawn, when a new tile is available.
+  requestTiles();
+
   if( isFirst )
     {
       ws->slot_SetText2( tr( "Reading Airspace Data" ) );
 
-      AirspaceHelper::loadAirspaces( airspaceList );
+      AirspaceHelper::LoadResult result;
 
-      // finally, sort the airspaces
-      airspaceList.sort();
+      AirspaceHelper::loadAirspaceSets( result, QMap<QString, QDateTime>() );
+      takeOverAirspaceSets( result );
 
       // Look, which airfield source has to be taken.
       // int airfieldSource = GeneralConfig::instance()->getAirfieldSource();
@@ -2009,6 +803,10 @@ void MapContents::proofeSection()
               m_hotspotLoadMutex.lock();
               poiLoader.load( hotspotList );
               m_hotspotLoadMutex.unlock();
+
+              m_spatialIndexes.remove( AirfieldList );
+              m_spatialIndexes.remove( RadioList );
+              m_spatialIndexes.remove( HotspotList );
             }
           else
             {
@@ -2036,6 +834,319 @@ void MapContents::proofeSection()
   mutex    = false; // unlock mutex
 }
 
+/**
+ * Requests the missing tiles of the current map view and the tiles, which
+ * are reached along the current track, from the tile loader thread.
+ */
+void MapContents::requestTiles()
+{
+  QList<MapTileRequest> requests;
+  QSet<int> tiles;
+
+  m_prefetchTiles.clear();
+
+  if( memoryFull )
+    {
+      // Drop all pending requests.
+      m_tileLoader->setRequests( requests );
+      return;
+    }
+
+  // Get map borders in KFLog coordinates. X=Longitude, Y=Latitude.
+  QRect mapBorder = _globalMapMatrix->getViewBorder();
+
+  // The tiles of the map view are loaded first, the nearest to the view
+  // center at first.
+  QPoint viewCenter = _globalMapMatrix->getMapCenter( false );
+
+  // The loader thread must not access the configuration.
+  GeneralConfig *conf = GeneralConfig::instance();
+
+  MapTileSettings settings;
+  settings.mapDirectories = conf->getMapDirectories();
+  settings.loadIsoLines   = conf->getMapLoadIsoLines();
+  settings.loadMotorways  = conf->getMapLoadMotorways();
+  settings.loadRoads      = conf->getMapLoadRoads();
+  settings.loadRailways   = conf->getMapLoadRailways();
+  settings.loadWaterways  = conf->getMapLoadWaterways();
+  settings.loadCities     = conf->getMapLoadCities();
+  settings.loadForests    = conf->getMapLoadForests();
+
+  addTileRequests( mapBorder, viewCenter, 0, settings, tiles, requests );
+
+  extern Calculator* calculator;
+
+  const double speed = calculator ? calculator->getLastSpeed().getKph() : 0.0;
+
+  if( speed > 20.0 )
+    {
+      // Prefetch the tiles, which are reached in the next half hour along
+      // the track. The view border is moved in steps of 25km.
+      const double lookAhead = qBound( 50.0, speed * 0.5, 300.0 );
+      const QPoint& position = calculator->getlastPosition();
+      const double heading = calculator->getlastHeading() * M_PI / 180.0;
+      const double latCos = qMax( 0.01, cos( position.x() * M_PI / 108000000.0 ) );
+
+      for( double distance = 25.0; distance <= lookAhead; distance += 25.0 )
+        {
+          // One minute of latitude is one nautical mile, the coordinates
+          // are given in 1/10000 minutes.
+          const int dLat = (int) rint( distance * cos( heading ) / 1.852 * 10000.0 );
+          const int dLon = (int) rint( distance * sin( heading ) / 1.852 * 10000.0 / latCos );
+
+          QPoint ahead( position.x() + dLat, position.y() + dLon );
+
+          addTileRequests( mapBorder.translated( dLon, dLat ),
+                           ahead,
+                           PREFETCH_PRIORITY,
+                           settings,
+                           tiles,
+                           requests );
+        }
+    }
+
+  m_tileLoader->setRequests( requests );
+}
+
+void MapContents::addTileRequests( const QRect& border,
+                                   const QPoint& center,
+                                   const int basePriority,
+                                   const MapTileSettings& settings,
+                                   QSet<int>& tiles,
+                                   QList<MapTileRequest>& requests )
+{
+  QList<int> tileList;
+
+  getTiles( border, tileList );
+
+  for( int i = 0; i < tileList.size(); i++ )
+    {
+      const int secID = tileList.at(i);
+
+      if( tiles.contains( secID ) )
+        {
+          continue;
+        }
+
+      tiles.insert( secID );
+
+      if( basePriority == PREFETCH_PRIORITY )
+        {
+          m_prefetchTiles.insert( secID );
+        }
+
+      if( tileSectionSet.contains( secID ) )
+        {
+          // Tile is already loaded.
+          continue;
+        }
+
+      // A tile covers 2x2 degrees, row 0 starts at 90 degrees north and
+      // column 0 at 180 degrees west.
+      QPoint tileCenter( (89 - 2 * (secID / 180)) * 600000,
+                         (2 * (secID % 180) - 179) * 600000 );
+
+      const int priority = basePriority +
+                           (int) MapCalc::dist( &tileCenter, const_cast<QPoint *> (&center) ) * 4;
+
+      // check to see if parts of this tile has already been loaded before
+      const char hasstep = tilePartMap.value( secID, 0 );
+
+      if( !(hasstep & 1) )
+        {
+          requests.append( MapTileRequest( secID, FILE_TYPE_GROUND,
+                                           priority, m_tileLoadGeneration,
+                                           settings ) );
+        }
+
+      if( !(hasstep & 2) )
+        {
+          requests.append( MapTileRequest( secID, FILE_TYPE_TERRAIN,
+                                           priority + 1, m_tileLoadGeneration,
+                                           settings ) );
+        }
+
+      if( !(hasstep & 4) )
+        {
+          requests.append( MapTileRequest( secID, FILE_TYPE_MAP,
+                                           priority + 2, m_tileLoadGeneration,
+                                           settings ) );
+        }
+    }
+}
+
+void MapContents::getTiles( const QRect& border, QList<int>& tiles )
+{
+  int westCorner = ( ( border.left() / 600000 / 2 ) * 2 + 180 ) / 2;
+  int eastCorner = ( ( border.right() / 600000 / 2 ) * 2 + 180 ) / 2;
+  int northCorner = ( ( border.top() / 600000 / 2 ) * 2 - 88 ) / -2;
+  int southCorner = ( ( border.bottom() / 600000 / 2 ) * 2 - 88 ) / -2;
+
+  if (border.left() < 0)
+    westCorner -= 1;
+  if (border.right() < 0)
+    eastCorner -= 1;
+  if (border.top() < 0)
+    northCorner += 1;
+  if (border.bottom() < 0)
+    southCorner += 1;
+
+  for( int row = northCorner; row <= southCorner; row++ )
+    {
+      for( int col = westCorner; col <= eastCorner; col++ )
+        {
+          int secID = row + (col + (row * 179));
+
+          // a valid tile (2x2 degree area) must be in the range 0 ... 16200
+          if( secID >= 0 && secID <= MAX_TILE_NUMBER )
+            {
+              tiles.append( secID );
+            }
+        }
+    }
+}
+
+/**
+ * This slot is called by the tile loader thread, if a map file of a tile
+ * has been loaded. The passed tile must be deleted in this method.
+ */
+void MapContents::slotTileLoaded( MapTile* tile )
+{
+  const int secID = tile->secID;
+
+  char step = 0;
+
+  switch( tile->fileTypeID )
+    {
+      case FILE_TYPE_GROUND:
+        step = 1;
+        break;
+      case FILE_TYPE_TERRAIN:
+        step = 2;
+        break;
+      default:
+        step = 4;
+        break;
+    }
+
+  // A projection change drops the loaded tiles and the tiles, which are
+  // still loaded. Only the elements of the new tile are projected here, the
+  // loaded ones are already projected.
+  updateProjection();
+
+  const char hasstep = tilePartMap.value( secID, 0 );
+
+  if( tile->generation != m_tileLoadGeneration ||
+      tileSectionSet.contains( secID ) || (hasstep & step) )
+    {
+      // Map data have been reloaded meanwhile or the tile was loaded twice.
+      delete tile;
+      return;
+    }
+
+  if( tile->result == MapTile::Missing )
+    {
+      QString kflName;
+      kflName.sprintf( "%c_%.5d.kfl", tile->fileTypeID, secID );
+
+      bool res = false;
+
+#ifdef INTERNET
+
+      res = askUserForDownload();
+
+      if( res == true )
+        {
+          QString path = GeneralConfig::instance()->getMapRootDir() + "/landscape";
+          res = downloadMapFile( kflName, path );
+        }
+
+#endif
+
+      if( res == false  )
+        {
+          qWarning( "no map file %s found! Please install it.",
+                    kflName.toLatin1().data() );
+        }
+
+      delete tile;
+      return;
+    }
+
+  if( tile->result != MapTile::Loaded )
+    {
+      delete tile;
+      return;
+    }
+
+  if( step == 4 )
+    {
+      projectElements( tile->motorwayList );
+      projectElements( tile->roadList );
+      projectElements( tile->railList );
+      projectElements( tile->hydroList );
+      projectElements( tile->cityList );
+      projectElements( tile->lakeList );
+      projectElements( tile->topoList );
+
+      motorwayList += tile->motorwayList;
+      roadList     += tile->roadList;
+      railList     += tile->railList;
+      hydroList    += tile->hydroList;
+      cityList     += tile->cityList;
+      lakeList     += tile->lakeList;
+      topoList     += tile->topoList;
+
+      // The single points are projected at once.
+      updateProjectedCoordinates( tile->villageList );
+      updateProjectedCoordinates( tile->obstacleList );
+      updateProjectedCoordinates( tile->landmarkList );
+
+      villageList  += tile->villageList;
+      obstacleList += tile->obstacleList;
+      landmarkList += tile->landmarkList;
+
+      m_spatialIndexes.remove( CityList );
+      m_spatialIndexes.remove( VillageList );
+      m_spatialIndexes.remove( ObstacleList );
+      m_spatialIndexes.remove( LandmarkList );
+    }
+  else
+    {
+      projectElements( tile->isoList );
+
+      // We do use two different maps, one for Ground and another for
+      // Terrain. The tile section identifier is the key.
+      if( step == 1 )
+        {
+          groundMap.insert( secID, tile->isoList );
+        }
+      else
+        {
+          terrainMap.insert( secID, tile->isoList );
+        }
+
+      // Ground and terrain rasters of a tile are merged into one.
+      m_elevationRasters[secID].merge( tile->raster );
+    }
+
+  delete tile;
+
+  if( (hasstep | step) == 7 ) //set the correct flags for this map tile
+    {
+      tileSectionSet.insert(secID);  // add section id to set
+      tilePartMap.remove(secID); // make sure we don't leave it as partly loaded
+    }
+  else
+    {
+      tilePartMap.insert(secID, hasstep | step);
+    }
+
+  // New map data are available for drawing.
+  markSectionChanged( secID );
+  emit mapDataReloaded( Map::baseLayer );
+}
+
 // Distance unit is expected as meters. The bounding map rectangle will be
 // enlarged by distance.
 void MapContents::unloadMaps(unsigned int distance)
@@ -2091,6 +1202,9 @@ void MapContents::unloadMaps(unsigned int distance)
         }
     }
 
+  // The tiles prefetched along the track are kept.
+  currentTileSet += m_prefetchTiles;
+
   bool something2free = false;
 
   // Iterate over all loaded tiles (tileSectionSet) and remove all tiles,
@@ -2100,6 +1214,7 @@ void MapContents::unloadMaps(unsigned int distance)
     if ( !currentTileSet.contains( secID ) )
       {
         // remove not more needed element from related objects
+        markSectionChanged( secID );
         tilePartMap.remove( secID );
         tileSectionSet.remove( secID );
         something2free = true;
@@ -2107,6 +1222,17 @@ void MapContents::unloadMaps(unsigned int distance)
       }
   }
 
+  // Partially loaded tiles are handled in the same way.
+  foreach( int secID, tilePartMap.keys() )
+  {
+    if ( !currentTileSet.contains( secID ) )
+      {
+        markSectionChanged( secID );
+        tilePartMap.remove( secID );
+        something2free = true;
+      }
+  }
+
   // @AP: check, if something is to free, otherwise we can return to spare
   // processing time
   if ( ! something2free )
@@ -2200,6 +1326,20 @@ void MapContents::unloadMaps(unsigned int distance)
   qDebug("Unload villageList(%d), elapsed=%d", villageList.count(), t.restart());
 #endif
 
+  m_spatialIndexes.remove( CityList );
+  m_spatialIndexes.remove( VillageList );
+  m_spatialIndexes.remove( ObstacleList );
+  m_spatialIndexes.remove( LandmarkList );
+
+  // Remove the elevation rasters of the unloaded tiles.
+  foreach( int secID, m_elevationRasters.keys() )
+  {
+    if( ! tileSectionSet.contains( secID ) && ! tilePartMap.contains( secID ) )
+      {
+        m_elevationRasters.remove( secID );
+      }
+  }
+
   unloadDone=true;
 
 #ifdef DEBUG_UNLOAD_SUM
@@ -2229,7 +1369,8 @@ void MapContents::unloadMapObjects( QList<LineElement>& list )
 
   for (int i = list.count() - 1; i >= 0; i--)
     {
-       if ( !tileSectionSet.contains(list.at(i).getMapSegment()) )
+       if ( !tileSectionSet.contains(list.at(i).getMapSegment()) &&
+            !tilePartMap.contains(list.at(i).getMapSegment()) )
         {
           list.removeAt(i);
           renew = true;
@@ -2251,7 +1392,8 @@ void MapContents::unloadMapObjects(QList<SinglePoint>& list)
 
   for (int i = list.count() - 1; i >= 0; i--)
     {
-      if ( !tileSectionSet.contains(list.at(i).getMapSegment()) )
+      if ( !tileSectionSet.contains(list.at(i).getMapSegment()) &&
+           !tilePartMap.contains(list.at(i).getMapSegment()) )
         {
           list.removeAt(i);
           renew = true;
@@ -2278,7 +1420,7 @@ void MapContents::unloadMapObjects(QList<RadioPoint>& list)
     }
 }
 
-void MapContents::unloadMapObjects(QMap<int, QList<Isohypse> > isoMap)
+void MapContents::unloadMapObjects(QMap<int, QList<Isohypse> >& isoMap)
 {
 
   QList<int> keys = isoMap.keys();
@@ -2286,7 +1428,8 @@ void MapContents::unloadMapObjects(QMap<int, QList<Isohypse> > isoMap)
   for( int i = 0; i < keys.size(); i++ )
    {
      // Tile not in global list, remove it.
-     if( ! tileSectionSet.contains(keys.at(i)) )
+     if( ! tileSectionSet.contains(keys.at(i)) &&
+         ! tilePartMap.contains(keys.at(i)) )
        {
          isoMap.remove( keys.at(i) );
        }
@@ -2319,6 +1462,8 @@ void MapContents::clearList(const int listIndex)
       break;
     case AirspaceList:
       airspaceList.clear();
+      m_airspaceSets.clear();
+      m_airspaceLimitsValid = false;
       break;
     case FlarmAlertZoneList:
       flarmAlertZoneList.clear();
@@ -2360,6 +1505,9 @@ void MapContents::clearList(const int listIndex)
       qWarning( "MapContents::clearList(): unknown list type %d!", listIndex );
       break;
     }
+
+  m_spatialIndexes.remove( listIndex );
+  markAllChanged();
 }
 
 
@@ -2455,33 +1603,126 @@ BaseMapElement* MapContents::getElement(int listType, unsigned int index)
     }
 }
 
-SinglePoint* MapContents::getSinglePoint(int listIndex, unsigned int index)
+SinglePoint* MapContents::getSinglePoint(int listIndex, unsigned int index)
+{
+  switch (listIndex)
+    {
+    case AirfieldList:
+      return static_cast<SinglePoint *> (&airfieldList[index]);
+    case GliderfieldList:
+      return static_cast<SinglePoint *> (&gliderfieldList[index]);
+    case OutLandingList:
+      return static_cast<SinglePoint *> (&outLandingList[index]);
+    case RadioList:
+      return static_cast<SinglePoint *> (&radioList[index]);
+    case HotspotList:
+      return &hotspotList[index];
+    case ObstacleList:
+      return &obstacleList[index];
+    case ReportList:
+      return &reportList[index];
+    case VillageList:
+      return &villageList[index];
+    case LandmarkList:
+      return &landmarkList[index];
+    default:
+      // Should never happen!
+      qCritical("trying to access unknown map element list");
+      return static_cast<SinglePoint *> (0);
+    }
+}
+
+const SpatialIndex& MapContents::getSpatialIndex( const int listID )
+{
+  QHash<int, SpatialIndex>::iterator it = m_spatialIndexes.find( listID );
+
+  if( it != m_spatialIndexes.end() )
+    {
+      return it.value();
+    }
+
+  SpatialIndex& index = m_spatialIndexes[listID];
+
+  switch( listID )
+    {
+    case AirfieldList:
+    case GliderfieldList:
+    case OutLandingList:
+    case RadioList:
+    case HotspotList:
+    case ObstacleList:
+    case ReportList:
+    case VillageList:
+    case LandmarkList:
+
+      for( unsigned int i = 0; i < getListLength( listID ); i++ )
+        {
+          index.insert( i, getSinglePoint( listID, i )->getWGSPosition() );
+        }
+
+      break;
+
+    case CityList:
+
+      for( int i = 0; i < cityList.size(); i++ )
+        {
+          index.insert( i, cityList.at(i).getWgsBoundingBox() );
+        }
+
+      break;
+
+    case AirspaceList:
+
+      for( int i = 0; i < airspaceList.size(); i++ )
+        {
+          const QRect& box = airspaceList.at(i)->getWgsBoundingBox();
+
+          if( box.isValid() )
+            {
+              index.insert( i, box );
+            }
+        }
+
+      break;
+
+    default:
+      qWarning( "MapContents::getSpatialIndex(): unsupported list type %d!",
+                listID );
+      break;
+    }
+
+  index.build();
+  return index;
+}
+
+AirspaceLimitTable& MapContents::getAirspaceLimitTable()
+{
+  if( m_airspaceLimitsValid == false )
+    {
+      m_airspaceLimits.build( airspaceList );
+      m_airspaceLimitsValid = true;
+    }
+
+  return m_airspaceLimits;
+}
+
+QRect MapContents::getViewportBox()
 {
-  switch (listIndex)
-    {
-    case AirfieldList:
-      return static_cast<SinglePoint *> (&airfieldList[index]);
-    case GliderfieldList:
-      return static_cast<SinglePoint *> (&gliderfieldList[index]);
-    case OutLandingList:
-      return static_cast<SinglePoint *> (&outLandingList[index]);
-    case RadioList:
-      return static_cast<SinglePoint *> (&radioList[index]);
-    case HotspotList:
-      return &hotspotList[index];
-    case ObstacleList:
-      return &obstacleList[index];
-    case ReportList:
-      return &reportList[index];
-    case VillageList:
-      return &villageList[index];
-    case LandmarkList:
-      return &landmarkList[index];
-    default:
-      // Should never happen!
-      qCritical("trying to access unknown map element list");
-      return static_cast<SinglePoint *> (0);
-    }
+  // The view border uses the x-axis as longitude and the y-axis as latitude.
+  const QRect border = _globalMapMatrix->getViewBorder();
+
+  const int latMin = qMin( border.top(), border.bottom() );
+  const int latMax = qMax( border.top(), border.bottom() );
+  const int lonMin = qMin( border.left(), border.right() );
+  const int lonMax = qMax( border.left(), border.right() );
+
+  // The elements are drawn with their icons and labels. Therefore elements
+  // a little bit outside of the view must be considered too.
+  const int dLat = (latMax - latMin) / 4;
+  const int dLon = (lonMax - lonMin) / 4;
+
+  return QRect( QPoint( latMin - dLat, lonMin - dLon ),
+                QPoint( latMax + dLat, lonMax + dLon ) );
 }
 
 /** This slot is called to do a first load of all map data or to do a
@@ -2509,21 +1750,22 @@ void MapContents::slotReloadMapData()
 
   qDeleteAll(airspaceList);
   airspaceList = SortableAirspaceList();
+  m_airspaceSets.clear();
 
   qDeleteAll(flarmAlertZoneList);
   flarmAlertZoneList = SortableAirspaceList();
 
-  cityList.clear();
-  hydroList.clear();
-  lakeList.clear();
-  landmarkList.clear();
-  obstacleList.clear();
-  railList.clear();
-  reportList.clear();
-  motorwayList.clear();
-  roadList.clear();
-  topoList.clear();
-  villageList.clear();
+  // The loaded map elements must be only loaded again, if other map files
+  // or elements are requested. After a projection change they are loaded
+  // again by updateProjection().
+  if( getMapLoadSettings() != m_mapLoadSettings )
+    {
+      m_mapLoadSettings = getMapLoadSettings();
+      clearMapElements();
+    }
+
+  m_spatialIndexes.clear();
+  m_airspaceLimitsValid = false;
 
   // free internal allocated memory in QList
   m_airfieldLoadMutex.lock();
@@ -2542,13 +1784,7 @@ void MapContents::slotReloadMapData()
   hotspotList = QList<SinglePoint>();
   m_hotspotLoadMutex.unlock();
 
-  // all isolines are cleared
-  groundMap.clear();
-  terrainMap.clear();
-
-  // tile maps are cleared
-  tileSectionSet.clear();
-  tilePartMap.clear();
+  markAllChanged();
 
   isFirst  = true;
   isReload = true;
@@ -2667,6 +1903,10 @@ void MapContents::slotOpenAipAirfieldLoadFinished( int noOfLists,
   gliderfieldList = QList<Airfield>();
   outLandingList  = QList<Airfield>();
 
+  m_spatialIndexes.remove( AirfieldList );
+  m_spatialIndexes.remove( GliderfieldList );
+  m_spatialIndexes.remove( OutLandingList );
+
   emit mapDataReloaded( Map::airfields );
 
   // This signal will update all list views of the main window.
@@ -2723,6 +1963,8 @@ void MapContents::slotOpenAipNavAidLoadFinished( int noOfLists,
   radioList = *radioListIn;
   delete radioListIn;
 
+  m_spatialIndexes.remove( RadioList );
+
   emit mapDataReloaded( Map::navaids );
 
   // This signal will update all list views of the main window.
@@ -2779,6 +2021,8 @@ void MapContents::slotOpenAipHotspotLoadFinished( int noOfLists,
   hotspotList = *hotspotListIn;
   delete hotspotListIn;
 
+  m_spatialIndexes.remove( HotspotList );
+
   emit mapDataReloaded( Map::hotspots );
 
   // This signal will update all list views of the main window.
@@ -2800,28 +2044,58 @@ void MapContents::loadAirspacesViaThread()
 
   _globalMapView->slot_info( tr("Loading Airspaces") );
 
-  AirspaceHelperThread *ashThread = new AirspaceHelperThread( this );
+  // The files of the loaded airspace sets are only loaded again, if they
+  // have been changed.
+  QMap<QString, QDateTime> keep;
+
+  QMap<QString, AirspaceHelper::AirspaceSet>::const_iterator it;
+
+  for( it = m_airspaceSets.constBegin(); it != m_airspaceSets.constEnd(); ++it )
+    {
+      keep.insert( it.key(), it.value().stamp );
+    }
+
+  AirspaceHelperThread *ashThread = new AirspaceHelperThread( this, keep );
 
   // Register a special data type for return results. That must be
   // done to transfer the results between different threads.
-  qRegisterMetaType<AirspaceListPtr>("AirspaceListPtr");
+  qRegisterMetaType<AirspaceLoadResultPtr>("AirspaceHelper::LoadResult*");
 
   // Connect the receiver of the results. It is located in this
   // thread and not in the new opened thread.
   connect( ashThread,
-           SIGNAL(loadedList( int, SortableAirspaceList* )),
+           SIGNAL(loadedSets( AirspaceHelper::LoadResult* )),
+           this,
+           SLOT(slotAirspaceLoadFinished( AirspaceHelper::LoadResult* )) );
+
+  connect( ashThread,
+           SIGNAL(loadedFile( const QString&, int, int )),
            this,
-           SLOT(slotAirspaceLoadFinished( int, SortableAirspaceList* )) );
+           SLOT(slotAirspaceFileLoaded( const QString&, int, int )) );
 
   ashThread->start();
 }
 
-void MapContents::slotAirspaceLoadFinished( int noOfLists,
-                                            SortableAirspaceList* airspaceListIn )
+void MapContents::slotAirspaceFileLoaded( const QString& fileName,
+                                          int airspaces,
+                                          int msecs )
+{
+  const QString file = QFileInfo( fileName ).fileName();
+
+  qDebug( "MapContents: %s: %d airspaces in %dms",
+          file.toLatin1().data(), airspaces, msecs );
+
+  // Reported to the wait screen, if it is still shown.
+  emit loadingFile( file );
+
+  _globalMapView->slot_info( tr("%1: %2 airspaces").arg( file ).arg( airspaces ) );
+}
+
+void MapContents::slotAirspaceLoadFinished( AirspaceHelper::LoadResult* result )
 {
   QMutexLocker locker( &m_airspaceLoadMutex );
 
-  if( noOfLists == 0 )
+  if( result->loadedFiles == 0 )
     {
       _globalMapView->slot_info( tr("No Airspaces loaded") );
     }
@@ -2830,24 +2104,162 @@ void MapContents::slotAirspaceLoadFinished( int noOfLists,
       _globalMapView->slot_info( tr("Airspaces loaded") );
     }
 
-  // Clear the airspace path list in map. They are outdated.
-  Map::getInstance()->clearAirspaceRegionList();
+  // The passed result must be deleted!
+  bool changed = takeOverAirspaceSets( *result );
+  delete result;
 
-  // Take over the new loaded airspace list. The passed list must be deleted!
-  qDeleteAll(airspaceList);
+  if( changed )
+    {
+      emit mapDataReloaded( Map::airspaces );
+    }
+}
+
+bool MapContents::takeOverAirspaceSets( AirspaceHelper::LoadResult& result )
+{
+  QSet<QString> loadedKeys;
+
+  for( int i = 0; i < result.sets.size(); i++ )
+    {
+      loadedKeys.insert( result.sets.at(i).key );
+    }
+
+  // Sets, which are not wanted any more or which have been loaded again,
+  // are removed.
+  QSet<Airspace*> removed;
+  bool unwanted = false;
+
+  QMutableMapIterator<QString, AirspaceHelper::AirspaceSet> it( m_airspaceSets );
+
+  while( it.hasNext() )
+    {
+      it.next();
+
+      const bool wanted = result.keys.contains( it.key() );
+
+      if( wanted && loadedKeys.contains( it.key() ) == false )
+        {
+          // The set is kept.
+          continue;
+        }
+
+      unwanted |= ! wanted;
+
+      const QList<Airspace*>& airspaces = it.value().airspaces;
+
+      for( int i = 0; i < airspaces.size(); i++ )
+        {
+          removed.insert( airspaces.at(i) );
+        }
+
+      it.remove();
+    }
+
+  if( removed.isEmpty() && result.sets.isEmpty() )
+    {
+      // Nothing has been changed.
+      return false;
+    }
+
+  m_airspaceGeneration++;
+
+  // The airspaces of the kept sets have priority over duplicates in the
+  // new loaded sets.
+  QSet<int> knownIds;
+
+  QMap<QString, AirspaceHelper::AirspaceSet>::const_iterator kit;
+
+  for( kit = m_airspaceSets.constBegin(); kit != m_airspaceSets.constEnd(); ++kit )
+    {
+      const QList<Airspace*>& airspaces = kit.value().airspaces;
+
+      for( int i = 0; i < airspaces.size(); i++ )
+        {
+          if( airspaces.at(i)->getId() >= 0 )
+            {
+              knownIds.insert( airspaces.at(i)->getId() );
+            }
+        }
+    }
+
+  for( int i = 0; i < result.sets.size(); i++ )
+    {
+      AirspaceHelper::AirspaceSet set = result.sets.at(i);
+      set.generation = m_airspaceGeneration;
+
+      for( int j = set.airspaces.size() - 1; j >= 0; j-- )
+        {
+          if( set.airspaces.at(j)->getId() >= 0 &&
+              knownIds.contains( set.airspaces.at(j)->getId() ) )
+            {
+              delete set.airspaces.takeAt(j);
+              set.skipped++;
+            }
+        }
+
+      m_airspaceSets.insert( set.key, set );
+    }
+
+  qDebug() << "MapContents: airspace generation" << m_airspaceGeneration
+           << ":" << result.sets.size() << "set(s) loaded,"
+           << removed.size() << "airspace(s) removed";
+
+  // The map must forget the removed airspaces before they are deleted.
+  if( removed.isEmpty() == false )
+    {
+      Map::getInstance()->removeAirspaces( removed );
+    }
+
+  // The airspace list is put together from the sets in the order of
+  // their files.
   airspaceList.clear();
 
-  // free all internal allocated memory in QList
-  airspaceList = SortableAirspaceList();
+  for( int i = 0; i < result.keys.size(); i++ )
+    {
+      QMap<QString, AirspaceHelper::AirspaceSet>::const_iterator sit =
+          m_airspaceSets.constFind( result.keys.at(i) );
 
-  // assign new airspace list
-  airspaceList = *airspaceListIn;
+      if( sit != m_airspaceSets.constEnd() )
+        {
+          airspaceList << sit.value().airspaces;
+        }
+    }
 
   // finally, sort the airspaces
   airspaceList.sort();
-  delete airspaceListIn;
 
-  emit mapDataReloaded( Map::airspaces );
+  qDeleteAll( removed );
+
+  // The airspace index is built at once, the first fix needs it.
+  m_spatialIndexes.remove( AirspaceList );
+  getSpatialIndex( AirspaceList );
+  m_airspaceLimitsValid = false;
+
+  if( unwanted )
+    {
+      // Airspaces, which have been skipped as duplicates of the removed
+      // sets, are only restored by a new load of their sets.
+      bool reload = false;
+
+      QMutableMapIterator<QString, AirspaceHelper::AirspaceSet> sit( m_airspaceSets );
+
+      while( sit.hasNext() )
+        {
+          sit.next();
+
+          if( sit.value().skipped > 0 )
+            {
+              sit.value().stamp = QDateTime();
+              reload = true;
+            }
+        }
+
+      if( reload )
+        {
+          QTimer::singleShot( 0, this, SLOT(slotReloadAirspaceData()) );
+        }
+    }
+
+  return true;
 }
 
 void MapContents::slotNewFlarmAlertZoneData( FlarmBase::FlarmAlertZone& faz )
@@ -2888,6 +2300,7 @@ void MapContents::slotNewFlarmAlertZoneData( FlarmBase::FlarmAlertZone& faz )
     {
       // The Flarm airspace object type is a circle
       QPolygon aspg;
+      QPolygon wgsPg;
 
       // Distance of one arc minute along latitude and longitude
       double distLat = MapCalc::distC1( faz.Latitude, faz.Longitude, faz.Latitude + 10000, faz.Longitude );
@@ -2912,9 +2325,11 @@ void MapContents::slotNewFlarmAlertZoneData( FlarmBase::FlarmAlertZone& faz )
           y = rint(y);
 
           aspg.append( _globalMapMatrix->wgsToMap( x, y ) );
+          wgsPg.append( QPoint( (int) x, (int) y ) );
         }
 
       as->setProjectedPolygon( aspg );
+      as->setWgsPolygon( wgsPg );
     }
 
   // Flarm Alert Zone
@@ -2952,6 +2367,10 @@ void MapContents::drawList( QPainter* targetP,
   //QTime t;
   //t.start();
 
+  // Only the elements near to the map view are drawn.
+  const QRect viewBox = getViewportBox();
+  QVector<int> visible;
+
   // load all configuration items once
   const bool showAfLabels  = GeneralConfig::instance()->getMapShowAirfieldLabels();
   const bool showOlLabels  = GeneralConfig::instance()->getMapShowOutLandingLabels();
@@ -2964,12 +2383,14 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing airports") );
 
-      for (int i = 0; i < airfieldList.size(); i++)
+      getSpatialIndex( AirfieldList ).queryViewport( viewBox, visible );
+
+      for (int j = 0; j < visible.size(); j++)
         {
-          if(  airfieldList[i].drawMapElement(targetP) && showAfLabels )
+          if(  airfieldList[visible.at(j)].drawMapElement(targetP) && showAfLabels )
             {
               // required and draw object is appended to the list
-              drawnAfList.append( &airfieldList[i] );
+              drawnAfList.append( &airfieldList[visible.at(j)] );
             }
         }
 
@@ -2981,12 +2402,14 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing glider sites") );
 
-      for (int i = 0; i < gliderfieldList.size(); i++)
+      getSpatialIndex( GliderfieldList ).queryViewport( viewBox, visible );
+
+      for (int j = 0; j < visible.size(); j++)
         {
-          if( gliderfieldList[i].drawMapElement(targetP) && showAfLabels )
+          if( gliderfieldList[visible.at(j)].drawMapElement(targetP) && showAfLabels )
             {
               // required and draw object is appended to the list
-              drawnAfList.append( &gliderfieldList[i] );
+              drawnAfList.append( &gliderfieldList[visible.at(j)] );
             }
         }
 
@@ -2998,12 +2421,14 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing outlanding sites") );
 
-      for (int i = 0; i < outLandingList.size(); i++)
+      getSpatialIndex( OutLandingList ).queryViewport( viewBox, visible );
+
+      for (int j = 0; j < visible.size(); j++)
         {
-          if( outLandingList[i].drawMapElement(targetP) && showOlLabels )
+          if( outLandingList[visible.at(j)].drawMapElement(targetP) && showOlLabels )
             {
               // required and draw object is appended to the list
-              drawnAfList.append( &outLandingList[i] );
+              drawnAfList.append( &outLandingList[visible.at(j)] );
             }
         }
 
@@ -3024,13 +2449,18 @@ void MapContents::drawList( QPainter* targetP,
 
   const bool showNaLabels = GeneralConfig::instance()->getMapShowNavAidsLabels();
 
+  const QRect viewBox = getViewportBox();
+  QVector<int> visible;
+
   showProgress2WaitScreen( tr("Drawing navaids") );
 
-  for (int i = 0; i < radioList.size(); i++)
+  getSpatialIndex( RadioList ).queryViewport( viewBox, visible );
+
+  for (int j = 0; j < visible.size(); j++)
     {
-      if( radioList[i].drawMapElement( targetP ) && showNaLabels )
+      if( radioList[visible.at(j)].drawMapElement( targetP ) && showNaLabels )
         {
-          drawnNaList.append( &radioList[i] );
+          drawnNaList.append( &radioList[visible.at(j)] );
         }
     }
 }
@@ -3045,6 +2475,10 @@ void MapContents::drawList( QPainter* targetP,
   //QTime t;
   //t.start();
 
+  // Only the elements near to the map view are drawn.
+  const QRect viewBox = getViewportBox();
+  QVector<int> visible;
+
   switch (listID)
     {
     case AirfieldList:
@@ -3053,9 +2487,11 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing airports") );
 
-      for (int i = 0; i < airfieldList.size(); i++)
+      getSpatialIndex( AirfieldList ).queryViewport( viewBox, visible );
+
+      for (int j = 0; j < visible.size(); j++)
         {
-          airfieldList[i].drawMapElement(targetP);
+          airfieldList[visible.at(j)].drawMapElement(targetP);
         }
 
       break;
@@ -3066,9 +2502,11 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing glider sites") );
 
-      for (int i = 0; i < gliderfieldList.size(); i++)
+      getSpatialIndex( GliderfieldList ).queryViewport( viewBox, visible );
+
+      for (int j = 0; j < visible.size(); j++)
         {
-          gliderfieldList[i].drawMapElement(targetP);
+          gliderfieldList[visible.at(j)].drawMapElement(targetP);
         }
 
       break;
@@ -3079,9 +2517,11 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing outlanding sites") );
 
-      for (int i = 0; i < outLandingList.size(); i++)
+      getSpatialIndex( OutLandingList ).queryViewport( viewBox, visible );
+
+      for (int j = 0; j < visible.size(); j++)
         {
-          outLandingList[i].drawMapElement(targetP);
+          outLandingList[visible.at(j)].drawMapElement(targetP);
         }
 
       break;
@@ -3092,9 +2532,11 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing navaids") );
 
-      for (int i = 0; i < radioList.size(); i++)
+      getSpatialIndex( RadioList ).queryViewport( viewBox, visible );
+
+      for (int j = 0; j < visible.size(); j++)
         {
-          radioList[i].drawMapElement(targetP);
+          radioList[visible.at(j)].drawMapElement(targetP);
         }
 
       break;
@@ -3105,9 +2547,11 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing hotspots") );
 
-      for (int i = 0; i < hotspotList.size(); i++)
+      getSpatialIndex( HotspotList ).queryViewport( viewBox, visible );
+
+      for (int j = 0; j < visible.size(); j++)
         {
-          hotspotList[i].drawMapElement(targetP);
+          hotspotList[visible.at(j)].drawMapElement(targetP);
         }
 
       break;
@@ -3131,8 +2575,10 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing obstacles") );
 
-      for (int i = 0; i < obstacleList.size(); i++)
-        obstacleList[i].drawMapElement(targetP);
+      getSpatialIndex( ObstacleList ).queryViewport( viewBox, visible );
+
+      for (int j = 0; j < visible.size(); j++)
+        obstacleList[visible.at(j)].drawMapElement(targetP);
       break;
 
     case ReportList:
@@ -3141,8 +2587,10 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing reporting points") );
 
-      for (int i = 0; i < reportList.size(); i++)
-        reportList[i].drawMapElement(targetP);
+      getSpatialIndex( ReportList ).queryViewport( viewBox, visible );
+
+      for (int j = 0; j < visible.size(); j++)
+        reportList[visible.at(j)].drawMapElement(targetP);
       break;
 
     case CityList:
@@ -3151,11 +2599,13 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing cities") );
 
-      for (int i = 0; i < cityList.size(); i++)
+      getSpatialIndex( CityList ).queryViewport( viewBox, visible );
+
+      for (int j = 0; j < visible.size(); j++)
         {
-          if( cityList[i].drawMapElement(targetP) )
+          if( cityList[visible.at(j)].drawMapElement(targetP) )
             {
-              drawnElements.append( &cityList[i] );
+              drawnElements.append( &cityList[visible.at(j)] );
             }
         }
 
@@ -3167,8 +2617,10 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing villages") );
 
-      for (int i = 0; i < villageList.size(); i++)
-        villageList[i].drawMapElement(targetP);
+      getSpatialIndex( VillageList ).queryViewport( viewBox, visible );
+
+      for (int j = 0; j < visible.size(); j++)
+        villageList[visible.at(j)].drawMapElement(targetP);
       break;
 
     case LandmarkList:
@@ -3177,8 +2629,10 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing landmarks") );
 
-      for (int i = 0; i < landmarkList.size(); i++)
-        landmarkList[i].drawMapElement(targetP);
+      getSpatialIndex( LandmarkList ).queryViewport( viewBox, visible );
+
+      for (int j = 0; j < visible.size(); j++)
+        landmarkList[visible.at(j)].drawMapElement(targetP);
       break;
 
     case MotorwayList:
@@ -3250,156 +2704,154 @@ void MapContents::drawList( QPainter* targetP,
 }
 
 /**
- * Draws the isoline areas and the related outer isoline border. Drawing
- * size depends on user configuration:
- *
- * a) Only ground can be drawn
- * b) Ground and terrain can be drawn
- * c) Isoline borders can be drawn depending on map scale. If map scale > 160
- *    drawing will be switched off automatically.
- **/
-void MapContents::drawIsoList(QPainter* targetP)
+ * Fills the map data part of a tile snapshot. The lists are implicitly
+ * shared, so that only reference counters are touched here.
+ */
+void MapContents::createTileSnapshot( MapTileSnapshot& snapshot )
 {
-  // qDebug("MapContents::drawIsoList():");
+  GeneralConfig *conf = GeneralConfig::instance();
 
-  QTime t;
-  t.start();
+  // The worker threads need the coordinates of the current projection.
+  updateProjection();
 
-  extern MapMatrix* _globalMapMatrix;
-  _lastIsoEntry = 0;
-  _isoLevelReset = true;
-  pathIsoLines.clear();
-  bool isolines = false;
-  GeneralConfig *conf = GeneralConfig::instance();
+  snapshot.background     = conf->getTerrainColor(0);
+  snapshot.groundColor    = conf->getGroundColor();
+  snapshot.drawTerrain    = conf->getMapLoadIsoLines();
+  snapshot.drawIsoBorders = conf->getMapShowIsoLineBorders() &&
+                            rint(snapshot.scale) < 160;
+  snapshot.drawRoads      = snapshot.scale <= 200;
 
-  targetP->setPen(QPen(Qt::black, 1, Qt::NoPen));
+  snapshot.groundMap  = groundMap;
+  snapshot.terrainMap = terrainMap;
 
-  if( conf->getMapShowIsoLineBorders() )
-    {
-      int scale = (int) rint(_globalMapMatrix->getScale(MapMatrix::CurrentScale));
+  int elevationIndexOffest = conf->getElevationColorOffset();
 
-      if( scale < 160 )
+  snapshot.groundColors.resize( SIZEOF_TERRAIN_COLORS );
+  snapshot.terrainColors.resize( SIZEOF_TERRAIN_COLORS );
+
+  for( int i = 0; i < SIZEOF_TERRAIN_COLORS; i++ )
+    {
+      if( snapshot.drawTerrain )
         {
-          // Draw outer isolines only at lower scales
-          isolines = true;
+          snapshot.groundColors[i] = conf->getTerrainColor(i);
+        }
+      else
+        {
+          // Only ground level will be drawn. We take the ground color
+          // when isoline drawing is switched off by the user.
+          snapshot.groundColors[i] = snapshot.groundColor;
         }
-    }
 
-  targetP->save();
-  showProgress2WaitScreen( tr("Drawing surface contours") );
+      snapshot.terrainColors[i] =
+        conf->getTerrainColor( shiftElevationColorIndex( i, elevationIndexOffest ) );
+    }
 
-  int count = 1; // draw only the ground
+  snapshot.topoList     = topoList;
+  snapshot.cityList     = cityList;
+  snapshot.lakeList     = lakeList;
+  snapshot.roadList     = roadList;
+  snapshot.railList     = railList;
+  snapshot.hydroList    = hydroList;
+  snapshot.motorwayList = motorwayList;
+}
 
-  bool drawTerrain = conf->getMapLoadIsoLines();
+/**
+ * Collects all cities, which are visible on the screen.
+ */
+void MapContents::getVisibleCities( QList<const LineElement *>& cities )
+{
+  GeneralConfig *conf = GeneralConfig::instance();
 
-  // shall we draw the terrain too?
-  if( drawTerrain )
+  if( conf->getMapLoadCities() == false ||
+      _globalMapConfig->isBorder( BaseMapElement::City ) == false )
     {
-      count++; // yes
+      return;
     }
 
-  int elevationIndexOffest = GeneralConfig::instance()->getElevationColorOffset();
+  QVector<int> visible;
 
-  QMap< int, QList<Isohypse> >* isoMaps[2] = { &groundMap, &terrainMap };
+  getSpatialIndex( CityList ).queryViewport( getViewportBox(), visible );
 
-  for( int i = 0; i < count; i++ )
+  // The city list can be shared with a tile snapshot. Only const access
+  // is used, otherwise the whole list is copied.
+  for( int j = 0; j < visible.size(); j++ )
     {
-      // assign the map to be drawn to the iterator
-      QMapIterator<int, QList<Isohypse> > it(*isoMaps[i]);
+      const LineElement& city = cityList.at( visible.at(j) );
 
-      while (it.hasNext())
+      if( city.isVisible() )
         {
-          // Iterate over all tiles in the isomap and fetch the isoline lists.
-          // The isoline list contains all isolines of a tile in ascending order.
-          it.next();
-
-          // Check, if tile has a map overlapping otherwise we can ignore it
-          // completely.
-          QRect mapBorder = _globalMapMatrix->getViewBorder();
+          cities.append( &city );
+        }
+    }
+}
 
-          if( MapCalc::getTileBox( it.key() ).intersects(mapBorder) == false )
-            {
-              // qDebug("Tile=%d do not intersect", it.key() );
-              continue;
-            }
+void MapContents::markSectionChanged( const int secID )
+{
+  m_generation++;
+  m_sectionGenerations.insert( secID, m_generation );
+}
 
-          const QList<Isohypse> &isoList = it.value();
+void MapContents::markAllChanged()
+{
+  m_generation++;
+  m_resetGeneration = m_generation;
+  m_sectionGenerations.clear();
+}
 
-          for (int j = 0; j < isoList.size(); j++)
-            {
-              Isohypse isoLine = isoList.at(j);
+bool MapContents::getChangedSections( const int sinceGeneration,
+                                      QList<int>& sections ) const
+{
+  if( m_resetGeneration > sinceGeneration )
+    {
+      // All map data have been changed.
+      return false;
+    }
 
-              if( drawTerrain )
-                {
-                  // Choose contour color.
-                  // The index of the isoList has a fixed relation to the isocolor list
-                  // normally with an offset of one.
-                  int colorIdx = isoLine.getElevationIndex();
-
-                  // We can move the color index by an user configuration option
-                  // to get a better color schema.
-                  if( colorIdx > 0 && elevationIndexOffest != 0 && i == 1 )
-                    {
-                      int newIndex = colorIdx + elevationIndexOffest;
-
-                      if( newIndex > 0 && newIndex <= SIZEOF_TERRAIN_COLORS )
-                        {
-                          // Move color index to the new position
-                          colorIdx = newIndex;
-                        }
-                      else if( newIndex <= 0 )
-                        {
-                          // Index 0 is blue ground and that is not true for
-                          // elevations above MSL.
-                          colorIdx = 1;
-                        }
-                      else if( newIndex >=  SIZEOF_TERRAIN_COLORS )
-                        {
-                          colorIdx = SIZEOF_TERRAIN_COLORS - 1;
-                        }
-                    }
-
-                  targetP->setBrush( QBrush(conf->getTerrainColor(colorIdx),
-                                     Qt::SolidPattern));
-                }
-              else
-                {
-                  // Only ground level will be drawn. We take the ground color
-                  // when isoline drawing is switched off by the user.
-                  targetP->setBrush( QBrush(conf->getGroundColor(),
-                                      Qt::SolidPattern));
-                }
+  QHashIterator<int, int> it( m_sectionGenerations );
 
-              // draw the single isoline
-              QPainterPath* Path = isoLine.drawRegion( targetP, isolines);
+  while( it.hasNext() )
+    {
+      it.next();
 
-              if (Path)
-                {
-                  // store drawn path in extra list for elevation finding
-                  IsoListEntry entry(Path, isoLine.getElevation());
-                  pathIsoLines.append(entry);
-                  //qDebug("  added Iso: %04x, %d", (int)reg, iso2.getElevation() );
-                }
-            }
+      if( it.value() > sinceGeneration )
+        {
+          sections.append( it.key() );
         }
     }
 
-  targetP->restore();
-  pathIsoLines.sort();
-  _isoLevelReset = false;
+  return true;
+}
 
-  qDebug( "IsoList, drawTime=%dms", t.elapsed() );
+/**
+ * Moves a terrain color index by the user defined elevation color offset.
+ */
+int MapContents::shiftElevationColorIndex( int colorIdx, int offset )
+{
+  // The index of the isoList has a fixed relation to the isocolor list
+  // normally with an offset of one.
+  if( colorIdx > 0 && offset != 0 )
+    {
+      int newIndex = colorIdx + offset;
 
-#if 0
-  QString isos;
+      if( newIndex > 0 && newIndex <= SIZEOF_TERRAIN_COLORS )
+        {
+          // Move color index to the new position
+          colorIdx = newIndex;
+        }
+      else if( newIndex <= 0 )
+        {
+          // Index 0 is blue ground and that is not true for
+          // elevations above MSL.
+          colorIdx = 1;
+        }
 
-  for ( int l = 0; l < pathIsoLines.count(); l++ )
-    {
-      isos += QString("%1, ").arg(pathIsoLines.at(l).height);
+      if( colorIdx >=  SIZEOF_TERRAIN_COLORS )
+        {
+          colorIdx = SIZEOF_TERRAIN_COLORS - 1;
+        }
     }
 
-  qDebug( isos.toLatin1().data() );
-#endif
+  return colorIdx;
 }
 
 /**
@@ -3419,8 +2871,14 @@ void MapContents::showProgress2WaitScreen( QString message )
     pathName. */
 bool MapContents::locateFile(const QString& fileName, QString& pathName)
 {
-  QStringList mapDirs = GeneralConfig::instance()->getMapDirectories();
+  return locateFile( fileName, pathName,
+                     GeneralConfig::instance()->getMapDirectories() );
+}
 
+bool MapContents::locateFile( const QString& fileName,
+                              QString& pathName,
+                              const QStringList& mapDirs )
+{
   for ( int i = 0; i < mapDirs.size(); ++i )
     {
       QFile test;
@@ -3725,94 +3183,66 @@ bool MapContents::compareProjections(ProjectionBase* p1, ProjectionBase* p2)
 
 int MapContents::findElevation(const QPoint& coordP, Distance* errorDist)
 {
-  extern MapMatrix* _globalMapMatrix;
+  // Position of the point in the global raster, which covers the whole
+  // earth. The cell centers are the sample points.
+  const double fx = double(coordP.y() + 180 * 600000) / ElevationRaster::CellSize - 0.5;
+  const double fy = double(90 * 600000 - coordP.x()) / ElevationRaster::CellSize - 0.5;
 
-  const IsoListEntry* entry = 0;
-  int height = 0;
-  double error = 0.0;
+  const int col = (int) floor(fx);
+  const int row = (int) floor(fy);
 
-  QPoint coordP1 = _globalMapMatrix->wgsToMap(coordP.x(), coordP.y());
-  QPoint coord = _globalMapMatrix->map(coordP1);
+  const double tx = fx - col;
+  const double ty = fy - row;
 
-  IsoList* list = getIsohypseRegions();
-
-  // qDebug("list->count() %d", list->count() );
-  //qDebug("==searching for elevation==");
-  //qDebug("_lastIsoLevel %d, _nextIsoLevel %d",_lastIsoLevel, _nextIsoLevel);
-  if (_isoLevelReset)
-    {
-      qDebug("findElevation: Busy rebuilding the isomap. Returning last known result...");
-      return _lastIsoLevel;
-    }
+  const double weights[4] = { (1.0 - tx) * (1.0 - ty), tx * (1.0 - ty),
+                              (1.0 - tx) * ty, tx * ty };
 
-  int cnt = list->count();
+  double sum = 0.0;
+  double weightSum = 0.0;
 
-  for ( int i=0; i<cnt; i++ )
+  // Bilinear interpolation between the four surrounding cells. Cells
+  // without data are ignored.
+  for( int i = 0; i < 4; i++ )
     {
-      entry = &(list->at(i));
-      // qDebug("i: %d entry->height %d contains %d",i,entry->height, entry->path->contains(coord) );
-      // qDebug("Point x:%d y:%d", coord.x(), coord.y() );
-      // qDebug("boundingRect l:%d r:%d t:%d b:%d", entry->path->boundingRect().left(),
-      //                                 entry->path->boundingRect().right(),
-      //                                 entry->path->boundingRect().top(),
-      //                                 entry->path->boundingRect().bottom() );
+      uchar idx = getElevationIndexOfCell( row + i / 2, col + i % 2 );
 
-      if (entry->height > height && /*there is no reason to search a lower level if we already have a hit on a higher one*/
-          entry->height <= _nextIsoLevel) /* since the odds of skipping a level between two fixes are not too high, we can ignore higher levels, making searching more efficient.*/
+      if( idx == ElevationRaster::NoData || weights[i] == 0.0 )
         {
-          if (entry->height == _lastIsoLevel && _lastIsoEntry)
-            {
-              //qDebug("Trying previous entry...");
-              if (_lastIsoEntry->path->contains(coord))
-                {
-                  height = qMax(height, entry->height);
-                  //qDebug("Found on height %d",entry->height);
-                  break;
-                }
-            }
+          continue;
+        }
 
-          if (entry == _lastIsoEntry)
-            {
-              continue; //we already tried this one, and it wasn't it.
-            }
+      sum += weights[i] * isoLevels[idx];
+      weightSum += weights[i];
+    }
 
-          //qDebug("Probing on height %d...", entry->height);
+  int height = 0;
+  double error = 0.0;
 
-          if (entry->path->contains(coord))
-            {
-              height = qMax(height,entry->height);
-              //qDebug("Found on height %d",entry->height);
-              _lastIsoEntry = entry;
-              break;
-            }
-        }
+  if( weightSum > 0.0 )
+    {
+      // Levels below MSL are handled as MSL.
+      height = qMax( 0, (int) rint( sum / weightSum ) );
     }
 
-  _lastIsoLevel = height;
-
   // The real altitude is between the current and the next
   // isolevel, therefore reduce error by taking the middle
   if ( height <100 )
     {
-      _nextIsoLevel = height+25;
       height += 12;
       error=12.5;
     }
   else if ( (height >=100) && (height < 500) )
     {
-      _nextIsoLevel = height+50;
       height += 25;
       error=25.0;
     }
   else if ( (height >=500) && (height < 1000) )
     {
-      _nextIsoLevel = height+100;
       height += 50;
       error=50.0;
     }
   else
     {
-      _nextIsoLevel = height+250;
       height += 125;
       error = 125.0;
     }
@@ -3825,3 +3255,24 @@ int MapContents::findElevation(const QPoint& coordP, Distance* errorDist)
 
   return height;
 }
+
+uchar MapContents::getElevationIndexOfCell( const int row, const int col ) const
+{
+  if( row < 0 || col < 0 ||
+      row >= 90 * ElevationRaster::Size || col >= 180 * ElevationRaster::Size )
+    {
+      return ElevationRaster::NoData;
+    }
+
+  // Map tile identifier, see proofeSection()
+  const int secID = (row / ElevationRaster::Size) * 180 + col / ElevationRaster::Size;
+
+  QHash<int, ElevationRaster>::const_iterator it = m_elevationRasters.constFind( secID );
+
+  if( it == m_elevationRasters.constEnd() || it.value().isNull() )
+    {
+      return ElevationRaster::NoData;
+    }
+
+  return it.value().cell( row % ElevationRaster::Size, col % ElevationRaster::Size );
+}
@@ -45,13 +45,17 @@
 
 #include "airfield.h"
 #include "airspace.h"
+#include "AirspaceHelper.h"
+#include "airspacelimittable.h"
 #include "distance.h"
 #include "flarmbase.h"
 #include "flighttask.h"
-#include "isolist.h"
+#include "elevationraster.h"
 #include "map.h"
+#include "maptileloaderthread.h"
 #include "radiopoint.h"
 #include "singlepoint.h"
+#include "spatialindex.h"
 #include "waitscreen.h"
 
 #ifdef INTERNET
@@ -60,6 +64,7 @@
 
 class Isohypse;
 class LineElement;
+class MapTileSnapshot;
 class SinglePoint;
 
 // number of isoline levels
@@ -258,6 +263,37 @@ class MapContents : public QObject
      */
     SinglePoint* getSinglePoint(int listIndex, unsigned int index);
 
+    /**
+     * Returns the spatial index of a map element list. The index is built,
+     * if it is requested the first time after a change of the list.
+     * Supported are the point lists, the city list and the airspace list.
+     *
+     * @param listID The index of the list
+     */
+    const SpatialIndex& getSpatialIndex( const int listID );
+
+    /**
+     * Returns the vertical limits of the airspace list for the evaluation
+     * of all vertical conflicts in one pass. The table is built, if it is
+     * requested the first time after a change of the airspace list.
+     */
+    AirspaceLimitTable& getAirspaceLimitTable();
+
+    /**
+     * Returns the generation of the airspace list. It is incremented on
+     * every change of the list, then the list indexes are outdated.
+     */
+    uint getAirspaceGeneration() const
+      {
+        return m_airspaceGeneration;
+      };
+
+    /**
+     * @return The WGS84 box of the current map view, enlarged by a quarter
+     * of its size at every side. The x-axis is the latitude.
+     */
+    static QRect getViewportBox();
+
     /**
      * @return The Flarm alert zone list.
      */
@@ -298,11 +334,43 @@ class MapContents : public QObject
                    QList<BaseMapElement *>& drawnElements );
 
     /**
-     * Draws all isohypses into the given painter
+     * Fills the map data part of a tile snapshot used by the background
+     * rendering of the base map.
      *
-     * @param  targetP  The painter to draw the elements into
+     * @param snapshot The snapshot to be filled.
+     */
+    void createTileSnapshot( MapTileSnapshot& snapshot );
+
+    /**
+     * Collects all cities, which are visible on the screen.
+     *
+     * @param cities The visible cities are added to this list.
+     */
+    void getVisibleCities( QList<const LineElement *>& cities );
+
+    /**
+     * Returns the generation of the map data. It is incremented every time,
+     * when map data are loaded or removed.
+     */
+    int getGeneration() const
+    {
+      return m_generation;
+    };
+
+    /**
+     * Returns the map sections, which have been loaded or removed after the
+     * passed generation.
+     *
+     * \param sinceGeneration The generation to be compared with.
+     *
+     * \param sections The identifiers of the changed sections are added to
+     *                 this list.
+     *
+     * \return False, if all map data have been changed in the meantime, in
+     *         this case the list is not usable.
      */
-    void drawIsoList(QPainter* targetP);
+    bool getChangedSections( const int sinceGeneration,
+                             QList<int>& sections ) const;
 
     /**
      * @return the waypoint list
@@ -378,19 +446,15 @@ class MapContents : public QObject
        */
     void AddPointToRect(QRect& rect, const QPoint& point);
 
-    /** Returns list of IsoHypse Regions */
-    IsoList* getIsohypseRegions()
-    {
-      return &pathIsoLines;
-    };
-
     /** Returns the elevation index for an elevation step in meters
      */
     uchar getElevationIndex(const ushort elevation ) const;
 
     /** returns ground elevation in meters
      * If the error argument is given, it will be set to the error margin for the
-     * returned value.
+     * returned value. The elevation is interpolated from the elevation rasters
+     * of the loaded map tiles and is available for every WGS84 point inside of
+     * them, visible or not.
      */
     int findElevation(const QPoint& coord, Distance* errorDist=0);
 
@@ -412,7 +476,7 @@ class MapContents : public QObject
 
     void unloadMapObjects(QList<RadioPoint>& list);
 
-    void unloadMapObjects(QMap<int, QList<Isohypse> > isoMap);
+    void unloadMapObjects(QMap<int, QList<Isohypse> >& isoMap);
 
     /**
      * This function checks all possible map directories for the
@@ -421,6 +485,14 @@ class MapContents : public QObject
      */
     static bool locateFile(const QString& fileName, QString& pathName);
 
+    /**
+     * Checks the passed map directories for the map file. That method does
+     * not use the configuration and can be called in other threads.
+     */
+    static bool locateFile( const QString& fileName,
+                            QString& pathName,
+                            const QStringList& mapDirs );
+
     /**
      * this function serves as a substitute for the not existing
      * QDir::entryInfoList with complete path information
@@ -487,8 +559,15 @@ class MapContents : public QObject
      * This slot is called by the AirspaceHelper load thread to signal, that the
      * requested airspace data have been loaded.
      */
-    void slotAirspaceLoadFinished( int noOfLists,
-                                   SortableAirspaceList* airspaceListIn );
+    void slotAirspaceLoadFinished( AirspaceHelper::LoadResult* result );
+
+    /**
+     * This slot is called by the AirspaceHelper load thread for every loaded
+     * airspace file. The file is reported to the user.
+     */
+    void slotAirspaceFileLoaded( const QString& fileName,
+                                 int airspaces,
+                                 int msecs );
 
     /**
      * This slot is called, if a new or updated Flarm Alert Zone is available.
@@ -531,8 +610,18 @@ class MapContents : public QObject
      */
     void slotDownloadAirspaces( const QStringList& openAipCountryList );
 
+#endif
+
   private slots:
 
+    /**
+     * This slot is called by the tile loader thread, if a map file of a
+     * tile has been loaded.
+     */
+    void slotTileLoaded( MapTile* tile );
+
+#ifdef INTERNET
+
     /** Called, if all map downloads are finished. */
     void slotDownloadMapsFinished( int requests, int errors );
 
@@ -575,26 +664,57 @@ class MapContents : public QObject
   private:
 
     /**
-     * Reads a binary map file.
-     *
-     * @param  fileSecID  The sectionID of the map file
-     * @param  fileTypeID  The typeID of the map file ("M" for additional
-     *                     map data)
-     *
-     * @return "true", when the file has successfully been loaded
+     * Requests the missing tiles of the current map view and the tiles
+     * along the current track from the tile loader thread.
      */
-    bool readBinaryFile(const int fileSecID, const char fileTypeID);
+    void requestTiles();
 
     /**
-     * Reads a binary ground/terrain file.
+     * Adds the requests of all missing files of the tiles covered by a map
+     * border. The priority rises with the distance of a tile to the center.
      *
-     * @param  fileSecID  The sectionID of the map file
-     * @param  fileTypeID  The typeID of the map file ("G" for ground-data,
-     *                     and "T" for terrain data)
+     * @param border Map border in KFLog coordinates. X=Longitude, Y=Latitude.
+     * @param center Center in KFLog coordinates.
+     * @param basePriority Priority added to all requests.
+     * @param settings Configuration settings passed with the requests.
+     * @param tiles Tiles already handled, they are skipped.
+     * @param requests List, to which the requests are appended.
+     */
+    void addTileRequests( const QRect& border,
+                          const QPoint& center,
+                          const int basePriority,
+                          const MapTileSettings& settings,
+                          QSet<int>& tiles,
+                          QList<MapTileRequest>& requests );
+
+    /**
+     * Returns the identifiers of all tiles covered by a map border.
      *
-     * @return "true", when the file has successfully been loaded
+     * @param border Map border in KFLog coordinates. X=Longitude, Y=Latitude.
+     * @param tiles List, to which the tile identifiers are appended.
+     */
+    static void getTiles( const QRect& border, QList<int>& tiles );
+
+    /**
+     * Checks, if the map projection has been changed. The loaded map
+     * elements keep only their projected positions, therefore they are
+     * dropped and their tiles are loaded again in that case. The elements
+     * of a new tile are projected, when the tile is loaded.
      */
-    bool readTerrainFile( const int fileSecID, const int fileTypeID );
+    void updateProjection();
+
+    /**
+     * Removes all loaded map elements, isolines and elevation rasters.
+     * Tiles, which are still loaded, are dropped.
+     */
+    void clearMapElements();
+
+    /**
+     * Returns the map root directory and the map load options of the
+     * configuration. If they are unchanged during a reload, the already
+     * loaded map elements can be kept.
+     */
+    QString getMapLoadSettings() const;
 
     /**
      * Starts a thread, which is loading the requested OpenAIP airfield data.
@@ -612,10 +732,22 @@ class MapContents : public QObject
     void loadOpenAipHotspotsViaThread();
 
     /**
-     * Starts a thread, which is loading the requested airspace data.
+     * Starts a thread, which is loading the requested airspace data. Only
+     * new and changed airspace files are loaded.
      */
     void loadAirspacesViaThread();
 
+    /**
+     * Takes over the new loaded airspace sets and removes the sets, which
+     * are not wanted any more or which have been loaded again. Airspaces of
+     * the new sets, which are already contained in the kept sets, are
+     * removed and counted as skipped. The airspace list, its index and the
+     * map are updated.
+     *
+     * \return True, if the airspace list has been changed.
+     */
+    bool takeOverAirspaceSets( AirspaceHelper::LoadResult& result );
+
 #ifdef INTERNET
 
     /**
@@ -634,6 +766,31 @@ class MapContents : public QObject
      */
     void showProgress2WaitScreen( QString message );
 
+    /**
+     * Moves a terrain color index by the user defined elevation color offset.
+     */
+    static int shiftElevationColorIndex( int colorIdx, int offset );
+
+    /**
+     * Returns the elevation index of a cell of the global elevation raster
+     * or ElevationRaster::NoData.
+     *
+     * \param row Row counted from the north pole.
+     *
+     * \param col Column counted from 180 degrees west.
+     */
+    uchar getElevationIndexOfCell( const int row, const int col ) const;
+
+    /**
+     * Marks a map section as changed and increments the generation.
+     */
+    void markSectionChanged( const int secID );
+
+    /**
+     * Marks all map data as changed and increments the generation.
+     */
+    void markAllChanged();
+
     /**
      * airfieldList contains airports, airfields, ultralight sites
      */
@@ -776,18 +933,72 @@ class MapContents : public QObject
     QPointer<WaitScreen> ws;
 
     /**
-     * List of all drawn isohypses.
+     * Generation of the map data, see \ref getGeneration.
      */
-    IsoList pathIsoLines;
+    int m_generation;
 
     /**
-     * Elevation where the next search for the current elevation will start.
-     * Set to one level higher than the current level by findElevation().
+     * Generation, at which all map data have been changed.
      */
-    int _nextIsoLevel;
-    int _lastIsoLevel;
-    bool _isoLevelReset;
-    const IsoListEntry* _lastIsoEntry;
+    int m_resetGeneration;
+
+    /**
+     * Generation of the last change of a map section. The key is the
+     * section identifier.
+     */
+    QHash<int, int> m_sectionGenerations;
+
+    /**
+     * Elevation rasters of the loaded map tiles. The key is the map tile
+     * identifier.
+     */
+    QHash<int, ElevationRaster> m_elevationRasters;
+
+    /**
+     * Identifier of the map projection used by the loaded map elements,
+     * see \ref MapMatrix::getProjectionId.
+     */
+    int m_projectionId;
+
+    /**
+     * Map root directory and load options, with which the map elements
+     * have been loaded, see \ref getMapLoadSettings.
+     */
+    QString m_mapLoadSettings;
+
+    /** Thread, which loads and compiles the map tile files. */
+    MapTileLoaderThread* m_tileLoader;
+
+    /**
+     * Load generation of the map tiles. It is incremented, if all loaded
+     * tiles are cleared. Tiles of older requests are dropped then.
+     */
+    int m_tileLoadGeneration;
+
+    /** Tiles, which are prefetched along the current track. */
+    QSet<int> m_prefetchTiles;
+
+    /**
+     * Spatial indexes of the map element lists. The key is the list
+     * identifier. An index is removed, when its list is modified.
+     */
+    QHash<int, SpatialIndex> m_spatialIndexes;
+
+    /**
+     * Vertical limits of the airspace list and a flag, if they match the
+     * current list.
+     */
+    AirspaceLimitTable m_airspaceLimits;
+    bool m_airspaceLimitsValid;
+
+    /**
+     * The airspace sets of the loaded airspace files. The key is the name
+     * of the source file. The airspaceList is put together from them.
+     */
+    QMap<QString, AirspaceHelper::AirspaceSet> m_airspaceSets;
+
+    /** Generation of the airspace list. */
+    uint m_airspaceGeneration;
 
     /**
      * Array containing the used elevation levels in meters. Is used as help
@@ -19,6 +19,7 @@
 #include <cmath>
 
 #include <QtGlobal>
+#include <QVarLengthArray>
 
 #include "calculator.h"
 #include "mapcalc.h"
@@ -26,12 +27,6 @@
 #include "mapmatrix.h"
 #include "generalconfig.h"
 
-// Projektions-Massstab
-// 50 Meter Hoehe pro Pixel ist die staerkste Vergroesserung.
-// Bei dieser Vergroesserung erfolgt die eigentliche Projektion
-#define MAX_SCALE 50.0   // 40.0
-#define MIN_SCALE 2000.0 // 800.0
-
 #define NUM_TO_RAD(num) ( (M_PI / 108000000.0) * (double)(num) )
 #define RAD_TO_NUM(rad) ( ( (rad) * (108000000.0 / M_PI) ) )
 
@@ -71,7 +66,8 @@ MapMatrix::MapMatrix( QObject* parent ) :
   mapCenterLat(0), mapCenterLon(0),
   homeLat(0), homeLon(0), cScale(0), pScale(0), rotationArc(0),
   _MaxScaleToCScaleRatio(0),
-  m11(0), m12(0), m21(0), m22(0), dx(0), dy(0), fx(0), fy(0)
+  m11(0), m12(0), m21(0), m22(0), dx(0), dy(0), fx(0), fy(0),
+  projectionId(0)
 {
   viewBorder.setTop(32000000);
   viewBorder.setBottom(25000000);
@@ -174,6 +170,52 @@ QRect MapMatrix::wgsToMap(const QRect& rect) const
 }
 
 
+void MapMatrix::wgsToMap( const qint32* lat, const qint32* lon, const int count,
+                          qint32* x, qint32* y ) const
+{
+  currentProjection->projectPoints( lat, lon, count, RADIUS / MAX_SCALE, x, y );
+}
+
+
+void MapMatrix::wgsToMap( const QPolygon& wgsPolygon, QPolygon& projPolygon ) const
+{
+  const int count = wgsPolygon.size();
+
+  // Split the points into coordinate arrays for the projection kernels.
+  QVarLengthArray<qint32, 1024> lat( count );
+  QVarLengthArray<qint32, 1024> lon( count );
+  QVarLengthArray<qint32, 1024> x( count );
+  QVarLengthArray<qint32, 1024> y( count );
+
+  const QPoint* src = wgsPolygon.constData();
+
+  for( int i = 0; i < count; i++ )
+    {
+      lat[i] = src[i].x();
+      lon[i] = src[i].y();
+    }
+
+  wgsToMap( lat.constData(), lon.constData(), count, x.data(), y.data() );
+
+  projPolygon.resize( count );
+
+  QPoint* dst = projPolygon.data();
+  int n = 0;
+
+  for( int i = 0; i < count; i++ )
+    {
+      if( n == 0 || x[i] != dst[n - 1].x() || y[i] != dst[n - 1].y() )
+        {
+          dst[n].setX( x[i] );
+          dst[n].setY( y[i] );
+          n++;
+        }
+    }
+
+  projPolygon.resize( n );
+}
+
+
 QPoint MapMatrix::__mapToWgs(const QPoint& origPoint) const
 {
   return __mapToWgs(origPoint.x(), origPoint.y());
@@ -192,7 +234,10 @@ QPoint MapMatrix::__mapToWgs(int x, int y) const
 }
 
 
-bool MapMatrix::isVisible( const QRect& itemBorder, int typeID) const
+bool MapMatrix::isVisible( const QRect& area,
+                           const QRect& itemBorder,
+                           int typeID,
+                           double scale )
 {
   // Grenze: Nahe 15Bit
   // Vereinfachung kann zu Fehlern fuehren ...
@@ -215,10 +260,10 @@ bool MapMatrix::isVisible( const QRect& itemBorder, int typeID) const
       typeID == BaseMapElement::Canal ||
       typeID == BaseMapElement::Aerial_Cable )
     {
-      return ( mapBorder.intersects(itemBorder) );
+      return ( area.intersects(itemBorder) );
     }
 
-  if( mapBorder.intersects( itemBorder ) == false )
+  if( area.intersects( itemBorder ) == false )
     {
       return false;
     }
@@ -227,12 +272,12 @@ bool MapMatrix::isVisible( const QRect& itemBorder, int typeID) const
   int h = itemBorder.height();
 
   if( typeID == BaseMapElement::Isohypse &&
-      ( w*4 < cScale || h*4 < cScale ) )
+      ( w*4 < scale || h*4 < scale ) )
     {
       return false;
     }
 
-  if( w*8 < cScale || h*8 < cScale )
+  if( w*8 < scale || h*8 < scale )
     {
       return false;
     }
@@ -563,6 +608,8 @@ void MapMatrix::slotInitMatrix()
 
   if( projChanged || initChanged )
     {
+      // Mark all data derived from the old projection as outdated.
+      projectionId++;
       emit projectionChanged();
     }
 }
@@ -613,14 +660,19 @@ double MapMatrix::ensureVisible(const QPoint& point2Show, QPoint center )
  * should be drawn.
  */
 unsigned int MapMatrix::currentDrawScale() const
+{
+  return drawScaleOf( cScale );
+}
+
+unsigned int MapMatrix::drawScaleOf( const double scale )
 {
   //these numbers need to be made configurable at some point.
 
-  if (cScale <= 125)
+  if (scale <= 125)
     {
       return 0;
     }
-  else if (cScale <= 200 )
+  else if (scale <= 200 )
     {
       return 1;
     }
@@ -630,6 +682,20 @@ unsigned int MapMatrix::currentDrawScale() const
     }
 }
 
+double MapMatrix::drawScaleTolerance( const unsigned int drawScale )
+{
+  // Lower borders of the draw scale bands in meters per pixel. The lowest
+  // band is drawn with all points.
+  static const double borders[DrawScaleCount] = { 0.0, 125.0, 200.0 };
+
+  if( drawScale >= DrawScaleCount )
+    {
+      return borders[DrawScaleCount - 1] * 0.5;
+    }
+
+  return borders[drawScale] * 0.5;
+}
+
 /**
  * @returns an indication, if a waypoint can be drawn on the map according to the current
  * scale setting.
@@ -684,6 +750,11 @@ QPolygon MapMatrix::map(const QPolygon &a) const
   return worldMatrix.map(a);
 }
 
+void MapMatrix::map(const QPolygon &a, QPolygon &p) const
+{
+  p = worldMatrix.map(a);
+}
+
 QPoint MapMatrix::map(const QPoint& p) const
 {
   return worldMatrix.map(p);
@@ -694,7 +765,14 @@ QPoint MapMatrix::map(const QPoint& p) const
 // The new function using fixed point multiplication
 QPolygon MapMatrix::map(const QPolygon &a) const
 {
-  int size = a.size();
+  QPolygon p;
+  map( a, p );
+  return p;
+}
+
+void MapMatrix::map(const QPolygon &a, QPolygon &p) const
+{
+  const int size = a.size();
   int64_t fx;
   int64_t fy;
   int32_t curx;
@@ -702,13 +780,18 @@ QPolygon MapMatrix::map(const QPolygon &a) const
   int32_t lastx = 0;
   int32_t lasty = 0;
 
-  QPolygon p;
+  // The result is written in place and shrunk at the end, duplicate points
+  // are skipped in the same pass.
+  p.resize( size );
+
+  const QPoint* src = a.constData();
+  QPoint* dst = p.data();
+  int n = 0;
 
   for( int i = 0; i < size; i++ )
     {
-      a.point(i, &curx, &cury);
-      fx = itofp24p8( curx );
-      fy = itofp24p8( cury );
+      fx = itofp24p8( src[i].x() );
+      fy = itofp24p8( src[i].y() );
       // some cheating involved; multiplication with the "wrong" macro
       // after "left shifting" the "m" value in createMatrix
       curx = fp24p8toi( mulfp8p24(m11,fx) + mulfp8p24(m21,fy) + dx);
@@ -716,13 +799,15 @@ QPolygon MapMatrix::map(const QPolygon &a) const
 
       if ( (i==0) | ( ((curx - lastx) | (cury - lasty)) != 0) )
         {
-          p.append(QPoint(curx, cury));
+          dst[n].setX( curx );
+          dst[n].setY( cury );
+          n++;
           lastx = curx;
           lasty = cury;
         }
     }
 
-  return p;
+  p.resize( n );
 }
 
 QPoint MapMatrix::map(const QPoint& p) const
@@ -26,6 +26,12 @@
 typedef int32_t fp24p8_t;
 typedef int32_t fp8p24_t;
 
+// Projektions-Massstab
+// 50 Meter Hoehe pro Pixel ist die staerkste Vergroesserung.
+// Bei dieser Vergroesserung erfolgt die eigentliche Projektion
+#define MAX_SCALE 50.0   // 40.0
+#define MIN_SCALE 2000.0 // 800.0
+
 #include "projectionlambert.h"
 #include "projectioncylindric.h"
 #include "waypoint.h"
@@ -111,6 +117,29 @@ public:
    */
   QRect wgsToMap(const QRect& rect) const;
 
+  /**
+   * Converts arrays of geographic coordinates into the current
+   * map-projection in one pass.
+   *
+   * @param  lat    The latitudes in the internal format of 1/10.000 minutes.
+   * @param  lon    The longitudes in the internal format of 1/10.000 minutes.
+   * @param  count  The number of points.
+   * @param  x      Receives the projected x-values.
+   * @param  y      Receives the projected y-values.
+   */
+  void wgsToMap( const qint32* lat, const qint32* lon, const int count,
+                 qint32* x, qint32* y ) const;
+
+  /**
+   * Converts a polygon of geographic coordinates into a projected polygon.
+   * Consecutive identical points of the result are removed.
+   *
+   * @param  wgsPolygon  The points in the internal format of 1/10.000
+   *                     minutes, x is the latitude and y is the longitude.
+   * @param  projPolygon  Receives the projected polygon.
+   */
+  void wgsToMap( const QPolygon& wgsPolygon, QPolygon& projPolygon ) const;
+
   /**
    * Maps the given projected polygon into the current map-matrix.
    *
@@ -119,6 +148,17 @@ public:
    * @return the mapped polygon
    */
   QPolygon map(const QPolygon &pPolygon) const;
+
+  /**
+   * Maps the given projected polygon into the current map-matrix.
+   * Consecutive identical points of the result are removed. The memory
+   * of the result polygon is reused.
+   *
+   * @param  pPolygon  The polygon to be mapped
+   *
+   * @param  mPolygon  Receives the mapped polygon
+   */
+  void map(const QPolygon &pPolygon, QPolygon &mPolygon) const;
 #if 0
   {
     return worldMatrix.map(pPolygon);
@@ -219,7 +259,27 @@ public:
   /**
    * @return "true", if the given rectangle intersects with the current map.
    */
-  bool isVisible( const QRect& itemBorder, int typeID) const;
+  bool isVisible( const QRect& itemBorder, int typeID) const
+  {
+    return isVisible( mapBorder, itemBorder, typeID, cScale );
+  };
+
+  /**
+   * Checks, if an item is visible in the passed projected area at the
+   * passed scale. Can be used from other threads because no member is
+   * touched.
+   *
+   * @param area The projected area to be checked against.
+   * @param itemBorder The projected bounding box of the item.
+   * @param typeID The type of the item, see \ref BaseMapElement::objectType.
+   * @param scale The scale in meters per pixel.
+   *
+   * @return "true", if the item shall be drawn in the area.
+   */
+  static bool isVisible( const QRect& area,
+                         const QRect& itemBorder,
+                         int typeID,
+                         double scale );
 
   /** */
   enum MoveDirection {NotSet = 0, North = 1, West = 2, East = 4,
@@ -318,6 +378,24 @@ public:
    */
   unsigned int currentDrawScale() const;
 
+  /**
+   * Number of draw scale bands, see \ref currentDrawScale.
+   */
+  enum { DrawScaleCount = 3 };
+
+  /**
+   * @returns the draw scale band of the passed scale in meters per pixel,
+   * see \ref currentDrawScale.
+   */
+  static unsigned int drawScaleOf( const double scale );
+
+  /**
+   * @returns the simplification tolerance in meters of the line elements
+   * drawn in the passed draw scale band. That is half a pixel at the
+   * smallest scale of the band.
+   */
+  static double drawScaleTolerance( const unsigned int drawScale );
+
   /**
    * @returns an indication, if a waypoint can be drawn according to the current
    * scale setting.
@@ -359,6 +437,40 @@ public:
     return mapCenterAreaProj.intersects(r);
   };
 
+  /**
+   * @returns the current used transformation matrix
+   */
+  const QTransform& getWorldMatrix() const
+    {
+      return worldMatrix;
+    };
+
+  /**
+   * @returns the rotation arc of the current map matrix.
+   */
+  double getRotationArc() const
+    {
+      return rotationArc;
+    };
+
+  /**
+   * @returns the factor to scale projected coordinates to map pixels
+   * at the current scale.
+   */
+  double getProjectionScale() const
+    {
+      return MAX_SCALE / cScale;
+    };
+
+  /**
+   * @returns an identifier of the current projection settings. It is
+   * changed every time, when the projection is changed.
+   */
+  int getProjectionId() const
+    {
+      return projectionId;
+    };
+
   /**
    * @returns the current projection type
    */
@@ -491,6 +603,9 @@ public:
   /** Root path to the map directories */
   QString mapRootDir;
 
+  /** Identifier of the current projection settings. */
+  int projectionId;
+
 };
 
 #endif
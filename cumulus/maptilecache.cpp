@@ -0,0 +1,351 @@
+/***********************************************************************
+**
+**   maptilecache.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <QtCore>
+
+#include "maptilecache.h"
+
+// Number of spilled tiles in relation to the tiles in memory.
+#define SPILL_FACTOR 4
+
+MapTileCache::MapTileCache() :
+  m_stamp(0),
+  m_cost(0),
+  m_maxCost(24 * 1024 * 1024),
+  m_maxScales(4)
+{
+}
+
+MapTileCache::~MapTileCache()
+{
+  clear();
+}
+
+void MapTileCache::setMaxCost( int maxCost )
+{
+  m_maxCost = qMax( 0, maxCost );
+  trim();
+}
+
+void MapTileCache::setMaxScales( int maxScales )
+{
+  m_maxScales = qMax( 1, maxScales );
+
+  if( m_scales.size() > m_maxScales )
+    {
+      useScale( m_scales.first().first, m_scales.first().second );
+    }
+}
+
+void MapTileCache::setSpillDirectory( const QString& path )
+{
+  if( path == m_spillDir )
+    {
+      return;
+    }
+
+  // The tiles spilled to the old directory are lost. Tiles, which are
+  // just saved, are removed by spillFinished.
+  cleanSpillDirectory();
+  m_spilled.clear();
+  m_spilledLru.clear();
+  m_saving.clear();
+  m_spills.clear();
+
+  m_spillDir = path;
+
+  if( m_spillDir.isEmpty() )
+    {
+      return;
+    }
+
+  QDir dir;
+
+  if( dir.mkpath( m_spillDir ) == false )
+    {
+      qWarning() << "MapTileCache: Cannot create spill directory" << m_spillDir;
+      m_spillDir.clear();
+      return;
+    }
+
+  // Remove the tiles of a former session.
+  cleanSpillDirectory();
+}
+
+bool MapTileCache::find( const MapTileKey& key, QImage& image )
+{
+  QHash<MapTileKey, Entry>::iterator it = m_entries.find( key );
+
+  if( it != m_entries.end() )
+    {
+      // Move tile to the end of the LRU list.
+      m_lru.remove( it.value().stamp );
+      it.value().stamp = ++m_stamp;
+      m_lru.insert( m_stamp, key );
+
+      image = it.value().image;
+      return true;
+    }
+
+  QHash<MapTileKey, MapTileSpill>::iterator it1 = m_saving.find( key );
+
+  if( it1 == m_saving.end() )
+    {
+      return false;
+    }
+
+  // The tile is not yet saved and is taken back into memory. A running
+  // save is discarded by spillFinished.
+  image = it1.value().image;
+
+  insert( key, image );
+  return true;
+}
+
+void MapTileCache::insert( const MapTileKey& key, const QImage& image )
+{
+  remove( key );
+
+  Entry entry;
+  entry.image = image;
+  entry.stamp = ++m_stamp;
+
+  m_entries.insert( key, entry );
+  m_lru.insert( entry.stamp, key );
+  m_cost += image.byteCount();
+
+  trim();
+}
+
+void MapTileCache::remove( const MapTileKey& key )
+{
+  QHash<MapTileKey, Entry>::iterator it = m_entries.find( key );
+
+  if( it != m_entries.end() )
+    {
+      m_cost -= it.value().image.byteCount();
+      m_lru.remove( it.value().stamp );
+      m_entries.erase( it );
+    }
+
+  if( m_saving.remove( key ) > 0 )
+    {
+      for( int i = m_spills.size() - 1; i >= 0; i-- )
+        {
+          if( m_spills.at(i).key == key )
+            {
+              m_spills.removeAt(i);
+            }
+        }
+    }
+
+  if( m_spilled.contains( key ) )
+    {
+      removeSpilled( key );
+    }
+}
+
+void MapTileCache::clear()
+{
+  m_entries.clear();
+  m_lru.clear();
+  m_cost = 0;
+
+  m_saving.clear();
+  m_spills.clear();
+
+  QList<MapTileKey> spilled = m_spilled.keys();
+
+  for( int i = 0; i < spilled.size(); i++ )
+    {
+      removeSpilled( spilled.at(i) );
+    }
+}
+
+QList<MapTileKey> MapTileCache::keys() const
+{
+  return m_entries.keys() + m_saving.keys() + m_spilled.keys();
+}
+
+void MapTileCache::useScale( int projection, int scale )
+{
+  QPair<int, int> current( projection, scale );
+
+  m_scales.removeAll( current );
+  m_scales.prepend( current );
+
+  // Remove all scales of an older projection and the least recently used
+  // scales beyond the limit.
+  for( int i = m_scales.size() - 1; i > 0; i-- )
+    {
+      if( m_scales.at(i).first != projection || i >= m_maxScales )
+        {
+          m_scales.removeAt(i);
+        }
+    }
+
+  QList<MapTileKey> all = keys();
+
+  for( int i = 0; i < all.size(); i++ )
+    {
+      const MapTileKey& key = all.at(i);
+
+      if( m_scales.contains( qMakePair( key.projection, key.scale ) ) == false )
+        {
+          remove( key );
+        }
+    }
+}
+
+void MapTileCache::trim()
+{
+  while( m_cost > m_maxCost && m_lru.isEmpty() == false )
+    {
+      MapTileKey key = m_lru.begin().value();
+
+      QHash<MapTileKey, Entry>::iterator it = m_entries.find( key );
+
+      MapTileSpill spill;
+      spill.key   = key;
+      spill.stamp = it.value().stamp;
+      spill.image = it.value().image;
+
+      m_cost -= spill.image.byteCount();
+      m_lru.erase( m_lru.begin() );
+      m_entries.erase( it );
+
+      if( m_spillDir.isEmpty() == false )
+        {
+          // The stamp makes the file name unique, so that a former save of
+          // the same tile cannot overwrite it.
+          spill.fileName = spillFileName( key, spill.stamp );
+
+          m_saving.insert( key, spill );
+          m_spills.append( spill );
+        }
+    }
+}
+
+QList<MapTileSpill> MapTileCache::takeSpills()
+{
+  QList<MapTileSpill> spills = m_spills;
+  m_spills.clear();
+  return spills;
+}
+
+void MapTileCache::spillFinished( const MapTileSpill& spill, bool ok )
+{
+  QHash<MapTileKey, MapTileSpill>::iterator it = m_saving.find( spill.key );
+
+  if( it == m_saving.end() || it.value().stamp != spill.stamp )
+    {
+      // The tile was used or removed during the save.
+      if( ok )
+        {
+          QFile::remove( spill.fileName );
+        }
+
+      return;
+    }
+
+  m_saving.erase( it );
+
+  if( ok == false )
+    {
+      return;
+    }
+
+  m_spilled.insert( spill.key, spill.stamp );
+  m_spilledLru.insert( spill.stamp, spill.key );
+
+  // Limit the number of tiles on disk.
+  const int maxSpilled = qMax( 1, SPILL_FACTOR * (m_maxCost / qMax( 1, spill.image.byteCount() )) );
+
+  while( m_spilled.size() > maxSpilled )
+    {
+      removeSpilled( m_spilledLru.begin().value() );
+    }
+}
+
+bool MapTileCache::saveSpill( const MapTileSpill& spill )
+{
+  if( spill.image.save( spill.fileName, "PNG" ) == false )
+    {
+      qWarning() << "MapTileCache: Cannot save tile" << spill.fileName;
+      return false;
+    }
+
+  return true;
+}
+
+QImage MapTileCache::loadSpill( const QString& fileName )
+{
+  QImage image;
+
+  if( image.load( fileName, "PNG" ) == false )
+    {
+      qWarning() << "MapTileCache: Cannot load tile" << fileName;
+      return QImage();
+    }
+
+  if( image.format() != QImage::Format_RGB32 )
+    {
+      image = image.convertToFormat( QImage::Format_RGB32 );
+    }
+
+  return image;
+}
+
+void MapTileCache::removeSpilled( const MapTileKey& key )
+{
+  QHash<MapTileKey, quint64>::iterator it = m_spilled.find( key );
+
+  if( it == m_spilled.end() )
+    {
+      return;
+    }
+
+  QFile::remove( spillFileName( key, it.value() ) );
+
+  m_spilledLru.remove( it.value() );
+  m_spilled.erase( it );
+}
+
+QString MapTileCache::spillFileName( const MapTileKey& key, quint64 stamp ) const
+{
+  return m_spillDir + QString( "/tile_%1_%2_%3_%4_%5.png" )
+                      .arg( key.projection )
+                      .arg( key.scale )
+                      .arg( key.x )
+                      .arg( key.y )
+                      .arg( stamp );
+}
+
+void MapTileCache::cleanSpillDirectory()
+{
+  if( m_spillDir.isEmpty() )
+    {
+      return;
+    }
+
+  QDir dir( m_spillDir );
+
+  QStringList files = dir.entryList( QStringList( "tile_*.png" ), QDir::Files );
+
+  for( int i = 0; i < files.size(); i++ )
+    {
+      dir.remove( files.at(i) );
+    }
+}
@@ -0,0 +1,297 @@
+/***********************************************************************
+**
+**   maptilecache.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class MapTileCache
+ *
+ * \author agent
+ *
+ * \brief Memory bounded LRU cache of rendered map tiles.
+ *
+ * The cache keeps the rendered base map tiles of the last used map scales.
+ * The memory usage is limited by the sum of the image sizes. If the limit
+ * is exceeded, the least recently used tiles are removed. Optionally the
+ * removed tiles are saved as PNG files in a spill directory and are loaded
+ * again from there on demand.
+ *
+ * The cache does no file I/O itself, because the PNG coding is too slow
+ * for the GUI thread. The removed tiles are handed over by \ref takeSpills
+ * and the owner saves them in a worker thread with \ref saveSpill. A
+ * spilled tile is not found by \ref find. The owner checks it with
+ * \ref isSpilled and loads it with \ref loadSpill in a worker thread.
+ *
+ * The tile keys contain runtime identifiers of the projection. Therefore
+ * the spilled tiles are only valid during the current session and the
+ * spill directory is cleaned up, when it is assigned.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef MAP_TILE_CACHE_H
+#define MAP_TILE_CACHE_H
+
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QString>
+
+/**
+ * Key of a map tile.
+ */
+class MapTileKey
+{
+ public:
+
+  MapTileKey() : projection(0), scale(0), x(0), y(0) {};
+
+  MapTileKey( int projectionIn, int scaleIn, int xIn, int yIn ) :
+    projection(projectionIn), scale(scaleIn), x(xIn), y(yIn) {};
+
+  bool operator==( const MapTileKey& other ) const
+    {
+      return ( x == other.x && y == other.y && scale == other.scale &&
+               projection == other.projection );
+    };
+
+  /** Identifier of the used projection, see \ref MapMatrix::getProjectionId. */
+  int projection;
+
+  /** Map scale in meters per pixel. */
+  int scale;
+
+  /** Tile column in the scaled projected coordinate system. */
+  int x;
+
+  /** Tile row in the scaled projected coordinate system. */
+  int y;
+};
+
+inline uint qHash( const MapTileKey& key )
+{
+  return ( uint(key.x) * 73856093U ) ^ ( uint(key.y) * 19349663U ) ^
+         ( uint(key.scale) * 83492791U ) ^ uint(key.projection);
+}
+
+/**
+ * A tile removed from the memory cache, which shall be saved to disk.
+ */
+class MapTileSpill
+{
+ public:
+
+  MapTileSpill() : stamp(0) {};
+
+  MapTileKey key;
+
+  /** Usage stamp of the tile, makes the file name unique. */
+  quint64 stamp;
+
+  /** File, into which the tile shall be saved. */
+  QString fileName;
+
+  QImage image;
+};
+
+class MapTileCache
+{
+ public:
+
+  MapTileCache();
+
+  virtual ~MapTileCache();
+
+  /**
+   * Sets the maximum memory size of all cached tiles in bytes.
+   */
+  void setMaxCost( int maxCost );
+
+  /**
+   * Sets the maximum number of scales, which are kept in the cache.
+   */
+  void setMaxScales( int maxScales );
+
+  /**
+   * Sets the directory used to spill tiles to disk. All tile files in this
+   * directory are removed. An empty path switches off the spilling.
+   */
+  void setSpillDirectory( const QString& path );
+
+  /**
+   * Looks up a tile in memory. Spilled tiles are not loaded, see
+   * \ref isSpilled.
+   *
+   * \param key The key of the tile.
+   *
+   * \param image The found tile image.
+   *
+   * \return True, if the tile was found.
+   */
+  bool find( const MapTileKey& key, QImage& image );
+
+  /**
+   * \return True, if the tile is available in the spill directory.
+   */
+  bool isSpilled( const MapTileKey& key ) const
+  {
+    return m_spilled.contains( key );
+  };
+
+  /**
+   * \return The file name of a spilled tile.
+   */
+  QString spillFileName( const MapTileKey& key ) const
+  {
+    return spillFileName( key, m_spilled.value( key, 0 ) );
+  };
+
+  /**
+   * Returns the removed tiles, which shall be saved to disk. For every
+   * tile \ref spillFinished must be called, when it is saved.
+   */
+  QList<MapTileSpill> takeSpills();
+
+  /**
+   * Registers a saved tile. A tile, which was used or removed meanwhile,
+   * is deleted from disk.
+   *
+   * \param spill The saved tile.
+   *
+   * \param ok False, if the tile could not be saved.
+   */
+  void spillFinished( const MapTileSpill& spill, bool ok );
+
+  /**
+   * Saves a tile to disk. Can be called in any thread.
+   */
+  static bool saveSpill( const MapTileSpill& spill );
+
+  /**
+   * Loads a spilled tile from disk. Can be called in any thread.
+   *
+   * \return A null image, if the tile could not be loaded.
+   */
+  static QImage loadSpill( const QString& fileName );
+
+  /**
+   * Inserts a tile into the cache. If the memory limit is exceeded, least
+   * recently used tiles are removed.
+   */
+  void insert( const MapTileKey& key, const QImage& image );
+
+  /**
+   * Removes a tile from memory and disk.
+   */
+  void remove( const MapTileKey& key );
+
+  /**
+   * Removes all tiles from memory and disk.
+   */
+  void clear();
+
+  /**
+   * Returns the keys of all cached tiles in memory and on disk.
+   */
+  QList<MapTileKey> keys() const;
+
+  /**
+   * Marks the passed scale as the recently used one. All tiles of other
+   * projections and of scales, which are not under the last used ones,
+   * are removed.
+   */
+  void useScale( int projection, int scale );
+
+  /**
+   * Returns the maximum memory size of all cached tiles in bytes.
+   */
+  int maxCost() const
+  {
+    return m_maxCost;
+  };
+
+  /**
+   * Returns the memory size of all cached tiles in bytes.
+   */
+  int cost() const
+  {
+    return m_cost;
+  };
+
+ private:
+
+  /** Removes least recently used tiles until the memory limit is kept. */
+  void trim();
+
+  /** Removes a spilled tile from disk. */
+  void removeSpilled( const MapTileKey& key );
+
+  /** Returns the file name of a spilled tile with the passed stamp. */
+  QString spillFileName( const MapTileKey& key, quint64 stamp ) const;
+
+  /** Removes all tile files from the spill directory. */
+  void cleanSpillDirectory();
+
+  class Entry
+  {
+   public:
+
+    QImage  image;
+    quint64 stamp;
+  };
+
+  /** Tiles in memory. */
+  QHash<MapTileKey, Entry> m_entries;
+
+  /** Tiles in memory ordered by their last usage. */
+  QMap<quint64, MapTileKey> m_lru;
+
+  /** Spilled tiles with their usage stamp. */
+  QHash<MapTileKey, quint64> m_spilled;
+
+  /** Spilled tiles ordered by their last usage. */
+  QMap<quint64, MapTileKey> m_spilledLru;
+
+  /**
+   * Removed tiles, which are not yet saved. They are still found by
+   * \ref find.
+   */
+  QHash<MapTileKey, MapTileSpill> m_saving;
+
+  /** Removed tiles, which are not yet handed over by \ref takeSpills. */
+  QList<MapTileSpill> m_spills;
+
+  /** Last used scales as pair of projection and scale, latest first. */
+  QList<QPair<int, int> > m_scales;
+
+  /** Usage counter. */
+  quint64 m_stamp;
+
+  /** Memory size of all tiles in bytes. */
+  int m_cost;
+
+  /** Maximum memory size of all tiles in bytes. */
+  int m_maxCost;
+
+  /** Maximum number of cached scales. */
+  int m_maxScales;
+
+  /** Spill directory, empty if spilling is switched off. */
+  QString m_spillDir;
+};
+
+#endif
@@ -0,0 +1,1423 @@
+/***********************************************************************
+**
+**   maptileloaderthread.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <csignal>
+#include <unistd.h>
+
+#include <QtCore>
+
+#include "basemapelement.h"
+#include "filetools.h"
+#include "mapcalc.h"
+#include "mapcontents.h"
+#include "mapmatrix.h"
+#include "maptileloaderthread.h"
+#include "projectionbase.h"
+#include "resource.h"
+#include "wgspoint.h"
+
+#define FILE_FORMAT_ID 100 // used to handle a previous version
+
+#define READ_POINT_LIST\
+  in >> locLength;\
+  all.resize(locLength);\
+  for(uint i = 0; i < locLength; i++) { \
+    in >> lat_temp; \
+    in >> lon_temp; \
+    all.setPoint(i, lat_temp, lon_temp); \
+  }
+
+MapTileLoaderThread::MapTileLoaderThread( QObject *parent,
+                                          const QHash<short, uchar>& isoHash ) :
+  QThread( parent ),
+  m_isoHash(isoHash),
+  m_stop(false)
+{
+  setObjectName( "MapTileLoaderThread" );
+}
+
+MapTileLoaderThread::~MapTileLoaderThread()
+{
+  stop();
+}
+
+void MapTileLoaderThread::setRequests( const QList<MapTileRequest>& requests )
+{
+  QMutexLocker locker( &m_mutex );
+
+  m_requests = requests;
+  qStableSort( m_requests );
+
+  if( ! m_requests.isEmpty() )
+    {
+      m_condition.wakeOne();
+    }
+}
+
+void MapTileLoaderThread::stop()
+{
+  m_mutex.lock();
+  m_stop = true;
+  m_requests.clear();
+  m_condition.wakeOne();
+  m_mutex.unlock();
+
+  wait();
+}
+
+void MapTileLoaderThread::run()
+{
+  sigset_t sigset;
+  sigfillset( &sigset );
+
+  // deactivate all signals in this thread
+  pthread_sigmask( SIG_SETMASK, &sigset, 0 );
+
+  // Check if signal is connected to a slot.
+  if( receivers( SIGNAL( tileLoaded( MapTile* )) ) == 0 )
+    {
+      qWarning() << "MapTileLoaderThread: No Slot connection to Signal tileLoaded!";
+      return;
+    }
+
+  while( true )
+    {
+      MapTileRequest request;
+
+      m_mutex.lock();
+
+      while( m_stop == false && m_requests.isEmpty() )
+        {
+          m_condition.wait( &m_mutex );
+        }
+
+      if( m_stop )
+        {
+          m_mutex.unlock();
+          return;
+        }
+
+      request = m_requests.takeFirst();
+      m_mutex.unlock();
+
+      MapTile* tile = new MapTile;
+
+      tile->secID      = request.secID;
+      tile->fileTypeID = request.fileTypeID;
+      tile->generation = request.generation;
+
+      m_settings = request.settings;
+
+      QTime t;
+      t.start();
+
+      if( request.fileTypeID == FILE_TYPE_MAP )
+        {
+          readBinaryFile( *tile );
+        }
+      else
+        {
+          readTerrainFile( *tile );
+        }
+
+      qDebug( "MapTileLoaderThread: Tile %c_%.5d loaded in %dms",
+              request.fileTypeID, request.secID, t.elapsed() );
+
+      /* It is expected that a receiver slot is connected to this signal. The
+       * receiver is responsible to delete the passed tile. Otherwise a big
+       * memory leak will occur.
+       */
+      emit tileLoaded( tile );
+    }
+}
+
+/**
+ * This method reads in the ground and terrain files from the original
+ * kflog source or from the own compiled source. Compiled sources are
+ * created from the original kflog source to have a faster access to the
+ * single data items.
+ *
+ * Ground files describe the surface at level 0m. They are always read in.
+ * Terrain files describe the surface above level 0m. If isoline drawing
+ * is switched off, terrain files are never read in.
+ *
+ * Thanks to Josua Dietze for his contribution of precomputed map files.
+ *
+ */
+bool MapTileLoaderThread::readTerrainFile( MapTile& tile )
+{
+  const int fileSecID = tile.secID;
+  const int fileTypeID = tile.fileTypeID;
+  bool kflExists, kfcExists;
+  bool compiling = false;
+
+  if ( fileTypeID != FILE_TYPE_TERRAIN && fileTypeID != FILE_TYPE_GROUND )
+    {
+      qWarning( "Requested terrain file type 0x%X is unsupported!", fileTypeID );
+      return false;
+    }
+
+  // First check if we need to load terrain files.
+  if ( fileTypeID == FILE_TYPE_TERRAIN &&
+       ( !m_settings.loadIsoLines ))
+    {
+      // loading of terrain files is switched off by the user
+      tile.result = MapTile::Loaded;
+      return true;
+    }
+
+  QString kflPathName, kfcPathName, pathName;
+  QString kflName, kfcName;
+
+  kflName.sprintf("%c_%.5d.kfl", fileTypeID, fileSecID);
+  kflExists = MapContents::locateFile("landscape/" + kflName, kflPathName,
+                                      m_settings.mapDirectories);
+
+  kfcName.sprintf("landscape/%c_%.5d.kfc", fileTypeID, fileSecID);
+  kfcExists = MapContents::locateFile(kfcName, kfcPathName,
+                                      m_settings.mapDirectories);
+
+  if ( ! (kflExists || kfcExists) )
+    {
+      // The download of the missing file is offered in the GUI thread.
+      tile.result = MapTile::Missing;
+      return false;
+    }
+
+  if ( kflExists )
+    {
+      if ( kfcExists )
+        {
+          // kfl file newer than kfc ? Then compile it
+          if (MapContents::getDateFromMapFile( kflPathName ) > MapContents::getDateFromMapFile( kfcPathName ))
+            {
+              compiling = true;
+              qDebug("Map file %s has a newer date! Recompiling it from source.",
+                     kflPathName.toLatin1().data() );
+            }
+        }
+      else
+        {
+          // no kfc file, we compile anyway
+          compiling = true;
+        }
+    }
+
+  // what file do we read after all ?
+  if ( compiling )
+    {
+      pathName = kflPathName;
+      kfcPathName = kflPathName;
+      kfcPathName.replace( kfcPathName.length()-1, 1, QString("c") );
+    }
+  else
+    {
+      pathName = kfcPathName;
+      kflPathName = kfcPathName;
+      kflPathName.replace( kflPathName.length()-1, 1, QString("l") );
+    }
+
+  QFile mapfile(pathName);
+
+  if( mapfile.size() == 0 )
+    {
+      // qWarning() << "Map file" << pathName << "is empty!";
+
+      if( ! compiling )
+	{
+	  // Remove corrupted compiled file
+	  mapfile.remove();
+	}
+
+      return false;
+    }
+
+  if ( !mapfile.open(QIODevice::ReadOnly) )
+    {
+      qWarning("Can't open map file %s for reading", pathName.toLatin1().data() );
+
+      if ( ! compiling && kflExists )
+        {
+          qDebug("Try to use file %s", kflPathName.toLatin1().data());
+          // try to remove unopenable file, not sure if this works.
+          mapfile.remove();
+          return readTerrainFile( tile );
+        }
+
+      return false;
+    }
+
+  emit loadingFile(pathName);
+
+  QDataStream in(&mapfile);
+
+  if( compiling )
+    {
+      in.setVersion(QDataStream::Qt_3_3);
+    }
+  else
+    {
+      in.setVersion(QDataStream::Qt_4_7);
+    }
+
+  // qDebug("reading file %s", pathName.toLatin1().data());
+
+  qint8 loadTypeID;
+  quint16 loadSecID, formatID;
+  quint32 magic;
+  QDateTime createDateTime;
+
+  in >> magic;
+  in >> loadTypeID;
+  in >> formatID;
+  in >> loadSecID;
+  in >> createDateTime;
+
+  if( in.status() != QDataStream::Ok )
+    {
+      qWarning() << "Data stream status of" << pathName
+	         << "is NOK! Status=" << in.status();
+      mapfile.close();
+
+      if( ! compiling )
+	{
+	  // Remove corrupted compiled file
+	  unlink( pathName.toLatin1().data() );
+	}
+
+      return false;
+    }
+
+  if ( magic != KFLOG_FILE_MAGIC )
+    {
+      mapfile.close();
+
+      if ( ! compiling && kflExists )
+        {
+          qWarning("Wrong magic key %x read!\n Retry to compile %s.",
+                   magic, kflPathName.toLatin1().data());
+          mapfile.remove();
+          return readTerrainFile( tile );
+        }
+
+      qWarning( "Wrong magic key %x read from %s! Removing content.",
+                 magic, pathName.toLatin1().data() );
+      // Some map file does not exists on the server. But if they have
+      // been downloaded, the map server has sent some http page content.
+      // That content makes no sense, therefore the map file content is cleared.
+      mapfile.open( QIODevice::WriteOnly|QIODevice::Truncate );
+      mapfile.close();
+      return false;
+    }
+
+  if (loadTypeID != fileTypeID) // wrong type
+    {
+      mapfile.close();
+
+      if ( ! compiling && kflExists )
+        {
+          qWarning("Wrong load type identifier %x read! "
+                   "Retry to compile %s",
+                   loadTypeID, kflPathName.toLatin1().data() );
+          mapfile.remove();
+          return readTerrainFile( tile );
+        }
+
+      qWarning("%s wrong load type identifier %x read! ",
+                pathName.toLatin1().data(), loadTypeID );
+
+      return false;
+    }
+
+  // Determine, which file format id is expected
+  int expFormatID, expComFormatID, projectedFormatID;
+
+  if ( fileTypeID == FILE_TYPE_TERRAIN )
+    {
+      expFormatID = FILE_VERSION_TERRAIN;
+      expComFormatID = FILE_VERSION_TERRAIN_C;
+      projectedFormatID = FILE_VERSION_TERRAIN_PROJECTED_C;
+    }
+  else
+    {
+      expFormatID = FILE_VERSION_GROUND;
+      expComFormatID = FILE_VERSION_GROUND_C;
+      projectedFormatID = FILE_VERSION_GROUND_PROJECTED_C;
+    }
+
+  QFileInfo fi( pathName );
+
+  qDebug("Reading File=%s, Magic=0x%x, TypeId=%c, formatId=%d, Date=%s",
+         fi.fileName().toLatin1().data(), magic, loadTypeID, formatID,
+         createDateTime.toString(Qt::ISODate).toLatin1().data() );
+
+  if ( compiling )
+    {
+      // Check map file
+      if ( formatID < expFormatID )
+        {
+          // too old ...
+          qWarning("File format too old! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, expFormatID );
+          return false;
+        }
+      else if (formatID > expFormatID )
+        {
+          // too new ...
+          qWarning("File format too new! (version %d, expecting: %d) "
+                   "Aborting ...", formatID,expFormatID );
+          return false;
+        }
+    }
+  else
+    {
+      // Check compiled file
+      if ( formatID < expComFormatID )
+        {
+          // too old ...
+          if ( kflExists )
+            {
+              qWarning("File format too old! (version %d, expecting: %d) "
+                       "Retry to compile %s",
+                       formatID, expComFormatID, kflPathName.toLatin1().data() );
+              mapfile.close();
+              unlink( pathName.toLatin1().data() );
+              return readTerrainFile( tile );
+            }
+
+          if ( formatID == projectedFormatID )
+            {
+              // The file contains projected coordinates. It is converted,
+              // because it cannot be compiled again.
+              mapfile.close();
+
+              if ( convertProjectedFile( pathName ) )
+                {
+                  return readTerrainFile( tile );
+                }
+            }
+
+          qWarning("File format too old! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, expComFormatID );
+          return false;
+        }
+      else if (formatID > expComFormatID )
+        {
+          // too new ...
+          if ( kflExists )
+            {
+              qWarning( "File format too new! (version %d, expecting: %d) "
+                        "Retry to compile %s",
+                        formatID, expComFormatID, kflPathName.toLatin1().data() );
+              mapfile.close();
+              unlink( pathName.toLatin1().data() );
+              return readTerrainFile( tile );
+            }
+
+          qWarning("File format too new! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, expFormatID );
+          return false;
+        }
+    }
+
+  if ( loadSecID != fileSecID )
+    {
+      if ( ! compiling && kflExists )
+        {
+          qWarning( "%s: wrong section, bogus file name!"
+                    "\n Retry to compile %s",
+                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
+          mapfile.close();
+          unlink( pathName.toLatin1().data() );
+          return readTerrainFile( tile );
+        }
+
+      qWarning("%s: wrong section, bogus file name! Arborting ...",
+               pathName.toLatin1().data() );
+      return false;
+    }
+
+  if ( compiling )
+    {
+      // Convert the isolines into the compiled format. The compiled file
+      // gets a time one second later than the time of the original file.
+      CompiledMapWriter writer( loadTypeID, quint16(expComFormatID), loadSecID,
+                                createDateTime.addSecs(1) );
+
+      qDebug("Writing file %s", kfcPathName.toLatin1().data());
+
+      QPolygon wgsIsoline;
+
+      while ( !in.atEnd() )
+        {
+          qint16 elevation;
+          qint32 pointNumber, lat, lon;
+
+          in >> elevation;
+          in >> pointNumber;
+
+          wgsIsoline.resize( 0 );
+
+          for (int i = 0; i < pointNumber; i++)
+            {
+              in >> lat;
+              in >> lon;
+
+              // Skip repeated points.
+              if( wgsIsoline.isEmpty() ||
+                  wgsIsoline.at( wgsIsoline.size() - 1 ) != QPoint( lat, lon ) )
+                {
+                  wgsIsoline.append( QPoint( lat, lon ) );
+                }
+            }
+
+          // Check, if first point and last point of the isoline identical. In this
+          // case we can remove the last point and repeat the check.
+          while( wgsIsoline.size() > 1 &&
+                 wgsIsoline.at(0) == wgsIsoline.at( wgsIsoline.size() - 1 ) )
+            {
+              wgsIsoline.remove( wgsIsoline.size() - 1 );
+            }
+
+          if( wgsIsoline.size() < 3)
+            {
+              // ignore to small isolines
+              qWarning( "Isoline Tile=%d, elevation=%dm has to less points!",
+                         loadSecID, elevation );
+              continue;
+            }
+
+          writer.addRecord( CompiledMapFile::Isohypses, BaseMapElement::Isohypse,
+                            0, elevation, QString(), wgsIsoline );
+        }
+
+      mapfile.close();
+
+      if( ! writer.save( kfcPathName ) )
+        {
+          return false;
+        }
+    }
+  else
+    {
+      mapfile.close();
+    }
+
+  // The compiled file is mapped into memory, only the isolines are read.
+  CompiledMapFile compiledFile;
+
+  if( ! compiledFile.open( kfcPathName, loadTypeID, quint16(expComFormatID), fileSecID ) )
+    {
+      if ( ! compiling && kflExists )
+        {
+          qWarning( "%s is corrupted!\n Retry to compile %s",
+                    kfcPathName.toLatin1().data(), kflPathName.toLatin1().data() );
+          unlink( kfcPathName.toLatin1().data() );
+          return readTerrainFile( tile );
+        }
+
+      qWarning( "Can't read compiled map file %s! Aborting ...",
+                kfcPathName.toLatin1().data() );
+      return false;
+    }
+
+  // The elevation raster is stored beside the compiled file. It is marked
+  // with the creation date of the compiled file.
+  QString rasterPathName = ElevationRaster::rasterFileName( kfcPathName );
+  QDateTime rasterDateTime = compiledFile.getCreateDateTime();
+  ElevationRaster raster;
+  bool buildRaster = compiling;
+
+  if( ! compiling &&
+      ! raster.load( rasterPathName, fileSecID, fileTypeID, rasterDateTime ) )
+    {
+      // Raster file is missing or outdated, create it from the isolines.
+      qDebug( "Creating elevation raster %s", rasterPathName.toLatin1().data() );
+      buildRaster = true;
+    }
+
+  if( buildRaster )
+    {
+      raster = ElevationRaster( fileSecID );
+    }
+
+  // The isoline list contains all isolines of a tile in ascending order.
+  QList<Isohypse>& isoList = tile.isoList;
+
+  CompiledMapFile::Record record;
+
+  compiledFile.seek( CompiledMapFile::Isohypses );
+
+  while( compiledFile.next( record ) )
+    {
+      // determine elevation index, 0 is returned as default for not existing values
+      uchar elevationIdx = m_isoHash.value( record.value, 0 );
+
+      if( buildRaster )
+        {
+          raster.fillPolygon( record.wgsPolygon, elevationIdx );
+        }
+
+      // The isohypse is projected, when it is drawn.
+      Isohypse newItem( QPolygon(), record.value, elevationIdx, fileSecID, fileTypeID );
+      newItem.setWgsPolygon( record.wgsPolygon, record.detailPolygons );
+
+      isoList.append( newItem );
+    }
+
+  compiledFile.close();
+
+  if( buildRaster )
+    {
+      raster.save( rasterPathName, fileTypeID, rasterDateTime );
+    }
+
+  tile.raster = raster;
+  tile.result = MapTile::Loaded;
+  return true;
+}
+
+bool MapTileLoaderThread::readBinaryFile( MapTile& tile )
+{
+  const int fileSecID = tile.secID;
+  const char fileTypeID = tile.fileTypeID;
+  bool kflExists, kfcExists;
+  bool compiling = false;
+
+  QString kflPathName, kfcPathName, pathName;
+  QString kflName, kfcName;
+
+  kflName.sprintf("%c_%.5d.kfl", fileTypeID, fileSecID);
+  kflExists = MapContents::locateFile("landscape/" + kflName, kflPathName,
+                                      m_settings.mapDirectories);
+
+  kfcName.sprintf("landscape/%c_%.5d.kfc", fileTypeID, fileSecID);
+  kfcExists = MapContents::locateFile(kfcName, kfcPathName,
+                                      m_settings.mapDirectories);
+
+  if ( ! (kflExists || kfcExists) )
+    {
+      // The download of the missing file is offered in the GUI thread.
+      tile.result = MapTile::Missing;
+      return false;
+    }
+
+  if ( kflExists )
+    {
+      if ( kfcExists )
+        // kfl file newer than kfc ? Then compile it
+        {
+          if ( MapContents::getDateFromMapFile( kflPathName ) > MapContents::getDateFromMapFile( kfcPathName ) )
+            {
+              compiling = true;
+              qDebug("Map file %s has a newer date! Recompiling it from source.",
+                     kflPathName.toLatin1().data() );
+            }
+        }
+      else
+        {
+          // no kfc file, we compile anyway
+          compiling = true;
+        }
+    }
+
+  // what file do we read after all ?
+  if ( compiling )
+    {
+      pathName = kflPathName;
+      kfcPathName = kflPathName;
+      kfcPathName.replace( kfcPathName.length()-1, 1, QString("c") );
+    }
+  else
+    {
+      pathName = kfcPathName;
+      kflPathName = kfcPathName;
+      kflPathName.replace( kflPathName.length()-1, 1, QString("l") );
+    }
+
+  QFile mapfile(pathName);
+
+  if( mapfile.size() == 0 )
+    {
+      // qWarning() << "Map file" << pathName << "is empty!";
+
+      if( ! compiling )
+	{
+	  // Remove corrupted compiled file
+	  mapfile.remove();
+	}
+
+      return false;
+    }
+
+  if (!mapfile.open(QIODevice::ReadOnly))
+    {
+      if ( ! compiling && kflExists )
+        {
+          qDebug("Can't open map file %s for reading!"
+                 " Try to use file %s",
+                 pathName.toLatin1().data(), kflPathName.toLatin1().data());
+          // try to remove unopenable file, not sure if this works.
+          mapfile.remove();
+          return readBinaryFile( tile );
+        }
+
+      qWarning("Can't open map file %s for reading! Aborting ...",
+               pathName.toLatin1().data() );
+      return false;
+    }
+
+  emit loadingFile(pathName);
+
+  QDataStream in(&mapfile);
+
+  if( compiling )
+    {
+      in.setVersion( QDataStream::Qt_2_0 );
+    }
+  else
+    {
+      in.setVersion( QDataStream::Qt_4_7 );
+    }
+
+  // qDebug("reading file %s", pathName.toLatin1().data());
+
+  qint8 loadTypeID;
+  quint16 loadSecID, formatID;
+  quint32 magic;
+  QDateTime createDateTime;
+
+  in >> magic;
+
+  if ( magic != KFLOG_FILE_MAGIC )
+    {
+      mapfile.close();
+
+      if ( ! compiling && kflExists )
+        {
+          qWarning("Wrong magic key %x read!\n Retry to compile %s.",
+                   magic, kflPathName.toLatin1().data());
+
+          mapfile.remove();
+          return readBinaryFile( tile );
+        }
+
+      qWarning( "Wrong magic key %x read from %s! Removing content.",
+                 magic, pathName.toLatin1().data() );
+      // Some map file does not exists on the server. But if they have
+      // been downloaded, the map server has sent some http page content.
+      // That content makes no sense, therefore the map file content is cleared.
+      mapfile.open( QIODevice::WriteOnly|QIODevice::Truncate );
+      mapfile.close();
+      return false;
+    }
+
+  in >> loadTypeID;
+
+  /** Originally, the binary files were mend to come in different flavors.
+   * Now, they are all of type 'm'. Use that fact to do check for the
+   * compiled or the uncompiled version. */
+  if (compiling)
+    {
+      // uncompiled maps have a different format identifier than compiled
+      // maps
+      if (loadTypeID != FILE_TYPE_MAP)
+        {
+          qWarning("Wrong load type identifier %x read! Aborting ...",
+                   loadTypeID );
+          mapfile.close();
+          return false;
+        }
+    }
+  else
+    {
+      if ( loadTypeID != FILE_TYPE_MAP_C) // wrong type
+        {
+          mapfile.close();
+
+          if ( kflExists )
+            {
+              qWarning("Wrong load type identifier %x read! "
+                       "Retry to compile %s",
+                       loadTypeID, kflPathName.toLatin1().data() );
+              mapfile.remove();
+              return readBinaryFile( tile );
+            }
+
+          qWarning("%s wrong load type identifier %x read!",
+                   pathName.toLatin1().data(), loadTypeID );
+          return false;
+        }
+    }
+
+  // Check the version of the subtype. This can be different for the
+  // compiled and the uncompiled version.
+  in >> formatID;
+  in >> loadSecID;
+  in >> createDateTime;
+
+  if( in.status() != QDataStream::Ok )
+    {
+      qWarning() << "Data stream status of" << pathName
+	         << "is NOK! Status=" << in.status();
+      mapfile.close();
+
+      if( ! compiling )
+	{
+	  // Remove corrupted compiled file
+	  unlink( pathName.toLatin1().data() );
+	}
+
+      return false;
+    }
+
+  QFileInfo fi( pathName );
+
+  qDebug("Reading File=%s, Magic=0x%x, TypeId=%c, FormatId=%d, Date=%s",
+         fi.fileName().toLatin1().data(), magic, loadTypeID, formatID,
+         createDateTime.toString(Qt::ISODate).toLatin1().data() );
+
+  if (compiling)
+    {
+      if ( formatID < FILE_VERSION_MAP)
+        {
+          // to old ...
+          qWarning("File format too old! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, FILE_VERSION_MAP );
+          mapfile.close();
+          return false;
+        }
+      else if (formatID > FILE_VERSION_MAP)
+        {
+          // to new ...
+          qWarning("File format too new! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, FILE_VERSION_MAP );
+          mapfile.close();
+          return false;
+        }
+    }
+  else
+    {
+      if ( formatID < FILE_VERSION_MAP_C)
+        {
+          // to old ...
+          mapfile.close();
+
+          if ( kflExists )
+            {
+              qWarning("File format too old! (version %d, expecting: %d) "
+                       "Retry to compile %s",
+                       formatID, FILE_VERSION_MAP_C, kflPathName.toLatin1().data() );
+              unlink( pathName.toLatin1().data() );
+              return readBinaryFile( tile );
+            }
+
+          if ( formatID == FILE_VERSION_MAP_PROJECTED_C )
+            {
+              // The file contains projected coordinates. It is converted,
+              // because it cannot be compiled again.
+              if ( convertProjectedFile( pathName ) )
+                {
+                  return readBinaryFile( tile );
+                }
+            }
+
+          qWarning("File format too old! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, FILE_VERSION_MAP_C );
+          return false;
+        }
+      else if (formatID > FILE_VERSION_MAP_C)
+        {
+          // to new ...
+          mapfile.close();
+
+          if ( kflExists )
+            {
+              qWarning( "File format too new! (version %d, expecting: %d) "
+                        "Retry to compile %s",
+                        formatID, FILE_VERSION_MAP_C, kflPathName.toLatin1().data() );
+              unlink( pathName.toLatin1().data() );
+              return readBinaryFile( tile );
+            }
+
+          qWarning("File format too new! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, FILE_VERSION_MAP_C );
+
+          return false;
+        }
+    }
+
+  // check if this section really covers the area we want to deal with
+  if ( loadSecID != fileSecID )
+    {
+      mapfile.close();
+
+      if ( ! compiling && kflExists )
+        {
+          qWarning( "%s: wrong section, bogus file name!"
+                    "\n Retry to compile %s",
+                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
+          unlink( pathName.toLatin1().data() );
+          return readBinaryFile( tile );
+        }
+
+      qWarning("%s: wrong section, bogus file name! Aborting ...",
+               pathName.toLatin1().data() );
+      return false;
+    }
+
+  if ( compiling )
+    {
+      // Convert the map elements into the compiled format. The compiled file
+      // gets a time one second later than the time of the original file.
+      CompiledMapWriter writer( FILE_TYPE_MAP_C, FILE_VERSION_MAP_C, loadSecID,
+                                createDateTime.addSecs(1) );
+
+      qDebug("Writing file %s", kfcPathName.toLatin1().data());
+
+      quint8 lm_typ;
+      qint8 sort, elev;
+      qint32 lat_temp, lon_temp;
+      quint32 locLength = 0;
+      QString name;
+      QPolygon all;
+
+      while ( ! in.atEnd() )
+        {
+          BaseMapElement::objectType typeIn = BaseMapElement::NotSelected;
+          in >> (quint8&)typeIn;
+
+          name = "";
+
+          switch (typeIn)
+            {
+            case BaseMapElement::Motorway:
+              READ_POINT_LIST
+              writer.addRecord( CompiledMapFile::Motorways, typeIn, 0, 0, name, all );
+              break;
+
+            case BaseMapElement::Road:
+            case BaseMapElement::Trail:
+              READ_POINT_LIST
+              writer.addRecord( CompiledMapFile::Roads, typeIn, 0, 0, name, all );
+              break;
+
+            case BaseMapElement::Aerial_Cable:
+            case BaseMapElement::Railway:
+            case BaseMapElement::Railway_D:
+              READ_POINT_LIST
+              writer.addRecord( CompiledMapFile::Railways, typeIn, 0, 0, name, all );
+              break;
+
+            case BaseMapElement::Canal:
+            case BaseMapElement::River:
+            case BaseMapElement::River_T:
+
+              typeIn = BaseMapElement::River; //don't use different river types internally
+
+              if (formatID >= FILE_FORMAT_ID)
+                {
+                  in >> name;
+                }
+
+              READ_POINT_LIST
+              writer.addRecord( CompiledMapFile::Hydro, typeIn, 0, 0, name, all );
+              break;
+
+            case BaseMapElement::City:
+              in >> sort;
+
+              if (formatID >= FILE_FORMAT_ID)
+                {
+                  in >> name;
+                }
+
+              READ_POINT_LIST
+              writer.addRecord( CompiledMapFile::Cities, typeIn, sort, 0, name, all );
+              break;
+
+            case BaseMapElement::Lake:
+            case BaseMapElement::Lake_T:
+
+              typeIn=BaseMapElement::Lake; // don't use different lake type internally
+              in >> sort;
+
+              if (formatID >= FILE_FORMAT_ID)
+                {
+                  in >> name;
+                }
+
+              READ_POINT_LIST
+              writer.addRecord( CompiledMapFile::Lakes, typeIn, sort, 0, name, all );
+              break;
+
+            case BaseMapElement::Forest:
+            case BaseMapElement::Glacier:
+            case BaseMapElement::PackIce:
+              in >> sort;
+
+              if (formatID >= FILE_FORMAT_ID)
+                {
+                  in >> name;
+                }
+
+              READ_POINT_LIST
+
+              if ( typeIn == BaseMapElement::Glacier ||
+                   typeIn == BaseMapElement::PackIce )
+                {
+                  // Cumulus ignores Glacier and PackIce items
+                  break;
+                }
+
+              writer.addRecord( CompiledMapFile::Topography, typeIn, sort, 0, name, all );
+              break;
+
+            case BaseMapElement::Village:
+
+              if (formatID >= FILE_FORMAT_ID)
+                {
+                  in >> name;
+                }
+
+              in >> lat_temp;
+              in >> lon_temp;
+
+              all.resize( 1 );
+              all.setPoint( 0, lat_temp, lon_temp );
+              writer.addRecord( CompiledMapFile::Villages, typeIn, 0, 0, name, all );
+              break;
+
+            case BaseMapElement::Spot:
+
+              elev = 0;
+
+              if (formatID >= FILE_FORMAT_ID)
+                {
+                  in >> elev;
+                }
+
+              in >> lat_temp;
+              in >> lon_temp;
+
+              all.resize( 1 );
+              all.setPoint( 0, lat_temp, lon_temp );
+              writer.addRecord( CompiledMapFile::Spots, typeIn, 0, elev, "Spot", all );
+              break;
+
+            case BaseMapElement::Landmark:
+
+              lm_typ = 0;
+
+              if (formatID >= FILE_FORMAT_ID)
+                {
+                  in >> lm_typ;
+                  in >> name;
+                }
+
+              in >> lat_temp;
+              in >> lon_temp;
+
+              all.resize( 1 );
+              all.setPoint( 0, lat_temp, lon_temp );
+              writer.addRecord( CompiledMapFile::Landmarks, typeIn, 0, lm_typ, name, all );
+              break;
+
+            default:
+              qWarning ("MapTileLoaderThread::readBinaryFile; type not handled in switch: %d", typeIn);
+              break;
+            }
+        }
+
+      mapfile.close();
+
+      if( ! writer.save( kfcPathName ) )
+        {
+          return false;
+        }
+    }
+  else
+    {
+      mapfile.close();
+    }
+
+  // The compiled file is mapped into memory, only the element lists to be
+  // loaded are read.
+  CompiledMapFile compiledFile;
+
+  if( ! compiledFile.open( kfcPathName, FILE_TYPE_MAP_C, FILE_VERSION_MAP_C, fileSecID ) )
+    {
+      if ( ! compiling && kflExists )
+        {
+          qWarning( "%s is corrupted!\n Retry to compile %s",
+                    kfcPathName.toLatin1().data(), kflPathName.toLatin1().data() );
+          unlink( kfcPathName.toLatin1().data() );
+          return readBinaryFile( tile );
+        }
+
+      qWarning( "Can't read compiled map file %s! Aborting ...",
+                kfcPathName.toLatin1().data() );
+      return false;
+    }
+
+  if ( m_settings.loadMotorways )
+    {
+      readLineElements( compiledFile, CompiledMapFile::Motorways, tile.motorwayList, fileSecID );
+    }
+
+  if ( m_settings.loadRoads )
+    {
+      readLineElements( compiledFile, CompiledMapFile::Roads, tile.roadList, fileSecID );
+    }
+
+  if ( m_settings.loadRailways )
+    {
+      readLineElements( compiledFile, CompiledMapFile::Railways, tile.railList, fileSecID );
+    }
+
+  if ( m_settings.loadWaterways )
+    {
+      readLineElements( compiledFile, CompiledMapFile::Hydro, tile.hydroList, fileSecID );
+    }
+
+  if ( m_settings.loadCities )
+    {
+      readLineElements( compiledFile, CompiledMapFile::Cities, tile.cityList, fileSecID );
+    }
+
+  readLineElements( compiledFile, CompiledMapFile::Lakes, tile.lakeList, fileSecID );
+
+  if ( m_settings.loadForests )
+    {
+      readLineElements( compiledFile, CompiledMapFile::Topography, tile.topoList, fileSecID );
+    }
+
+  if ( m_settings.loadCities )
+    {
+      readSinglePoints( compiledFile, CompiledMapFile::Villages, tile.villageList, fileSecID );
+      readSinglePoints( compiledFile, CompiledMapFile::Spots, tile.obstacleList, fileSecID );
+      readSinglePoints( compiledFile, CompiledMapFile::Landmarks, tile.landmarkList, fileSecID );
+    }
+
+  compiledFile.close();
+
+  tile.result = MapTile::Loaded;
+  return true;
+}
+
+/**
+ * Converts a point in map coordinates of the former compiled format back into
+ * WGS84 coordinates. The returned point contains the latitude as x and the
+ * longitude as y.
+ */
+static QPoint projectedToWgs( const ProjectionBase* projection, const QPoint& point )
+{
+  const double x = point.x() * (MAX_SCALE / RADIUS);
+  const double y = point.y() * (MAX_SCALE / RADIUS);
+
+  return QPoint( (int) rint( projection->invertLat( x, y ) * (108000000.0 / M_PI) ),
+                 (int) rint( projection->invertLon( x, y ) * (108000000.0 / M_PI) ) );
+}
+
+/**
+ * Converts a projected polygon of the former compiled format into a WGS84
+ * polygon. Points, which become identical, are skipped.
+ */
+static QPolygon projectedToWgs( const ProjectionBase* projection, const QPolygon& polygon )
+{
+  QPolygon wgsPolygon;
+
+  wgsPolygon.reserve( polygon.size() );
+
+  for( int i = 0; i < polygon.size(); i++ )
+    {
+      QPoint wgs = projectedToWgs( projection, polygon.at(i) );
+
+      if( wgsPolygon.isEmpty() || wgsPolygon.at( wgsPolygon.size() - 1 ) != wgs )
+        {
+          wgsPolygon.append( wgs );
+        }
+    }
+
+  return wgsPolygon;
+}
+
+bool MapTileLoaderThread::convertProjectedFile( const QString& pathName )
+{
+  QFile mapfile( pathName );
+
+  if( ! mapfile.open( QIODevice::ReadOnly ) )
+    {
+      qWarning( "Can't open map file %s for conversion!",
+                pathName.toLatin1().data() );
+      return false;
+    }
+
+  QDataStream in( &mapfile );
+  in.setVersion( QDataStream::Qt_4_7 );
+
+  qint8 loadTypeID;
+  quint16 loadSecID, formatID;
+  quint32 magic;
+  QDateTime createDateTime;
+
+  in >> magic;
+  in >> loadTypeID;
+  in >> formatID;
+  in >> loadSecID;
+  in >> createDateTime;
+
+  // The former format stores the projection used for the map coordinates.
+  ProjectionBase* projection = LoadProjection( in );
+
+  if( in.status() != QDataStream::Ok || projection == 0 )
+    {
+      qWarning( "%s: unknown projection, can't convert the file!",
+                pathName.toLatin1().data() );
+      delete projection;
+      return false;
+    }
+
+  quint16 newFormatID = FILE_VERSION_MAP_C;
+
+  if( loadTypeID == FILE_TYPE_TERRAIN )
+    {
+      newFormatID = FILE_VERSION_TERRAIN_C;
+    }
+  else if( loadTypeID == FILE_TYPE_GROUND )
+    {
+      newFormatID = FILE_VERSION_GROUND_C;
+    }
+
+  qDebug( "Converting file %s from version %d to version %d",
+          pathName.toLatin1().data(), formatID, newFormatID );
+
+  // The creation date is kept, so that a newer source file is still
+  // recognized.
+  CompiledMapWriter writer( loadTypeID, newFormatID, loadSecID, createDateTime );
+
+  bool ok = true;
+
+  while( ok && ! in.atEnd() )
+    {
+      QString name;
+      QPolygon all;
+      QPoint single;
+
+      if( loadTypeID != FILE_TYPE_MAP_C )
+        {
+          qint16 elevation;
+
+          in >> elevation;
+          ShortLoad( in, all );
+
+          QPolygon wgsIsoline = projectedToWgs( projection, all );
+
+          if( wgsIsoline.size() >= 3 )
+            {
+              writer.addRecord( CompiledMapFile::Isohypses, BaseMapElement::Isohypse,
+                                0, elevation, name, wgsIsoline );
+            }
+
+          continue;
+        }
+
+      quint8 lm_typ;
+      qint8 sort, elev;
+
+      BaseMapElement::objectType typeIn = BaseMapElement::NotSelected;
+      in >> (quint8&)typeIn;
+
+      switch (typeIn)
+        {
+        case BaseMapElement::Motorway:
+          ShortLoad( in, all );
+          writer.addRecord( CompiledMapFile::Motorways, typeIn, 0, 0, name,
+                            projectedToWgs( projection, all ) );
+          break;
+
+        case BaseMapElement::Road:
+        case BaseMapElement::Trail:
+          ShortLoad( in, all );
+          writer.addRecord( CompiledMapFile::Roads, typeIn, 0, 0, name,
+                            projectedToWgs( projection, all ) );
+          break;
+
+        case BaseMapElement::Aerial_Cable:
+        case BaseMapElement::Railway:
+        case BaseMapElement::Railway_D:
+          ShortLoad( in, all );
+          writer.addRecord( CompiledMapFile::Railways, typeIn, 0, 0, name,
+                            projectedToWgs( projection, all ) );
+          break;
+
+        case BaseMapElement::Canal:
+        case BaseMapElement::River:
+        case BaseMapElement::River_T:
+          ShortLoad( in, name );
+          ShortLoad( in, all );
+          writer.addRecord( CompiledMapFile::Hydro, BaseMapElement::River, 0, 0, name,
+                            projectedToWgs( projection, all ) );
+          break;
+
+        case BaseMapElement::City:
+          in >> sort;
+          ShortLoad( in, name );
+          ShortLoad( in, all );
+          writer.addRecord( CompiledMapFile::Cities, typeIn, sort, 0, name,
+                            projectedToWgs( projection, all ) );
+          break;
+
+        case BaseMapElement::Lake:
+        case BaseMapElement::Lake_T:
+          in >> sort;
+          ShortLoad( in, name );
+          ShortLoad( in, all );
+          writer.addRecord( CompiledMapFile::Lakes, BaseMapElement::Lake, sort, 0, name,
+                            projectedToWgs( projection, all ) );
+          break;
+
+        case BaseMapElement::Forest:
+        case BaseMapElement::Glacier:
+        case BaseMapElement::PackIce:
+          in >> sort;
+          ShortLoad( in, name );
+          ShortLoad( in, all );
+
+          if ( typeIn == BaseMapElement::Forest )
+            {
+              // Cumulus ignores Glacier and PackIce items
+              writer.addRecord( CompiledMapFile::Topography, typeIn, sort, 0, name,
+                                projectedToWgs( projection, all ) );
+            }
+
+          break;
+
+        case BaseMapElement::Village:
+          ShortLoad( in, name );
+          in >> single;
+          writer.addRecord( CompiledMapFile::Villages, typeIn, 0, 0, name,
+                            QPolygon() << projectedToWgs( projection, single ) );
+          break;
+
+        case BaseMapElement::Spot:
+          in >> elev;
+          in >> single;
+          writer.addRecord( CompiledMapFile::Spots, typeIn, 0, elev, "Spot",
+                            QPolygon() << projectedToWgs( projection, single ) );
+          break;
+
+        case BaseMapElement::Landmark:
+          in >> lm_typ;
+          ShortLoad( in, name );
+          in >> single;
+          writer.addRecord( CompiledMapFile::Landmarks, typeIn, 0, lm_typ, name,
+                            QPolygon() << projectedToWgs( projection, single ) );
+          break;
+
+        default:
+          qWarning( "%s: unknown map element type %d, can't convert the file!",
+                    pathName.toLatin1().data(), typeIn );
+          ok = false;
+          break;
+        }
+    }
+
+  delete projection;
+  mapfile.close();
+
+  if( ! ok || in.status() != QDataStream::Ok )
+    {
+      qWarning( "%s is corrupted, can't convert the file!",
+                pathName.toLatin1().data() );
+      return false;
+    }
+
+  // The converted file replaces the former one after it has been written
+  // completely.
+  const QString tmpPathName = pathName + ".tmp";
+
+  if( ! writer.save( tmpPathName ) )
+    {
+      QFile::remove( tmpPathName );
+      return false;
+    }
+
+  QFile::remove( pathName );
+
+  if( ! QFile::rename( tmpPathName, pathName ) )
+    {
+      qWarning( "Can't rename %s to %s!",
+                tmpPathName.toLatin1().data(), pathName.toLatin1().data() );
+      return false;
+    }
+
+  return true;
+}
+
+void MapTileLoaderThread::readLineElements( CompiledMapFile& file,
+                                            const CompiledMapFile::Section section,
+                                            QList<LineElement>& list,
+                                            const int fileSecID )
+{
+  CompiledMapFile::Record record;
+
+  file.seek( section );
+
+  while( file.next( record ) )
+    {
+      // The element is projected, when the tile is merged into the map
+      // contents.
+      LineElement element( record.name,
+                           (BaseMapElement::objectType) record.type,
+                           QPolygon(),
+                           record.sort,
+                           fileSecID );
+
+      element.setWgsPolygon( record.wgsPolygon, record.detailPolygons );
+      list.append( element );
+    }
+}
+
+void MapTileLoaderThread::readSinglePoints( CompiledMapFile& file,
+                                            const CompiledMapFile::Section section,
+                                            QList<SinglePoint>& list,
+                                            const int fileSecID )
+{
+  CompiledMapFile::Record record;
+
+  file.seek( section );
+
+  while( file.next( record ) )
+    {
+      if( record.wgsPolygon.isEmpty() )
+        {
+          continue;
+        }
+
+      const QPoint& wgs = record.wgsPolygon.at(0);
+
+      // The point is projected, when it is taken over by the map contents.
+      list.append( SinglePoint( record.name,
+                                "",
+                                (BaseMapElement::objectType) record.type,
+                                WGSPoint( wgs.x(), wgs.y() ),
+                                QPoint(),
+                                0,
+                                "",
+                                "",
+                                fileSecID ) );
+    }
+}
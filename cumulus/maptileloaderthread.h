@@ -0,0 +1,279 @@
+/***********************************************************************
+**
+**   maptileloaderthread.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#ifndef MAP_TILE_LOADER_THREAD_H
+#define MAP_TILE_LOADER_THREAD_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "compiledmapfile.h"
+#include "elevationraster.h"
+#include "isohypse.h"
+#include "lineelement.h"
+#include "singlepoint.h"
+
+/**
+ * \class MapTile
+ *
+ * \author agent
+ *
+ * \brief Map elements of one file of a map tile.
+ *
+ * A map tile consists of a ground, a terrain and a map file. Every file is
+ * loaded separately by the \ref MapTileLoaderThread. The elements contain
+ * only their WGS84 coordinates, they are projected by the map contents.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+class MapTile
+{
+ public:
+
+  /** Result of a load request. */
+  enum Result { Failed, Loaded, Missing };
+
+  MapTile() : secID(-1), fileTypeID(0), generation(0), result(Failed) {};
+
+  /** Map tile identifier. */
+  int secID;
+
+  /** File type, FILE_TYPE_GROUND, FILE_TYPE_TERRAIN or FILE_TYPE_MAP. */
+  char fileTypeID;
+
+  /** Generation of the request, see \ref MapTileRequest. */
+  int generation;
+
+  Result result;
+
+  /** Isohypses of a ground or terrain file in ascending order. */
+  QList<Isohypse> isoList;
+
+  /** Elevation raster of a ground or terrain file. */
+  ElevationRaster raster;
+
+  QList<LineElement> motorwayList;
+  QList<LineElement> roadList;
+  QList<LineElement> railList;
+  QList<LineElement> hydroList;
+  QList<LineElement> cityList;
+  QList<LineElement> lakeList;
+  QList<LineElement> topoList;
+
+  QList<SinglePoint> villageList;
+  QList<SinglePoint> obstacleList;
+  QList<SinglePoint> landmarkList;
+};
+
+/**
+ * The configuration settings, which are needed to load a map tile. They
+ * are taken in the GUI thread, because GeneralConfig is not thread safe.
+ */
+class MapTileSettings
+{
+ public:
+
+  MapTileSettings() :
+    loadIsoLines(true),
+    loadMotorways(true),
+    loadRoads(true),
+    loadRailways(true),
+    loadWaterways(true),
+    loadCities(true),
+    loadForests(true)
+  {};
+
+  /** Map directories in search order, see GeneralConfig::getMapDirectories. */
+  QStringList mapDirectories;
+
+  bool loadIsoLines;
+  bool loadMotorways;
+  bool loadRoads;
+  bool loadRailways;
+  bool loadWaterways;
+  bool loadCities;
+  bool loadForests;
+};
+
+/**
+ * A request to load one file of a map tile.
+ */
+class MapTileRequest
+{
+ public:
+
+  MapTileRequest( const int secID=-1,
+                  const char fileTypeID=0,
+                  const int priority=0,
+                  const int generation=0,
+                  const MapTileSettings& settings=MapTileSettings() ) :
+    secID(secID),
+    fileTypeID(fileTypeID),
+    priority(priority),
+    generation(generation),
+    settings(settings)
+  {};
+
+  /** Requests with a lower priority value are loaded first. */
+  bool operator<( const MapTileRequest& other ) const
+  {
+    return priority < other.priority;
+  };
+
+  int  secID;
+  char fileTypeID;
+  int  priority;
+
+  /**
+   * Load generation of the map contents. Loaded tiles of an older
+   * generation are dropped by the receiver.
+   */
+  int  generation;
+
+  /** Configuration settings at the time of the request. */
+  MapTileSettings settings;
+};
+
+/**
+ * \class MapTileLoaderThread
+ *
+ * \author agent
+ *
+ * \brief Loads and compiles map tile files in an extra thread.
+ *
+ * The thread works on a queue of \ref MapTileRequest objects, ordered by
+ * their priority. The queue is replaced by every call of \ref setRequests,
+ * so that the tiles near to the current map view and in front of the
+ * aircraft are always loaded first. Every loaded file is returned via the
+ * signal \ref tileLoaded.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+class MapTileLoaderThread : public QThread
+{
+  Q_OBJECT
+
+ private:
+
+  Q_DISABLE_COPY ( MapTileLoaderThread )
+
+ public:
+
+  /**
+   * \param parent The parent object.
+   *
+   * \param isoHash Mapping of elevations to elevation indexes.
+   */
+  MapTileLoaderThread( QObject *parent, const QHash<short, uchar>& isoHash );
+
+  virtual ~MapTileLoaderThread();
+
+  /**
+   * Replaces all pending requests. A request, which is just processed,
+   * is finished.
+   */
+  void setRequests( const QList<MapTileRequest>& requests );
+
+  /**
+   * Stops the thread and waits for its end.
+   */
+  void stop();
+
+ protected:
+
+  /**
+   * That is the main method of the thread.
+   */
+  void run();
+
+ signals:
+
+  /**
+   * This signal emits a loaded map tile file. The receiver slot is
+   * responsible to delete the dynamic allocated tile in every case.
+   */
+  void tileLoaded( MapTile* tile );
+
+  /**
+   * Emitted, when a map file is opened.
+   */
+  void loadingFile( const QString& fileName );
+
+ private:
+
+  /**
+   * Reads a ground or terrain file, compiles it, if necessary.
+   */
+  bool readTerrainFile( MapTile& tile );
+
+  /**
+   * Reads a map file, compiles it, if necessary.
+   */
+  bool readBinaryFile( MapTile& tile );
+
+  /**
+   * Converts a compiled file of the former format with projected
+   * coordinates into the current format. The points are converted back to
+   * WGS84 coordinates with the projection stored in the file. That is
+   * used, if the source file is not available to compile it again.
+   *
+   * \param pathName The compiled file, which is replaced.
+   *
+   * \return True in case of success.
+   */
+  bool convertProjectedFile( const QString& pathName );
+
+  /**
+   * Reads the line elements of a section of a compiled map file.
+   */
+  void readLineElements( CompiledMapFile& file,
+                         const CompiledMapFile::Section section,
+                         QList<LineElement>& list,
+                         const int fileSecID );
+
+  /**
+   * Reads the single points of a section of a compiled map file.
+   */
+  void readSinglePoints( CompiledMapFile& file,
+                         const CompiledMapFile::Section section,
+                         QList<SinglePoint>& list,
+                         const int fileSecID );
+
+  /** Mapping of elevations to elevation indexes. */
+  QHash<short, uchar> m_isoHash;
+
+  /** Pending requests, sorted by priority. Protected by m_mutex. */
+  QList<MapTileRequest> m_requests;
+
+  /** Settings of the request, which is processed. Used only by the thread. */
+  MapTileSettings m_settings;
+
+  /** Stop flag of the thread. Protected by m_mutex. */
+  bool m_stop;
+
+  QMutex m_mutex;
+  QWaitCondition m_condition;
+};
+
+#endif
@@ -0,0 +1,941 @@
+/***********************************************************************
+**
+**   maptilerenderer.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cmath>
+#include <cstring>
+
+#include <QtCore>
+
+#include "basemapelement.h"
+#include "generalconfig.h"
+#include "layout.h"
+#include "mapcalc.h"
+#include "mapconfig.h"
+#include "mapcontents.h"
+#include "mapmatrix.h"
+#include "maptilerenderer.h"
+#include "polygonrasterizer.h"
+
+extern MapContents *_globalMapContents;
+extern MapMatrix   *_globalMapMatrix;
+extern MapConfig   *_globalMapConfig;
+
+// Margin in pixels around a tile, used to catch elements, which are drawn
+// with wide pens across the tile border.
+#define TILE_MARGIN 8
+
+namespace
+{
+  /**
+   * Span functor, which sets the covered pixels of a palette image to
+   * a color index.
+   */
+  class IndexSpan
+  {
+   public:
+
+    IndexSpan( uchar* bits, const int bytesPerLine, const uchar index ) :
+      m_bits(bits),
+      m_bytesPerLine(bytesPerLine),
+      m_index(index)
+    {};
+
+    void operator()( int row, int firstColumn, int lastColumn )
+    {
+      memset( m_bits + row * m_bytesPerLine + firstColumn, m_index,
+              lastColumn - firstColumn + 1 );
+    };
+
+   private:
+
+    uchar* m_bits;
+    int    m_bytesPerLine;
+    uchar  m_index;
+  };
+}
+
+MapTileSnapshot::MapTileSnapshot() :
+  generation(0),
+  scale(0.0),
+  projectionScale(0.0),
+  density(1),
+  drawTerrain(false),
+  drawIsoBorders(false),
+  drawRoads(false)
+{
+}
+
+MapTileRenderer::MapTileRenderer( QObject* parent ) :
+  QObject( parent ),
+  m_serial(0),
+  m_projection(-1),
+  m_scale(-1)
+{
+  setObjectName( "MapTileRenderer" );
+
+  // Leave one core for the GUI thread, if possible.
+  m_pool.setMaxThreadCount( qMax( 1, QThread::idealThreadCount() - 1 ) );
+
+  applyConfig();
+}
+
+MapTileRenderer::~MapTileRenderer()
+{
+  // All queued jobs will return immediately, if nothing is wanted.
+  m_mutex.lock();
+  m_wanted.clear();
+  m_serial++;
+  m_mutex.unlock();
+
+  // Tiles saved meanwhile are removed with the spill directory at the next
+  // start.
+  m_pool.waitForDone();
+}
+
+void MapTileRenderer::invalidate()
+{
+  applyConfig();
+  discardTiles( QList<QRect>(), true );
+
+  // Forces the creation of a new snapshot at the next drawing.
+  m_snapshot.clear();
+}
+
+void MapTileRenderer::applyConfig()
+{
+  GeneralConfig *conf = GeneralConfig::instance();
+
+  m_cache.setMaxCost( conf->getMapTileCacheSize() * 1024 );
+  m_cache.setMaxScales( conf->getMapTileCacheScales() );
+
+  if( conf->getMapTileCacheSpill() )
+    {
+      m_cache.setSpillDirectory( conf->getUserDataDirectory() + "/tilecache" );
+    }
+  else
+    {
+      m_cache.setSpillDirectory( QString() );
+    }
+}
+
+void MapTileRenderer::discardTiles( const QList<QRect>& areas, bool all )
+{
+  QList<MapTileKey> keys = m_cache.keys();
+
+  for( int i = 0; i < keys.size(); i++ )
+    {
+      const MapTileKey& key = keys.at(i);
+
+      if( all == false )
+        {
+          QRect tileArea = projectedTileArea( key, MAX_SCALE / key.scale, TILE_MARGIN );
+
+          bool changed = false;
+
+          for( int j = 0; j < areas.size(); j++ )
+            {
+              if( tileArea.intersects( areas.at(j) ) )
+                {
+                  changed = true;
+                  break;
+                }
+            }
+
+          if( changed == false )
+            {
+              continue;
+            }
+        }
+
+      if( key.projection == m_projection && key.scale == m_scale )
+        {
+          // Keep the tile for drawing until the new one is available.
+          QImage image;
+
+          if( m_cache.find( key, image ) )
+            {
+              m_staleTiles.insert( key, image );
+            }
+        }
+
+      m_cache.remove( key );
+    }
+}
+
+QRect MapTileRenderer::projectedTileArea( const MapTileKey& key,
+                                          double projectionScale,
+                                          int margin )
+{
+  const int size = (int) ceil( (TileSize + 2 * margin) / projectionScale ) + 1;
+
+  return QRect( (int) floor( (key.x * TileSize - margin) / projectionScale ),
+                (int) floor( (key.y * TileSize - margin) / projectionScale ),
+                size, size );
+}
+
+void MapTileRenderer::updateSnapshot()
+{
+  const int generation = _globalMapContents->getGeneration();
+  const int projection = _globalMapMatrix->getProjectionId();
+  const int scale      = (int) rint( _globalMapMatrix->getScale(MapMatrix::CurrentScale) );
+
+  if( ! m_snapshot.isNull() &&
+      m_snapshot->generation == generation &&
+      m_projection == projection &&
+      m_scale == scale )
+    {
+      // Snapshot is up to date.
+      return;
+    }
+
+  if( m_projection != projection || m_scale != scale )
+    {
+      // The tiles of the former scales remain in the cache.
+      m_staleTiles.clear();
+      m_cache.useScale( projection, scale );
+
+      m_projection = projection;
+      m_scale      = scale;
+    }
+
+  if( ! m_snapshot.isNull() && m_snapshot->generation != generation )
+    {
+      // The map contents have been changed. Only the tiles covering the
+      // changed map sections must be rendered again.
+      QList<int> sections;
+
+      if( _globalMapContents->getChangedSections( m_snapshot->generation, sections ) )
+        {
+          QList<QRect> areas;
+
+          for( int i = 0; i < sections.size(); i++ )
+            {
+              // Sample the section border in the current projection.
+              QRect box = MapCalc::getTileBox( sections.at(i) ).normalized();
+              QPolygon points;
+
+              for( int j = 0; j <= 4; j++ )
+                {
+                  for( int k = 0; k <= 4; k++ )
+                    {
+                      points.append( _globalMapMatrix->wgsToMap( box.top() + j * box.height() / 4,
+                                                                 box.left() + k * box.width() / 4 ) );
+                    }
+                }
+
+              areas.append( points.boundingRect() );
+            }
+
+          discardTiles( areas, false );
+        }
+      else
+        {
+          discardTiles( QList<QRect>(), true );
+        }
+    }
+
+  MapTileSnapshot* snapshot = new MapTileSnapshot;
+
+  snapshot->generation      = generation;
+  snapshot->scale           = _globalMapMatrix->getScale(MapMatrix::CurrentScale);
+  snapshot->projectionScale = _globalMapMatrix->getProjectionScale();
+  snapshot->density         = Layout::getIntScaledDensity();
+
+  _globalMapContents->createTileSnapshot( *snapshot );
+
+  // Fetch the drawing attributes of all element types, which are drawn
+  // in the tiles. That must be done here because the map configuration
+  // is not thread safe.
+  static const int types[] = { BaseMapElement::Forest,
+                               BaseMapElement::Glacier,
+                               BaseMapElement::PackIce,
+                               BaseMapElement::Lake,
+                               BaseMapElement::City,
+                               BaseMapElement::Motorway,
+                               BaseMapElement::Road,
+                               BaseMapElement::Trail,
+                               BaseMapElement::Railway,
+                               BaseMapElement::Railway_D,
+                               BaseMapElement::Aerial_Cable,
+                               BaseMapElement::River,
+                               BaseMapElement::Canal };
+
+  GeneralConfig *conf = GeneralConfig::instance();
+
+  for( uint i = 0; i < sizeof(types) / sizeof(types[0]); i++ )
+    {
+      MapTileStyle style;
+
+      style.pen       = _globalMapConfig->getDrawPen( types[i] );
+      style.brush     = _globalMapConfig->getDrawBrush( types[i] );
+      style.isBorder  = _globalMapConfig->isBorder( types[i] );
+      style.isEnabled = true;
+
+      switch( types[i] )
+        {
+          case BaseMapElement::Forest:
+            style.isEnabled = conf->getMapLoadForests();
+            break;
+          case BaseMapElement::Motorway:
+            style.isEnabled = conf->getMapLoadMotorways();
+            break;
+          case BaseMapElement::Railway:
+            style.isEnabled = conf->getMapLoadRailways();
+            break;
+          case BaseMapElement::Road:
+            style.isEnabled = conf->getMapLoadRoads();
+            break;
+          case BaseMapElement::River:
+            style.isEnabled = conf->getMapLoadWaterways();
+            break;
+          case BaseMapElement::City:
+            style.isEnabled = conf->getMapLoadCities();
+            break;
+          default:
+            break;
+        }
+
+      snapshot->styles.insert( types[i], style );
+    }
+
+  m_snapshot = QSharedPointer<MapTileSnapshot>( snapshot );
+
+  // Jobs of the old snapshot are now outdated.
+  m_mutex.lock();
+  m_serial++;
+  m_mutex.unlock();
+
+  m_pending.clear();
+}
+
+int MapTileRenderer::drawTiles( QPainter* painter, const QSize& size )
+{
+  updateSnapshot();
+
+  // The tiles are located in the scaled projected coordinate system. The
+  // map matrix adds the rotation and the translation to it.
+  const QTransform& wm = _globalMapMatrix->getWorldMatrix();
+  const double arc     = _globalMapMatrix->getRotationArc();
+
+  QTransform tileToMap( cos(arc), sin(arc), -sin(arc), cos(arc), wm.dx(), wm.dy() );
+
+  QRectF area = tileToMap.inverted().mapRect( QRectF( 0, 0, size.width(), size.height() ) );
+
+  const int x1 = (int) floor( area.left() / TileSize );
+  const int x2 = (int) floor( area.right() / TileSize );
+  const int y1 = (int) floor( area.top() / TileSize );
+  const int y2 = (int) floor( area.bottom() / TileSize );
+
+  const double cx = area.center().x() / TileSize;
+  const double cy = area.center().y() / TileSize;
+
+  // The cache must be able to hold at least the tiles of the map twice.
+  const int needed = 2 * (x2 - x1 + 1) * (y2 - y1 + 1) * TileSize * TileSize * 4;
+
+  if( m_cache.maxCost() < needed )
+    {
+      m_cache.setMaxCost( needed );
+    }
+
+  QSet<MapTileKey> wanted;
+  QMap<double, MapTileKey> missing;
+  QImage image;
+
+  painter->save();
+  painter->setWorldTransform( tileToMap, true );
+
+  if( arc != 0.0 )
+    {
+      painter->setRenderHint( QPainter::SmoothPixmapTransform, true );
+    }
+
+  for( int y = y1; y <= y2; y++ )
+    {
+      for( int x = x1; x <= x2; x++ )
+        {
+          MapTileKey key( m_projection, m_scale, x, y );
+
+          wanted.insert( key );
+
+          if( m_cache.find( key, image ) )
+            {
+              painter->drawImage( x * TileSize, y * TileSize, image );
+              continue;
+            }
+
+          if( m_staleTiles.contains( key ) )
+            {
+              // Draw the outdated tile until the new one is rendered.
+              painter->drawImage( x * TileSize, y * TileSize, m_staleTiles.value( key ) );
+            }
+
+          // The tiles near to the map center are rendered first.
+          double dist = (x + 0.5 - cx) * (x + 0.5 - cx) + (y + 0.5 - cy) * (y + 0.5 - cy);
+          missing.insertMulti( dist, key );
+        }
+    }
+
+  painter->restore();
+
+  m_mutex.lock();
+  m_wanted = wanted;
+  m_mutex.unlock();
+
+  QMapIterator<double, MapTileKey> it( missing );
+
+  while( it.hasNext() )
+    {
+      it.next();
+
+      if( m_pending.contains( it.value() ) )
+        {
+          continue;
+        }
+
+      m_pending.insert( it.value() );
+
+      if( m_cache.isSpilled( it.value() ) )
+        {
+          // The tile is loaded from disk instead of rendering it.
+          m_pool.start( new MapTileLoadJob( this, it.value(), m_serial,
+                                            m_cache.spillFileName( it.value() ) ) );
+        }
+      else
+        {
+          m_pool.start( new MapTileJob( this, it.value(), m_serial, m_snapshot ) );
+        }
+    }
+
+  startSpillJobs();
+
+  // Remove all outdated tiles, which are not more visible.
+  QMutableHashIterator<MapTileKey, QImage> it1( m_staleTiles );
+
+  while( it1.hasNext() )
+    {
+      it1.next();
+
+      if( ! wanted.contains( it1.key() ) )
+        {
+          it1.remove();
+        }
+    }
+
+  return missing.size();
+}
+
+void MapTileRenderer::jobFinished( const MapTileKey& key,
+                                   int serial,
+                                   const QImage& image )
+{
+  m_mutex.lock();
+  m_finished.append( qMakePair( key, image ) );
+  m_finishedSerials.append( serial );
+  m_mutex.unlock();
+
+  // Hand over the tile to the GUI thread.
+  QMetaObject::invokeMethod( this, "slotDeliverTiles", Qt::QueuedConnection );
+}
+
+void MapTileRenderer::loadFailed( const MapTileKey& key )
+{
+  m_mutex.lock();
+  m_failedLoads.append( key );
+  m_mutex.unlock();
+
+  QMetaObject::invokeMethod( this, "slotDeliverTiles", Qt::QueuedConnection );
+}
+
+void MapTileRenderer::spillFinished( const MapTileSpill& spill, bool ok )
+{
+  m_mutex.lock();
+  m_savedSpills.append( qMakePair( spill, ok ) );
+  m_mutex.unlock();
+
+  QMetaObject::invokeMethod( this, "slotDeliverTiles", Qt::QueuedConnection );
+}
+
+void MapTileRenderer::startSpillJobs()
+{
+  QList<MapTileSpill> spills = m_cache.takeSpills();
+
+  for( int i = 0; i < spills.size(); i++ )
+    {
+      // Rendering and loading of visible tiles has precedence.
+      m_pool.start( new MapTileSpillJob( this, spills.at(i) ), -1 );
+    }
+}
+
+bool MapTileRenderer::isWanted( const MapTileKey& key, int serial )
+{
+  QMutexLocker locker( &m_mutex );
+
+  return ( serial == m_serial && m_wanted.contains( key ) );
+}
+
+void MapTileRenderer::slotDeliverTiles()
+{
+  m_mutex.lock();
+  QList<QPair<MapTileKey, QImage> > finished = m_finished;
+  QList<int> serials = m_finishedSerials;
+  QList<MapTileKey> failed = m_failedLoads;
+  QList<QPair<MapTileSpill, bool> > saved = m_savedSpills;
+  m_finished.clear();
+  m_finishedSerials.clear();
+  m_failedLoads.clear();
+  m_savedSpills.clear();
+  m_mutex.unlock();
+
+  bool ready = false;
+
+  for( int i = 0; i < saved.size(); i++ )
+    {
+      m_cache.spillFinished( saved.at(i).first, saved.at(i).second );
+    }
+
+  for( int i = 0; i < failed.size(); i++ )
+    {
+      // The tile is rendered again at the next drawing.
+      m_cache.remove( failed.at(i) );
+      m_pending.remove( failed.at(i) );
+      ready = true;
+    }
+
+  for( int i = 0; i < finished.size(); i++ )
+    {
+      if( serials.at(i) != m_serial )
+        {
+          // Tile was rendered from an outdated snapshot.
+          continue;
+        }
+
+      const MapTileKey& key = finished.at(i).first;
+
+      m_pending.remove( key );
+
+      if( finished.at(i).second.isNull() )
+        {
+          // Rendering was skipped because the tile is no longer needed.
+          continue;
+        }
+
+      m_cache.insert( key, finished.at(i).second );
+      m_staleTiles.remove( key );
+      ready = true;
+    }
+
+  // The inserted tiles may have displaced others.
+  startSpillJobs();
+
+  if( ready )
+    {
+      emit tilesReady();
+    }
+}
+
+QImage MapTileRenderer::renderTile( const MapTileKey& key,
+                                    const MapTileSnapshot& snapshot )
+{
+  // Upper left corner of the tile in the scaled projected coordinate system.
+  const QPoint origin( key.x * TileSize, key.y * TileSize );
+
+  // Projected area of the tile including a margin.
+  const QRect projArea = projectedTileArea( key, snapshot.projectionScale, TILE_MARGIN );
+
+  // First, rasterize the iso lines into a palette image. Index 0 is the
+  // background, the ground colors and the terrain colors follow.
+  const int groundOffset  = 1;
+  const int terrainOffset = groundOffset + snapshot.groundColors.size();
+
+  QVector<QRgb> colorTable;
+  colorTable.reserve( terrainOffset + snapshot.terrainColors.size() );
+  colorTable.append( snapshot.background.rgb() );
+
+  for( int i = 0; i < snapshot.groundColors.size(); i++ )
+    {
+      colorTable.append( snapshot.groundColors.at(i).rgb() );
+    }
+
+  for( int i = 0; i < snapshot.terrainColors.size(); i++ )
+    {
+      colorTable.append( snapshot.terrainColors.at(i).rgb() );
+    }
+
+  QImage isoImage( TileSize, TileSize, QImage::Format_Indexed8 );
+  isoImage.setColorTable( colorTable );
+  isoImage.fill( 0 );
+
+  PolygonRasterizer rasterizer( TileSize, TileSize );
+  QPolygon mP;
+
+  drawIsoMap( isoImage, rasterizer, mP, snapshot.groundMap,
+              groundOffset, snapshot.groundColors.size(),
+              snapshot, projArea, origin );
+
+  if( snapshot.drawTerrain )
+    {
+      drawIsoMap( isoImage, rasterizer, mP, snapshot.terrainMap,
+                  terrainOffset, snapshot.terrainColors.size(),
+                  snapshot, projArea, origin );
+    }
+
+  QImage image = isoImage.convertToFormat( QImage::Format_RGB32 );
+
+  QPainter painter( &image );
+
+  if( snapshot.drawIsoBorders )
+    {
+      drawIsoBorders( painter, mP, snapshot.groundMap, snapshot, projArea, origin );
+
+      if( snapshot.drawTerrain )
+        {
+          drawIsoBorders( painter, mP, snapshot.terrainMap, snapshot, projArea, origin );
+        }
+    }
+
+  // next, draw the topographical elements and the cities
+  drawLineList( painter, snapshot.topoList, snapshot, projArea, origin );
+  drawLineList( painter, snapshot.cityList, snapshot, projArea, origin );
+  drawLineList( painter, snapshot.lakeList, snapshot, projArea, origin );
+
+  // draw the roads, the railroads, the hydro
+  if( snapshot.drawRoads )
+    {
+      drawLineList( painter, snapshot.roadList, snapshot, projArea, origin );
+      drawLineList( painter, snapshot.railList, snapshot, projArea, origin );
+      drawLineList( painter, snapshot.hydroList, snapshot, projArea, origin );
+    }
+
+  // draw the motorways
+  drawLineList( painter, snapshot.motorwayList, snapshot, projArea, origin );
+
+  painter.end();
+
+  return image;
+}
+
+void MapTileRenderer::drawIsoMap( QImage& isoImage,
+                                  PolygonRasterizer& rasterizer,
+                                  QPolygon& mP,
+                                  const QMap<int, QList<Isohypse> >& isoMap,
+                                  const int colorOffset,
+                                  const int colorCount,
+                                  const MapTileSnapshot& snapshot,
+                                  const QRect& projArea,
+                                  const QPoint& origin )
+{
+  // The isoline list of every map tile contains its isolines in ascending
+  // order. All lists are walked in parallel, so that the isolines of one
+  // elevation level are rasterized together in one pass. The higher levels
+  // overwrite the lower ones, as before with the painter.
+  QVarLengthArray<const QList<Isohypse> *, 64> lists;
+  QVarLengthArray<int, 64> positions;
+
+  QMapIterator<int, QList<Isohypse> > it( isoMap );
+
+  while( it.hasNext() )
+    {
+      it.next();
+
+      if( it.value().isEmpty() == false )
+        {
+          lists.append( &it.value() );
+          positions.append( 0 );
+        }
+    }
+
+  uchar* bits = isoImage.bits();
+  const int bytesPerLine = isoImage.bytesPerLine();
+
+  // The isolines are drawn simplified according to the tile scale.
+  const unsigned int drawScale = MapMatrix::drawScaleOf( snapshot.scale );
+
+  while( true )
+    {
+      // Determine the lowest elevation level not yet drawn.
+      int level = -1;
+
+      for( int i = 0; i < lists.size(); i++ )
+        {
+          if( positions[i] < lists[i]->size() )
+            {
+              const int index = lists[i]->at( positions[i] ).getElevationIndex();
+
+              if( level < 0 || index < level )
+                {
+                  level = index;
+                }
+            }
+        }
+
+      if( level < 0 )
+        {
+          // All isolines are drawn.
+          break;
+        }
+
+      bool added = false;
+
+      for( int i = 0; i < lists.size(); i++ )
+        {
+          const QList<Isohypse>& isoList = *lists[i];
+
+          for( ; positions[i] < isoList.size() &&
+                 isoList.at( positions[i] ).getElevationIndex() == level;
+               positions[i]++ )
+            {
+              const Isohypse& iso = isoList.at( positions[i] );
+              const QPolygon& polygon = iso.getProjectedPolygon( drawScale );
+
+              if( polygon.size() < 3 ||
+                  ! MapMatrix::isVisible( projArea, iso.getBoundingBox(),
+                                          BaseMapElement::Isohypse, snapshot.scale ) )
+                {
+                  continue;
+                }
+
+              mapPolygon( polygon, snapshot.projectionScale, origin, mP );
+
+              if( mP.size() < 3 )
+                {
+                  continue;
+                }
+
+              rasterizer.addPolygon( mP );
+              added = true;
+            }
+        }
+
+      if( added == false )
+        {
+          continue;
+        }
+
+      if( level >= colorCount )
+        {
+          // No color available, drop the polygons.
+          rasterizer.clear();
+          continue;
+        }
+
+      IndexSpan span( bits, bytesPerLine, uchar( colorOffset + level ) );
+
+      rasterizer.fill( span );
+    }
+}
+
+void MapTileRenderer::drawIsoBorders( QPainter& painter,
+                                      QPolygon& mP,
+                                      const QMap<int, QList<Isohypse> >& isoMap,
+                                      const MapTileSnapshot& snapshot,
+                                      const QRect& projArea,
+                                      const QPoint& origin )
+{
+  painter.setPen( QPen( Qt::black, 1, Qt::DotLine ) );
+  painter.setBrush( Qt::NoBrush );
+
+  const unsigned int drawScale = MapMatrix::drawScaleOf( snapshot.scale );
+
+  QMapIterator<int, QList<Isohypse> > it( isoMap );
+
+  while( it.hasNext() )
+    {
+      it.next();
+
+      const QList<Isohypse>& isoList = it.value();
+
+      for( int i = 0; i < isoList.size(); i++ )
+        {
+          const Isohypse& iso = isoList.at(i);
+          const QPolygon& polygon = iso.getProjectedPolygon( drawScale );
+
+          if( polygon.size() < 3 ||
+              ! MapMatrix::isVisible( projArea, iso.getBoundingBox(),
+                                      BaseMapElement::Isohypse, snapshot.scale ) )
+            {
+              continue;
+            }
+
+          mapPolygon( polygon, snapshot.projectionScale, origin, mP );
+
+          if( mP.size() < 3 )
+            {
+              continue;
+            }
+
+          painter.drawPolygon( mP );
+        }
+    }
+}
+
+void MapTileRenderer::drawLineList( QPainter& painter,
+                                    const QList<LineElement>& list,
+                                    const MapTileSnapshot& snapshot,
+                                    const QRect& projArea,
+                                    const QPoint& origin )
+{
+  QPolygon mP;
+
+  // The elements are drawn simplified according to the tile scale.
+  const unsigned int drawScale = MapMatrix::drawScaleOf( snapshot.scale );
+
+  for( int i = 0; i < list.size(); i++ )
+    {
+      const LineElement& element = list.at(i);
+      const int typeID = element.getTypeID();
+
+      QHash<int, MapTileStyle>::const_iterator it = snapshot.styles.constFind( typeID );
+
+      if( it == snapshot.styles.constEnd() ||
+          it.value().isBorder == false || it.value().isEnabled == false )
+        {
+          continue;
+        }
+
+      if( ! MapMatrix::isVisible( projArea, element.getBoundingBox(),
+                                  typeID, snapshot.scale ) )
+        {
+          continue;
+        }
+
+      mapPolygon( element.getProjectedPolygon( drawScale ),
+                  snapshot.projectionScale, origin, mP );
+
+      const MapTileStyle& style = it.value();
+
+      painter.setPen( style.pen );
+
+      if( element.isClosed() )
+        {
+          painter.setBrush( style.brush );
+          painter.drawPolygon( mP );
+          continue;
+        }
+
+      painter.drawPolyline( mP );
+
+      if( typeID == BaseMapElement::Motorway && style.pen.width() > 4 )
+        {
+          // draw the white line in the middle
+          painter.setPen( QPen( Qt::white, snapshot.density ) );
+          painter.drawPolyline( mP );
+        }
+    }
+}
+
+void MapTileRenderer::mapPolygon( const QPolygon& in,
+                                  double projectionScale,
+                                  const QPoint& origin,
+                                  QPolygon& out )
+{
+  // Fixed point factor with 24 bits fraction
+  const qint64 f = (qint64) (projectionScale * 16777216.0);
+
+  const int size = in.size();
+
+  out.resize( size );
+
+  const QPoint* src = in.constData();
+  QPoint* dst = out.data();
+  int n = 0;
+
+  for( int i = 0; i < size; i++ )
+    {
+      const int x = int( ((qint64) src[i].x() * f) >> 24 ) - origin.x();
+      const int y = int( ((qint64) src[i].y() * f) >> 24 ) - origin.y();
+
+      if( n == 0 || x != dst[n - 1].x() || y != dst[n - 1].y() )
+        {
+          dst[n].setX( x );
+          dst[n].setY( y );
+          n++;
+        }
+    }
+
+  out.resize( n );
+}
+
+MapTileJob::MapTileJob( MapTileRenderer* renderer,
+                        const MapTileKey& key,
+                        int serial,
+                        QSharedPointer<MapTileSnapshot> snapshot ) :
+  m_renderer(renderer),
+  m_key(key),
+  m_serial(serial),
+  m_snapshot(snapshot)
+{
+  setAutoDelete( true );
+}
+
+void MapTileJob::run()
+{
+  if( m_renderer->isWanted( m_key, m_serial ) == false )
+    {
+      // The tile is not longer needed, signal only the end of the job.
+      m_renderer->jobFinished( m_key, m_serial, QImage() );
+      return;
+    }
+
+  QImage image = MapTileRenderer::renderTile( m_key, *m_snapshot );
+
+  m_renderer->jobFinished( m_key, m_serial, image );
+}
+
+MapTileLoadJob::MapTileLoadJob( MapTileRenderer* renderer,
+                                const MapTileKey& key,
+                                int serial,
+                                const QString& fileName ) :
+  m_renderer(renderer),
+  m_key(key),
+  m_serial(serial),
+  m_fileName(fileName)
+{
+  setAutoDelete( true );
+}
+
+void MapTileLoadJob::run()
+{
+  if( m_renderer->isWanted( m_key, m_serial ) == false )
+    {
+      // The tile is not longer needed, signal only the end of the job.
+      m_renderer->jobFinished( m_key, m_serial, QImage() );
+      return;
+    }
+
+  QImage image = MapTileCache::loadSpill( m_fileName );
+
+  if( image.isNull() )
+    {
+      m_renderer->loadFailed( m_key );
+      return;
+    }
+
+  m_renderer->jobFinished( m_key, m_serial, image );
+}
+
+MapTileSpillJob::MapTileSpillJob( MapTileRenderer* renderer,
+                                  const MapTileSpill& spill ) :
+  m_renderer(renderer),
+  m_spill(spill)
+{
+  setAutoDelete( true );
+}
+
+void MapTileSpillJob::run()
+{
+  const bool ok = MapTileCache::saveSpill( m_spill );
+
+  m_renderer->spillFinished( m_spill, ok );
+}
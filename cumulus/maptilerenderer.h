@@ -0,0 +1,431 @@
+/***********************************************************************
+**
+**   maptilerenderer.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class MapTileRenderer
+ *
+ * \author agent
+ *
+ * \brief Renders the base layer of the map as tiles in background threads.
+ *
+ * The base layer of the map (isolines, topography, cities, lakes, roads,
+ * railways, hydro and motorways) is drawn in fixed size image tiles by
+ * worker threads of a thread pool. The tiles are located in the projected
+ * and scaled but not rotated coordinate system of the map. They are
+ * identified by the projection, the scale and the tile position. Because
+ * of that a tile can be reused, when the map is moved. The rendered tiles
+ * are kept in a \ref MapTileCache for the last used scales, so that a
+ * return to a recently used scale or area needs no new rendering.
+ *
+ * The tiles removed from the memory cache are saved to disk and loaded
+ * again by jobs of the same thread pool. A spilled tile is pending like a
+ * tile to be rendered, until it is loaded.
+ *
+ * All map data used by a worker thread are passed as an implicitly shared
+ * copy to it in a \ref MapTileSnapshot object, so that the GUI thread can
+ * modify the map data during the tile rendering.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef MAP_TILE_RENDERER_H
+#define MAP_TILE_RENDERER_H
+
+#include <QBrush>
+#include <QColor>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QObject>
+#include <QPainter>
+#include <QPen>
+#include <QPolygon>
+#include <QRunnable>
+#include <QSet>
+#include <QSharedPointer>
+#include <QSize>
+#include <QThreadPool>
+#include <QVector>
+
+#include "isohypse.h"
+#include "lineelement.h"
+#include "maptilecache.h"
+
+class PolygonRasterizer;
+
+/**
+ * Drawing attributes of one map element type.
+ */
+class MapTileStyle
+{
+ public:
+
+  MapTileStyle() : isBorder(false), isEnabled(false) {};
+
+  QPen   pen;
+  QBrush brush;
+
+  /** Element type shall be drawn at the current scale. */
+  bool isBorder;
+
+  /** Element type is enabled by the user configuration. */
+  bool isEnabled;
+};
+
+/**
+ * All data needed by a worker thread to render a tile. The snapshot is
+ * filled in the GUI thread and is afterwards only read.
+ */
+class MapTileSnapshot
+{
+ public:
+
+  MapTileSnapshot();
+
+  /** Map contents generation, see \ref MapContents::getGeneration. */
+  int generation;
+
+  /** Scale in meters per pixel. */
+  double scale;
+
+  /** Factor to convert projected coordinates into scaled coordinates. */
+  double projectionScale;
+
+  /** Layout density used for line widths. */
+  int density;
+
+  /** Background color of a tile. */
+  QColor background;
+
+  /** Ground isohypses, the key is the map tile identifier. */
+  QMap<int, QList<Isohypse> > groundMap;
+
+  /** Terrain isohypses, the key is the map tile identifier. */
+  QMap<int, QList<Isohypse> > terrainMap;
+
+  /** Draw also the terrain isohypses. */
+  bool drawTerrain;
+
+  /** Draw the outlines of the isohypses. */
+  bool drawIsoBorders;
+
+  /** Color to be used for ground, if terrain drawing is switched off. */
+  QColor groundColor;
+
+  /** Colors of the ground isohypses indexed by the elevation index. */
+  QVector<QColor> groundColors;
+
+  /** Colors of the terrain isohypses indexed by the elevation index. */
+  QVector<QColor> terrainColors;
+
+  QList<LineElement> topoList;
+  QList<LineElement> cityList;
+  QList<LineElement> lakeList;
+  QList<LineElement> roadList;
+  QList<LineElement> railList;
+  QList<LineElement> hydroList;
+  QList<LineElement> motorwayList;
+
+  /** Draw roads, railways and hydro. */
+  bool drawRoads;
+
+  /** Drawing attributes, the key is the element type. */
+  QHash<int, MapTileStyle> styles;
+};
+
+class MapTileRenderer : public QObject
+{
+  Q_OBJECT
+
+ private:
+
+  Q_DISABLE_COPY ( MapTileRenderer )
+
+  friend class MapTileJob;
+  friend class MapTileLoadJob;
+  friend class MapTileSpillJob;
+
+ public:
+
+  /** Width and height of a tile in pixels. */
+  enum { TileSize = 256 };
+
+  MapTileRenderer( QObject* parent = 0 );
+
+  virtual ~MapTileRenderer();
+
+  /**
+   * Draws all available tiles covering the current map matrix into the
+   * painter. Missing tiles are requested from the worker threads. For them
+   * an outdated tile is drawn, if one is available. The signal
+   * \ref tilesReady is emitted, if requested tiles have been rendered.
+   *
+   * Must be called in the GUI thread.
+   *
+   * \param painter The painter to draw into.
+   *
+   * \param size The size of the map.
+   *
+   * \return The number of tiles, which are not up to date.
+   */
+  int drawTiles( QPainter* painter, const QSize& size );
+
+  /**
+   * Marks all rendered tiles as outdated and reads the cache configuration.
+   * Should be called, if the drawing configuration has been changed.
+   */
+  void invalidate();
+
+ signals:
+
+  /**
+   * Emitted, when requested tiles have been rendered.
+   */
+  void tilesReady();
+
+ private slots:
+
+  /** Takes over all tiles, which have been rendered by the worker threads. */
+  void slotDeliverTiles();
+
+ private:
+
+  /**
+   * Updates the snapshot of the map data, if the map contents, the scale
+   * or the projection have been changed.
+   */
+  void updateSnapshot();
+
+  /**
+   * Removes tiles from the cache. The tiles of the current scale are kept
+   * as outdated tiles until they are rendered again.
+   *
+   * \param areas Projected areas of the changed map data. Tiles, which
+   *              overlap one of them, are removed.
+   *
+   * \param all If true, all tiles are removed.
+   */
+  void discardTiles( const QList<QRect>& areas, bool all );
+
+  /** Reads the configuration of the tile cache. */
+  void applyConfig();
+
+  /**
+   * Returns the projected area of a tile.
+   *
+   * \param key The key of the tile.
+   *
+   * \param projectionScale Factor between projected and scaled coordinates.
+   *
+   * \param margin Margin in pixels added around the tile.
+   */
+  static QRect projectedTileArea( const MapTileKey& key,
+                                  double projectionScale,
+                                  int margin );
+
+  /** Starts the jobs saving the tiles removed from the memory cache. */
+  void startSpillJobs();
+
+  /** Called by a worker thread to hand over a rendered tile. */
+  void jobFinished( const MapTileKey& key, int serial, const QImage& image );
+
+  /** Called by a worker thread, if a spilled tile could not be loaded. */
+  void loadFailed( const MapTileKey& key );
+
+  /** Called by a worker thread, when a removed tile has been saved. */
+  void spillFinished( const MapTileSpill& spill, bool ok );
+
+  /** Called by a worker thread to check, if a tile is still needed. */
+  bool isWanted( const MapTileKey& key, int serial );
+
+  /** Renders a tile. Called in a worker thread. */
+  static QImage renderTile( const MapTileKey& key,
+                            const MapTileSnapshot& snapshot );
+
+  /**
+   * Rasterizes the isohypses of an isohypse map into the palette image of
+   * a tile. All isohypses of the same elevation level are filled in one
+   * pass, the buffers are reused to avoid allocations per polygon.
+   *
+   * \param colorOffset Palette index of the first elevation color.
+   *
+   * \param colorCount Number of elevation colors in the palette.
+   */
+  static void drawIsoMap( QImage& isoImage,
+                          PolygonRasterizer& rasterizer,
+                          QPolygon& mP,
+                          const QMap<int, QList<Isohypse> >& isoMap,
+                          const int colorOffset,
+                          const int colorCount,
+                          const MapTileSnapshot& snapshot,
+                          const QRect& projArea,
+                          const QPoint& origin );
+
+  /** Draws the borders of the isohypses of an isohypse map into a tile. */
+  static void drawIsoBorders( QPainter& painter,
+                              QPolygon& mP,
+                              const QMap<int, QList<Isohypse> >& isoMap,
+                              const MapTileSnapshot& snapshot,
+                              const QRect& projArea,
+                              const QPoint& origin );
+
+  /** Draws the elements of a line list into a tile. */
+  static void drawLineList( QPainter& painter,
+                            const QList<LineElement>& list,
+                            const MapTileSnapshot& snapshot,
+                            const QRect& projArea,
+                            const QPoint& origin );
+
+  /**
+   * Maps a projected polygon into the coordinate system of a tile and
+   * removes consecutive duplicate points.
+   */
+  static void mapPolygon( const QPolygon& in,
+                          double projectionScale,
+                          const QPoint& origin,
+                          QPolygon& out );
+
+  /** Thread pool used for rendering. */
+  QThreadPool m_pool;
+
+  /** Current map data, shared with the running jobs. */
+  QSharedPointer<MapTileSnapshot> m_snapshot;
+
+  /** Serial number of the snapshot, used to detect outdated jobs. */
+  int m_serial;
+
+  /** Projection identifier and scale of the current snapshot. */
+  int m_projection;
+  int m_scale;
+
+  /** Rendered and up to date tiles. */
+  MapTileCache m_cache;
+
+  /** Outdated tiles, drawn until a newer one is available. */
+  QHash<MapTileKey, QImage> m_staleTiles;
+
+  /** Requested tiles, which are not yet rendered. */
+  QSet<MapTileKey> m_pending;
+
+  /** Tiles needed by the current map view. Protected by m_mutex. */
+  QSet<MapTileKey> m_wanted;
+
+  /** Tiles delivered by the worker threads. Protected by m_mutex. */
+  QList<QPair<MapTileKey, QImage> > m_finished;
+
+  /** Serial number of the delivered tiles. Protected by m_mutex. */
+  QList<int> m_finishedSerials;
+
+  /** Spilled tiles, which could not be loaded. Protected by m_mutex. */
+  QList<MapTileKey> m_failedLoads;
+
+  /** Saved tiles and the save results. Protected by m_mutex. */
+  QList<QPair<MapTileSpill, bool> > m_savedSpills;
+
+  /** Mutex to protect the data shared with the worker threads. */
+  QMutex m_mutex;
+};
+
+/**
+ * \class MapTileJob
+ *
+ * \author agent
+ *
+ * \brief Renders one map tile in a thread of the thread pool.
+ *
+ * \date 2026
+ */
+class MapTileJob : public QRunnable
+{
+ public:
+
+  MapTileJob( MapTileRenderer* renderer,
+              const MapTileKey& key,
+              int serial,
+              QSharedPointer<MapTileSnapshot> snapshot );
+
+  virtual ~MapTileJob() {};
+
+  virtual void run();
+
+ private:
+
+  MapTileRenderer* m_renderer;
+  MapTileKey m_key;
+  int m_serial;
+  QSharedPointer<MapTileSnapshot> m_snapshot;
+};
+
+/**
+ * \class MapTileLoadJob
+ *
+ * \author agent
+ *
+ * \brief Loads one spilled map tile in a thread of the thread pool.
+ *
+ * \date 2026
+ */
+class MapTileLoadJob : public QRunnable
+{
+ public:
+
+  MapTileLoadJob( MapTileRenderer* renderer,
+                  const MapTileKey& key,
+                  int serial,
+                  const QString& fileName );
+
+  virtual ~MapTileLoadJob() {};
+
+  virtual void run();
+
+ private:
+
+  MapTileRenderer* m_renderer;
+  MapTileKey m_key;
+  int m_serial;
+  QString m_fileName;
+};
+
+/**
+ * \class MapTileSpillJob
+ *
+ * \author agent
+ *
+ * \brief Saves one map tile removed from the memory cache in a thread of
+ * the thread pool.
+ *
+ * \date 2026
+ */
+class MapTileSpillJob : public QRunnable
+{
+ public:
+
+  MapTileSpillJob( MapTileRenderer* renderer, const MapTileSpill& spill );
+
+  virtual ~MapTileSpillJob() {};
+
+  virtual void run();
+
+ private:
+
+  MapTileRenderer* m_renderer;
+  MapTileSpill m_spill;
+};
+
+#endif
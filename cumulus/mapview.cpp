@@ -26,6 +26,7 @@
 #include <QtWidgets>
 #endif
 
+#include "airspaceprofiledialog.h"
 #include "altimeterdialog.h"
 #include "filetools.h"
 #include "generalconfig.h"
@@ -1443,6 +1444,22 @@ void MapView::slot_gpsStatusDialog()
   gpsDlg->setVisible(true);
 }
 
+/** Opens the airspace profile dialog */
+void MapView::slot_airspaceProfileDialog()
+{
+  if( AirspaceProfileDialog::getNrOfInstances() > 0 )
+    {
+      // Only one instance of airspace profile dialog is allowed.
+      return;
+    }
+
+  AirspaceProfileDialog *apDlg = new AirspaceProfileDialog( this );
+  connect( apDlg, SIGNAL( closingWidget() ), SIGNAL( closingSubWidget() ) );
+
+  emit openingSubWidget();
+  apDlg->setVisible(true);
+}
+
 /** Opens the inflight glider settings dialog. */
 void MapView::slot_gliderFlightDialog()
 {
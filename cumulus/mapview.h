@@ -296,6 +296,9 @@ class MapView : public QWidget
     /** Opens the GPS status dialog */
     void slot_gpsStatusDialog();
 
+    /** Opens the airspace profile dialog */
+    void slot_airspaceProfileDialog();
+
     /** Show/hide the map info boxes. */
     void slot_showInfoBoxes( bool show );
 
@@ -0,0 +1,658 @@
+/***********************************************************************
+**
+**   nmeadecoder.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cstring>
+
+#include <QtCore>
+
+#include "nmeadecoder.h"
+
+/** Powers of ten for the conversion of fixed point numbers. */
+static const double Pow10[] =
+  {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+  };
+
+static inline bool isDigit( const char c )
+{
+  return c >= '0' && c <= '9';
+}
+
+/** Returns the value of two decimal digits. */
+static inline int digitPair( const char* s )
+{
+  return (s[0] - '0') * 10 + (s[1] - '0');
+}
+
+static inline bool hexValue( const char c, int& value )
+{
+  if( c >= '0' && c <= '9' )
+    {
+      value = c - '0';
+    }
+  else if( c >= 'A' && c <= 'F' )
+    {
+      value = c - 'A' + 10;
+    }
+  else if( c >= 'a' && c <= 'f' )
+    {
+      value = c - 'a' + 10;
+    }
+  else
+    {
+      return false;
+    }
+
+  return true;
+}
+
+/** Removes leading and trailing blanks from a field. */
+static inline void trim( const char*& s, int& len )
+{
+  while( len > 0 && s[0] == ' ' )
+    {
+      s++;
+      len--;
+    }
+
+  while( len > 0 && s[len - 1] == ' ' )
+    {
+      len--;
+    }
+}
+
+/** Returns the type of a proprietary sentence of Garmin and Flarm. */
+static int proprietaryType( const char* sentence )
+{
+  const char t2 = sentence[2];
+  int type = NmeaFix::None;
+
+  if( t2 == 'G' && sentence[3] == 'R' && sentence[4] == 'M' && sentence[5] == 'Z' )
+    {
+      type = NmeaFix::PGRMZ;
+    }
+  else if( t2 == 'F' && sentence[3] == 'L' && sentence[4] == 'A' )
+    {
+      if( sentence[5] == 'A' )
+        {
+          type = NmeaFix::PFLAA;
+        }
+      else if( sentence[5] == 'U' )
+        {
+          type = NmeaFix::PFLAU;
+        }
+    }
+
+  return type;
+}
+
+/** Returns the type of a sentence of an accepted talker. */
+static int talkerType( const char* sentence )
+{
+  const char t2 = sentence[2];
+  int type = NmeaFix::None;
+
+  switch( sentence[3] )
+    {
+      case 'R':
+
+        if( sentence[4] == 'M' && sentence[5] == 'C' )
+          {
+            type = NmeaFix::RMC;
+          }
+
+        break;
+
+      case 'G':
+
+        switch( sentence[4] )
+          {
+            case 'L':
+              type = ( sentence[5] == 'L' ) ? NmeaFix::GLL : NmeaFix::None;
+              break;
+
+            case 'G':
+              type = ( sentence[5] == 'A' ) ? NmeaFix::GGA : NmeaFix::None;
+              break;
+
+            case 'N':
+              // GNS is only accepted from the combined talker.
+              type = ( sentence[5] == 'S' && t2 == 'N' ) ? NmeaFix::GNS : NmeaFix::None;
+              break;
+
+            case 'S':
+
+              if( sentence[5] == 'A' )
+                {
+                  type = NmeaFix::GSA;
+                }
+              else if( sentence[5] == 'V' )
+                {
+                  type = NmeaFix::GSV;
+                }
+
+              break;
+
+            default:
+              break;
+          }
+
+        break;
+
+      default:
+        break;
+    }
+
+  return type;
+}
+
+NmeaDecoder::NmeaDecoder() :
+  m_sentence(""),
+  m_fields(0)
+{
+}
+
+NmeaDecoder::~NmeaDecoder()
+{
+}
+
+int NmeaDecoder::decode( const QString& sentence, NmeaFix& fix )
+{
+  const int length = qMin( sentence.size(), (int) MaxLength );
+  const QChar* data = sentence.constData();
+
+  for( int i = 0; i < length; i++ )
+    {
+      m_buffer[i] = data[i].toLatin1();
+    }
+
+  return decode( m_buffer, length, fix );
+}
+
+int NmeaDecoder::decode( const char* sentence, const int length, NmeaFix& fix )
+{
+  memset( &fix, 0, sizeof(fix) );
+  fix.altitudeUnit = 'M';
+
+  if( length < 7 || sentence[0] != '$' || sentence[6] != ',' )
+    {
+      return NmeaFix::None;
+    }
+
+  const char t1 = sentence[1];
+  const char t2 = sentence[2];
+
+  int type = NmeaFix::None;
+
+  if( t1 == 'P' )
+    {
+      type = proprietaryType( sentence );
+    }
+  else if( ( t1 == 'B' && t2 == 'D' ) ||
+           ( t1 == 'G' && ( t2 == 'P' || t2 == 'A' || t2 == 'L' || t2 == 'N' ) ) )
+    {
+      // Accepted talkers are BD, GP, GA, GL and GN.
+      type = talkerType( sentence );
+    }
+
+  if( type == NmeaFix::None )
+    {
+      return NmeaFix::None;
+    }
+
+  if( tokenize( sentence, qMin( length, (int) MaxLength ) ) == false )
+    {
+      return NmeaFix::Corrupt;
+    }
+
+  memcpy( fix.identifier, sentence, 6 );
+  fix.identifier[6] = '\0';
+  fix.fields = m_fields;
+
+  int value;
+
+  switch( type )
+    {
+      case NmeaFix::RMC:
+
+        fix.status = fieldIs( 2, 'A' ) ? NmeaFix::Valid : NmeaFix::Invalid;
+
+        decodeTime( 1, fix );
+        decodePosition( 3, fix );
+
+        if( decodeDouble( 7, fix.speed ) )
+          {
+            fix.valid |= NmeaFix::Speed;
+          }
+
+        if( decodeDouble( 8, fix.heading ) )
+          {
+            fix.valid |= NmeaFix::Heading;
+          }
+
+        decodeDate( 9, fix );
+        break;
+
+      case NmeaFix::GLL:
+
+        fix.status = fieldIs( 6, 'A' ) ? NmeaFix::Valid : NmeaFix::Invalid;
+
+        decodePosition( 1, fix );
+        decodeTime( 5, fix );
+        break;
+
+      case NmeaFix::GGA:
+      case NmeaFix::GNS:
+
+        if( type == NmeaFix::GGA )
+          {
+            // Quality indicator, 0 means no fix.
+            if( fieldLength( 6 ) == 0 )
+              {
+                fix.status = NmeaFix::Unknown;
+              }
+            else
+              {
+                fix.status = fieldIs( 6, '0' ) ? NmeaFix::Invalid : NmeaFix::Valid;
+              }
+
+            if( fieldLength( 10 ) > 0 )
+              {
+                fix.altitudeUnit = field( 10 )[0];
+              }
+          }
+        else
+          {
+            // Mode indicator per satellite system, N means no fix.
+            fix.status = memchr( field( 6 ), 'N', fieldLength( 6 ) ) ?
+                         NmeaFix::Invalid : NmeaFix::Valid;
+          }
+
+        decodeTime( 1, fix );
+        decodePosition( 2, fix );
+
+        if( parseInt( field( 7 ), fieldLength( 7 ), value ) )
+          {
+            fix.satellites = value;
+            fix.valid |= NmeaFix::Satellites;
+          }
+
+        if( decodeDouble( 9, fix.altitude ) )
+          {
+            fix.valid |= NmeaFix::Altitude;
+          }
+
+        break;
+
+      default:
+        break;
+    }
+
+  return type;
+}
+
+bool NmeaDecoder::tokenize( const char* sentence, const int length )
+{
+  m_sentence = sentence;
+  m_fields = 0;
+
+  uchar sum = 0;
+  int begin = 0;
+  int i = 0;
+
+  // The start sign is not part of the checksum.
+  if( length > 0 && ( sentence[0] == '$' || sentence[0] == '!' ) )
+    {
+      i = 1;
+    }
+
+  char c = '\0';
+
+  for( ; i <= length; i++ )
+    {
+      c = ( i < length ) ? sentence[i] : '\0';
+
+      if( c == ',' || c == '*' || c == '\r' || c == '\n' || c == '\0' )
+        {
+          if( m_fields == MaxFields )
+            {
+              return false;
+            }
+
+          m_begin[m_fields]  = begin;
+          m_length[m_fields] = i - begin;
+          m_fields++;
+          begin = i + 1;
+
+          if( c != ',' )
+            {
+              break;
+            }
+        }
+
+      sum ^= (uchar) c;
+    }
+
+  if( c != '*' )
+    {
+      // The sentence contains no checksum.
+      return true;
+    }
+
+  int end = begin;
+
+  while( end < length && sentence[end] != '\r' &&
+         sentence[end] != '\n' && sentence[end] != '\0' )
+    {
+      end++;
+    }
+
+  if( m_fields == MaxFields )
+    {
+      return false;
+    }
+
+  // The checksum is a field too.
+  m_begin[m_fields]  = begin;
+  m_length[m_fields] = end - begin;
+  m_fields++;
+
+  int high, low;
+
+  if( end - begin < 2 ||
+      ! hexValue( sentence[begin], high ) ||
+      ! hexValue( sentence[begin + 1], low ) )
+    {
+      return false;
+    }
+
+  return ( (high << 4) | low ) == sum;
+}
+
+bool NmeaDecoder::parseInt( const char* s, const int len, int& value )
+{
+  int n = len;
+  trim( s, n );
+
+  bool negative = false;
+
+  if( n > 0 && ( s[0] == '-' || s[0] == '+' ) )
+    {
+      negative = ( s[0] == '-' );
+      s++;
+      n--;
+    }
+
+  if( n == 0 || n > 9 )
+    {
+      return false;
+    }
+
+  int result = 0;
+
+  for( int i = 0; i < n; i++ )
+    {
+      if( ! isDigit( s[i] ) )
+        {
+          return false;
+        }
+
+      result = result * 10 + (s[i] - '0');
+    }
+
+  value = negative ? -result : result;
+  return true;
+}
+
+bool NmeaDecoder::parseDouble( const char* s, const int len, double& value )
+{
+  int n = len;
+  trim( s, n );
+
+  bool negative = false;
+
+  if( n > 0 && ( s[0] == '-' || s[0] == '+' ) )
+    {
+      negative = ( s[0] == '-' );
+      s++;
+      n--;
+    }
+
+  // The number is read as fixed point value, mantissa / 10^scale.
+  qint64 mantissa = 0;
+  int digits = 0;
+  int scale = 0;
+  bool point = false;
+
+  for( int i = 0; i < n; i++ )
+    {
+      const char c = s[i];
+
+      if( isDigit( c ) )
+        {
+          if( ++digits > 18 )
+            {
+              return false;
+            }
+
+          mantissa = mantissa * 10 + (c - '0');
+
+          if( point )
+            {
+              scale++;
+            }
+        }
+      else if( c == '.' && point == false )
+        {
+          point = true;
+        }
+      else
+        {
+          return false;
+        }
+    }
+
+  if( digits == 0 )
+    {
+      return false;
+    }
+
+  value = (double) mantissa / Pow10[scale];
+
+  if( negative )
+    {
+      value = -value;
+    }
+
+  return true;
+}
+
+bool NmeaDecoder::parseCoordinate( const char* s, const int len,
+                                   const int degreeDigits, int& value )
+{
+  /* The internal KFLog format for coordinates represents coordinates in
+     10.000'st of a minute. So, one minute corresponds to 10.000, one degree
+     to 600.000. The minutes are read as fixed point number with 8 decimals
+     and rounded to the KFLog resolution.
+  */
+  if( len <= degreeDigits )
+    {
+      return false;
+    }
+
+  int degrees = 0;
+
+  for( int i = 0; i < degreeDigits; i++ )
+    {
+      if( ! isDigit( s[i] ) )
+        {
+          return false;
+        }
+
+      degrees = degrees * 10 + (s[i] - '0');
+    }
+
+  qint64 minutes = 0;
+  qint64 fraction = 0;
+  int fractionDigits = 0;
+  bool point = false;
+  bool digits = false;
+
+  for( int i = degreeDigits; i < len; i++ )
+    {
+      const char c = s[i];
+
+      if( isDigit( c ) )
+        {
+          digits = true;
+
+          if( point == false )
+            {
+              if( minutes > 99 )
+                {
+                  return false;
+                }
+
+              minutes = minutes * 10 + (c - '0');
+            }
+          else if( fractionDigits < 8 )
+            {
+              fraction = fraction * 10 + (c - '0');
+              fractionDigits++;
+            }
+        }
+      else if( c == '.' && point == false )
+        {
+          point = true;
+        }
+      else
+        {
+          return false;
+        }
+    }
+
+  if( digits == false )
+    {
+      return false;
+    }
+
+  for( ; fractionDigits < 8; fractionDigits++ )
+    {
+      fraction *= 10;
+    }
+
+  // Minutes in units of 10^-8
+  const qint64 fixedMinutes = minutes * Q_INT64_C(100000000) + fraction;
+
+  value = degrees * 600000 + (int) ( (fixedMinutes + 5000) / 10000 );
+  return true;
+}
+
+bool NmeaDecoder::decodeTime( const int i, NmeaFix& fix ) const
+{
+  // hhmmss with optional fraction, which is not used.
+  const char* s = field( i );
+
+  if( fieldLength( i ) < 6 )
+    {
+      return false;
+    }
+
+  for( int k = 0; k < 6; k++ )
+    {
+      if( ! isDigit( s[k] ) )
+        {
+          return false;
+        }
+    }
+
+  fix.hour   = digitPair( s );
+  fix.minute = digitPair( s + 2 );
+  fix.second = digitPair( s + 4 );
+  fix.valid |= NmeaFix::Time;
+  return true;
+}
+
+bool NmeaDecoder::decodeDate( const int i, NmeaFix& fix ) const
+{
+  // ddmmyy, we assume that we only use this after the year 2000.
+  const char* s = field( i );
+
+  if( fieldLength( i ) != 6 )
+    {
+      return false;
+    }
+
+  for( int k = 0; k < 6; k++ )
+    {
+      if( ! isDigit( s[k] ) )
+        {
+          return false;
+        }
+    }
+
+  fix.day   = digitPair( s );
+  fix.month = digitPair( s + 2 );
+  fix.year  = digitPair( s + 4 ) + 2000;
+  fix.valid |= NmeaFix::Date;
+  return true;
+}
+
+bool NmeaDecoder::decodePosition( const int i, NmeaFix& fix ) const
+{
+  if( fieldLength( i + 1 ) == 0 || fieldLength( i + 3 ) == 0 )
+    {
+      return false;
+    }
+
+  int lat, lon;
+
+  if( ! parseCoordinate( field( i ), fieldLength( i ), 2, lat ) ||
+      ! parseCoordinate( field( i + 2 ), fieldLength( i + 2 ), 3, lon ) )
+    {
+      return false;
+    }
+
+  fix.latitude  = fieldIs( i + 1, 'S' ) ? -lat : lat;
+  fix.longitude = fieldIs( i + 3, 'W' ) ? -lon : lon;
+  fix.valid |= NmeaFix::Position;
+  return true;
+}
+
+bool NmeaDecoder::decodeDouble( const int i, double& value ) const
+{
+  return parseDouble( field( i ), fieldLength( i ), value );
+}
+
+QStringList NmeaDecoder::split( const QString& sentence )
+{
+  QStringList list;
+
+  const QChar* data = sentence.constData();
+  const int size = sentence.size();
+  int begin = 0;
+
+  for( int i = 0; i <= size; i++ )
+    {
+      if( i == size || data[i] == QLatin1Char(',') || data[i] == QLatin1Char('*') )
+        {
+          list.append( sentence.mid( begin, i - begin ) );
+          begin = i + 1;
+        }
+    }
+
+  return list;
+}
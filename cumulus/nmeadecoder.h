@@ -0,0 +1,241 @@
+/***********************************************************************
+**
+**   nmeadecoder.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class NmeaDecoder
+ *
+ * \author agent
+ *
+ * \brief Byte oriented decoder of the NMEA position sentences.
+ *
+ * The sentences RMC, GLL, GGA and GNS of the talkers BD, GP, GA, GL and GN
+ * are decoded without any memory allocation. The sentence type is selected
+ * by a switch over the characters of the identifier. The sentences GSA and
+ * GSV of these talkers and the proprietary sentences PGRMZ, PFLAA and PFLAU
+ * are recognized by the same switch and are only tokenized and verified.
+ * Their fields are split by \ref split without a regular expression. All
+ * other sentences are rejected after the identifier check.
+ *
+ * The tokenizer runs once over the sentence bytes. It records the begin and
+ * the length of every field in fixed arrays and computes the checksum in the
+ * same pass. The fields are parsed directly from the sentence bytes.
+ * Coordinates are converted with integer arithmetic to the KFLog format, so
+ * that no precision is lost at the minutes.
+ *
+ * The result is stored in the plain structure \ref NmeaFix.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef NMEA_DECODER_H
+#define NMEA_DECODER_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * Decoded data of a NMEA position sentence.
+ */
+struct NmeaFix
+  {
+    /** Decoded sentence types */
+    enum Sentence
+      {
+        None = 0, // not a position sentence, use the generic path
+        RMC,
+        GLL,
+        GGA,
+        GNS,
+        Corrupt,  // checksum error or not tokenizable
+        // Recognized sentences, which are not decoded into the fix
+        GSA,
+        GSV,
+        PGRMZ,
+        PFLAA,
+        PFLAU
+      };
+
+    /** Fix status reported by the sentence */
+    enum Status
+      {
+        Unknown = 0,
+        Valid,
+        Invalid
+      };
+
+    /** Bits of the member valid, set for every successfully parsed item */
+    enum Item
+      {
+        Time       = 1,
+        Date       = 2,
+        Position   = 4,
+        Speed      = 8,
+        Heading    = 16,
+        Altitude   = 32,
+        Satellites = 64
+      };
+
+    /** \return True, if the sentence type is decoded into the fix. */
+    static bool isPosition( const int type )
+    {
+      return type == RMC || type == GLL || type == GGA || type == GNS;
+    };
+
+    /** Sentence identifier, e.g. $GPRMC */
+    char identifier[8];
+    /** Number of fields inclusive identifier and checksum */
+    int fields;
+    int status;
+    uint valid;
+
+    /** UTC time and date */
+    int hour;
+    int minute;
+    int second;
+    int day;
+    int month;
+    int year;
+
+    /** Position in KFLog format */
+    int latitude;
+    int longitude;
+
+    /** Speed in knots */
+    double speed;
+    /** Course over ground in degrees */
+    double heading;
+    /** Altitude in the unit altitudeUnit */
+    double altitude;
+    char altitudeUnit;
+    int satellites;
+  };
+
+class NmeaDecoder
+{
+ public:
+
+  enum
+    {
+      /** Maximum number of tokenized fields. */
+      MaxFields = 32,
+      /** Maximum length of a sentence in bytes. */
+      MaxLength = 256
+    };
+
+  NmeaDecoder();
+
+  virtual ~NmeaDecoder();
+
+  /**
+   * Decodes a sentence. The characters are copied into an internal buffer
+   * as Latin-1 bytes.
+   *
+   * \return The decoded sentence type, see \ref NmeaFix::Sentence.
+   */
+  int decode( const QString& sentence, NmeaFix& fix );
+
+  /**
+   * Decodes a sentence of the passed bytes. The sentence may be terminated
+   * by CR, LF or a null byte before length is reached.
+   *
+   * \return The decoded sentence type, see \ref NmeaFix::Sentence.
+   */
+  int decode( const char* sentence, const int length, NmeaFix& fix );
+
+  /**
+   * Splits the sentence at commas and at the asterisk and verifies the
+   * checksum, if one is contained.
+   *
+   * \return False in case of a checksum error or too many fields.
+   */
+  bool tokenize( const char* sentence, const int length );
+
+  /**
+   * \return The number of fields of the last tokenized sentence.
+   */
+  int fieldCount() const
+  {
+    return m_fields;
+  };
+
+  /**
+   * \return The begin of the field, it is not null terminated.
+   */
+  const char* field( const int i ) const
+  {
+    return ( i < m_fields ) ? m_sentence + m_begin[i] : "";
+  };
+
+  /**
+   * \return The length of the field, 0 for missing fields.
+   */
+  int fieldLength( const int i ) const
+  {
+    return ( i < m_fields ) ? m_length[i] : 0;
+  };
+
+  /** Parses a decimal integer. */
+  static bool parseInt( const char* s, const int len, int& value );
+
+  /** Parses a decimal number with an optional fraction. */
+  static bool parseDouble( const char* s, const int len, double& value );
+
+  /**
+   * Parses a coordinate ddmm.mmmm respectively dddmm.mmmm into the KFLog
+   * format, that is 1/10000 minutes.
+   *
+   * \param degreeDigits Number of the degree digits, 2 or 3.
+   */
+  static bool parseCoordinate( const char* s, const int len,
+                               const int degreeDigits, int& value );
+
+  /**
+   * Splits a sentence at commas and at the asterisk. The result is the
+   * same as of a split with the regular expression [,*].
+   */
+  static QStringList split( const QString& sentence );
+
+ private:
+
+  bool decodeTime( const int i, NmeaFix& fix ) const;
+
+  bool decodeDate( const int i, NmeaFix& fix ) const;
+
+  /** Decodes latitude, hemisphere, longitude and hemisphere from field i. */
+  bool decodePosition( const int i, NmeaFix& fix ) const;
+
+  bool decodeDouble( const int i, double& value ) const;
+
+  /** Compares the field with a single character. */
+  bool fieldIs( const int i, const char c ) const
+  {
+    return fieldLength(i) == 1 && field(i)[0] == c;
+  };
+
+  /** Sentence of the last tokenize call. */
+  const char* m_sentence;
+
+  /** Begin offsets and lengths of the fields. */
+  short m_begin[MaxFields];
+  short m_length[MaxFields];
+  int m_fields;
+
+  /** Latin-1 copy of a QString sentence. */
+  char m_buffer[MaxLength];
+};
+
+#endif
@@ -15,7 +15,9 @@
  ***********************************************************************/
 
 #include <cmath>
+#include <cctype>
 #include <cstdlib>
+#include <cstring>
 #include <unistd.h>
 
 #include <QtCore>
@@ -23,6 +25,7 @@
 #include "airspace.h"
 #include "AirspaceHelper.h"
 #include "openairparser.h"
+#include "openairtokenizer.h"
 #include "mapcalc.h"
 #include "mapcontents.h"
 #include "filetools.h"
@@ -35,6 +38,17 @@
 #undef BOUNDING_BOX
 // #define BOUNDING_BOX 1
 
+
+// The OpenAir records are parsed directly on the bytes of the file. Only
+// airspace names, types and altitudes are converted into strings.
+
+using OpenAirTokenizer::isRecord;
+using OpenAirTokenizer::nextLine;
+using OpenAirTokenizer::readCoordinatePart;
+using OpenAirTokenizer::readNumber;
+using OpenAirTokenizer::readSeparator;
+using OpenAirTokenizer::skipBlanks;
+
 OpenAirParser::OpenAirParser() :
   _lineNumber(0),
   _objCounter(0),
@@ -49,9 +63,9 @@ OpenAirParser::OpenAirParser() :
   asLowerType(BaseMapElement::NotSet),
   _awy_width(0.0),
   _direction(1),
-  _boundingBox(0)
+  _boundingBox(0),
+  m_codec(QTextCodec::codecForName( "ISO 8859-15" ))
 {
-  QLocale::setDefault(QLocale::C);
 }
 
 OpenAirParser::~OpenAirParser()
@@ -85,30 +99,41 @@ bool OpenAirParser::parse( const QString& path,
       return false;
     }
 
-  QTextStream in(&source);
-  in.setCodec( "ISO 8859-15" );
+  // The file is mapped into the memory and parsed without a copy. If
+  // mapping is not possible, the file content is read into a buffer.
+  const qint64 size = source.size();
+  uchar* mapped = 0;
+  QByteArray buffer;
 
-  // Set these values to true to get loaded the first airspace.
-  _acRead = true;
-  _anRead = true;
+  if( size > 0 )
+    {
+      mapped = source.map( 0, size );
+    }
 
-  while( ! in.atEnd() )
+  if( mapped == 0 )
     {
-      QString line = in.readLine().simplified();
-      _lineNumber++;
+      buffer = source.readAll();
+    }
 
-      // qDebug("reading line %d: '%s'", _lineNumber, line.toLatin1().data());
+  const char* data = mapped ? reinterpret_cast<const char *>(mapped) : buffer.constData();
+  const char* const dataEnd = data + (mapped ? size : buffer.size());
 
-      if( line.startsWith( "*" ) || line.startsWith( "#" ) || line.isEmpty() )
-        {
-          continue;
-        }
+  // Set these values to true to get loaded the first airspace.
+  _acRead = true;
+  _anRead = true;
 
-      // delete comments at the end of the line before parsing it
-      line = line.split( '*' )[0];
-      line = line.split( '#' )[0];
+  const char* p = data;
+  const char* begin;
+  const char* end;
+
+  while( nextLine( p, dataEnd, begin, end, _lineNumber ) )
+    {
+      parseLine( begin, end );
+    }
 
-      parseLine( line );
+  if( mapped )
+    {
+      source.unmap( mapped );
     }
 
   if( _isCurrentAirspace )
@@ -160,10 +185,22 @@ void OpenAirParser::resetState()
   _parseError = false;
 }
 
-void OpenAirParser::parseLine(QString& line)
+QString OpenAirParser::toString( const char* begin, const char* end ) const
 {
-  if( (line.startsWith( "AC " ) || line.startsWith( "AN " )) &&
-       _acRead == true && _anRead == true )
+  if( m_codec )
+    {
+      return m_codec->toUnicode( begin, end - begin );
+    }
+
+  return QString::fromLatin1( begin, end - begin );
+}
+
+void OpenAirParser::parseLine( const char* line, const char* end )
+{
+  const bool isAC = isRecord( line, end, 'A', 'C' );
+  const bool isAN = isRecord( line, end, 'A', 'N' );
+
+  if( (isAC || isAN) && _acRead == true && _anRead == true )
     {
       // This indicates we're starting a new object and have to save the
       // the previous one.
@@ -175,19 +212,19 @@ void OpenAirParser::parseLine(QString& line)
       newAirspace();
     }
 
-  if (line.startsWith("AC "))
+  if( isAC )
     {
       // airspace class
       _acRead = true;
-      parseType(line);
+      parseType( line + 3, end );
       return;
     }
 
-  if (line.startsWith("AN "))
+  if( isAN )
     {
       // airspace name
       _anRead = true;
-      asName = line.mid(3);
+      asName = toString( line + 3, end ).simplified();
 
       if( asName == "COLORENTRY" )
         {
@@ -221,30 +258,30 @@ void OpenAirParser::parseLine(QString& line)
       return;
     }
 
-  if (line.startsWith("AH "))
+  if( isRecord( line, end, 'A', 'H' ) )
     {
       //airspace ceiling
-      QString alt = line.mid(3);
+      QString alt = toString( line + 3, end );
       parseAltitude(alt, asUpperType, asUpper);
       return;
     }
 
-  if (line.startsWith("AL "))
+  if( isRecord( line, end, 'A', 'L' ) )
     {
       //airspace floor
-      QString alt = line.mid(3);
+      QString alt = toString( line + 3, end );
       parseAltitude(alt, asLowerType, asLower);
       return;
     }
 
-  if (line.startsWith("DP "))
+  if( isRecord( line, end, 'D', 'P' ) )
     {
       int lat, lon;
 
       //polygon coordinate
-      QString coord = line.mid(3);
+      const char* p = line + 3;
 
-      if( parseCoordinate(coord, lat, lon) )
+      if( parseCoordinate( p, end, lat, lon ) )
         {
           asPA.append(QPoint(lat, lon));
         }
@@ -256,14 +293,13 @@ void OpenAirParser::parseLine(QString& line)
       return;
     }
 
-  if (line.startsWith("DC "))
+  if( isRecord( line, end, 'D', 'C' ) )
     {
-      bool ok;
-
       //circle
-      double radius = line.mid(3).toDouble(&ok);
+      const char* p = line + 3;
+      double radius;
 
-      if (ok)
+      if( readNumber( p, end, radius ) && skipBlanks( p, end ) == end )
         {
           addCircle(radius);
         }
@@ -275,10 +311,9 @@ void OpenAirParser::parseLine(QString& line)
       return;
     }
 
-  if (line.startsWith("DA "))
+  if( isRecord( line, end, 'D', 'A' ) )
     {
-
-      if( makeAngleArc(line.mid(3)) == false )
+      if( makeAngleArc( line + 3, end ) == false )
         {
           _parseError = true;
         }
@@ -286,9 +321,9 @@ void OpenAirParser::parseLine(QString& line)
       return;
     }
 
-  if (line.startsWith("DB "))
+  if( isRecord( line, end, 'D', 'B' ) )
     {
-      if( makeCoordinateArc(line.mid(3) ) == false )
+      if( makeCoordinateArc( line + 3, end ) == false )
         {
           _parseError = true;
         }
@@ -296,15 +331,15 @@ void OpenAirParser::parseLine(QString& line)
       return;
     }
 
-  if (line.startsWith("DY "))
+  if( isRecord( line, end, 'D', 'Y' ) )
     {
       // airway, ignore
       return;
     }
 
-  if (line.startsWith("V "))
+  if( isRecord( line, end, 'V' ) )
     {
-      if( parseVariable(line.mid(2)) == false )
+      if( parseVariable( line + 2, end ) == false )
         {
           _parseError = true;
         }
@@ -313,31 +348,31 @@ void OpenAirParser::parseLine(QString& line)
     }
 
   // ignored record types
-  if (line.startsWith("AT "))
+  if( isRecord( line, end, 'A', 'T' ) )
     {
       // label placement, ignore
       return;
     }
 
-  if (line.startsWith("TO "))
+  if( isRecord( line, end, 'T', 'O' ) )
     {
       // terrain open polygon, ignore
       return;
     }
 
-  if (line.startsWith("TC "))
+  if( isRecord( line, end, 'T', 'C' ) )
     {
       // terrain closed polygon, ignore
       return;
     }
 
-  if (line.startsWith("SP "))
+  if( isRecord( line, end, 'S', 'P' ) )
     {
       // pen definition, ignore
       return;
     }
 
-  if (line.startsWith("SB "))
+  if( isRecord( line, end, 'S', 'B' ) )
     {
       // brush definition, ignore
       return;
@@ -345,7 +380,7 @@ void OpenAirParser::parseLine(QString& line)
 
   // unknown record type
   qDebug( "OAP::parseLine: unknown type at line (%d): %s", _lineNumber,
-          line.toLatin1().data());
+          QByteArray( line, end - line ).data() );
 }
 
 void OpenAirParser::newAirspace()
@@ -405,27 +440,30 @@ void OpenAirParser::finishAirspace()
                                astPA,
                                asUpper, asUpperType,
                                asLower, asLowerType );
+
+  // The WGS84 points are used by the airspace conflict checks.
+  as->setWgsPolygon( asPA );
   _airlist.append(as);
   _objCounter++;
 
   // qDebug("finalized airspace %s. %d points in airspace", asName.toLatin1().data(), asPA.count());
 }
 
-void OpenAirParser::parseType(QString& line)
+void OpenAirParser::parseType( const char* begin, const char* end )
 {
-  line = line.mid(3);
+  QString type = toString( begin, end ).simplified();
 
-  if( ! m_airspaceTypeMapper.contains(line) )
+  if( ! m_airspaceTypeMapper.contains(type) )
     {
       // no mapping found to a Cumulus basetype
       qWarning("OAP: Line=%d AS Type, '%s' not mapped to a basetype. Object ignored.",
-               _lineNumber, line.toLatin1().data());
+               _lineNumber, type.toLatin1().data());
       _isCurrentAirspace = false; //stop accepting other lines in this object
       return;
     }
   else
     {
-      asType = m_airspaceTypeMapper.value(line, BaseMapElement::AirUkn);
+      asType = m_airspaceTypeMapper.value(type, BaseMapElement::AirUkn);
     }
 }
 
@@ -568,202 +606,118 @@ void OpenAirParser::parseAltitude(QString& line, BaseMapElement::elevationType&
 }
 
 
-bool OpenAirParser::parseCoordinate(QString& line, int& lat, int& lon)
+bool OpenAirParser::parseCoordinate( const char*& p, const char* end,
+                                     int& lat, int& lon )
 {
-  bool result=true;
-  line=line.toUpper();
+  lat = 0;
+  lon = 0;
 
-  int pos=0;
-  lat=0;
-  lon=0;
-
-  QRegExp reg("[NSEW]");
-  pos = reg.indexIn(line, 0);
-
-  if( pos == -1 )
+  // A coordinate consists of a latitude and a longitude part like:
+  // "50:11:31.1504N 17:42:38.5171E"
+  if( parseCoordinatePart( p, end, lat, lon ) == false ||
+      parseCoordinatePart( p, end, lat, lon ) == false )
     {
-      qWarning() << "OAP::parseCoordinate: line"
-                 << _lineNumber
-                 << "missing sky directions!";
-
       return false;
     }
 
-  QString part1 = line.left(pos+1);
-  QString part2 = line.mid(pos+1);
-
-  result &= parseCoordinatePart(part1, lat, lon);
-  result &= parseCoordinatePart(part2, lat, lon);
-
-  return result;
+  return true;
 }
 
-
-bool OpenAirParser::parseCoordinatePart(QString& line, int& lat, int& lon)
+bool OpenAirParser::parseCoordinatePart( const char*& p, const char* end,
+                                         int& lat, int& lon )
 {
-  bool ok, ok1, ok2 = false;
+  // Up to three elements are possible, degrees, minutes and seconds.
+  const char* part = p;
   int value = 0;
+  char skyDirection = 0;
 
-  if( line.isEmpty() )
+  if( readCoordinatePart( p, end, value, skyDirection ) == false )
     {
-      qWarning("OAP: Tried to parse empty coordinate part! Line %d", _lineNumber);
+      qWarning() << "OAP::parseCoordinatePart: wrong coordinate value"
+                 << QByteArray( part, end - part ) << "at line" << _lineNumber;
       return false;
     }
 
-  // A input line can contain elements like:
-  // P1= "50:11:31.1504N" P2= " 17:42:38.5171E"
-
-  QStringList sl = line.split(QChar(':'));
-  QString skyDirection;
-
-  if( sl.size() == 1 )
-    {
-      // One element is contained, that means decimal degrees
-      QString deg = sl.at(0).trimmed();
-      skyDirection = deg.right(1);
-
-      if( skyDirection != "N" && skyDirection != "S" && skyDirection != "W" && skyDirection != "E" )
-        {
-          qWarning() << "OAP::parseCoordinatePart: wrong sky direction at line" << _lineNumber;
-          return false;
-        }
-
-      deg = deg.left( deg.size() - 1 );
-
-      double ddeg = deg.toDouble(&ok);
-
-      if( ! ok )
-        {
-          qWarning() << "OAP::parseCoordinatePart: wrong coordinate value"
-                     << line << "at line" << _lineNumber;
-          return false;
-        }
-
-      value = static_cast<int> (rint(ddeg * 600000.0));
-    }
-  else if( sl.size() == 2 )
-    {
-      // Two elements are contained
-      QString deg = sl.at(0).trimmed();
-      QString min = sl.at(1).trimmed();
-
-      skyDirection = min.right(1);
-
-      if( skyDirection != "N" && skyDirection != "S" && skyDirection != "W" && skyDirection != "E" )
-        {
-          qWarning() << "OAP::parseCoordinatePart: wrong sky direction at line" << _lineNumber;
-          return false;
-        }
-
-      min = min.left( min.size() - 1 );
-
-      double ddeg = deg.toDouble(&ok);
-      double dmin = min.toDouble(&ok1);
-
-      if( ! ok || ! ok1 )
-        {
-          qWarning() << "OAP::parseCoordinatePart: wrong coordinate value"
-                      << line << "at line" << _lineNumber;
-          return false;
-        }
-
-      value = static_cast<int> (rint((ddeg * 600000.0) + (dmin * 10000.0)));
-    }
-  else if( sl.size() == 3 )
-    {
-      // Three elements are contained
-      QString deg = sl.at(0).trimmed();
-      QString min = sl.at(1).trimmed();
-      QString sec = sl.at(2).trimmed();
-
-      skyDirection = sec.right(1);
-
-      if( skyDirection != "N" && skyDirection != "S" && skyDirection != "W" && skyDirection != "E" )
-        {
-          qWarning() << "OAP::parseCoordinatePart: wrong sky direction" << skyDirection << "at line" << _lineNumber;
-          return false;
-        }
-
-      sec = sec.left( sec.size() - 1 );
-
-      double ddeg = deg.toDouble(&ok);
-      double dmin = min.toDouble(&ok1);
-      double dsec = sec.toDouble(&ok2);
-
-      if( ! ok || ! ok1 || ! ok2 )
-        {
-          qWarning() << "OAP::parseCoordinatePart: wrong coordinate value"
-                      << line << "at line" << _lineNumber;
-          return false;
-        }
-
-      value = static_cast<int> (rint((600000.0 * ddeg) + (10000.0 * (dmin + (dsec / 60.0)))));
-    }
-  else
+  if( skyDirection == 0 )
     {
-      qWarning("OAP::parseCoordinatePart: unknown format! Line %d", _lineNumber);
+      qWarning() << "OAP::parseCoordinate: line"
+                 << _lineNumber
+                 << "missing sky directions!";
       return false;
     }
 
-  if( skyDirection == "N" )
+  switch( skyDirection )
     {
-      lat = value;
-      return true;
-    }
-
-  if( skyDirection == "S" )
-    {
-      lat = -value;
-      return true;
-    }
-
-  if( skyDirection == "E" )
-    {
-      lon = value;
-      return true;
-    }
-
-  if( skyDirection == "W" )
-    {
-      lon = -value;
-      return true;
+      case 'N':
+        lat = value;
+        return true;
+      case 'S':
+        lat = -value;
+        return true;
+      case 'E':
+        lon = value;
+        return true;
+      case 'W':
+        lon = -value;
+        return true;
+      default:
+        break;
     }
 
+  qWarning() << "OAP::parseCoordinatePart: wrong sky direction"
+             << skyDirection << "at line" << _lineNumber;
   return false;
 }
 
-bool OpenAirParser::parseCoordinate(QString& line, QPoint& coord)
+bool OpenAirParser::parseCoordinate( const char*& p, const char* end,
+                                     QPoint& coord )
 {
   int lat=0, lon=0;
-  bool result = parseCoordinate(line, lat, lon);
+  bool result = parseCoordinate( p, end, lat, lon );
   coord.setX(lat);
   coord.setY(lon);
   return result;
 }
 
-bool OpenAirParser::parseVariable(QString line)
+bool OpenAirParser::parseVariable( const char* p, const char* end )
 {
-  QStringList arguments=line.split('=');
-  if (arguments.count()<2)
-    return false;
-
-  QString variable=arguments[0].simplified().toUpper();
-  QString value=arguments[1].simplified();
-  // qDebug("line %d: variable = '%s', value='%s'", _lineNumber, variable.toLatin1().data(), value.toLatin1().data());
-  if (variable=="X")
+  p = skipBlanks( p, end );
+
+  if( p == end )
+    {
+      return false;
+    }
+
+  const char variable = toupper( static_cast<unsigned char> (*p) );
+  p++;
+
+  if( readSeparator( p, end, '=' ) == false )
+    {
+      return false;
+    }
+
+  p = skipBlanks( p, end );
+
+  // qDebug("line %d: variable = '%c'", _lineNumber, variable);
+  if (variable=='X')
     {
       //coordinate
-      return parseCoordinate(value, _center);
+      return parseCoordinate( p, end, _center );
     }
 
-  if (variable=="D")
+  if (variable=='D')
     {
       //direction
-      if (value=="+")
+      if( end - p != 1 )
+        {
+          return false;
+        }
+
+      if (*p=='+')
         {
           _direction=+1;
         }
-      else if (value=="-")
+      else if (*p=='-')
         {
           _direction=-1;
         }
@@ -775,13 +729,12 @@ bool OpenAirParser::parseVariable(QString line)
       return true;
     }
 
-  if (variable=="W")
+  if (variable=='W')
     {
       //airway width
-      bool ok;
-      double result=value.toDouble(&ok);
+      double result;
 
-      if (ok)
+      if( readNumber( p, end, result ) )
         {
           _awy_width = result;
           return true;
@@ -789,7 +742,7 @@ bool OpenAirParser::parseVariable(QString line)
       return false;
     }
 
-  if (variable=="Z")
+  if (variable=='Z')
     {
       //zoom visiblity at zoom level; ignore
       return true;
@@ -801,33 +754,16 @@ bool OpenAirParser::parseVariable(QString line)
 
 // DA radius, angleStart, angleEnd
 // radius in nm, center defined by using V X=...
-bool OpenAirParser::makeAngleArc(QString line)
+bool OpenAirParser::makeAngleArc( const char* p, const char* end )
 {
   //qDebug("OpenAirParser::makeAngleArc");
-  bool ok;
   double radius, angle1, angle2;
 
-  QStringList arguments = line.split(',');
-  if (arguments.count()<3)
-    return false;
-
-  radius=arguments[0].trimmed().toDouble(&ok);
-
-  if ( !ok )
-    {
-      return false;
-    }
-
-  angle1=arguments[1].trimmed().toDouble(&ok);
-
-  if (!ok)
-    {
-      return false;
-    }
-
-  angle2=arguments[2].trimmed().toDouble(&ok);
-
-  if (!ok)
+  if( readNumber( p, end, radius ) == false ||
+      readSeparator( p, end, ',' ) == false ||
+      readNumber( p, end, angle1 ) == false ||
+      readSeparator( p, end, ',' ) == false ||
+      readNumber( p, end, angle2 ) == false )
     {
       return false;
     }
@@ -901,21 +837,20 @@ double OpenAirParser::bearing( QPoint& p1, QPoint& p2 )
  * DB coordinate1, coordinate2
  * center defined by using V X=...
  */
-bool OpenAirParser::makeCoordinateArc(QString line)
+bool OpenAirParser::makeCoordinateArc( const char* p, const char* end )
 {
   // qDebug("OpenAirParser::makeCoordinateArc");
   double radius, angle1, angle2;
 
-  //split of the coordinates, and check the number of arguments
-  QStringList arguments = line.split(',');
-  if (arguments.count()<2)
-    return false;
-
   QPoint coord1, coord2;
 
-  //try to parse the coordinates
-  if (!(parseCoordinate(arguments[0], coord1) && parseCoordinate(arguments[1], coord2)))
-    return false;
+  //try to parse the two coordinates, separated by a comma
+  if( parseCoordinate( p, end, coord1 ) == false ||
+      readSeparator( p, end, ',' ) == false ||
+      parseCoordinate( p, end, coord2 ) == false )
+    {
+      return false;
+    }
 
   //calculate the radius by taking the average of the two distances (in km)
   radius = (MapCalc::dist(&_center, &coord1) + MapCalc::dist(&_center, &coord2)) / 2.0;
@@ -946,6 +881,8 @@ void OpenAirParser::addCircle(const double& rLat, const double& rLon)
 {
   double x, y, phi;
 
+  asPA.reserve( asPA.size() + 360 );
+
   // qDebug("rLat: %d, rLon:%d", rLat, rLon);
   for (int i=0; i<360; i+=1)
     {
@@ -1003,6 +940,8 @@ void OpenAirParser::addArc(const double& rX, const double& rY,
 
   const double step = (STEP_WIDTH * M_PI) / 180.0;
 
+  asPA.reserve( asPA.size() + nsteps );
+
   double phi = angle1;
 
   for (int i = 0; i < nsteps - 1; i++)
@@ -34,6 +34,10 @@
  * For a file named airspace.txt, the matching mapping file would be
  * named airspace_mappings.conf and must be placed in the same directory.
  *
+ * The file is mapped into the memory and tokenized on byte level. The
+ * coordinates and numbers are parsed directly from the bytes, only names,
+ * types and altitudes are converted into strings.
+ *
  * \date 2005-2014
  *
  * \version 1.0
@@ -56,6 +60,7 @@
 #include "basemapelement.h"
 
 class Airspace;
+class QTextCodec;
 
 class OpenAirParser
 {
@@ -86,18 +91,24 @@ class OpenAirParser
  private:
 
   void resetState();
-  void parseLine(QString&);
+  void parseLine( const char* line, const char* end );
   void newAirspace();
   void newPA();
   void finishAirspace();
-  void parseType(QString&);
+  void parseType( const char* begin, const char* end );
   void parseAltitude(QString&, BaseMapElement::elevationType&, uint&);
-  bool parseCoordinate(QString&, int& lat, int& lon);
-  bool parseCoordinate(QString&, QPoint&);
-  bool parseCoordinatePart(QString&, int& lat, int& lon);
-  bool parseVariable(QString);
-  bool makeAngleArc(QString);
-  bool makeCoordinateArc(QString);
+  bool parseCoordinate( const char*& p, const char* end, int& lat, int& lon );
+  bool parseCoordinate( const char*& p, const char* end, QPoint& coord );
+  bool parseCoordinatePart( const char*& p, const char* end, int& lat, int& lon );
+  bool parseVariable( const char* p, const char* end );
+  bool makeAngleArc( const char* p, const char* end );
+  bool makeCoordinateArc( const char* p, const char* end );
+
+  /**
+   * Converts a byte range of the file into a string.
+   */
+  QString toString( const char* begin, const char* end ) const;
+
   double bearing( QPoint& p1, QPoint& p2 );
   void addCircle(const double& rLat, const double& rLon);
   void addCircle(const double& radius);
@@ -137,6 +148,9 @@ private:
 
   // bounding box
   QRect *_boundingBox;
+
+  // codec of the OpenAir files
+  QTextCodec* m_codec;
 };
 
 #endif
@@ -0,0 +1,259 @@
+/***********************************************************************
+**
+**   openairtokenizer.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \author agent
+ *
+ * \brief Byte level tokenizer of OpenAir files.
+ *
+ * The functions work directly on the bytes of an OpenAir file without any
+ * string conversion or memory allocation. They are used by the
+ * \ref OpenAirParser and by its benchmark in tests/openair.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef OPEN_AIR_TOKENIZER_H
+#define OPEN_AIR_TOKENIZER_H
+
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+namespace OpenAirTokenizer
+{
+  /** Checks, if the character is a blank of a line. */
+  inline bool isBlank( const char c )
+  {
+    return c == ' ' || c == '\t' || c == '\r';
+  }
+
+  /** Returns the first non blank character of the range. */
+  inline const char* skipBlanks( const char* p, const char* end )
+  {
+    while( p < end && isBlank( *p ) )
+      {
+        p++;
+      }
+
+    return p;
+  }
+
+  /** Returns the end of the range without trailing blanks. */
+  inline const char* trimEnd( const char* begin, const char* end )
+  {
+    while( end > begin && isBlank( *(end - 1) ) )
+      {
+        end--;
+      }
+
+    return end;
+  }
+
+  /**
+   * Checks, if the line starts with the record code, followed by a blank.
+   * The code must consist of one or two characters.
+   */
+  inline bool isRecord( const char* line, const char* end,
+                        const char c1, const char c2 = 0 )
+  {
+    const int len = c2 ? 2 : 1;
+
+    if( end - line <= len || line[0] != c1 || (c2 && line[1] != c2) )
+      {
+        return false;
+      }
+
+    return isBlank( line[len] );
+  }
+
+  /**
+   * Returns the next line with content. Comment lines and empty lines are
+   * skipped, comments at the end of a line and the blanks around the
+   * content are removed.
+   *
+   * \param p Current position in the data, moved behind the returned line.
+   *
+   * \param dataEnd End of the data.
+   *
+   * \param begin Begin of the content of the line.
+   *
+   * \param end End of the content of the line.
+   *
+   * \param lineNumber Incremented for every read line.
+   *
+   * \return False, if the end of the data is reached.
+   */
+  inline bool nextLine( const char*& p, const char* dataEnd,
+                        const char*& begin, const char*& end,
+                        int& lineNumber )
+  {
+    while( p < dataEnd )
+      {
+        const char* nl = static_cast<const char *>(memchr( p, '\n', dataEnd - p ));
+        const char* lineEnd = nl ? nl : dataEnd;
+
+        begin = skipBlanks( p, lineEnd );
+
+        p = nl ? nl + 1 : dataEnd;
+        lineNumber++;
+
+        if( begin == lineEnd || *begin == '*' || *begin == '#' )
+          {
+            continue;
+          }
+
+        // delete comments at the end of the line
+        end = begin;
+
+        while( end < lineEnd && *end != '*' && *end != '#' )
+          {
+            end++;
+          }
+
+        end = trimEnd( begin, end );
+
+        if( begin < end )
+          {
+            return true;
+          }
+      }
+
+    return false;
+  }
+
+  /**
+   * Reads a decimal number at p, leading blanks are skipped. On success p
+   * is moved behind the number.
+   */
+  inline bool readNumber( const char*& p, const char* end, double& value )
+  {
+    const char* s = skipBlanks( p, end );
+    bool negative = false;
+
+    if( s < end && (*s == '-' || *s == '+') )
+      {
+        negative = (*s == '-');
+        s++;
+      }
+
+    double v = 0.0;
+    int digits = 0;
+
+    while( s < end && *s >= '0' && *s <= '9' )
+      {
+        v = v * 10.0 + (*s - '0');
+        s++;
+        digits++;
+      }
+
+    if( s < end && *s == '.' )
+      {
+        double fraction = 0.0;
+        double divisor = 1.0;
+
+        s++;
+
+        while( s < end && *s >= '0' && *s <= '9' )
+          {
+            fraction = fraction * 10.0 + (*s - '0');
+            divisor *= 10.0;
+            s++;
+            digits++;
+          }
+
+        v += fraction / divisor;
+      }
+
+    if( digits == 0 )
+      {
+        return false;
+      }
+
+    value = negative ? -v : v;
+    p = s;
+    return true;
+  }
+
+  /**
+   * Reads the passed separator at p, leading blanks are skipped. On success
+   * p is moved behind the separator.
+   */
+  inline bool readSeparator( const char*& p, const char* end, const char separator )
+  {
+    const char* s = skipBlanks( p, end );
+
+    if( s < end && *s == separator )
+      {
+        p = s + 1;
+        return true;
+      }
+
+    return false;
+  }
+
+  /**
+   * Reads a coordinate part like "50:11:31.1504N" at p. Up to three numbers,
+   * degrees, minutes and seconds, are separated by colons. On success p is
+   * moved behind the sky direction.
+   *
+   * \param value The absolute value of the part in the KFLog format.
+   *
+   * \param skyDirection The upper case character behind the numbers, 0 if
+   *                     the line ends before.
+   *
+   * \return False, if a number cannot be read.
+   */
+  inline bool readCoordinatePart( const char*& p, const char* end,
+                                  int& value, char& skyDirection )
+  {
+    double values[3] = { 0.0, 0.0, 0.0 };
+    int count = 0;
+
+    while( count < 3 )
+      {
+        if( readNumber( p, end, values[count] ) == false )
+          {
+            return false;
+          }
+
+        count++;
+
+        if( readSeparator( p, end, ':' ) == false )
+          {
+            break;
+          }
+      }
+
+    p = skipBlanks( p, end );
+
+    if( p == end )
+      {
+        skyDirection = 0;
+        return true;
+      }
+
+    skyDirection = toupper( static_cast<unsigned char> (*p) );
+    p++;
+
+    value = static_cast<int> (rint( (600000.0 * values[0]) +
+                                    (10000.0 * (values[1] + (values[2] / 60.0))) ));
+    return true;
+  }
+}
+
+#endif
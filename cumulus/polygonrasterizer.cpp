@@ -0,0 +1,135 @@
+/***********************************************************************
+**
+**   polygonrasterizer.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cmath>
+
+#include "polygonrasterizer.h"
+
+PolygonRasterizer::PolygonRasterizer( const int width, const int height ) :
+  m_width(width),
+  m_height(height),
+  m_count(0),
+  m_start(0.0)
+{
+  m_crossings.resize( 256 );
+}
+
+PolygonRasterizer::~PolygonRasterizer()
+{
+}
+
+void PolygonRasterizer::addPolygon( const QPolygonF& polygon )
+{
+  const int size = polygon.size();
+
+  if( size < 3 )
+    {
+      return;
+    }
+
+  // The sign of the area gives the orientation of the polygon.
+  double area = 0.0;
+
+  for( int i = 0, j = size - 1; i < size; j = i++ )
+    {
+      area += polygon.at(j).x() * polygon.at(i).y() -
+              polygon.at(i).x() * polygon.at(j).y();
+    }
+
+  const int orientation = ( area < 0.0 ) ? -1 : 1;
+
+  for( int i = 0, j = size - 1; i < size; j = i++ )
+    {
+      const QPointF& p1 = polygon.at(j);
+      const QPointF& p2 = polygon.at(i);
+
+      addEdge( p1.x(), p1.y(), p2.x(), p2.y(), orientation );
+    }
+}
+
+void PolygonRasterizer::addPolygon( const QPolygon& polygon )
+{
+  const int size = polygon.size();
+
+  if( size < 3 )
+    {
+      return;
+    }
+
+  double area = 0.0;
+
+  for( int i = 0, j = size - 1; i < size; j = i++ )
+    {
+      area += double(polygon.at(j).x()) * double(polygon.at(i).y()) -
+              double(polygon.at(i).x()) * double(polygon.at(j).y());
+    }
+
+  const int orientation = ( area < 0.0 ) ? -1 : 1;
+
+  for( int i = 0, j = size - 1; i < size; j = i++ )
+    {
+      const QPoint& p1 = polygon.at(j);
+      const QPoint& p2 = polygon.at(i);
+
+      addEdge( p1.x(), p1.y(), p2.x(), p2.y(), orientation );
+    }
+}
+
+void PolygonRasterizer::addEdge( double x1, double y1,
+                                 double x2, double y2,
+                                 int direction )
+{
+  if( y1 == y2 )
+    {
+      // Horizontal edges do not cross any scanline.
+      return;
+    }
+
+  if( y1 > y2 )
+    {
+      qSwap( x1, x2 );
+      qSwap( y1, y2 );
+      direction = -direction;
+    }
+
+  // Scanlines pass through the cell centers. An edge covers the scanlines
+  // in the half open interval [y1, y2).
+  const int firstRow = qMax( 0, (int) ceil( y1 - 0.5 ) );
+  const int lastRow  = qMin( m_height - 1, (int) ceil( y2 - 0.5 ) - 1 );
+
+  if( firstRow > lastRow )
+    {
+      return;
+    }
+
+  const double slope = (x2 - x1) / (y2 - y1);
+
+  if( m_count + (lastRow - firstRow + 1) > m_crossings.size() )
+    {
+      m_crossings.resize( qMax( m_crossings.size() * 2,
+                                m_count + (lastRow - firstRow + 1) ) );
+    }
+
+  Crossing* c = m_crossings.data() + m_count;
+
+  for( int row = firstRow; row <= lastRow; row++, c++ )
+    {
+      c->row       = row;
+      c->x         = x1 + (row + 0.5 - y1) * slope;
+      c->direction = direction;
+    }
+
+  m_count += lastRow - firstRow + 1;
+}
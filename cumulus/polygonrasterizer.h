@@ -0,0 +1,193 @@
+/***********************************************************************
+**
+**   polygonrasterizer.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class PolygonRasterizer
+ *
+ * \author agent
+ *
+ * \brief Scanline rasterizer for polygons.
+ *
+ * The rasterizer determines all cells of a raster, which centers are
+ * located inside of the added polygons. The orientation of every polygon
+ * is normalized, so that the result is the union of all added polygons.
+ * The found cells are passed row by row as horizontal spans to a functor,
+ * which must provide the operator
+ *
+ * \code
+ * void operator()( int row, int firstColumn, int lastColumn );
+ * \endcode
+ *
+ * The intersections of all edges with the scanlines are collected in one
+ * buffer and sorted afterwards. Therefore the effort depends only on the
+ * number of edges and the number of covered scanlines. The buffer is
+ * reused, so that no allocations are necessary per polygon.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef POLYGON_RASTERIZER_H
+#define POLYGON_RASTERIZER_H
+
+#include <algorithm>
+#include <cmath>
+
+#include <QPolygon>
+#include <QPolygonF>
+#include <QVector>
+
+class PolygonRasterizer
+{
+ public:
+
+  /**
+   * Creates a rasterizer.
+   *
+   * \param width The number of columns of the raster.
+   *
+   * \param height The number of rows of the raster.
+   */
+  PolygonRasterizer( const int width, const int height );
+
+  virtual ~PolygonRasterizer();
+
+  /**
+   * Removes all added polygons.
+   */
+  void clear()
+  {
+    m_count = 0;
+  };
+
+  /**
+   * Adds a polygon in raster coordinates. The cell (row, column) covers the
+   * area from column to column + 1 and from row to row + 1.
+   */
+  void addPolygon( const QPolygonF& polygon );
+
+  /**
+   * Adds a polygon with integer raster coordinates.
+   */
+  void addPolygon( const QPolygon& polygon );
+
+  /**
+   * Rasterizes the union of all added polygons and removes them afterwards.
+   *
+   * \param span The functor, which is called for every found span.
+   */
+  template<class SpanFunctor>
+  void fill( SpanFunctor& span )
+  {
+    std::sort( m_crossings.begin(), m_crossings.begin() + m_count );
+
+    int i = 0;
+
+    while( i < m_count )
+      {
+        const int row = m_crossings.at(i).row;
+        int winding = 0;
+
+        // Cells between crossings with a winding number unequal zero are
+        // inside of at least one polygon.
+        for( ; i < m_count && m_crossings.at(i).row == row; i++ )
+          {
+            const Crossing& c = m_crossings.at(i);
+
+            const int last = winding;
+            winding += c.direction;
+
+            if( last == 0 && winding != 0 )
+              {
+                m_start = c.x;
+              }
+            else if( last != 0 && winding == 0 )
+              {
+                int firstCol = (int) ceil( m_start - 0.5 );
+                int lastCol  = (int) ceil( c.x - 0.5 ) - 1;
+
+                firstCol = qMax( firstCol, 0 );
+                lastCol  = qMin( lastCol, m_width - 1 );
+
+                if( firstCol <= lastCol )
+                  {
+                    span( row, firstCol, lastCol );
+                  }
+              }
+          }
+      }
+
+    clear();
+  };
+
+  /**
+   * Rasterizes a single polygon.
+   *
+   * \param polygon The polygon in raster coordinates.
+   *
+   * \param width The number of columns of the raster.
+   *
+   * \param height The number of rows of the raster.
+   *
+   * \param span The functor, which is called for every found span.
+   */
+  template<class SpanFunctor>
+  static void fill( const QPolygonF& polygon,
+                    const int width,
+                    const int height,
+                    SpanFunctor& span )
+  {
+    PolygonRasterizer rasterizer( width, height );
+    rasterizer.addPolygon( polygon );
+    rasterizer.fill( span );
+  };
+
+ private:
+
+  /** Adds the crossings of one edge with the scanlines. */
+  void addEdge( double x1, double y1, double x2, double y2, int direction );
+
+  /** Intersection of a polygon edge with a scanline. */
+  class Crossing
+  {
+   public:
+
+    int    row;
+    double x;
+
+    /** Winding direction of the edge, +1 or -1. */
+    int    direction;
+
+    bool operator<( const Crossing& other ) const
+    {
+      return row < other.row || ( row == other.row && x < other.x );
+    };
+  };
+
+  int m_width;
+  int m_height;
+
+  /** Buffer of the collected crossings. */
+  QVector<Crossing> m_crossings;
+
+  /** Number of used elements in the crossing buffer. */
+  int m_count;
+
+  /** Start of the current span. */
+  double m_start;
+};
+
+#endif
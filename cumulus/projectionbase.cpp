@@ -15,6 +15,8 @@
 **
 ***********************************************************************/
 
+#include <cmath>
+
 #include "projectionbase.h"
 #include "projectionlambert.h"
 #include "projectioncylindric.h"
@@ -27,6 +29,24 @@ ProjectionBase::~ProjectionBase()
 {}
 
 
+void ProjectionBase::projectPoints( const qint32* latitude,
+                                    const qint32* longitude,
+                                    const int count,
+                                    const double factor,
+                                    qint32* x,
+                                    qint32* y )
+{
+  for( int i = 0; i < count; i++ )
+    {
+      double rLat = M_PI / 108000000.0 * (double) latitude[i];
+      double rLon = M_PI / 108000000.0 * (double) longitude[i];
+
+      x[i] = (qint32) rint( projectX( rLat, rLon ) * factor );
+      y[i] = (qint32) rint( projectY( rLat, rLon ) * factor );
+    }
+}
+
+
 void SaveProjection(QDataStream & s, ProjectionBase * p)
 {
   s << qint8( p->projectionType() );
@@ -56,6 +56,27 @@ class ProjectionBase
   /** */
   virtual double projectY(const double& latitude, const double& longitude)  = 0;
 
+  /**
+   * Projects arrays of positions. The coordinates are given in 1/10000
+   * minutes, the projected values are multiplied with the factor and
+   * rounded to the nearest integer. The default implementation calls
+   * projectX() and projectY() for every position, the derived classes
+   * provide faster kernels with the same results.
+   *
+   * @param latitude Array of latitudes.
+   * @param longitude Array of longitudes.
+   * @param count Number of positions.
+   * @param factor Factor applied to the projected values.
+   * @param x Array receiving the projected x-values.
+   * @param y Array receiving the projected y-values.
+   */
+  virtual void projectPoints( const qint32* latitude,
+                              const qint32* longitude,
+                              const int count,
+                              const double factor,
+                              qint32* x,
+                              qint32* y );
+
   /** */
   virtual double invertLat(const double& x, const double& y) const = 0;
 
@@ -17,6 +17,7 @@
 
 #include <cmath>
 #include "projectioncylindric.h"
+#include "projectionsimd.h"
 
 #define NUM_TO_RAD(num) ( M_PI  / 108000000.0 * (double)(num) )
 
@@ -61,6 +62,44 @@ bool ProjectionCylindric::initProjection(int v1_new)
 }
 
 
+void ProjectionCylindric::projectPoints( const qint32* latitude,
+                                         const qint32* longitude,
+                                         const int count,
+                                         const double factor,
+                                         qint32* x,
+                                         qint32* y )
+{
+  // The operations are done in the same order as in projectX() and
+  // projectY(), so that the results are identical.
+  const double toRad = M_PI / 108000000.0;
+
+  int i = 0;
+
+#ifdef PROJECTION_SIMD
+
+  using namespace ProjectionSimd;
+
+  const Vector vToRad     = set( toRad );
+  const Vector vCos       = set( cos_v1 );
+  const Vector vFactor    = set( factor );
+  const Vector vNegFactor = set( -factor );
+
+  for( ; i + 1 < count; i += 2 )
+    {
+      store( x + i, mul( mul( mul( vToRad, load( longitude + i ) ), vCos ), vFactor ) );
+      store( y + i, mul( mul( vToRad, load( latitude + i ) ), vNegFactor ) );
+    }
+
+#endif
+
+  for( ; i < count; i++ )
+    {
+      x[i] = (qint32) rint( toRad * (double) longitude[i] * cos_v1 * factor );
+      y[i] = (qint32) rint( -(toRad * (double) latitude[i]) * factor );
+    }
+}
+
+
 /**
  * Saves the parameters specific to this projection to a stream
  */
@@ -73,6 +73,17 @@ class ProjectionCylindric : public ProjectionBase
     return -latitude;
   };
 
+  /**
+   * Projects arrays of positions with vectorized kernels, see
+   * ProjectionBase::projectPoints().
+   */
+  virtual void projectPoints( const qint32* latitude,
+                              const qint32* longitude,
+                              const int count,
+                              const double factor,
+                              qint32* x,
+                              qint32* y );
+
   /**
    * Returns the latitude of a given projected position in radiant.
    *
@@ -17,6 +17,7 @@
 
 #include <cmath>
 #include "projectionlambert.h"
+#include "projectionsimd.h"
 
 #define NUM_TO_RAD(num) ( (M_PI / 108000000.0) * (double)(num) )
 
@@ -131,6 +132,94 @@ double ProjectionLambert::projectY(const double& latitude, const double& longitu
 }
 
 
+void ProjectionLambert::projectPoints( const qint32* latitude,
+                                       const qint32* longitude,
+                                       const int count,
+                                       const double factor,
+                                       qint32* x,
+                                       qint32* y )
+{
+  // The trigonometric functions are taken from the math library for a
+  // block of positions, the remaining calculations are vectorized. The
+  // operations are done in the same order as in projectX() and projectY(),
+  // so that the results are identical.
+  enum { BlockSize = 64 };
+
+  const double toRad = M_PI / 108000000.0;
+  const double lonFactor = 2.0 * var3;
+
+  double sinLat[BlockSize];
+  double sinLon[BlockSize];
+  double cosLon[BlockSize];
+
+  // Consecutive positions often have the same latitude.
+  qint32 lastLat = 0;
+  double lastSinLat = 0.0;
+  bool lastValid = false;
+
+  for( int start = 0; start < count; start += BlockSize )
+    {
+      const int n = qMin( int(BlockSize), count - start );
+
+      for( int i = 0; i < n; i++ )
+        {
+          const qint32 lat = latitude[start + i];
+
+          if( lastValid == false || lat != lastLat )
+            {
+              lastLat = lat;
+              lastSinLat = sin( toRad * (double) lat );
+              lastValid = true;
+            }
+
+          sinLat[i] = lastSinLat;
+
+          const double arg = lonFactor * (toRad * (double) longitude[start + i] - origin);
+
+          sinLon[i] = sin( arg );
+          cosLon[i] = cos( arg );
+        }
+
+      qint32* xb = x + start;
+      qint32* yb = y + start;
+
+      int i = 0;
+
+#ifdef PROJECTION_SIMD
+
+      using namespace ProjectionSimd;
+
+      const Vector vSinv1   = set( sinv1 );
+      const Vector vVar1    = set( var1 );
+      const Vector vCosv1_2 = set( cosv1_2 );
+      const Vector vVar4    = set( var4 );
+      const Vector vFactor  = set( factor );
+
+      for( ; i + 1 < n; i += 2 )
+        {
+          const Vector root =
+            mul( vVar4,
+                 ProjectionSimd::sqrt( add( vCosv1_2,
+                                            mul( sub( vSinv1, load( sinLat + i ) ),
+                                                 vVar1 ) ) ) );
+
+          store( xb + i, mul( mul( root, load( sinLon + i ) ), vFactor ) );
+          store( yb + i, mul( mul( root, load( cosLon + i ) ), vFactor ) );
+        }
+
+#endif
+
+      for( ; i < n; i++ )
+        {
+          const double root = var4 * sqrt( cosv1_2 + (sinv1 - sinLat[i]) * var1 );
+
+          xb[i] = (qint32) rint( root * sinLon[i] * factor );
+          yb[i] = (qint32) rint( root * cosLon[i] * factor );
+        }
+    }
+}
+
+
 double ProjectionLambert::invertLat(const double& x, const double& y) const
 {
   //    double lat =
@@ -91,6 +91,17 @@ public:
    */
   virtual double projectY(const double& latitude, const double& longitude) ;
 
+  /**
+   * Projects arrays of positions with vectorized kernels, see
+   * ProjectionBase::projectPoints().
+   */
+  virtual void projectPoints( const qint32* latitude,
+                              const qint32* longitude,
+                              const int count,
+                              const double factor,
+                              qint32* x,
+                              qint32* y );
+
   /**
    * Returns the latitude of a given projected position in radiant.
    */
@@ -0,0 +1,146 @@
+/***********************************************************************
+**
+**   projectionsimd.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \author agent
+ *
+ * \brief Vector operations used by the projection kernels.
+ *
+ * The operations work on two double values at once. The instruction set is
+ * selected at compile time, SSE2 on x86 and NEON on ARM64. If none of them
+ * is available, PROJECTION_SIMD is not defined and the kernels use scalar
+ * code only. The conversion to integer rounds to the nearest even value
+ * like rint() does in the default rounding mode, so that the vectorized
+ * kernels deliver the same results as the scalar code.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef PROJECTION_SIMD_H
+#define PROJECTION_SIMD_H
+
+#include <QtGlobal>
+
+#if defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#define PROJECTION_SIMD 1
+
+namespace ProjectionSimd
+{
+  typedef __m128d Vector;
+
+  /** Loads two integers and converts them to double. */
+  inline Vector load( const qint32* p )
+  {
+    return _mm_cvtepi32_pd( _mm_loadl_epi64( reinterpret_cast<const __m128i *> (p) ) );
+  }
+
+  inline Vector load( const double* p )
+  {
+    return _mm_loadu_pd( p );
+  }
+
+  inline Vector set( const double value )
+  {
+    return _mm_set1_pd( value );
+  }
+
+  inline Vector add( const Vector a, const Vector b )
+  {
+    return _mm_add_pd( a, b );
+  }
+
+  inline Vector sub( const Vector a, const Vector b )
+  {
+    return _mm_sub_pd( a, b );
+  }
+
+  inline Vector mul( const Vector a, const Vector b )
+  {
+    return _mm_mul_pd( a, b );
+  }
+
+  inline Vector sqrt( const Vector a )
+  {
+    return _mm_sqrt_pd( a );
+  }
+
+  /** Rounds two doubles to the nearest integers and stores them. */
+  inline void store( qint32* p, const Vector a )
+  {
+    _mm_storel_epi64( reinterpret_cast<__m128i *> (p), _mm_cvtpd_epi32( a ) );
+  }
+}
+
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+
+#include <arm_neon.h>
+
+#define PROJECTION_SIMD 1
+
+namespace ProjectionSimd
+{
+  typedef float64x2_t Vector;
+
+  /** Loads two integers and converts them to double. */
+  inline Vector load( const qint32* p )
+  {
+    return vcvtq_f64_s64( vmovl_s32( vld1_s32( p ) ) );
+  }
+
+  inline Vector load( const double* p )
+  {
+    return vld1q_f64( p );
+  }
+
+  inline Vector set( const double value )
+  {
+    return vdupq_n_f64( value );
+  }
+
+  inline Vector add( const Vector a, const Vector b )
+  {
+    return vaddq_f64( a, b );
+  }
+
+  inline Vector sub( const Vector a, const Vector b )
+  {
+    return vsubq_f64( a, b );
+  }
+
+  inline Vector mul( const Vector a, const Vector b )
+  {
+    return vmulq_f64( a, b );
+  }
+
+  inline Vector sqrt( const Vector a )
+  {
+    return vsqrtq_f64( a );
+  }
+
+  /** Rounds two doubles to the nearest integers and stores them. */
+  inline void store( qint32* p, const Vector a )
+  {
+    vst1_s32( p, vmovn_s64( vcvtnq_s64_f64( a ) ) );
+  }
+}
+
+#endif
+
+#endif
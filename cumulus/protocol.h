@@ -29,7 +29,7 @@
 
 //------- Used by Command/Response channel -------//
 
-#define MSG_PROTOCOL   "Cumulus-GPS_Client_IPC_V1.5_Axel@kflog.org"
+#define MSG_PROTOCOL   "Cumulus-GPS_Client_IPC_V1.6_Axel@kflog.org"
 
 #define MSG_MAGIC      "\\Magic\\"
 
@@ -72,6 +72,9 @@
 // GPS data message
 #define MSG_GPS_DATA  "#Gps_Data#"
 
+// GPS data message with several sentences, each terminated by a newline
+#define MSG_GPS_BATCH  "#Gps_Batch#"
+
 // Flarm flight list response
 #define MSG_FLARM_FLIGHT_LIST_RES  "#FFLR#"
 
@@ -187,12 +187,18 @@ void ReachableList::addItemsToList(enum MapContents::ListID item)
     }
   else
     {
-      // get number of elements in the list
-      int nr = _globalMapContents->getListLength(item);
+      // Only the sites inside of the maximum reach are checked.
+      QVector<int> candidates;
 
-      // qDebug("No of sites: %d type %d", nr, item );
-      for (int i=0; i<nr; i++ )
+      _globalMapContents->getSpatialIndex( item ).queryRadius( lastPosition,
+                                                               _maxReach,
+                                                               candidates );
+
+      // qDebug("No of sites: %d type %d", candidates.size(), item );
+      for (int c=0; c<candidates.size(); c++ )
         {
+          const int i = candidates.at(c);
+
           // Get specific site data from current list. We have to distinguish
           // between AirfieldList, GilderSiteList and OutlandingList.
           Airfield* site;
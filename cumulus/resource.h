@@ -90,12 +90,22 @@
 //=================================================================================
 // Compiled file versions. Increment this value, if you change the compiled format.
 //=================================================================================
-#define FILE_VERSION_GROUND_C   104
-#define FILE_VERSION_TERRAIN_C  104
-#define FILE_VERSION_MAP_C      103
+#define FILE_VERSION_GROUND_C   106
+#define FILE_VERSION_TERRAIN_C  106
+#define FILE_VERSION_MAP_C      105
+
+// Last compiled file versions with projected coordinates. Such files are
+// converted, if their source files are not available.
+#define FILE_VERSION_GROUND_PROJECTED_C   104
+#define FILE_VERSION_TERRAIN_PROJECTED_C  104
+#define FILE_VERSION_MAP_PROJECTED_C      103
+
+// Version definition for elevation raster files, stored beside compiled
+// terrain files.
+#define FILE_VERSION_ELEVATION_C 100
 
 // Version definition for compiled airspace files.
-#define FILE_VERSION_AIRSPACE_C 2
+#define FILE_VERSION_AIRSPACE_C 3
 
 // Version definition for compiled airfield files.
 #define FILE_VERSION_AIRFIELD_C 3
@@ -156,6 +156,22 @@ SettingsPageInformation::SettingsPageInformation( QWidget *parent ) :
   topLayout->addWidget( buttonReset, row, 2, Qt::AlignLeft );
   row++;
 
+  topLayout->addWidget(new QLabel(tr("Airspace lookahead time:"), this), row, 0);
+
+  spinLookahead = new NumberEditor;
+  spinLookahead->setDecimalVisible( false );
+  spinLookahead->setPmVisible( false );
+  spinLookahead->setMaxLength(3);
+  spinLookahead->setRange(0, 120);
+  spinLookahead->setSpecialValueText(tr("Off"));
+  spinLookahead->setSuffix( " s" );
+  spinLookahead->setTip("0...120 s");
+  QRegExpValidator* lValidator = new QRegExpValidator( QRegExp( "([0-9]{1,3})" ), this );
+  spinLookahead->setValidator( lValidator );
+  spinLookahead->setMinimumWidth( mw );
+  topLayout->addWidget( spinLookahead, row, 1 );
+  row++;
+
   checkAlarmSound = new QCheckBox(tr("Alarm Sound"), this);
   checkAlarmSound->setObjectName("checkAlarmSound");
   checkAlarmSound->setChecked(true);
@@ -282,6 +298,7 @@ void SettingsPageInformation::load()
   spinWaypoint->setValue( conf->getWaypointDisplayTime() );
   spinWarning->setValue( conf->getWarningDisplayTime() );
   spinSuppress->setValue( conf->getWarningSuppressTime() );
+  spinLookahead->setValue( conf->getAirspaceLookaheadTime() );
   checkAlarmSound->setChecked( conf->getAlarmSoundOn() );
   checkFlarmAlarms->setChecked( conf->getPopupFlarmAlarms() );
   calculateNearestSites->setChecked( conf->getNearestSiteCalculatorSwitch() );
@@ -302,6 +319,7 @@ void SettingsPageInformation::save()
   conf->setWaypointDisplayTime( spinWaypoint->value() );
   conf->setWarningDisplayTime( spinWarning->value() );
   conf->setWarningSuppressTime( spinSuppress->value() );
+  conf->setAirspaceLookaheadTime( spinLookahead->value() );
   conf->setAlarmSoundOn( checkAlarmSound->isChecked() );
   conf->setPopupFlarmAlarms( checkFlarmAlarms->isChecked() );
   conf->setNearestSiteCalculatorSwitch( calculateNearestSites->isChecked() );
@@ -320,6 +338,7 @@ void SettingsPageInformation::slot_setFactoryDefault()
   spinWaypoint->setValue(WAYPOINT_DISPLAY_TIME_DEFAULT);
   spinWarning->setValue(WARNING_DISPLAY_TIME_DEFAULT);
   spinSuppress->setValue(WARNING_SUPPRESS_TIME_DEFAULT);
+  spinLookahead->setValue(AIRSPACE_LOOKAHEAD_TIME_DEFAULT);
   checkAlarmSound->setChecked(ALARM_SOUND_DEFAULT);
   checkFlarmAlarms->setChecked( true );
   inverseInfoDisplay->setChecked( false );
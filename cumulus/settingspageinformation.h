@@ -113,6 +113,7 @@ class SettingsPageInformation : public QWidget
   NumberEditor* spinWarning;
   NumberEditor* spinInfo;
   NumberEditor* spinSuppress;
+  NumberEditor* spinLookahead;
 
   QCheckBox*   checkAlarmSound;
   QCheckBox*   checkFlarmAlarms;
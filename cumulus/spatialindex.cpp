@@ -0,0 +1,248 @@
+/***********************************************************************
+**
+**   spatialindex.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cmath>
+
+#include <QtAlgorithms>
+
+#include "mapcalc.h"
+#include "spatialindex.h"
+
+SpatialIndex::SpatialIndex()
+{
+}
+
+void SpatialIndex::clear()
+{
+  m_indexes.clear();
+  m_boxes.clear();
+  m_cells.clear();
+  m_cellItems.clear();
+}
+
+int SpatialIndex::cellOf( const int coordinate )
+{
+  // Round down also for negative coordinates.
+  if( coordinate >= 0 )
+    {
+      return coordinate / CellSize;
+    }
+
+  return -((-coordinate - 1) / CellSize) - 1;
+}
+
+void SpatialIndex::insert( const int index, const QRect& wgsBox )
+{
+  m_indexes.append( index );
+  m_boxes.append( wgsBox.normalized() );
+}
+
+void SpatialIndex::build()
+{
+  m_cells.clear();
+  m_cellItems.clear();
+
+  // First pass counts the elements per cell.
+  QHash<int, int> counts;
+
+  for( int i = 0; i < m_boxes.size(); i++ )
+    {
+      const QRect& box = m_boxes.at(i);
+
+      for( int lat = cellOf( box.left() ); lat <= cellOf( box.right() ); lat++ )
+        {
+          for( int lon = cellOf( box.top() ); lon <= cellOf( box.bottom() ); lon++ )
+            {
+              counts[cellKey( lat, lon )]++;
+            }
+        }
+    }
+
+  // Assign a range of the item vector to every cell.
+  int offset = 0;
+
+  QHash<int, int>::const_iterator it;
+
+  for( it = counts.constBegin(); it != counts.constEnd(); ++it )
+    {
+      m_cells.insert( it.key(), qMakePair( offset, 0 ) );
+      offset += it.value();
+    }
+
+  m_cellItems.resize( offset );
+
+  // Second pass fills the ranges.
+  for( int i = 0; i < m_boxes.size(); i++ )
+    {
+      const QRect& box = m_boxes.at(i);
+
+      for( int lat = cellOf( box.left() ); lat <= cellOf( box.right() ); lat++ )
+        {
+          for( int lon = cellOf( box.top() ); lon <= cellOf( box.bottom() ); lon++ )
+            {
+              QPair<int, int>& range = m_cells[cellKey( lat, lon )];
+              m_cellItems[range.first + range.second] = i;
+              range.second++;
+            }
+        }
+    }
+}
+
+void SpatialIndex::collect( const QRect& wgsBox, QVector<int>& positions ) const
+{
+  if( m_cells.isEmpty() )
+    {
+      return;
+    }
+
+  const QRect box = wgsBox.normalized();
+
+  const int latMin = cellOf( box.left() );
+  const int latMax = cellOf( box.right() );
+  const int lonMin = cellOf( box.top() );
+  const int lonMax = cellOf( box.bottom() );
+
+  QVector<int> found;
+
+  qint64 cellsInBox = qint64( latMax - latMin + 1 ) * (lonMax - lonMin + 1);
+
+  if( cellsInBox > m_cells.size() )
+    {
+      // The box covers more cells than are occupied, check the occupied ones.
+      QHash<int, QPair<int, int> >::const_iterator it;
+
+      for( it = m_cells.constBegin(); it != m_cells.constEnd(); ++it )
+        {
+          const int lat = it.key() / 4096 - 1024;
+          const int lon = it.key() % 4096 - 2048;
+
+          if( lat < latMin || lat > latMax || lon < lonMin || lon > lonMax )
+            {
+              continue;
+            }
+
+          for( int j = 0; j < it.value().second; j++ )
+            {
+              found.append( m_cellItems.at( it.value().first + j ) );
+            }
+        }
+    }
+  else
+    {
+      for( int lat = latMin; lat <= latMax; lat++ )
+        {
+          for( int lon = lonMin; lon <= lonMax; lon++ )
+            {
+              QHash<int, QPair<int, int> >::const_iterator it =
+                  m_cells.constFind( cellKey( lat, lon ) );
+
+              if( it == m_cells.constEnd() )
+                {
+                  continue;
+                }
+
+              for( int j = 0; j < it.value().second; j++ )
+                {
+                  found.append( m_cellItems.at( it.value().first + j ) );
+                }
+            }
+        }
+    }
+
+  // Elements spanning several cells are found more than once.
+  qSort( found );
+
+  int last = -1;
+
+  for( int i = 0; i < found.size(); i++ )
+    {
+      const int pos = found.at(i);
+
+      if( pos == last )
+        {
+          continue;
+        }
+
+      last = pos;
+
+      if( m_boxes.at(pos).intersects( box ) )
+        {
+          positions.append( pos );
+        }
+    }
+}
+
+void SpatialIndex::queryViewport( const QRect& wgsBox, QVector<int>& indexes ) const
+{
+  indexes.clear();
+
+  QVector<int> positions;
+  collect( wgsBox, positions );
+
+  for( int i = 0; i < positions.size(); i++ )
+    {
+      indexes.append( m_indexes.at( positions.at(i) ) );
+    }
+
+  qSort( indexes );
+}
+
+void SpatialIndex::queryRadius( const QPoint& wgsCenter,
+                                const double radiusKm,
+                                QVector<int>& indexes ) const
+{
+  indexes.clear();
+
+  // One minute of latitude is 1.852 km.
+  const int deltaLat = (int) ceil( radiusKm / 1.852 * 10000.0 );
+
+  double cosLat = cos( wgsCenter.x() / 600000.0 * M_PI / 180.0 );
+
+  if( cosLat < 0.01 )
+    {
+      cosLat = 0.01;
+    }
+
+  const int deltaLon = (int) ceil( deltaLat / cosLat );
+
+  QRect box( wgsCenter.x() - deltaLat, wgsCenter.y() - deltaLon,
+             2 * deltaLat + 1, 2 * deltaLon + 1 );
+
+  QVector<int> positions;
+  collect( box, positions );
+
+  QPoint center( wgsCenter );
+
+  for( int i = 0; i < positions.size(); i++ )
+    {
+      const int pos = positions.at(i);
+      const QRect& ebox = m_boxes.at(pos);
+
+      if( ebox.width() == 1 && ebox.height() == 1 )
+        {
+          // Point elements are filtered by their distance.
+          QPoint point( ebox.topLeft() );
+
+          if( MapCalc::dist( &center, &point ) > radiusKm )
+            {
+              continue;
+            }
+        }
+
+      indexes.append( m_indexes.at(pos) );
+    }
+
+  qSort( indexes );
+}
@@ -0,0 +1,130 @@
+/***********************************************************************
+**
+**   spatialindex.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <QHash>
+#include <QPair>
+#include <QPoint>
+#include <QRect>
+#include <QVector>
+
+/**
+ * \class SpatialIndex
+ *
+ * \author agent
+ *
+ * \brief Uniform grid index over the elements of a map element list.
+ *
+ * Every element is inserted with its list index and its bounding box in
+ * KFLog WGS84 coordinates (x=latitude, y=longitude). After \ref build the
+ * index answers viewport and radius queries. The cost of a query depends
+ * only on the number of grid cells touched and the elements found in them,
+ * not on the length of the list.
+ *
+ * The returned list indexes are sorted ascending, so that the drawing order
+ * of the list is kept.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+class SpatialIndex
+{
+ public:
+
+  /** Edge length of a grid cell in 1/10000 minutes, that are 15 minutes. */
+  enum { CellSize = 150000 };
+
+  SpatialIndex();
+
+  /**
+   * Removes all elements from the index.
+   */
+  void clear();
+
+  /**
+   * \return True, if no element is contained in the index.
+   */
+  bool isEmpty() const
+  {
+    return m_boxes.isEmpty();
+  };
+
+  /**
+   * Adds an element with its WGS84 bounding box to the index.
+   */
+  void insert( const int index, const QRect& wgsBox );
+
+  /**
+   * Adds an element with its WGS84 position to the index.
+   */
+  void insert( const int index, const QPoint& wgsPoint )
+  {
+    insert( index, QRect( wgsPoint, QSize( 1, 1 ) ) );
+  };
+
+  /**
+   * Packs the inserted elements into the grid. Must be called after the
+   * last insert and before the first query.
+   */
+  void build();
+
+  /**
+   * Returns the indexes of all elements, whose bounding box intersects the
+   * passed WGS84 box.
+   */
+  void queryViewport( const QRect& wgsBox, QVector<int>& indexes ) const;
+
+  /**
+   * Returns the indexes of all elements, which are located inside of the
+   * circle with the passed radius in km around the WGS84 center point.
+   * Elements with an extent are returned, if their bounding box touches
+   * the bounding box of the circle.
+   */
+  void queryRadius( const QPoint& wgsCenter,
+                    const double radiusKm,
+                    QVector<int>& indexes ) const;
+
+ private:
+
+  /** Returns the key of the cell containing the passed cell coordinates. */
+  static int cellKey( const int latCell, const int lonCell )
+  {
+    return (latCell + 1024) * 4096 + (lonCell + 2048);
+  };
+
+  /** Returns the cell coordinate of the passed WGS84 coordinate. */
+  static int cellOf( const int coordinate );
+
+  /**
+   * Collects the positions of all elements in the cells touched by the box,
+   * filtered by their bounding boxes.
+   */
+  void collect( const QRect& wgsBox, QVector<int>& positions ) const;
+
+  /** Element indexes and bounding boxes, as they were inserted. */
+  QVector<int>   m_indexes;
+  QVector<QRect> m_boxes;
+
+  /** Cell key to range in m_cellItems, built by build(). */
+  QHash<int, QPair<int, int> > m_cells;
+
+  /** Positions in m_indexes and m_boxes, grouped by cells. */
+  QVector<int> m_cellItems;
+};
+
+#endif
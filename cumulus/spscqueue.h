@@ -0,0 +1,102 @@
+/***********************************************************************
+**
+**   spscqueue.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class SpscQueue
+ *
+ * \author agent
+ *
+ * \brief Lock-free queue for one producer and one consumer thread.
+ *
+ * The queue is a ring of Size slots, one slot is always kept free. The
+ * producer writes only the head index, the consumer only the tail index.
+ * An item is written before the head is published with release semantics
+ * and is read after the head has been loaded with acquire semantics, so
+ * that no lock is needed. The indexes are accessed with the fetch methods
+ * of QAtomicInt, which are available in Qt4 and Qt5.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <QAtomicInt>
+
+template <class T, int Size>
+class SpscQueue
+{
+ public:
+
+  SpscQueue() :
+    m_head(0),
+    m_tail(0)
+  {};
+
+  /**
+   * Appends an item. Must be called only by the producer thread.
+   *
+   * \return False, if the queue is full.
+   */
+  bool push( const T& item )
+  {
+    const int head = m_head.fetchAndAddRelaxed( 0 );
+    const int next = (head + 1) % Size;
+
+    if( next == m_tail.fetchAndAddAcquire( 0 ) )
+      {
+        return false;
+      }
+
+    m_items[head] = item;
+    m_head.fetchAndStoreRelease( next );
+    return true;
+  };
+
+  /**
+   * Takes the oldest item. Must be called only by the consumer thread.
+   *
+   * \return False, if the queue is empty.
+   */
+  bool pop( T& item )
+  {
+    const int tail = m_tail.fetchAndAddRelaxed( 0 );
+
+    if( tail == m_head.fetchAndAddAcquire( 0 ) )
+      {
+        return false;
+      }
+
+    item = m_items[tail];
+    m_tail.fetchAndStoreRelease( (tail + 1) % Size );
+    return true;
+  };
+
+ private:
+
+  Q_DISABLE_COPY( SpscQueue )
+
+  /** Next slot to be written by the producer. */
+  QAtomicInt m_head;
+
+  /** Next slot to be read by the consumer. */
+  QAtomicInt m_tail;
+
+  T m_items[Size];
+};
+
+#endif
@@ -72,11 +72,14 @@ GpsClient::GpsClient( const ushort portIn )
   forwardGpsData   = true;
   connectionLost   = true;
   shutdown         = false;
-  datapointer      = databuffer;
-  dbsize           = 0;
   badSentences     = 0;
   activateTimeout  = false;
 
+  // The frame header behind the length is constant.
+  memcpy( forwardHeader + sizeof(uint), MSG_GPS_BATCH " ", sizeof(MSG_GPS_BATCH) );
+  forwardPartCount = 0;
+  forwardBatchSize = 0;
+
   // establish a connection to the server
   if( ipcPort )
     {
@@ -216,23 +219,19 @@ bool GpsClient::readGpsData()
       return false;
     }
 
-  // First check, if enough space is available in the receiver buffer.
+  // First check, if space is available in the receiver buffer.
   // If we read only trash for a while we can run in a dead lock.
-  int freeSpace = sizeof(databuffer) - dbsize;
-
-  if( freeSpace < 10 )
+  if( rxBuffer.isFull() )
     {
-      // Reset buffer pointer because the minimal free buffer space is
-      // reached. That will discard all already read data but we never
-      // read a end of line. That is our emergency break.
-      datapointer = databuffer;
-      dbsize = 0;
+      // Reset the buffer because it contains no end of line. That will
+      // discard all already read data. That is our emergency break.
+      rxBuffer.clear();
     }
 
   // all available GPS data lines are read successive
   int bytes = 0;
 
-  bytes = read( fd, datapointer, sizeof(databuffer) - dbsize -1 );
+  bytes = read( fd, rxBuffer.writePointer(), rxBuffer.writeSpace() );
 
   if( bytes == 0 ) // Nothing read, should normally not happen
     {
@@ -249,10 +248,7 @@ bool GpsClient::readGpsData()
 
   if( bytes > 0 )
     {
-      dbsize      += bytes;
-      datapointer += bytes;
-
-      databuffer[dbsize] = '\0'; // terminate buffer with a null
+      rxBuffer.commit( bytes );
 
       readSentenceFromBuffer();
 
@@ -324,10 +320,8 @@ bool GpsClient::openGps( const char *deviceIn, const uint ioSpeedIn )
       return false;
     }
 
-  // reset buffer pointer
-  datapointer = databuffer;
-  dbsize      = 0;
-  memset( databuffer, 0, sizeof(databuffer) );
+  // reset receive buffer
+  rxBuffer.clear();
 
   if( fd != -1 )
     {
@@ -487,73 +481,35 @@ bool GpsClient::openGps( const char *deviceIn, const uint ioSpeedIn )
 
 /**
  * This method tries to read all lines contained in the receive buffer. A line
- * is always terminated by a newline and is taken over in the receiver queue,
- * if the checksum is valid and the GPS identifier is requested.
+ * is always terminated by a newline and is forwarded to the server, if the
+ * checksum is valid. The lines are checked in the receive buffer and are
+ * forwarded as one batch message.
  */
 void GpsClient::readSentenceFromBuffer()
 {
-  char *start = databuffer;
-  char *end   = 0;
+  const char *record;
+  int length;
 
-  while(strlen(start))
+  while( (record = rxBuffer.nextLine( length )) != 0 )
     {
-      // Search for a newline in the receiver buffer.
-      // That is the normal end of a GPS sentence.
-      if( ! (end = strchr( start, '\n' )) )
-        {
-          // No newline in the receiver buffer, wait for more characters
-          return;
-        }
-
-      if( start == end )
-        {
-          // skip newline and start at next position with a new search
-          start++;
-          continue;
-        }
-
-      // found a complete record in the buffer, it will be extracted now
-      char *record = (char *) malloc( end-start + 2 );
-
-      memset( record, 0, end-start + 2 );
-
-      strncpy( record, start, end-start + 1);
-
-      if( verifyCheckSum( record ) == true )
+      if( verifyCheckSum( record, length ) == true )
         {
           // Forward sentence to the server, if checksum is ok and
           // processing is desired.
-          // if( checkGpsMessageFilter( record ) == true && forwardGpsData == true )
           // AP 2018: we forward all sentences now.
           if( forwardGpsData == true )
             {
-              QByteArray ba;
-              ba.append( MSG_GPS_DATA );
-              ba.append( ' ' );
-              ba.append( record );
-              writeForwardMsg( ba.data() );
+              forwardGpsSentence( record, length );
             }
         }
 
 #ifdef DEBUG_NMEA
-      qDebug() << "GpsClient::read():" << record;
+      qDebug() << "GpsClient::read():" << QByteArray::fromRawData( record, length );
 #endif
-
-      free(record);
-      record = 0;
-
-      // remove queued record from receive buffer
-      memmove( databuffer, end+1,
-               databuffer + sizeof(databuffer)-1 - end );
-
-      datapointer -= (end+1 - databuffer);
-
-      dbsize -= ( end+1 - databuffer);
-
-      start = databuffer;
-
-      end = 0;
     }
+
+  // All sentences of this read are sent together.
+  flushGpsSentences();
 }
 
 /**
@@ -623,7 +579,7 @@ bool GpsClient::checkGpsMessageFilter( const char *sentence )
  *
  * @returns true (success) or false (error occurred)
  */
-bool GpsClient::verifyCheckSum( const char *sentence )
+bool GpsClient::verifyCheckSum( const char *sentence, const int length )
 {
   // Filter out wrong data messages read in from the GPS port. Known messages
   // do start with a dollar sign or an exclamation mark.
@@ -631,42 +587,15 @@ bool GpsClient::verifyCheckSum( const char *sentence )
   // with a dollar sign or an exclamation mark.
   if( sentence[0] != '$' && sentence[0] != '!' )
     {
-      qWarning() << "GpsClient::CheckSumError:" << sentence;
+      qWarning() << "GpsClient::CheckSumError:"
+                 << QByteArray::fromRawData( sentence, length );
       badSentences++;
       return false;
     }
 
   badSentences = 0;
 
-  for( int i = strlen(sentence) - 1; i >= 0; i-- )
-    {
-      if( sentence[i] == '*' )
-        {
-          if( (strlen(sentence) - 1 - i) < 2 )
-            {
-              // too less characters
-              return false;
-            }
-
-          char checkBytes[3];
-          checkBytes[0] = sentence[i+1];
-          checkBytes[1] = sentence[i+2];
-          checkBytes[2] = '\0';
-
-          uchar checkSum = (uchar) QString( checkBytes ).toUShort( 0, 16 );
-
-          if( checkSum == calcCheckSum( sentence ) )
-            {
-              return true;
-            }
-          else
-            {
-              return false;
-            }
-        }
-    }
-
-  return false;
+  return NmeaRingBuffer::verifyCheckSum( sentence, length );
 }
 
 /** Calculate check sum over NMEA record. */
@@ -979,7 +908,7 @@ void GpsClient::writeServerMsg( const char *msg )
  */
 void GpsClient::writeForwardMsg( const char *msg )
 {
-  static QString method = "GpsClient::writeForwardMsg():";
+  static const char *method = "GpsClient::writeForwardMsg():";
 
   // The message to be transfered starts with the message length.
   uint msgLen = strlen( msg );
@@ -987,10 +916,88 @@ void GpsClient::writeForwardMsg( const char *msg )
   QByteArray ba = QByteArray::fromRawData( (const char *) &msgLen, sizeof(msgLen) );
   ba.append( msg );
 
+  writeForwardFrame( ba.data(), ba.size(), method );
+
+#ifdef DEBUG
+  qDebug() << method << msg;
+#endif
+
+  return;
+}
+
+/**
+ * Appends a GPS sentence to the batch message. The sentence is not copied,
+ * the batch refers to the line returned by NmeaRingBuffer::nextLine. The
+ * lines stay valid until the receive buffer is filled again, that is done
+ * after the batch has been sent. The sentences keep their line ends, which
+ * separate them in the batch.
+ */
+void GpsClient::forwardGpsSentence( const char *sentence, const int length )
+{
+  if( forwardPartCount == MaxForwardParts ||
+      forwardBatchSize + length > NmeaRingBuffer::Capacity )
+    {
+      flushGpsSentences();
+    }
+
+  if( forwardPartCount == 0 )
+    {
+      forwardParts[0].iov_base = forwardHeader;
+      forwardParts[0].iov_len  = sizeof(forwardHeader);
+      forwardPartCount = 1;
+    }
+
+  forwardParts[forwardPartCount].iov_base = (void *) sentence;
+  forwardParts[forwardPartCount].iov_len  = length;
+  forwardPartCount++;
+
+  forwardBatchSize += length;
+}
+
+/**
+ * Sends the collected GPS sentences as one message to the server.
+ */
+void GpsClient::flushGpsSentences()
+{
+  static const char *method = "GpsClient::flushGpsSentences():";
+
+  if( forwardBatchSize == 0 )
+    {
+      return;
+    }
+
+  // The key is followed by a space, that replaces the terminating null.
+  uint msgLen = sizeof(MSG_GPS_BATCH) + forwardBatchSize;
+
+  memcpy( forwardHeader, &msgLen, sizeof(msgLen) );
+
+  const int count = forwardPartCount;
+
+  forwardPartCount = 0;
+  forwardBatchSize = 0;
+
+  // The header and the sentences are written at once without copying them
+  // into one frame.
+  checkForwardResult( clientForward.writeMsg( forwardParts, count ), method );
+}
+
+/**
+ * Writes a frame via the forward channel to the server.
+ */
+void GpsClient::writeForwardFrame( const char *frame,
+                                   const int size,
+                                   const char *method )
+{
+  checkForwardResult( clientForward.writeMsg( (char *) frame, size ), method );
+}
+
+/**
+ * Checks the result of a write via the forward channel.
+ */
+void GpsClient::checkForwardResult( const int done, const char *method )
+{
   // We use non blocking IO for the transfer. Therefore we have to consider some
   // special return codes.
-  int done = clientForward.writeMsg( (char *) ba.data(), ba.size() );
-
   if( done < 0 )
     {
       if( errno == EWOULDBLOCK )
@@ -1006,12 +1013,6 @@ void GpsClient::writeForwardMsg( const char *msg )
           setShutdownFlag(true);
         }
     }
-
-#ifdef DEBUG
-  qDebug() << method << msg;
-#endif
-
-  return;
 }
 
 /**
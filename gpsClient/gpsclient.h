@@ -52,6 +52,8 @@
 #include <QTime>
 
 #include "ipc.h"
+#include "nmearingbuffer.h"
+#include "protocol.h"
 
 //++++++++++++++++++++++ CLASS GpsClient +++++++++++++++++++++++++++
 
@@ -125,11 +127,12 @@ public:
   uchar calcCheckSum( const char *sentence );
 
   /**
-   * Verify the checksum of the passed sentences.
+   * Verify the checksum of the passed sentences. The sentence is checked in
+   * place, it needs not to be null terminated.
    *
    * @returns true (success) or false (error occurred)
    */
-  bool verifyCheckSum( const char *sentence );
+  bool verifyCheckSum( const char *sentence, const int length );
 
   /**
    * Check GPS message key, if it shall be processed or filtered out.
@@ -172,6 +175,30 @@ public:
 
   void writeForwardMsg( const char *msg );
 
+  /**
+   * Writes a complete frame, consisting of the message length and the
+   * message, via the forward channel to the server.
+   */
+  void writeForwardFrame( const char *frame, const int size, const char *method );
+
+  /**
+   * Checks the result of a write via the forward channel. A message, which
+   * would block, is dropped. Other errors shut down the client.
+   */
+  void checkForwardResult( const int done, const char *method );
+
+  /**
+   * Appends a GPS sentence to the batch in forwardParts. The sentence is not
+   * copied, it must stay valid until \ref flushGpsSentences is called.
+   */
+  void forwardGpsSentence( const char *sentence, const int length );
+
+  /**
+   * Sends all GPS sentences collected in forwardParts as one message to the
+   * server.
+   */
+  void flushGpsSentences();
+
   uint getBaudrate( int rate );
 
   void readSentenceFromBuffer();
@@ -224,12 +251,25 @@ public:
   // RX/TX rate of serial device
   uint ioSpeedTerminal, ioSpeedDevice;
 
-  // data buffers and pointers
-  char* datapointer;
+  // receive buffer of the GPS data
+  NmeaRingBuffer rxBuffer;
+
+  // Maximum number of parts of a GPS sentence batch message.
+  enum { MaxForwardParts = 64 };
+
+  // Header of the GPS sentence batch message. It contains the message length
+  // followed by the MSG_GPS_BATCH key and a space, which is set only once.
+  char forwardHeader[sizeof(uint) + sizeof(MSG_GPS_BATCH)];
+
+  // Parts of the GPS sentence batch message. The first part is the header,
+  // the others refer to the sentences in the receive buffer.
+  struct iovec forwardParts[MaxForwardParts];
 
-  char  databuffer[1024];
+  // Number of used parts in forwardParts.
+  int forwardPartCount;
 
-  int   dbsize;
+  // Number of sentence bytes in forwardParts.
+  int forwardBatchSize;
 
   // file descriptor to GPS device
   int fd;
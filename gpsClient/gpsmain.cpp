@@ -33,6 +33,7 @@ using namespace std;
 #include "signalhandler.h"
 #include "gpsclient.h"
 #include "gpscon.h"
+#include "nmearingbuffer.h"
 
 //----------------------------------------------------
 // import global sutdown flag, set by SignalHandler
@@ -49,18 +50,23 @@ void usage( char * progName )
        << "       -help   (optional)  display this usage" << endl
        << "       -port   (mandatory) socket port for IPC to server" << endl
        << "       -slave  (optional)  process is running as slave" << endl
+       << "       -replay (optional)  feed a NMEA log file through the" << endl
+       << "                           receive buffer, report the throughput" << endl
+       << "                           and exit" << endl
        << endl;
 
   exit(2);
 }
 
 /**
- * Main of GPS client program. The program has three options
+ * Main of GPS client program. The program has four options
  *
  * a) -help shows the usage to the caller
  * b) -port Port number of listening end point of cumulus process
  * c) -slave if this option is set, process will terminate, if parent
  *           has gone down (zombie protection).
+ * d) -replay runs the passed NMEA log file through the receive buffer and
+ *            the checksum check as benchmark and exits.
  *
  * This module checks the passed options and handles the socket events.
  *
@@ -92,6 +98,18 @@ int main( int argc, char* argv[] )
           slave = true; // Running as slave
           i++;
         }
+      else if ( strcmp( argv[i], "-replay" ) == 0 )
+        {
+          if ( i+1 < argc )
+            {
+              return NmeaRingBuffer::replay( argv[i+1] );
+            }
+
+          cerr << basename(argv[0])
+               << ": missing argument!"
+               << endl;
+          usage( argv[0] );
+        }
       else if ( strcmp( argv[i], "-port" ) == 0 )
         {
           if ( i+1 < argc )
@@ -0,0 +1,233 @@
+/***********************************************************************
+**
+**   nmearingbuffer.cpp
+**
+**   This file is part of Cumulus
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent (agent@local)
+**
+**   This program is free software; you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation; either version 2 of the License, or
+**   (at your option) any later version.
+**
+***********************************************************************/
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <QtCore>
+
+#include "nmearingbuffer.h"
+
+NmeaRingBuffer::NmeaRingBuffer() :
+  m_tail(0),
+  m_size(0),
+  m_scanned(0)
+{
+}
+
+NmeaRingBuffer::~NmeaRingBuffer()
+{
+}
+
+int NmeaRingBuffer::writeSpace() const
+{
+  if( m_size == Capacity )
+    {
+      return 0;
+    }
+
+  int head = (m_tail + m_size) % Capacity;
+
+  if( head < m_tail )
+    {
+      // The data wrap around, the free space lies between head and tail.
+      return m_tail - head;
+    }
+
+  return Capacity - head;
+}
+
+const char* NmeaRingBuffer::nextLine( int& length )
+{
+  while( m_scanned < m_size )
+    {
+      // Search the newline in the next contiguous part of the unscanned data.
+      int pos   = (m_tail + m_scanned) % Capacity;
+      int count = qMin( m_size - m_scanned, Capacity - pos );
+
+      const char* nl = static_cast<const char *>( memchr( m_buffer + pos, '\n', count ) );
+
+      if( nl == 0 )
+        {
+          m_scanned += count;
+          continue;
+        }
+
+      int lineLength = m_scanned + (nl - (m_buffer + pos)) + 1;
+      const char* line = m_buffer + m_tail;
+
+      if( m_tail + lineLength > Capacity )
+        {
+          // The line wraps around the buffer end, copy it together.
+          int first = Capacity - m_tail;
+
+          memcpy( m_line, m_buffer + m_tail, first );
+          memcpy( m_line + first, m_buffer, lineLength - first );
+          line = m_line;
+        }
+
+      m_tail     = (m_tail + lineLength) % Capacity;
+      m_size    -= lineLength;
+      m_scanned  = 0;
+
+      if( m_size == 0 )
+        {
+          // Start at the buffer begin to get the largest free space.
+          m_tail = 0;
+        }
+
+      if( lineLength == 1 )
+        {
+          // skip empty line
+          continue;
+        }
+
+      length = lineLength;
+      return line;
+    }
+
+  return static_cast<const char *>(0);
+}
+
+bool NmeaRingBuffer::verifyCheckSum( const char* sentence, const int length )
+{
+  uchar sum = 0;
+
+  // The start sign at position 0 is not considered.
+  for( int i = 1; i < length; i++ )
+    {
+      uchar c = (uchar) sentence[i];
+
+      if( c == '$' || c == '!' )
+        {
+          continue;
+        }
+
+      if( c != '*' )
+        {
+          sum ^= c;
+          continue;
+        }
+
+      // End of sentence reached, two hex digits must follow.
+      if( i + 2 >= length )
+        {
+          return false;
+        }
+
+      uchar check = 0;
+
+      for( int j = i + 1; j <= i + 2; j++ )
+        {
+          char h = sentence[j];
+
+          check <<= 4;
+
+          if( h >= '0' && h <= '9' )
+            {
+              check |= h - '0';
+            }
+          else if( h >= 'A' && h <= 'F' )
+            {
+              check |= h - 'A' + 10;
+            }
+          else if( h >= 'a' && h <= 'f' )
+            {
+              check |= h - 'a' + 10;
+            }
+          else
+            {
+              return false;
+            }
+        }
+
+      return check == sum;
+    }
+
+  return false;
+}
+
+int NmeaRingBuffer::replay( const char* fileName )
+{
+  int fd = open( fileName, O_RDONLY );
+
+  if( fd == -1 )
+    {
+      std::cerr << "NmeaRingBuffer::replay(): Cannot open " << fileName
+                << ": " << strerror(errno) << std::endl;
+      return 1;
+    }
+
+  NmeaRingBuffer buffer;
+
+  qint64 bytes = 0;
+  int lines    = 0;
+  int bad      = 0;
+
+  QTime t;
+  t.start();
+
+  while( true )
+    {
+      if( buffer.isFull() )
+        {
+          // No newline in the whole buffer, that is our emergency break.
+          buffer.clear();
+        }
+
+      // Simulate the chunk size of a serial device read.
+      int n = read( fd, buffer.writePointer(), qMin( buffer.writeSpace(), 512 ) );
+
+      if( n <= 0 )
+        {
+          break;
+        }
+
+      buffer.commit( n );
+      bytes += n;
+
+      const char* line;
+      int length;
+
+      while( (line = buffer.nextLine( length )) != 0 )
+        {
+          lines++;
+
+          if( (line[0] != '$' && line[0] != '!') ||
+              verifyCheckSum( line, length ) == false )
+            {
+              bad++;
+            }
+        }
+    }
+
+  int ms = t.elapsed();
+
+  close( fd );
+
+  std::cerr << "NmeaRingBuffer::replay(): " << fileName << ": "
+            << bytes << " bytes, " << lines << " lines, "
+            << bad << " bad, " << ms << " ms, "
+            << (ms > 0 ? (bytes * 1000 / ms) / 1024 : 0) << " KB/s"
+            << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+/***********************************************************************
+**
+**   nmearingbuffer.h
+**
+**   This file is part of Cumulus
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent (agent@local)
+**
+**   This program is free software; you can redistribute it and/or modify
+**   it under the terms of the GNU General Public License as published by
+**   the Free Software Foundation; either version 2 of the License, or
+**   (at your option) any later version.
+**
+***********************************************************************/
+
+/**
+ * \class NmeaRingBuffer
+ *
+ * \author agent
+ *
+ * \date 2026
+ *
+ * \brief Receive buffer of the GPS client with line framing.
+ *
+ * The GPS device data are read directly into a ring buffer of fixed capacity.
+ * Complete lines are taken out of the buffer without moving the remaining
+ * bytes. The newline search is done with memchr, which is vectorized by the
+ * C library. Already scanned bytes of an incomplete line are not scanned
+ * again after the next read.
+ *
+ * A returned line points into the ring buffer, only a line wrapping around
+ * the buffer end is copied into a scratch buffer. The line is valid until the
+ * next call of \ref commit or \ref clear.
+ *
+ * \version 1.0
+ */
+
+#ifndef NMEA_RING_BUFFER_H
+#define NMEA_RING_BUFFER_H
+
+class NmeaRingBuffer
+{
+ public:
+
+  enum
+    {
+      /** Capacity of the ring buffer in bytes. */
+      Capacity = 4096
+    };
+
+  NmeaRingBuffer();
+
+  virtual ~NmeaRingBuffer();
+
+  /**
+   * Discards all buffered data.
+   */
+  void clear()
+  {
+    m_tail    = 0;
+    m_size    = 0;
+    m_scanned = 0;
+  };
+
+  /**
+   * \return The number of buffered bytes.
+   */
+  int size() const
+  {
+    return m_size;
+  };
+
+  /**
+   * \return True, if no more data can be stored.
+   */
+  bool isFull() const
+  {
+    return m_size == Capacity;
+  };
+
+  /**
+   * \return The begin of the contiguous free space, where new data can be
+   *         read in.
+   */
+  char* writePointer()
+  {
+    return m_buffer + ((m_tail + m_size) % Capacity);
+  };
+
+  /**
+   * \return The size of the contiguous free space at \ref writePointer.
+   */
+  int writeSpace() const;
+
+  /**
+   * Takes over bytes, which have been written at \ref writePointer.
+   */
+  void commit( const int bytes )
+  {
+    m_size += bytes;
+  };
+
+  /**
+   * Takes the next complete line out of the buffer. Empty lines are skipped.
+   *
+   * \param length The length of the returned line inclusive the newline.
+   *
+   * \return The line, it is not null terminated. Null is returned, if no
+   *         complete line is available. The line stays valid until the
+   *         buffer is written again. A line, which wraps around the buffer
+   *         end, is copied together. That happens at most once between two
+   *         writes.
+   */
+  const char* nextLine( int& length );
+
+  /**
+   * Verifies the checksum of a NMEA sentence in place. The checksum is
+   * built over all characters between the start sign and the asterisk.
+   *
+   * \return True, if the sentence contains a matching checksum.
+   */
+  static bool verifyCheckSum( const char* sentence, const int length );
+
+  /**
+   * Feeds a recorded NMEA log file through the line framing and the checksum
+   * check and reports the throughput to stderr.
+   *
+   * \return 0 on success otherwise 1.
+   */
+  static int replay( const char* fileName );
+
+ private:
+
+  /** Start index of the buffered data. */
+  int m_tail;
+
+  /** Number of buffered bytes. */
+  int m_size;
+
+  /** Number of buffered bytes, which are already searched for a newline. */
+  int m_scanned;
+
+  char m_buffer[Capacity];
+
+  /** Copy of the last line, which has wrapped around the buffer end. */
+  char m_line[Capacity];
+};
+
+#endif
@@ -0,0 +1,153 @@
+/***********************************************************************
+**
+**   main.cpp
+**
+**   This file is part of Cumulus
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * Tests of MapCalc::simplifyPolygon. The program returns a non zero exit
+ * code, if a check fails.
+ */
+
+#include <cmath>
+#include <iostream>
+
+#include <QtCore>
+
+#include "mapcalc.h"
+#include "mapmatrix.h"
+
+// MapCalc uses the map matrix only for the projected distance, which is
+// not tested here.
+MapMatrix *_globalMapMatrix = 0;
+
+void MapMatrix::wgsToMap( int latIn, int lonIn, double& latOut, double& lonOut )
+{
+  latOut = latIn;
+  lonOut = lonIn;
+}
+
+// Length of a KFLog coordinate unit in meters
+static const double Unit = MILE_kfl / 10000.0;
+
+static int failures = 0;
+
+static void check( const char* name, const QPolygon& result, const QPolygon& expected )
+{
+  if( result == expected )
+    {
+      std::cout << "PASS: " << name << std::endl;
+      return;
+    }
+
+  failures++;
+
+  std::cout << "FAIL: " << name << ": expected " << expected.size()
+            << " points, got " << result.size() << ":";
+
+  for( int i = 0; i < result.size(); i++ )
+    {
+      std::cout << " (" << result.at(i).x() << "," << result.at(i).y() << ")";
+    }
+
+  std::cout << std::endl;
+}
+
+/** Returns a point with the passed distances in meters from the origin. */
+static QPoint point( const double north, const double east )
+{
+  return QPoint( (int) rint( north / Unit ), (int) rint( east / Unit ) );
+}
+
+/**
+ * The line runs 2000m to the north and then back by 1000m. The turn point
+ * lies on the infinite line through the end points, but 1000m beyond the
+ * segment between them, so it must be kept.
+ */
+static void testDoublingBack()
+{
+  QPolygon line;
+  line << point( 0, 0 ) << point( 1000, 0 ) << point( 2000, 0 )
+       << point( 1500, 0 ) << point( 1000, 0 );
+
+  QPolygon expected;
+  expected << point( 0, 0 ) << point( 2000, 0 ) << point( 1000, 0 );
+
+  QPolygon result;
+  MapCalc::simplifyPolygon( line, 100.0, result );
+
+  check( "doubling back", result, expected );
+}
+
+/**
+ * The line starts behind the first end point. The first inner point lies
+ * before the segment and must be kept.
+ */
+static void testDoublingBackAtStart()
+{
+  QPolygon line;
+  line << point( 0, 0 ) << point( -1000, 0 ) << point( 500, 0 )
+       << point( 1000, 0 );
+
+  QPolygon expected;
+  expected << point( 0, 0 ) << point( -1000, 0 ) << point( 1000, 0 );
+
+  QPolygon result;
+  MapCalc::simplifyPolygon( line, 100.0, result );
+
+  check( "doubling back at start", result, expected );
+}
+
+/**
+ * Deviations below the tolerance are removed, larger ones are kept.
+ */
+static void testTolerance()
+{
+  QPolygon line;
+  line << point( 0, 0 ) << point( 1000, 520 ) << point( 2000, 1000 )
+       << point( 3000, 650 ) << point( 4000, 0 );
+
+  // The second point deviates by 18m, the fourth one by 134m.
+  QPolygon expected;
+  expected << point( 0, 0 ) << point( 2000, 1000 ) << point( 3000, 650 )
+           << point( 4000, 0 );
+
+  QPolygon result;
+  MapCalc::simplifyPolygon( line, 100.0, result );
+
+  check( "tolerance", result, expected );
+}
+
+/**
+ * A closed polygon has identical end points. The farthest point is kept.
+ */
+static void testClosedPolygon()
+{
+  QPolygon line;
+  line << point( 0, 0 ) << point( 1000, 0 ) << point( 1000, 1000 )
+       << point( 0, 1000 ) << point( 0, 0 );
+
+  QPolygon result;
+  MapCalc::simplifyPolygon( line, 100.0, result );
+
+  check( "closed polygon", result, line );
+}
+
+int main()
+{
+  testDoublingBack();
+  testDoublingBackAtStart();
+  testTolerance();
+  testClosedPolygon();
+
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,32 @@
+################################################################################
+# MapCalc test project file of Cumulus for qmake
+#
+# (c) 2026 agent
+#
+# This template generates a makefile for the MapCalc test binary.
+#
+################################################################################
+
+TEMPLATE    = app
+CONFIG      = qt warn_on release console
+
+# Put all generated objects into an extra directory
+OBJECTS_DIR = .obj
+MOC_DIR     = .obj
+
+HEADERS     = \
+    ../../cumulus/mapcalc.h \
+    ../../cumulus/speed.h \
+    ../../cumulus/vector.h
+
+SOURCES     = \
+    main.cpp \
+    ../../cumulus/mapcalc.cpp \
+    ../../cumulus/speed.cpp \
+    ../../cumulus/vector.cpp
+
+TARGET = mapcalcTest
+DESTDIR     = .
+INCLUDEPATH += ../../cumulus
+
+LIBS += -lstdc++ -lm
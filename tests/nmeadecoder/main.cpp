@@ -0,0 +1,445 @@
+/***********************************************************************
+**
+**   main.cpp
+**
+**   This file is part of Cumulus
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * Tests of NmeaDecoder. The results of the decoder are compared with the
+ * former QString based splitting and parsing and with known values.
+ * Afterwards the run times of both ways are measured with the same
+ * sentences. The program returns a non zero exit code, if a check fails.
+ *
+ * Call: nmeadecoderTest [loops]
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <QtCore>
+
+#include "nmeadecoder.h"
+
+static int failures = 0;
+
+static void check( const char* name, const bool ok )
+{
+  if( ok )
+    {
+      std::cout << "PASS: " << name << std::endl;
+      return;
+    }
+
+  failures++;
+  std::cout << "FAIL: " << name << std::endl;
+}
+
+/** Sentences of a typical Flarm data stream. */
+static QStringList sentences()
+{
+  QStringList list;
+
+  list << "$GPRMC,132217.000,A,5228.19856,N,01408.32249,E,47.100,267.38,300710,,,A*68"
+       << "$GPGGA,132217.000,5228.19856,N,01408.32249,E,1,09,0.9,567.8,M,44.4,M,,*5D"
+       << "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39"
+       << "$GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00*74"
+       << "$PGRMZ,1843,f,2*24"
+       << "$PFLAU,3,1,2,1,1,-45,2,-132,1340,DD8451*73"
+       << "$PFLAA,0,-1234,1234,220,2,DD8F12,180,,30,-1.4,1*19";
+
+  return list;
+}
+
+/** The former splitting of all sentences. */
+static QStringList regExpSplit( const QString& sentence )
+{
+  return sentence.split( QRegExp("[,*]"), QString::KeepEmptyParts );
+}
+
+/** Checks, that the split of the decoder is equal to the former one. */
+static void testSplit()
+{
+  const QStringList list = sentences();
+
+  bool ok = true;
+
+  for( int i = 0; i < list.size(); i++ )
+    {
+      if( NmeaDecoder::split( list.at(i) ) != regExpSplit( list.at(i) ) )
+        {
+          std::cout << "  split differs: " << list.at(i).toLatin1().data() << std::endl;
+          ok = false;
+        }
+    }
+
+  // Empty fields at the begin and the end
+  const QString empty( ",a,,b*" );
+  ok = ok && NmeaDecoder::split( empty ) == regExpSplit( empty );
+
+  check( "split", ok );
+}
+
+/** Checks, that the decoder recognizes all sentence types. */
+static void testTypes()
+{
+  const int types[] = { NmeaFix::RMC, NmeaFix::GGA, NmeaFix::GSA,
+                        NmeaFix::GSV, NmeaFix::PGRMZ, NmeaFix::PFLAU,
+                        NmeaFix::PFLAA };
+
+  const QStringList list = sentences();
+
+  NmeaDecoder decoder;
+  NmeaFix fix;
+
+  bool ok = true;
+
+  for( int i = 0; i < list.size(); i++ )
+    {
+      const int type = decoder.decode( list.at(i), fix );
+
+      if( type != types[i] )
+        {
+          std::cout << "  type " << type << " instead of " << types[i]
+                    << ": " << list.at(i).toLatin1().data() << std::endl;
+          ok = false;
+        }
+    }
+
+  ok = ok && decoder.decode( QString( "$PCAID,N,-00084,000,128*0B" ), fix ) == NmeaFix::None;
+  ok = ok && decoder.decode( QString( "$GPRMC,132217.000,A*00" ), fix ) == NmeaFix::Corrupt;
+
+  check( "sentence types", ok );
+}
+
+/**
+ * Parses a RMC sentence in the former way and returns the values in the
+ * order time, date, latitude, longitude, speed and heading.
+ */
+static QList<double> regExpRmc( const QString& sentence )
+{
+  QStringList slst = regExpSplit( sentence );
+
+  QTime time( slst[1].left(2).toInt(), slst[1].mid(2,2).toInt(),
+              slst[1].mid(4,2).toInt() );
+
+  QDate date( slst[9].right(2).toInt() + 2000, slst[9].mid(2,2).toInt(),
+              slst[9].left(2).toInt() );
+
+  int lat = slst[3].left(2).toInt() * 600000 +
+            (int) rint( slst[3].mid(2).toFloat() * 10000 );
+
+  int lon = slst[5].left(3).toInt() * 600000 +
+            (int) rint( slst[5].mid(3).toFloat() * 10000 );
+
+  QList<double> values;
+  values << QTime( 0, 0 ).secsTo( time ) << QDate( 2000, 1, 1 ).daysTo( date )
+         << lat << lon << slst[7].toDouble() << slst[8].toDouble();
+
+  return values;
+}
+
+/** Checks the decoded RMC values against the former parsing. */
+static void testRmc()
+{
+  const QString sentence = sentences().first();
+
+  NmeaDecoder decoder;
+  NmeaFix fix;
+
+  decoder.decode( sentence, fix );
+
+  const QList<double> expected = regExpRmc( sentence );
+
+  QList<double> values;
+  values << QTime( 0, 0 ).secsTo( QTime( fix.hour, fix.minute, fix.second ) )
+         << QDate( 2000, 1, 1 ).daysTo( QDate( fix.year, fix.month, fix.day ) )
+         << fix.latitude << fix.longitude << fix.speed << fix.heading;
+
+  bool ok = ( fix.valid & NmeaFix::Position ) && values.size() == expected.size();
+
+  for( int i = 0; ok && i < values.size(); i++ )
+    {
+      // The former parsing rounds the minutes as float.
+      ok = fabs( values.at(i) - expected.at(i) ) <= ( i == 2 || i == 3 ? 1.0 : 1e-9 );
+    }
+
+  check( "RMC values", ok );
+}
+
+/** Appends the checksum to a sentence body, which ends before the asterisk. */
+static QString withChecksum( const QString& body )
+{
+  const QByteArray bytes = body.toLatin1();
+  uchar sum = 0;
+
+  for( int i = 1; i < bytes.size(); i++ )
+    {
+      sum ^= (uchar) bytes.at(i);
+    }
+
+  return body + QString( "*%1" ).arg( (int) sum, 2, 16, QChar('0') ).toUpper();
+}
+
+/** Returns the sentence with a wrong last checksum digit. */
+static QString corruptChecksum( const QString& sentence )
+{
+  const int digit = QString( sentence.right(1) ).toInt( 0, 16 );
+
+  return sentence.left( sentence.size() - 1 ) +
+         QString::number( (digit + 1) % 16, 16 ).toUpper();
+}
+
+/** Checks the decoded GGA values. */
+static void testGga()
+{
+  const QString sentence = sentences().at(1);
+
+  NmeaDecoder decoder;
+  NmeaFix fix;
+
+  bool ok = decoder.decode( sentence, fix ) == NmeaFix::GGA;
+
+  ok = ok && fix.status == NmeaFix::Valid &&
+       fix.valid == ( NmeaFix::Time | NmeaFix::Position |
+                      NmeaFix::Altitude | NmeaFix::Satellites ) &&
+       fix.hour == 13 && fix.minute == 22 && fix.second == 17 &&
+       fix.latitude == 52 * 600000 + 281986 &&
+       fix.longitude == 14 * 600000 + 83225 &&
+       fix.satellites == 9 &&
+       fix.altitude == 567.8 && fix.altitudeUnit == 'M' &&
+       strcmp( fix.identifier, "$GPGGA" ) == 0;
+
+  // Quality indicator 0 means no fix.
+  ok = ok && decoder.decode( withChecksum( "$GPGGA,132217.000,,,,,0,00,,,M,,M,," ),
+                             fix ) == NmeaFix::GGA &&
+       fix.status == NmeaFix::Invalid && ( fix.valid & NmeaFix::Position ) == 0;
+
+  check( "GGA values", ok );
+}
+
+/** Checks the decoded GLL values in the southern and western hemisphere. */
+static void testGll()
+{
+  NmeaDecoder decoder;
+  NmeaFix fix;
+
+  bool ok = decoder.decode( QString( "$GPGLL,3751.65000,S,14507.36000,W,225444.00,A,A*66" ),
+                            fix ) == NmeaFix::GLL;
+
+  ok = ok && fix.status == NmeaFix::Valid &&
+       fix.valid == ( NmeaFix::Time | NmeaFix::Position ) &&
+       fix.hour == 22 && fix.minute == 54 && fix.second == 44 &&
+       fix.latitude == -( 37 * 600000 + 516500 ) &&
+       fix.longitude == -( 145 * 600000 + 73600 );
+
+  check( "GLL values", ok );
+}
+
+/** Checks the decoded GNS values and the accepted talker. */
+static void testGns()
+{
+  NmeaDecoder decoder;
+  NmeaFix fix;
+
+  bool ok = decoder.decode( QString( "$GNGNS,014035.00,4332.69262,S,17235.48549,E,"
+                                     "RR,13,0.9,25.63,11.24,,*70" ), fix ) == NmeaFix::GNS;
+
+  ok = ok && fix.status == NmeaFix::Valid &&
+       fix.valid == ( NmeaFix::Time | NmeaFix::Position |
+                      NmeaFix::Altitude | NmeaFix::Satellites ) &&
+       fix.hour == 1 && fix.minute == 40 && fix.second == 35 &&
+       fix.latitude == -( 43 * 600000 + 326926 ) &&
+       fix.longitude == 172 * 600000 + 354855 &&
+       fix.satellites == 13 && fix.altitude == 25.63;
+
+  // Mode indicator N means no fix.
+  ok = ok && decoder.decode( QString( "$GNGNS,014035.00,,,,,NN,00,,,,,*7E" ), fix ) == NmeaFix::GNS &&
+       fix.status == NmeaFix::Invalid && ( fix.valid & NmeaFix::Position ) == 0;
+
+  // GNS is only accepted from the combined talker GN.
+  ok = ok && decoder.decode( QString( "$GPGNS,014035.00,4332.69262,S,17235.48549,E,"
+                                      "RR,13,0.9,25.63,11.24,,*6E" ), fix ) == NmeaFix::None;
+
+  check( "GNS values", ok );
+}
+
+/** Checks the signs of the coordinates in all hemispheres. */
+static void testHemispheres()
+{
+  NmeaDecoder decoder;
+  NmeaFix fix;
+
+  bool ok = decoder.decode( QString( "$GPRMC,081836.000,A,3751.65000,S,14507.36000,W,"
+                                     "12.5,271.4,130910,,,A*58" ), fix ) == NmeaFix::RMC;
+
+  ok = ok && fix.latitude == -( 37 * 600000 + 516500 ) &&
+       fix.longitude == -( 145 * 600000 + 73600 ) &&
+       fix.day == 13 && fix.month == 9 && fix.year == 2010;
+
+  const char* hemispheres[] = { "N,01408.32249,E", "S,01408.32249,E",
+                                "N,01408.32249,W", "S,01408.32249,W" };
+
+  for( int i = 0; ok && i < 4; i++ )
+    {
+      const QString sentence =
+        withChecksum( QString( "$GPGGA,132217.000,5228.19856,%1,1,09,0.9,567.8,M,44.4,M,," )
+                      .arg( hemispheres[i] ) );
+
+      ok = decoder.decode( sentence, fix ) == NmeaFix::GGA &&
+           fix.latitude == ( i & 1 ? -1 : 1 ) * ( 52 * 600000 + 281986 ) &&
+           fix.longitude == ( i & 2 ? -1 : 1 ) * ( 14 * 600000 + 83225 );
+    }
+
+  check( "hemispheres", ok );
+}
+
+/**
+ * Checks, that a wrong checksum is rejected in every sentence type. A
+ * sentence without checksum is decoded, an asterisk without checksum digits
+ * is rejected.
+ */
+static void testChecksums()
+{
+  QStringList list = sentences();
+
+  list << "$GPGLL,3751.65000,S,14507.36000,W,225444.00,A,A*66"
+       << "$GNGNS,014035.00,4332.69262,S,17235.48549,E,RR,13,0.9,25.63,11.24,,*70";
+
+  NmeaDecoder decoder;
+  NmeaFix fix;
+
+  bool ok = true;
+
+  for( int i = 0; i < list.size(); i++ )
+    {
+      const QString& sentence = list.at(i);
+      const int type = decoder.decode( sentence, fix );
+      const QString body = sentence.left( sentence.indexOf( '*' ) );
+
+      if( decoder.decode( corruptChecksum( sentence ), fix ) != NmeaFix::Corrupt ||
+          decoder.decode( body + "*", fix ) != NmeaFix::Corrupt ||
+          decoder.decode( body + "*G0", fix ) != NmeaFix::Corrupt ||
+          decoder.decode( body, fix ) != type )
+        {
+          std::cout << "  checksum not checked: " << sentence.toLatin1().data() << std::endl;
+          ok = false;
+        }
+    }
+
+  check( "checksums", ok );
+}
+
+/** Checks sentences at the field and the length limits of the decoder. */
+static void testLimits()
+{
+  NmeaDecoder decoder;
+  NmeaFix fix;
+
+  // The identifier and the checksum are fields too.
+  const QString fields = QString( ",1" ).repeated( NmeaDecoder::MaxFields - 2 );
+
+  bool ok = decoder.decode( withChecksum( "$GPGSA" + fields ), fix ) == NmeaFix::GSA &&
+            fix.fields == NmeaDecoder::MaxFields;
+
+  ok = ok && decoder.decode( withChecksum( "$GPGSA" + fields + ",1" ), fix ) == NmeaFix::Corrupt;
+
+  // The checksum takes the last 3 bytes of the sentence.
+  const QString data( NmeaDecoder::MaxLength - 10, QChar('1') );
+  const QString longest = withChecksum( "$GPGSV," + data );
+
+  ok = ok && longest.size() == NmeaDecoder::MaxLength &&
+       decoder.decode( longest, fix ) == NmeaFix::GSV && fix.fields == 3;
+
+  // A longer sentence is cut, so that its checksum is incomplete.
+  ok = ok && decoder.decode( withChecksum( "$GPGSV," + data + "1" ), fix ) == NmeaFix::Corrupt;
+
+  check( "limits", ok );
+}
+
+/**
+ * Measures the run time of the former processing, a split with a regular
+ * expression and a lookup of the identifier in a hash, against the decoder
+ * with the same sentences.
+ */
+static void benchmark( const int loops )
+{
+  const QStringList list = sentences();
+
+  QHash<QString, short> keys;
+  keys.insert( "$GPRMC", 0 );
+  keys.insert( "$GPGGA", 2 );
+  keys.insert( "$GPGSA", 3 );
+  keys.insert( "$GPGSV", 4 );
+  keys.insert( "$PGRMZ", 5 );
+  keys.insert( "$PFLAU", 21 );
+  keys.insert( "$PFLAA", 20 );
+
+  double check = 0.0;
+
+  QTime timer;
+  timer.start();
+
+  for( int i = 0; i < loops; i++ )
+    {
+      for( int j = 0; j < list.size(); j++ )
+        {
+          QStringList slst = regExpSplit( list.at(j) );
+
+          check += keys.value( slst[0] ) + slst.size();
+        }
+    }
+
+  const int regExpTime = timer.restart();
+
+  NmeaDecoder decoder;
+  NmeaFix fix;
+
+  for( int i = 0; i < loops; i++ )
+    {
+      for( int j = 0; j < list.size(); j++ )
+        {
+          const int type = decoder.decode( list.at(j), fix );
+
+          // Only the position sentences need no split.
+          if( NmeaFix::isPosition( type ) == false )
+            {
+              check -= NmeaDecoder::split( list.at(j) ).size();
+            }
+        }
+    }
+
+  const int decoderTime = timer.elapsed();
+
+  std::cout << "BENCHMARK: " << loops * list.size() << " sentences, "
+            << "split with QRegExp: " << regExpTime << "ms, "
+            << "decoder: " << decoderTime << "ms"
+            << " (" << check << ")" << std::endl;
+}
+
+int main( int argc, char* argv[] )
+{
+  testSplit();
+  testTypes();
+  testRmc();
+  testGga();
+  testGll();
+  testGns();
+  testHemispheres();
+  testChecksums();
+  testLimits();
+
+  benchmark( argc > 1 ? atoi( argv[1] ) : 20000 );
+
+  return failures > 0 ? 1 : 0;
+}
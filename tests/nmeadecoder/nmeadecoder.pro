@@ -0,0 +1,31 @@
+################################################################################
+# NmeaDecoder test project file of Cumulus for qmake
+#
+# (c) 2026 agent
+#
+# This template generates a makefile for the NmeaDecoder test binary. It
+# checks the decoder against the former QString based parsing and compares
+# the run times of both.
+#
+################################################################################
+
+TEMPLATE    = app
+CONFIG      = qt warn_on release console
+QT         -= gui
+
+# Put all generated objects into an extra directory
+OBJECTS_DIR = .obj
+MOC_DIR     = .obj
+
+HEADERS     = \
+    ../../cumulus/nmeadecoder.h
+
+SOURCES     = \
+    main.cpp \
+    ../../cumulus/nmeadecoder.cpp
+
+TARGET = nmeadecoderTest
+DESTDIR     = .
+INCLUDEPATH += ../../cumulus
+
+LIBS += -lstdc++ -lm
@@ -0,0 +1,341 @@
+/***********************************************************************
+**
+**   main.cpp
+**
+**   This file is part of Cumulus
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * Tests of the OpenAir tokenizer. The polygon points of a generated OpenAir
+ * file are read by the former QString based parsing and by the tokenizer,
+ * the results are compared. Afterwards the run times of both ways are
+ * measured with the same data. The program returns a non zero exit code,
+ * if a check fails.
+ *
+ * Call: openairTest [airspaces]
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <QtCore>
+
+#include "openairtokenizer.h"
+
+static int failures = 0;
+
+static void check( const char* name, const bool ok )
+{
+  if( ok )
+    {
+      std::cout << "PASS: " << name << std::endl;
+      return;
+    }
+
+  failures++;
+  std::cout << "FAIL: " << name << std::endl;
+}
+
+/** Formats a coordinate part in one of the usual OpenAir notations. */
+static QString coordinate( const int i, const int degrees, const char direction )
+{
+  const int minutes = (i * 7) % 60;
+  const double seconds = ((i * 1301) % 6000) / 100.0;
+
+  switch( i % 3 )
+    {
+      case 0:
+        return QString( "%1:%2:%3 %4" ).arg( degrees )
+                                       .arg( minutes, 2, 10, QChar('0') )
+                                       .arg( seconds, 5, 'f', 2, QChar('0') )
+                                       .arg( direction );
+      case 1:
+        return QString( "%1:%2%3" ).arg( degrees )
+                                   .arg( minutes + seconds / 60.0, 0, 'f', 3 )
+                                   .arg( QChar( direction ).toLower() );
+      default:
+        return QString( "%1:%2:%3%4" ).arg( degrees )
+                                      .arg( minutes )
+                                      .arg( (int) seconds )
+                                      .arg( direction );
+    }
+}
+
+/** Generates an OpenAir file with the passed number of airspaces. */
+static QByteArray openAirFile( const int airspaces )
+{
+  QByteArray data;
+
+  data.append( "* Generated OpenAir file\n\n" );
+
+  int n = 0;
+
+  for( int i = 0; i < airspaces; i++ )
+    {
+      data.append( "AC D\n" );
+      data.append( QString( "AN CTR Test %1\n" ).arg( i ).toLatin1() );
+      data.append( "AL GND\n" );
+      data.append( "AH 2500ft MSL   * upper limit\n" );
+
+      for( int j = 0; j < 40; j++, n++ )
+        {
+          const QString line = QString( "DP %1  %2\r\n" )
+                               .arg( coordinate( n, 45 + n % 10, n % 5 ? 'N' : 'S' ) )
+                               .arg( coordinate( n + 1, 5 + n % 100, n % 7 ? 'E' : 'W' ) );
+
+          data.append( line.toLatin1() );
+        }
+
+      data.append( "# end of airspace\n\n" );
+    }
+
+  return data;
+}
+
+/**
+ * The former parsing of a coordinate part, which was done with QString
+ * methods.
+ */
+static bool oldCoordinatePart( const QString& line, int& lat, int& lon )
+{
+  QStringList sl = line.split( QChar(':') );
+
+  if( sl.isEmpty() || sl.size() > 3 )
+    {
+      return false;
+    }
+
+  QString last = sl.last().trimmed();
+  const QString skyDirection = last.right(1);
+
+  sl.last() = last.left( last.size() - 1 );
+
+  double values[3] = { 0.0, 0.0, 0.0 };
+
+  for( int i = 0; i < sl.size(); i++ )
+    {
+      bool ok;
+      values[i] = sl.at(i).trimmed().toDouble( &ok );
+
+      if( ! ok )
+        {
+          return false;
+        }
+    }
+
+  const int value =
+      static_cast<int> (rint( (600000.0 * values[0]) +
+                              (10000.0 * (values[1] + (values[2] / 60.0))) ));
+
+  if( skyDirection == "N" ) lat = value;
+  else if( skyDirection == "S" ) lat = -value;
+  else if( skyDirection == "E" ) lon = value;
+  else if( skyDirection == "W" ) lon = -value;
+  else return false;
+
+  return true;
+}
+
+/**
+ * The former reading of the polygon points: line reading with a text
+ * stream, simplifying of every line, comment removal by splitting and
+ * coordinate splitting with a regular expression.
+ */
+static void oldParse( const QByteArray& data, QVector<QPoint>& points )
+{
+  QBuffer buffer;
+  buffer.setData( data );
+  buffer.open( QIODevice::ReadOnly );
+
+  QTextStream in( &buffer );
+  in.setCodec( "ISO 8859-15" );
+
+  while( ! in.atEnd() )
+    {
+      QString line = in.readLine().simplified();
+
+      if( line.startsWith( "*" ) || line.startsWith( "#" ) || line.isEmpty() )
+        {
+          continue;
+        }
+
+      line = line.split( '*' )[0];
+      line = line.split( '#' )[0];
+
+      if( ! line.startsWith( "DP " ) )
+        {
+          continue;
+        }
+
+      QString coord = line.mid( 3 ).toUpper();
+
+      QRegExp reg( "[NSEW]" );
+      const int pos = reg.indexIn( coord, 0 );
+
+      int lat = 0, lon = 0;
+
+      if( pos == -1 ||
+          ! oldCoordinatePart( coord.left( pos + 1 ), lat, lon ) ||
+          ! oldCoordinatePart( coord.mid( pos + 1 ), lat, lon ) )
+        {
+          points.append( QPoint( 0, 0 ) );
+          continue;
+        }
+
+      points.append( QPoint( lat, lon ) );
+    }
+}
+
+/** Reads a coordinate part with the tokenizer like the OpenAirParser. */
+static bool newCoordinatePart( const char*& p, const char* end, int& lat, int& lon )
+{
+  int value;
+  char skyDirection;
+
+  if( ! OpenAirTokenizer::readCoordinatePart( p, end, value, skyDirection ) )
+    {
+      return false;
+    }
+
+  switch( skyDirection )
+    {
+      case 'N':
+        lat = value;
+        return true;
+      case 'S':
+        lat = -value;
+        return true;
+      case 'E':
+        lon = value;
+        return true;
+      case 'W':
+        lon = -value;
+        return true;
+      default:
+        return false;
+    }
+}
+
+/** Reads the polygon points with the tokenizer like the OpenAirParser. */
+static void newParse( const QByteArray& data, QVector<QPoint>& points )
+{
+  const char* p = data.constData();
+  const char* const dataEnd = p + data.size();
+  const char* begin;
+  const char* end;
+  int lineNumber = 0;
+
+  while( OpenAirTokenizer::nextLine( p, dataEnd, begin, end, lineNumber ) )
+    {
+      if( ! OpenAirTokenizer::isRecord( begin, end, 'D', 'P' ) )
+        {
+          continue;
+        }
+
+      const char* s = begin + 3;
+      int lat = 0, lon = 0;
+
+      if( ! newCoordinatePart( s, end, lat, lon ) ||
+          ! newCoordinatePart( s, end, lat, lon ) )
+        {
+          points.append( QPoint( 0, 0 ) );
+          continue;
+        }
+
+      points.append( QPoint( lat, lon ) );
+    }
+}
+
+/** Checks, that the tokenizer delivers the same points as before. */
+static void testPoints( const QByteArray& data )
+{
+  QVector<QPoint> oldPoints;
+  QVector<QPoint> newPoints;
+
+  oldParse( data, oldPoints );
+  newParse( data, newPoints );
+
+  bool ok = ! oldPoints.isEmpty() && oldPoints.size() == newPoints.size();
+
+  for( int i = 0; ok && i < oldPoints.size(); i++ )
+    {
+      // The numbers are converted differently, the rounded values may
+      // differ by one unit.
+      const QPoint d = oldPoints.at(i) - newPoints.at(i);
+
+      if( oldPoints.at(i).isNull() || abs( d.x() ) > 1 || abs( d.y() ) > 1 )
+        {
+          std::cout << "  point " << i << " differs: ("
+                    << oldPoints.at(i).x() << "," << oldPoints.at(i).y() << ") ("
+                    << newPoints.at(i).x() << "," << newPoints.at(i).y() << ")"
+                    << std::endl;
+          ok = false;
+        }
+    }
+
+  check( "polygon points", ok );
+}
+
+/** Checks the line handling of the tokenizer. */
+static void testLines()
+{
+  const QByteArray data( "* comment\n  \t\nAN Name  * comment\r\n#x\nAL GND" );
+
+  const char* p = data.constData();
+  const char* const dataEnd = p + data.size();
+  const char* begin;
+  const char* end;
+  int lineNumber = 0;
+
+  QStringList lines;
+
+  while( OpenAirTokenizer::nextLine( p, dataEnd, begin, end, lineNumber ) )
+    {
+      lines.append( QString::fromLatin1( begin, end - begin ) );
+    }
+
+  check( "lines", lines == ( QStringList() << "AN Name" << "AL GND" ) &&
+                  lineNumber == 5 );
+}
+
+/** Measures the run time of the former parsing against the tokenizer. */
+static void benchmark( const QByteArray& data )
+{
+  QVector<QPoint> points;
+
+  QTime timer;
+  timer.start();
+
+  oldParse( data, points );
+
+  const int oldTime = timer.restart();
+
+  points.clear();
+  newParse( data, points );
+
+  const int newTime = timer.elapsed();
+
+  std::cout << "BENCHMARK: " << data.size() / 1024 << "KB, "
+            << points.size() << " points, "
+            << "QString parsing: " << oldTime << "ms, "
+            << "tokenizer: " << newTime << "ms" << std::endl;
+}
+
+int main( int argc, char* argv[] )
+{
+  testLines();
+  testPoints( openAirFile( 100 ) );
+
+  benchmark( openAirFile( argc > 1 ? atoi( argv[1] ) : 5000 ) );
+
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,30 @@
+################################################################################
+# OpenAir tokenizer test project file of Cumulus for qmake
+#
+# (c) 2026 agent
+#
+# This template generates a makefile for the OpenAir tokenizer test binary.
+# It checks the tokenizer against the former QString based parsing and
+# compares the run times of both.
+#
+################################################################################
+
+TEMPLATE    = app
+CONFIG      = qt warn_on release console
+QT         -= gui
+
+# Put all generated objects into an extra directory
+OBJECTS_DIR = .obj
+MOC_DIR     = .obj
+
+HEADERS     = \
+    ../../cumulus/openairtokenizer.h
+
+SOURCES     = \
+    main.cpp
+
+TARGET = openairTest
+DESTDIR     = .
+INCLUDEPATH += ../../cumulus
+
+LIBS += -lstdc++ -lm
@@ -0,0 +1,17 @@
+################################################################################
+# Test project file of Cumulus for qmake
+#
+# (c) 2026 agent
+#
+# This template builds the test and benchmark programs of Cumulus. Every
+# program is a console application, which returns a non zero exit code,
+# if a check fails.
+#
+################################################################################
+
+TEMPLATE = subdirs
+
+SUBDIRS = \
+    mapcalc \
+    nmeadecoder \
+    openair